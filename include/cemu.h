@@ -40,38 +40,6 @@ struct PPCInterpreter_t {
     } sprNew;
 };
 
-enum VPADButtons : uint32_t {
-    VPAD_BUTTON_NONE = 0,
-    VPAD_BUTTON_A = 0x8000,
-    VPAD_BUTTON_B = 0x4000,
-    VPAD_BUTTON_X = 0x2000,
-    VPAD_BUTTON_Y = 0x1000,
-    VPAD_BUTTON_LEFT = 0x0800,
-    VPAD_BUTTON_RIGHT = 0x0400,
-    VPAD_BUTTON_UP = 0x0200,
-    VPAD_BUTTON_DOWN = 0x0100,
-    VPAD_BUTTON_ZL = 0x0080,
-    VPAD_BUTTON_ZR = 0x0040,
-    VPAD_BUTTON_L = 0x0020,
-    VPAD_BUTTON_R = 0x0010,
-    VPAD_BUTTON_PLUS = 0x0008,
-    VPAD_BUTTON_MINUS = 0x0004,
-    VPAD_BUTTON_HOME = 0x0002,
-    VPAD_BUTTON_SYNC = 0x0001,
-    VPAD_BUTTON_STICK_R = 0x00020000,
-    VPAD_BUTTON_STICK_L = 0x00040000,
-    VPAD_BUTTON_TV = 0x00010000,
-    VPAD_STICK_R_EMULATION_LEFT = 0x04000000,
-    VPAD_STICK_R_EMULATION_RIGHT = 0x02000000,
-    VPAD_STICK_R_EMULATION_UP = 0x01000000,
-    VPAD_STICK_R_EMULATION_DOWN = 0x00800000,
-    VPAD_STICK_L_EMULATION_LEFT = 0x40000000,
-    VPAD_STICK_L_EMULATION_RIGHT = 0x20000000,
-    VPAD_STICK_L_EMULATION_UP = 0x10000000,
-    VPAD_STICK_L_EMULATION_DOWN = 0x08000000,
-};
-ENABLE_BITMASK_OPERATORS(VPADButtons);
-
 struct BEDir {
     BEVec3 x;
     BEVec3 y;
@@ -406,15 +406,6 @@ struct AttackSensorOtherArg {
 };
 static_assert(sizeof(AttackSensorOtherArg) == 0x24, "AttackSensorOtherArg size mismatch");
 
-enum WeaponType : uint32_t {
-    SmallSword = 0x0,
-    LargeSword = 0x1,
-    Spear = 0x2,
-    Bow = 0x3,
-    Shield = 0x4,
-    UnknownWeapon = 0x5,
-};
-
 enum class EquipType {
     None = 0,
     Melee = 1,
@@ -426,26 +417,6 @@ enum class EquipType {
     ThrowableObject = 7
 };
 
-enum class RumbleType {
-    Fixed,
-    Raising,
-    Falling,
-    OscillationSmooth,
-    OscillationFallingSawtoothWave,
-    OscillationRaisingSawtoothWave
-};
-
- struct RumbleParameters {
-     bool prioritizeThisRumble = false;
-     int hand = 0;
-     RumbleType rumbleType = RumbleType::Fixed;
-     float oscillationFrequency = 0.0f;
-     bool keepRumblingOnEffectEnd = false; // requires stopInputsRumble() to manually stop the rumble
-     double effectDuration = 0;
-     float frequency = 0.0f;
-     float amplitude = 0.0f;
- };
-
 enum class Direction {
     Up,
     Right,
@@ -0,0 +1,596 @@
+#pragma once
+
+// The part of pch.h that doesn't depend on Windows, D3D12 or ImGui, so that the tests can use it too.
+// Expects the standard library, Vulkan, OpenXR and glm headers to be included already.
+
+inline glm::fvec2 ToGLM(const XrVector2f& vec) {
+    return glm::make_vec2(&vec.x);
+}
+
+inline glm::fvec3 ToGLM(const XrVector3f& vec) {
+    return glm::make_vec3(&vec.x);
+}
+
+inline glm::fquat ToGLM(const XrQuaternionf& quat) {
+    return glm::fquat(quat.w, quat.x, quat.y, quat.z);
+}
+
+
+inline XrVector2f ToXR(const glm::fvec2& vec) {
+    return { vec.x, vec.y };
+}
+
+inline XrVector3f ToXR(const glm::fvec3& vec) {
+    return { vec.x, vec.y, vec.z };
+}
+
+inline XrQuaternionf ToXR(const glm::fquat& quat) {
+    return { quat.x, quat.y, quat.z, quat.w };
+}
+
+inline glm::fmat4 ToMat4(const glm::fvec3& pos) {
+    return glm::translate(glm::identity<glm::fmat4>(), pos);
+}
+
+inline glm::fmat4 ToMat4(const glm::fquat& rot) {
+    return glm::mat4(rot);
+}
+
+inline glm::fmat4 ToMat4(const glm::fvec3& pos, const glm::fquat& rot) {
+    return ToMat4(pos) * ToMat4(rot);
+}
+
+
+inline std::string toLower(std::string str) {
+    std::ranges::transform(str, str.begin(), [](unsigned char c) { return std::tolower(c); });
+    return str;
+}
+
+inline uint32_t stringToHash(const char* str) {
+    uint32_t hash = 0;
+    while (*str) {
+        hash = (hash << 7) + *str++;
+    }
+    return hash;
+}
+
+template<class T, template<class...> class U>
+inline constexpr bool is_instance_of_v = std::false_type{};
+
+template<template<class...> class U, class... Vs>
+inline constexpr bool is_instance_of_v<U<Vs...>,U> = std::true_type{};
+
+template <typename T>
+requires std::is_enum_v<T>
+constexpr bool HAS_FLAG(T value, T mask) {
+    auto v = std::to_underlying(value);
+    auto m = std::to_underlying(mask);
+    return (v & m) == m;
+}
+
+template <typename T>
+struct is_bitmask_enum : std::false_type {};
+
+template <typename T>
+using enable_if_bitmask_t = std::enable_if_t<is_bitmask_enum<T>::value, T>;
+
+#define ENABLE_BITMASK_OPERATORS(x) \
+    template <>                     \
+    struct is_bitmask_enum<x> : std::true_type {};
+
+// Bitwise OR
+template <typename T>
+constexpr enable_if_bitmask_t<T> operator|(T lhs, T rhs) {
+    using U = std::underlying_type_t<T>;
+    return static_cast<T>(static_cast<U>(lhs) | static_cast<U>(rhs));
+}
+
+// Bitwise AND
+template <typename T>
+constexpr enable_if_bitmask_t<T> operator&(T lhs, T rhs) {
+    using U = std::underlying_type_t<T>;
+    return static_cast<T>(static_cast<U>(lhs) & static_cast<U>(rhs));
+}
+
+// Bitwise XOR
+template <typename T>
+constexpr enable_if_bitmask_t<T> operator^(T lhs, T rhs) {
+    using U = std::underlying_type_t<T>;
+    return static_cast<T>(static_cast<U>(lhs) ^ static_cast<U>(rhs));
+}
+
+// Bitwise NOT
+template <typename T>
+constexpr enable_if_bitmask_t<T> operator~(T val) {
+    using U = std::underlying_type_t<T>;
+    return static_cast<T>(~static_cast<U>(val));
+}
+
+// Assignment OR
+template <typename T>
+constexpr enable_if_bitmask_t<T>& operator|=(T& lhs, T rhs) {
+    lhs = lhs | rhs;
+    return lhs;
+}
+
+
+template <typename T>
+inline T swapEndianness(T val) {
+    if constexpr (std::is_floating_point<T>::value) {
+        union {
+            T f;
+            uint32_t i;
+        } bits;
+
+        bits.f = val;
+        bits.i = (bits.i & 0x000000FF) << 24 | (bits.i & 0x0000FF00) << 8  | (bits.i & 0x00FF0000) >> 8  | (bits.i & 0xFF000000) >> 24;
+
+        return bits.f;
+    }
+    else if constexpr (std::is_integral<T>::value) {
+        if constexpr (sizeof(T) == 1) {
+            return val;
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return static_cast<T>((val << 8) | (val >> 8));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return ((val & 0x000000FF) << 24) | ((val & 0x0000FF00) <<  8) | ((val & 0x00FF0000) >>  8) | ((val & 0xFF000000) >> 24);
+        }
+        else {
+            union U {
+                T val;
+                std::array<std::uint8_t, sizeof(T)> raw;
+            } src, dst;
+
+            src.val = val;
+            std::reverse_copy(src.raw.begin(), src.raw.end(), dst.raw.begin());
+            return dst.val;
+        }
+    }
+    else {
+        union U {
+            T val;
+            std::array<std::uint8_t, sizeof(T)> raw;
+        } src, dst;
+
+        src.val = val;
+        std::reverse_copy(src.raw.begin(), src.raw.end(), dst.raw.begin());
+        return dst.val;
+    }
+}
+
+struct BETypeCompatible {
+};
+
+template<typename T>
+struct BEType : BETypeCompatible {
+    T val;
+
+    BEType() = default;
+
+    BEType(T x) : val(swapEndianness(x)) {}
+
+    explicit operator T() {
+        return swapEndianness(val);
+    }
+
+    BEType<T>& operator =(T x) {
+        val = swapEndianness(x);
+        return *this;
+    }
+
+    BEType<T>& operator =(const BEType<T>& other) {
+        val = other.val;
+        return *this;
+    }
+
+    T getLE() const {
+        return swapEndianness(val);
+    }
+
+    T getBE() const {
+        return val;
+    }
+
+
+    bool operator ==(const BEType<T>& other) const { return val == other.val; }
+    bool operator ==(const T& other) const { return swapEndianness(val) == other; }
+    friend bool operator ==(const T& lhs, const BEType<T>& rhs) { return lhs == swapEndianness(rhs.val);}
+
+    bool operator !=(const BEType<T>& other) const { return val != other.val; }
+    bool operator !=(const T& other) const { return swapEndianness(val) != other.val; }
+    friend bool operator !=(const T& lhs, const BEType<T>& rhs) { return lhs != swapEndianness(rhs.val); }
+
+    bool operator <(const BEType<T>& other) const { return swapEndianness(val) < swapEndianness(other.val); }
+    bool operator <(const T& other) const { return swapEndianness(val) < other; }
+    friend bool operator <(const T& lhs, const BEType<T>& rhs) { return lhs < swapEndianness(rhs.val); }
+
+    bool operator >(const BEType<T>& other) const { return swapEndianness(val) > swapEndianness(other.val); }
+    bool operator >(const T& other) const { return swapEndianness(val) > other; }
+    friend bool operator >(const T& lhs, const BEType<T>& rhs) { return lhs > swapEndianness(rhs.val); }
+
+    bool operator <=(const BEType<T>& other) const { return swapEndianness(val) <= swapEndianness(other.val); }
+    bool operator <=(const T& other) const { return swapEndianness(val) <= other; }
+    friend bool operator <=(const T& lhs, const BEType<T>& rhs) { return lhs <= swapEndianness(rhs.val); }
+
+    bool operator >=(const BEType<T>& other) const { return swapEndianness(val) >= swapEndianness(other.val); }
+    bool operator >=(const T& other) const { return swapEndianness(val) >= other; }
+    friend bool operator >=(const T& lhs, const BEType<T>& rhs) { return lhs >= swapEndianness(rhs.val); }
+};
+
+
+template<typename T>
+inline constexpr bool is_BEType_v = std::is_base_of_v<BETypeCompatible, T>;
+
+struct BEVec2 : BETypeCompatible {
+    BEType<float> x;
+    BEType<float> y;
+
+    BEVec2() = default;
+    BEVec2(float x, float y): x(x), y(y) {}
+    BEVec2(BEType<float> x, BEType<float> y): x(x), y(y) {}
+};
+
+struct BEVec3 : BETypeCompatible {
+    BEType<float> x;
+    BEType<float> y;
+    BEType<float> z;
+
+    BEVec3() = default;
+    BEVec3(BEType<float> x, BEType<float> y, BEType<float> z): x(x), y(y), z(z) {}
+    BEVec3(float x, float y, float z): x(x), y(y), z(z) {}
+
+    float DistanceSq(BEVec3 other) const {
+        return (x.getLE() - other.x.getLE()) * (x.getLE() - other.x.getLE()) + (y.getLE() - other.y.getLE()) * (y.getLE() - other.y.getLE()) + (z.getLE() - other.z.getLE()) * (z.getLE() - other.z.getLE());
+    }
+
+    glm::fvec3 getLE() const {
+        return { x.getLE(), y.getLE(), z.getLE() };
+    }
+
+    bool operator==(const BEVec3& other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+
+    void operator=(const glm::fvec3& other) {
+        x = other.x;
+        y = other.y;
+        z = other.z;
+    }
+};
+
+struct BEMatrix34 : BETypeCompatible {
+    BEType<float> x_x;
+    BEType<float> y_x;
+    BEType<float> z_x;
+    BEType<float> pos_x;
+    BEType<float> x_y;
+    BEType<float> y_y;
+    BEType<float> z_y;
+    BEType<float> pos_y;
+    BEType<float> x_z;
+    BEType<float> y_z;
+    BEType<float> z_z;
+    BEType<float> pos_z;
+
+    BEMatrix34() = default;
+
+    float DistanceSq(const BEMatrix34& other) const {
+        return (pos_x.getLE() - other.pos_x.getLE()) * (pos_x.getLE() - other.pos_x.getLE()) + (pos_y.getLE() - other.pos_y.getLE()) * (pos_y.getLE() - other.pos_y.getLE()) + (pos_z.getLE() - other.pos_z.getLE()) * (pos_z.getLE() - other.pos_z.getLE());
+    }
+
+    std::array<std::array<float, 4>, 3> getLE() const {
+        std::array row0 = { x_x.getLE(), y_x.getLE(), z_x.getLE(), pos_x.getLE() };
+        std::array row1 = { x_y.getLE(), y_y.getLE(), z_y.getLE(), pos_y.getLE() };
+        std::array row2 = { x_z.getLE(), y_z.getLE(), z_z.getLE(), pos_z.getLE() };
+        return { row0, row1, row2 };
+    }
+
+    glm::mat4x3 getLEMatrix() const {
+        return glm::mat4x3(
+            glm::vec3(x_x.getLE(), x_y.getLE(), x_z.getLE()),      // X basis column
+            glm::vec3(y_x.getLE(), y_y.getLE(), y_z.getLE()),      // Y basis column
+            glm::vec3(z_x.getLE(), z_y.getLE(), z_z.getLE()),      // Z basis column
+            glm::vec3(pos_x.getLE(), pos_y.getLE(), pos_z.getLE()) // translation column
+        );
+    }
+
+    void setLEMatrix(const glm::mat4x3& m) {
+        // m[col][row]
+        x_x = m[0][0];
+        x_y = m[0][1];
+        x_z = m[0][2];
+        y_x = m[1][0];
+        y_y = m[1][1];
+        y_z = m[1][2];
+        z_x = m[2][0];
+        z_y = m[2][1];
+        z_z = m[2][2];
+
+        pos_x = m[3][0];
+        pos_y = m[3][1];
+        pos_z = m[3][2];
+    }
+
+    BEVec3 getPos() const {
+        return { pos_x, pos_y, pos_z };
+    }
+
+    void setPos(glm::fvec3 pos) {
+        pos_x = pos.x;
+        pos_y = pos.y;
+        pos_z = pos.z;
+    }
+
+    glm::fquat getRotLE() const {
+        return glm::quat_cast(glm::fmat3(getLEMatrix()));
+    }
+
+	void setRotLE(const glm::fquat& rotation) {
+        glm::fmat3 rotMat = glm::mat3_cast(rotation);
+
+        x_x = rotMat[0][0];
+        y_x = rotMat[1][0];
+        z_x = rotMat[2][0];
+        x_y = rotMat[0][1];
+        y_y = rotMat[1][1];
+        z_y = rotMat[2][1];
+        x_z = rotMat[0][2];
+        y_z = rotMat[1][2];
+        z_z = rotMat[2][2];
+    }
+};
+
+struct BEMatrix44 : BETypeCompatible {
+    BEType<float> a00;
+    BEType<float> a01;
+    BEType<float> a02;
+    BEType<float> a03;
+    BEType<float> a10;
+    BEType<float> a11;
+    BEType<float> a12;
+    BEType<float> a13;
+    BEType<float> a20;
+    BEType<float> a21;
+    BEType<float> a22;
+    BEType<float> a23;
+    BEType<float> a30;
+    BEType<float> a31;
+    BEType<float> a32;
+    BEType<float> a33;
+
+    BEMatrix44() = default;
+
+    glm::fmat4 getLE() const {
+        return glm::fmat4(
+            a00.getLE(), a01.getLE(), a02.getLE(), a03.getLE(),
+            a10.getLE(), a11.getLE(), a12.getLE(), a13.getLE(),
+            a20.getLE(), a21.getLE(), a22.getLE(), a23.getLE(),
+            a30.getLE(), a31.getLE(), a32.getLE(), a33.getLE()
+        );
+    }
+
+    void operator=(glm::fmat4 mtx) {
+        a00 = mtx[0][0];
+        a01 = mtx[0][1];
+        a02 = mtx[0][2];
+        a03 = mtx[0][3];
+        a10 = mtx[1][0];
+        a11 = mtx[1][1];
+        a12 = mtx[1][2];
+        a13 = mtx[1][3];
+        a20 = mtx[2][0];
+        a21 = mtx[2][1];
+        a22 = mtx[2][2];
+        a23 = mtx[2][3];
+        a30 = mtx[3][0];
+        a31 = mtx[3][1];
+        a32 = mtx[3][2];
+        a33 = mtx[3][3];
+    }
+};
+
+#pragma pack(push, 1)
+struct BESeadProjection {
+    BEType<bool> dirty;
+    BEType<bool> deviceDirty;
+    BEType<uint8_t> pad0;
+    BEType<uint8_t> pad1;
+    BEMatrix44 matrix;
+    BEMatrix44 deviceMatrix;
+    BEType<uint32_t> devicePosture;
+    BEType<float> deviceZScale;
+    BEType<float> deviceZOffset;
+    BEType<uint32_t> __vftable;
+};
+
+struct BESeadPerspectiveProjection : BESeadProjection {
+    BEType<float> zNear;
+    BEType<float> zFar;
+    BEType<float> fovYRadiansOrAngle;
+    BEType<float> fovySin;
+    BEType<float> fovyCos;
+    BEType<float> fovyTan;
+    BEType<float> aspect;
+    BEVec2 offset;
+};
+#pragma pack(pop)
+
+struct data_VRProjectionMatrixOut {
+    BEType<float> aspectRatio;
+    BEType<float> fovY;
+    BEType<float> offsetX;
+    BEType<float> offsetY;
+};
+
+enum VPADButtons : uint32_t {
+    VPAD_BUTTON_NONE = 0,
+    VPAD_BUTTON_A = 0x8000,
+    VPAD_BUTTON_B = 0x4000,
+    VPAD_BUTTON_X = 0x2000,
+    VPAD_BUTTON_Y = 0x1000,
+    VPAD_BUTTON_LEFT = 0x0800,
+    VPAD_BUTTON_RIGHT = 0x0400,
+    VPAD_BUTTON_UP = 0x0200,
+    VPAD_BUTTON_DOWN = 0x0100,
+    VPAD_BUTTON_ZL = 0x0080,
+    VPAD_BUTTON_ZR = 0x0040,
+    VPAD_BUTTON_L = 0x0020,
+    VPAD_BUTTON_R = 0x0010,
+    VPAD_BUTTON_PLUS = 0x0008,
+    VPAD_BUTTON_MINUS = 0x0004,
+    VPAD_BUTTON_HOME = 0x0002,
+    VPAD_BUTTON_SYNC = 0x0001,
+    VPAD_BUTTON_STICK_R = 0x00020000,
+    VPAD_BUTTON_STICK_L = 0x00040000,
+    VPAD_BUTTON_TV = 0x00010000,
+    VPAD_STICK_R_EMULATION_LEFT = 0x04000000,
+    VPAD_STICK_R_EMULATION_RIGHT = 0x02000000,
+    VPAD_STICK_R_EMULATION_UP = 0x01000000,
+    VPAD_STICK_R_EMULATION_DOWN = 0x00800000,
+    VPAD_STICK_L_EMULATION_LEFT = 0x40000000,
+    VPAD_STICK_L_EMULATION_RIGHT = 0x20000000,
+    VPAD_STICK_L_EMULATION_UP = 0x10000000,
+    VPAD_STICK_L_EMULATION_DOWN = 0x08000000,
+};
+ENABLE_BITMASK_OPERATORS(VPADButtons);
+
+enum WeaponType : uint32_t {
+    SmallSword = 0x0,
+    LargeSword = 0x1,
+    Spear = 0x2,
+    Bow = 0x3,
+    Shield = 0x4,
+    UnknownWeapon = 0x5,
+};
+
+enum class RumbleType {
+    Fixed,
+    Raising,
+    Falling,
+    OscillationSmooth,
+    OscillationFallingSawtoothWave,
+    OscillationRaisingSawtoothWave
+};
+
+struct RumbleParameters {
+    bool prioritizeThisRumble = false;
+    int hand = 0;
+    RumbleType rumbleType = RumbleType::Fixed;
+    float oscillationFrequency = 0.0f;
+    bool keepRumblingOnEffectEnd = false; // requires stopInputsRumble() to manually stop the rumble
+    double effectDuration = 0;
+    float frequency = 0.0f;
+    float amplitude = 0.0f;
+};
+
+enum class EventMode : int32_t {
+    NO_EVENT = 0,
+    ALWAYS_FIRST_PERSON = 1,
+    FOLLOW_DEFAULT_EVENT_SETTINGS = 2,
+    ALWAYS_THIRD_PERSON = 3,
+};
+
+enum class CameraMode : int32_t {
+    THIRD_PERSON = 0,
+    FIRST_PERSON = 1,
+};
+
+enum class PlayMode : int32_t {
+    SEATED = 0,
+    STANDING = 1,
+};
+
+enum class GazeFollowUISetting : int32_t {
+    FIXED = 0,
+    FOLLOW_LOOKING_DIRECTION = 1,
+};
+
+enum class AngularVelocityFixerMode : int32_t {
+    AUTO = 0, // Angular velocity fixer is automatically enabled for Oculus Link
+    FORCED_ON = 1,
+    FORCED_OFF = 2,
+};
+
+// Every setting that's saved to BetterVR_settings.ini as (field, type, ini key, default value).
+// Parsing and saving are generated from this list, so adding a setting only needs a new entry here.
+#define BETTERVR_SETTINGS(X) \
+    /* playing mode settings */ \
+    X(cameraMode, CameraMode, "CameraMode", CameraMode::FIRST_PERSON) \
+    X(playMode, PlayMode, "PlayMode", PlayMode::STANDING) \
+    X(thirdPlayerDistance, float, "ThirdPlayerDistance", 0.5f) \
+    X(cutsceneCameraMode, EventMode, "CutsceneCameraMode", EventMode::FOLLOW_DEFAULT_EVENT_SETTINGS) \
+    X(useBlackBarsForCutscenes, bool, "UseBlackBarsForCutscenes", false) \
+    /* first-person settings */ \
+    X(playerHeightOffset, float, "PlayerHeightOffset", 0.0f) \
+    X(leftHanded, bool, "LeftHanded", false) \
+    X(uiFollowsGaze, bool, "UiFollowsGaze", true) \
+    X(cropFlatTo16x9, bool, "CropFlatTo16x9", true) \
+    /* advanced settings */ \
+    X(enableDebugOverlay, bool, "EnableDebugOverlay", false) \
+    X(buggyAngularVelocity, AngularVelocityFixerMode, "BuggyAngularVelocity", AngularVelocityFixerMode::AUTO) \
+    X(performanceOverlay, uint32_t, "PerformanceOverlay", 0) \
+    X(performanceOverlayFrequency, uint32_t, "PerformanceOverlayFrequency", 90) \
+    X(tutorialPromptShown, bool, "TutorialPromptShown", false)
+
+// An immutable snapshot of the settings. GetSettings() returns the latest one with a single atomic load, so hooks that read several settings
+// should grab it once and keep using it for the rest of their call. UpdateSettings() publishes a modified copy as a new version.
+struct ModSettings {
+#define BETTERVR_SETTING_FIELD(name, type, key, defaultValue) type name = defaultValue;
+    BETTERVR_SETTINGS(BETTERVR_SETTING_FIELD)
+#undef BETTERVR_SETTING_FIELD
+
+    uint64_t version = 0;
+
+    CameraMode GetCameraMode() const { return cameraMode; }
+
+    PlayMode GetPlayMode() const { return playMode; }
+    bool DoesUIFollowGaze() const { return uiFollowsGaze; }
+    bool IsLeftHanded() const { return leftHanded; }
+    float GetPlayerHeightOffset() const {
+        // disable height offset in third-person mode
+        if (GetCameraMode() == CameraMode::THIRD_PERSON) {
+            return 0.0f;
+        }
+
+        return playerHeightOffset;
+    }
+    EventMode GetCutsceneCameraMode() const {
+        // if in third-person mode, always use third-person cutscene camera
+        if (GetCameraMode() == CameraMode::THIRD_PERSON) {
+            return EventMode::ALWAYS_THIRD_PERSON;
+        }
+        return cutsceneCameraMode;
+    }
+    bool UseBlackBarsForCutscenes() const { return useBlackBarsForCutscenes; }
+    bool ShouldFlatPreviewBeCroppedTo16x9() const { return cropFlatTo16x9; }
+    
+    bool ShowDebugOverlay() const { return enableDebugOverlay; }
+    AngularVelocityFixerMode AngularVelocityFixer_GetMode() const { return buggyAngularVelocity; }
+
+    // By default BotW's camera uses 0.1f for near plane and 25000.0f for far plane, except maybe some indoor areas? But for simplicity, we'll use the default values everywhere.
+    float GetZNear() const { return 0.1f; }
+    float GetZFar() const { return 25000.0f; }
+
+    std::string ToString() const {
+        std::string buffer = "";
+        std::format_to(std::back_inserter(buffer), " - Camera Mode: {}\n", GetCameraMode() == CameraMode::FIRST_PERSON ? "First Person" : "Third Person");
+        std::format_to(std::back_inserter(buffer), " - Left Handed: {}\n", IsLeftHanded() ? "Yes" : "No");
+        std::format_to(std::back_inserter(buffer), " - GUI Follow Setting: {}\n", DoesUIFollowGaze() ? "Follow Looking Direction" : "Fixed");
+        std::format_to(std::back_inserter(buffer), " - Player Height: {} meters\n", GetPlayerHeightOffset());
+        std::format_to(std::back_inserter(buffer), " - Crop Flat to 16:9: {}\n", ShouldFlatPreviewBeCroppedTo16x9() ? "Yes" : "No");
+        std::format_to(std::back_inserter(buffer), " - Debug Overlay: {}\n", ShowDebugOverlay() ? "Enabled" : "Disabled");
+        std::format_to(std::back_inserter(buffer), " - Cutscene Camera Mode: {}\n", GetCutsceneCameraMode() == EventMode::ALWAYS_FIRST_PERSON ? "Always First Person" : (GetCutsceneCameraMode() == EventMode::ALWAYS_THIRD_PERSON ? "Always Third Person" : "Follow Default Event Settings"));
+        std::format_to(std::back_inserter(buffer), " - Show Black Bars for Third-Person Cutscenes: {}\n", UseBlackBarsForCutscenes() ? "Yes" : "No");
+        std::format_to(std::back_inserter(buffer), " - Performance Overlay: {}\n", performanceOverlay == 0 ? "Disabled" : (performanceOverlay == 1 ? "2D Only" : "Enabled"));
+        std::format_to(std::back_inserter(buffer), " - Performance Overlay Frequency: {} Hz\n", performanceOverlayFrequency);
+        return buffer;
+    }
+
+};
+
+// The returned snapshot stays alive for as long as it's held, but it won't pick up newer settings, so don't keep it across frames
+extern std::shared_ptr<const ModSettings> GetSettings();
+extern void UpdateSettings(const std::function<void(ModSettings&)>& update);
+extern void InitSettings();
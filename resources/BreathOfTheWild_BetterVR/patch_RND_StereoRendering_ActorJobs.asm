@@ -511,6 +511,7 @@ addi r4, r4, strActor_job0_1@l
 lis r5, currentEyeSide@ha
 lwz r5, currentEyeSide@l(r5)
 bl import.coreinit.hook_RouteActorJob
+stw r3, 0x0C(r1)
 
 cmpwi r3, 0
 beq job0_1_normal
@@ -518,6 +519,8 @@ cmpwi r3, 1
 beq finish_hook_actor_job0_1
 cmpwi r3, 2
 beq job0_1_altered
+cmpwi r3, 3
+beq job0_1_normal
 
 job0_1_normal:
 lis r4, real_actor_job0_1@ha
@@ -525,6 +528,12 @@ addi r4, r4, real_actor_job0_1@l
 mtctr r4
 lwz r3, 0x1C(r1)
 bctrl ; ba real_actor_job0_1
+
+; only while profiling the actor jobs
+lwz r3, 0x0C(r1)
+cmpwi r3, 3
+bne finish_hook_actor_job0_1
+bl import.coreinit.hook_RouteActorJobEnd
 b finish_hook_actor_job0_1
 
 job0_1_altered:
@@ -606,6 +615,7 @@ addi r4, r4, strActor_job0_2@l
 lis r5, currentEyeSide@ha
 lwz r5, currentEyeSide@l(r5)
 bl import.coreinit.hook_RouteActorJob
+stw r3, 0x0C(r1)
 
 cmpwi r3, 1
 beq finish_hook_actor_job0_2
@@ -616,6 +626,12 @@ mtctr r3
 lwz r3, 0x1C(r1)
 bctrl ; ba real_actor_job0_2
 
+; only while profiling the actor jobs
+lwz r3, 0x0C(r1)
+cmpwi r3, 3
+bne finish_hook_actor_job0_2
+bl import.coreinit.hook_RouteActorJobEnd
+
 finish_hook_actor_job0_2:
 lwz r6, 0x10(r1)
 lwz r5, 0x14(r1)
@@ -649,6 +665,7 @@ addi r4, r4, strActor_job1_1@l
 lis r5, currentEyeSide@ha
 lwz r5, currentEyeSide@l(r5)
 bl import.coreinit.hook_RouteActorJob
+stw r3, 0x0C(r1)
 
 cmpwi r3, 1
 beq finish_hook_actor_job1_1
@@ -659,6 +676,12 @@ mtctr r3
 lwz r3, 0x1C(r1)
 bctrl ; ba real_actor_job1_1
 
+; only while profiling the actor jobs
+lwz r3, 0x0C(r1)
+cmpwi r3, 3
+bne finish_hook_actor_job1_1
+bl import.coreinit.hook_RouteActorJobEnd
+
 finish_hook_actor_job1_1:
 lwz r6, 0x10(r1)
 lwz r5, 0x14(r1)
@@ -695,6 +718,7 @@ addi r4, r4, strActor_job1_2@l
 lis r5, currentEyeSide@ha
 lwz r5, currentEyeSide@l(r5)
 bl import.coreinit.hook_RouteActorJob
+stw r3, 0x0C(r1)
 
 cmpwi r3, 1
 beq finish_hook_actor_job1_2
@@ -705,6 +729,12 @@ mtctr r3
 lwz r3, 0x1C(r1)
 bctrl ; ba real_actor_job1_2
 
+; only while profiling the actor jobs
+lwz r3, 0x0C(r1)
+cmpwi r3, 3
+bne finish_hook_actor_job1_2
+bl import.coreinit.hook_RouteActorJobEnd
+
 finish_hook_actor_job1_2:
 lwz r6, 0x10(r1)
 lwz r5, 0x14(r1)
@@ -740,6 +770,7 @@ addi r4, r4, strActor_job2_1@l
 lis r5, currentEyeSide@ha
 lwz r5, currentEyeSide@l(r5)
 bl import.coreinit.hook_RouteActorJob
+stw r3, 0x0C(r1)
 
 cmpwi r3, 1
 beq finish_hook_actor_job2_1
@@ -750,6 +781,12 @@ mtctr r3
 lwz r3, 0x1C(r1)
 bctrl ; ba real_actor_job2_1_ragdoll_related
 
+; only while profiling the actor jobs
+lwz r3, 0x0C(r1)
+cmpwi r3, 3
+bne finish_hook_actor_job2_1
+bl import.coreinit.hook_RouteActorJobEnd
+
 finish_hook_actor_job2_1:
 lwz r6, 0x10(r1)
 lwz r5, 0x14(r1)
@@ -785,6 +822,7 @@ addi r4, r4, strActor_job2_2@l
 lis r5, currentEyeSide@ha
 lwz r5, currentEyeSide@l(r5)
 bl import.coreinit.hook_RouteActorJob
+stw r3, 0x0C(r1)
 
 cmpwi r3, 1
 beq finish_hook_actor_job2_2
@@ -795,6 +833,12 @@ mtctr r3
 lwz r3, 0x1C(r1)
 bctrl ; ba real_actor_job2_2
 
+; only while profiling the actor jobs
+lwz r3, 0x0C(r1)
+cmpwi r3, 3
+bne finish_hook_actor_job2_2
+bl import.coreinit.hook_RouteActorJobEnd
+
 finish_hook_actor_job2_2:
 lwz r6, 0x10(r1)
 lwz r5, 0x14(r1)
@@ -830,6 +874,7 @@ addi r4, r4, strActor_job4@l
 lis r5, currentEyeSide@ha
 lwz r5, currentEyeSide@l(r5)
 bl import.coreinit.hook_RouteActorJob
+stw r3, 0x0C(r1)
 
 cmpwi r3, 1
 beq finish_hook_actor_job4
@@ -840,6 +885,12 @@ mtctr r3
 lwz r3, 0x1C(r1)
 bctrl ; ba real_actor_job4
 
+; only while profiling the actor jobs
+lwz r3, 0x0C(r1)
+cmpwi r3, 3
+bne finish_hook_actor_job4
+bl import.coreinit.hook_RouteActorJobEnd
+
 finish_hook_actor_job4:
 lwz r6, 0x10(r1)
 lwz r5, 0x14(r1)
@@ -0,0 +1,174 @@
+#pragma once
+#include "pch.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+
+// The game runs every actor job once per eye, so hook_RouteActorJob decides for each eye whether the hooks in patch_RND_StereoRendering_ActorJobs.asm
+// run a job, skip it or take an altered path. The values are what the hooks compare r3 against.
+enum class JobRoute : uint32_t {
+    Run = 0,
+    Skip = 1,
+    Altered = 2,
+    RunAndMeasure = 3, // runs the job and calls hook_RouteActorJobEnd afterwards, only used while profiling
+};
+
+struct ActorJobRule {
+    std::string actorName; // empty matches every actor
+    std::string jobName;
+    std::array<JobRoute, 2> routes; // left, right
+};
+
+// Which eye each actor job runs on. Jobs without a rule run on both eyes. The defaults can be overridden with BetterVR_actor_jobs.txt next to Cemu's executable:
+//   # actor job left right
+//   GameROMPlayer job0_1 altered run
+//   * job4 run skip
+// Rules from the file are checked before the defaults and the first matching rule wins. The report written by ActorJobProfiler uses the same format.
+class ActorJobRules {
+public:
+    static JobRoute Get(std::string_view actorName, std::string_view jobName, uint32_t side) {
+        if (const ActorJobRule* rule = Find(actorName, jobName)) {
+            return rule->routes[side & 1];
+        }
+        return JobRoute::Run;
+    }
+
+    static const ActorJobRule* Find(std::string_view actorName, std::string_view jobName) {
+        std::call_once(s_loaded, Load);
+        auto rule = std::ranges::find_if(s_rules, [&](const ActorJobRule& rule) {
+            return rule.jobName == jobName && (rule.actorName.empty() || rule.actorName == actorName);
+        });
+        return rule != s_rules.end() ? &*rule : nullptr;
+    }
+
+    static std::optional<JobRoute> ParseRoute(std::string_view name) {
+        if (name == "run") return JobRoute::Run;
+        if (name == "skip") return JobRoute::Skip;
+        if (name == "altered") return JobRoute::Altered;
+        return std::nullopt;
+    }
+
+private:
+    static void Load();
+
+    static inline std::once_flag s_loaded;
+    // the player only runs the climbing portion of job0_1 on the left eye so that later jobs on the left side can use the state it sets,
+    // every other job only needs to run for one of the eyes
+    static inline std::vector<ActorJobRule> s_rules = {
+        { "GameROMPlayer", "job0_1", { JobRoute::Altered, JobRoute::Run } },
+        { "GameROMPlayer", "job0_2", { JobRoute::Run, JobRoute::Skip } },
+        { "GameROMPlayer", "job1_1", { JobRoute::Run, JobRoute::Skip } },
+        { "GameROMPlayer", "job1_2", { JobRoute::Run, JobRoute::Skip } },
+        { "GameROMPlayer", "job2_1_ragdoll_related", { JobRoute::Run, JobRoute::Skip } },
+        { "GameROMPlayer", "job2_2", { JobRoute::Run, JobRoute::Skip } },
+        { "GameROMPlayer", "job4", { JobRoute::Run, JobRoute::Skip } },
+        { "", "job0_1", { JobRoute::Skip, JobRoute::Run } },
+        { "", "job0_2", { JobRoute::Run, JobRoute::Skip } },
+        { "", "job1_1", { JobRoute::Run, JobRoute::Skip } },
+        { "", "job1_2", { JobRoute::Run, JobRoute::Skip } },
+        { "", "job2_1_ragdoll_related", { JobRoute::Run, JobRoute::Skip } },
+        { "", "job2_2", { JobRoute::Run, JobRoute::Skip } },
+        { "", "job4", { JobRoute::Run, JobRoute::Skip } },
+    };
+};
+
+// Opt-in profiling mode that runs every job that isn't altered on both eyes and measures each run.
+// Actor jobs run on several guest cores at once, so the run that's being measured is kept per guest thread.
+// A run is measured by the time until hook_RouteActorJobEnd and by comparing the actor's memory before and after the job.
+// If the right eye's run never changes anything after the left eye's run, running the job once per frame gives the same result.
+class ActorJobProfiler {
+public:
+    // Covers the actor and the fields that the larger actor classes like the player have after it
+    static constexpr uint32_t SNAPSHOT_SIZE = 0x2000;
+    // Runs to measure on each eye before a job can be recommended to only run once
+    static constexpr uint32_t MIN_RUNS = 60;
+
+    // The context is the guest thread that runs the job, since a guest thread can get preempted by another one that runs jobs on the same core
+    void Begin(const void* context, std::string_view actorName, std::string_view jobName, uint32_t side, const uint8_t* actorMemory) {
+        std::scoped_lock lock(m_mutex);
+        Measurement& current = m_current[context];
+        current.key = std::format("{} {}", actorName, jobName);
+        current.side = side & 1;
+        current.actorMemory = actorMemory;
+        memcpy(current.snapshot.data(), actorMemory, SNAPSHOT_SIZE);
+        current.start = std::chrono::steady_clock::now();
+    }
+
+    void End(const void* context) {
+        const auto end = std::chrono::steady_clock::now();
+        std::scoped_lock lock(m_mutex);
+        auto it = m_current.find(context);
+        if (it == m_current.end() || it->second.actorMemory == nullptr) {
+            return;
+        }
+        Measurement& current = it->second;
+        const bool changed = memcmp(current.snapshot.data(), current.actorMemory, SNAPSHOT_SIZE) != 0;
+        current.actorMemory = nullptr;
+
+        EyeStats& eye = m_stats[current.key].eyes[current.side];
+        eye.runs++;
+        eye.changedRuns += changed ? 1 : 0;
+        eye.time += end - current.start;
+    }
+
+    // Writes every measured job sorted by the time spent in it, together with the rules that would let the redundant runs be skipped
+    void WriteReport(const std::filesystem::path& filePath) {
+        std::scoped_lock lock(m_mutex);
+        std::vector<std::pair<std::string, JobStats>> jobs(m_stats.begin(), m_stats.end());
+        std::ranges::sort(jobs, std::greater{}, [](const auto& job) { return job.second.eyes[0].time + job.second.eyes[1].time; });
+
+        std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            Log::print<WARNING>("Failed to write the actor job report to {}", filePath.string());
+            return;
+        }
+        file << "# BetterVR actor job report, copy the rules below into BetterVR_actor_jobs.txt to use them\n";
+        file << "# actor job left right\n";
+
+        uint32_t onceCount = 0;
+        for (const auto& [key, stats] : jobs) {
+            const EyeStats& left = stats.eyes[0];
+            const EyeStats& right = stats.eyes[1];
+            const bool enoughRuns = left.runs >= MIN_RUNS && right.runs >= MIN_RUNS;
+            const bool once = enoughRuns && right.changedRuns == 0;
+            file << std::format("# {}: left {} runs {:.1f} us avg {} changed, right {} runs {:.1f} us avg {} changed{}\n", key,
+                left.runs, left.AverageMicroseconds(), left.changedRuns, right.runs, right.AverageMicroseconds(), right.changedRuns,
+                !enoughRuns ? ", not enough runs" : once ? ", safe to run once" : ", changes the actor on both eyes");
+            if (once) {
+                file << key << " run skip\n";
+                onceCount++;
+            }
+        }
+        Log::print<INFO>("Wrote the actor job report for {} jobs to {}, {} of them are safe to run once per frame", jobs.size(), filePath.string(), onceCount);
+    }
+
+private:
+    struct EyeStats {
+        uint64_t runs = 0;
+        uint64_t changedRuns = 0;
+        std::chrono::steady_clock::duration time = {};
+
+        double AverageMicroseconds() const {
+            return runs == 0 ? 0.0 : std::chrono::duration<double, std::micro>(time).count() / (double)runs;
+        }
+    };
+
+    struct JobStats {
+        std::array<EyeStats, 2> eyes;
+    };
+
+    struct Measurement {
+        std::string key;
+        uint32_t side = 0;
+        const uint8_t* actorMemory = nullptr;
+        std::chrono::steady_clock::time_point start;
+        std::array<uint8_t, SNAPSHOT_SIZE> snapshot;
+    };
+
+    std::mutex m_mutex;
+    std::unordered_map<const void*, Measurement> m_current;
+    std::unordered_map<std::string, JobStats> m_stats;
+};
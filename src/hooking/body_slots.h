@@ -0,0 +1,112 @@
+#pragma once
+#include "pch.h"
+
+
+// Body-relative volumes that the hands reach into to grab things from the shoulders and waist, whistle at the mouth or raise the shield.
+// Every slot is just a set of limits on where a hand is relative to the headset, so adding a slot only needs a new entry in SLOTS.
+// Both hands are evaluated against every slot in one pass of plain comparisons, which results in a bitmask of the slots that each hand is in.
+namespace BodySlots {
+    enum class Slot : uint8_t {
+        LeftShoulder,
+        RightShoulder,
+        LeftWaist,
+        RightWaist,
+        Mouth,
+        Chest,
+        Behind, // anywhere behind the body, grabs there are never meant for the world
+        Count
+    };
+
+    using SlotMask = uint32_t;
+    constexpr SlotMask Bit(Slot slot) { return 1u << (uint32_t)slot; }
+
+    enum class Side : uint8_t {
+        Any,
+        Left,
+        Right
+    };
+
+    constexpr float NO_LIMIT = std::numeric_limits<float>::infinity();
+
+    // Where a hand is relative to the headset
+    struct HandOffset {
+        float forward;    // along the view direction flattened onto the floor
+        float right;      // along the headset's right vector
+        float height;     // above the headset
+        float distanceSq; // from the headset
+    };
+
+    // Forward is checked as [minForward, maxForward) and height as (minHeight, maxHeight) so that behind/in front and above/below splits don't overlap
+    struct SlotVolume {
+        Slot slot;
+        float minForward = -NO_LIMIT;
+        float maxForward = NO_LIMIT;
+        float minHeight = -NO_LIMIT;
+        float maxHeight = NO_LIMIT;
+        float maxDistanceSq = NO_LIMIT;
+        Side side = Side::Any;
+
+        constexpr bool Contains(const HandOffset& hand) const {
+            const bool onSide = side == Side::Any || (side == Side::Left) == (hand.right < 0.0f);
+            return (hand.forward >= minForward) & (hand.forward < maxForward) & (hand.height > minHeight) & (hand.height < maxHeight) & (hand.distanceSq < maxDistanceSq) & onSide;
+        }
+    };
+
+    constexpr float SHOULDER_RADIUS = 0.35f;
+    constexpr float MOUTH_RADIUS = 0.2f;
+    constexpr float WAIST_BEHIND_OFFSET = 0.05f; // the waist slots reach a bit further forward than the shoulders
+    constexpr float WAIST_HEIGHT = -0.45f;
+    constexpr float CHEST_HEIGHT = -0.3f;
+
+    constexpr std::array SLOTS = {
+        SlotVolume{ .slot = Slot::LeftShoulder, .maxForward = 0.0f, .maxDistanceSq = SHOULDER_RADIUS * SHOULDER_RADIUS, .side = Side::Left },
+        SlotVolume{ .slot = Slot::RightShoulder, .maxForward = 0.0f, .maxDistanceSq = SHOULDER_RADIUS * SHOULDER_RADIUS, .side = Side::Right },
+        SlotVolume{ .slot = Slot::LeftWaist, .maxForward = WAIST_BEHIND_OFFSET, .maxHeight = WAIST_HEIGHT, .side = Side::Left },
+        SlotVolume{ .slot = Slot::RightWaist, .maxForward = WAIST_BEHIND_OFFSET, .maxHeight = WAIST_HEIGHT, .side = Side::Right },
+        SlotVolume{ .slot = Slot::Mouth, .minForward = 0.0f, .maxDistanceSq = MOUTH_RADIUS * MOUTH_RADIUS },
+        SlotVolume{ .slot = Slot::Chest, .minHeight = CHEST_HEIGHT },
+        SlotVolume{ .slot = Slot::Behind, .maxForward = WAIST_BEHIND_OFFSET },
+    };
+
+    constexpr bool HasEverySlotOnce() {
+        SlotMask seen = 0;
+        for (const SlotVolume& volume : SLOTS) {
+            if ((seen & Bit(volume.slot)) != 0) return false;
+            seen |= Bit(volume.slot);
+        }
+        return seen == Bit(Slot::Count) - 1;
+    }
+    static_assert(HasEverySlotOnce(), "Every slot needs exactly one volume");
+
+    // A hand that's in front of the body and away from the mouth isn't reaching for any slot
+    constexpr SlotMask REACHING_SLOTS = Bit(Slot::Behind) | Bit(Slot::Mouth);
+
+    struct HeadsetFrame {
+        glm::fvec3 position;
+        glm::fvec3 forward; // flattened onto the floor
+        glm::fvec3 right;
+    };
+
+    inline HeadsetFrame GetHeadsetFrame(const glm::fmat4& headsetMtx) {
+        glm::fvec3 forward = -glm::normalize(glm::fvec3(headsetMtx[2]));
+        forward.y = 0.0f;
+        return { glm::fvec3(headsetMtx[3]), glm::normalize(forward), glm::normalize(glm::fvec3(headsetMtx[0])) };
+    }
+
+    // Evaluates every slot for both hands and returns the slots that each hand is in
+    inline std::array<SlotMask, 2> Evaluate(const HeadsetFrame& headset, const std::array<glm::fvec3, 2>& handPositions) {
+        std::array<HandOffset, 2> hands = {};
+        for (size_t hand = 0; hand < 2; hand++) {
+            const glm::fvec3 headToHand = handPositions[hand] - headset.position;
+            hands[hand] = { glm::dot(headset.forward, headToHand), glm::dot(headset.right, headToHand), headToHand.y, glm::length2(headToHand) };
+        }
+
+        std::array<SlotMask, 2> masks = {};
+        for (const SlotVolume& volume : SLOTS) {
+            for (size_t hand = 0; hand < 2; hand++) {
+                masks[hand] |= (SlotMask)volume.Contains(hands[hand]) << (uint32_t)volume.slot;
+            }
+        }
+        return masks;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "pch.h"
+
+
+// Turns whether a button is down every frame into short and long presses. Used by the OpenXR actions and the real gamepad's start button.
+struct ButtonState {
+    enum class Event {
+        None,
+        ShortPress,
+        LongPress,
+        //DoublePress
+    };
+
+    bool wasDownLastFrame = false;
+    bool longFired = false;
+    bool waitingForSecond = false;
+    bool longFired_actedUpon = false;
+    bool longFired_stillPressed = false;
+    std::chrono::steady_clock::time_point pressStartTime;
+    std::chrono::steady_clock::time_point lastReleaseTime;
+
+    Event lastEvent = Event::None;
+
+    void resetFrameFlags() { lastEvent = Event::None; }
+    void resetButtonState() {
+        wasDownLastFrame = false;
+        longFired = false;
+        waitingForSecond = false;
+    }
+
+    // The time is passed in so that every button of a sync sees the same time and scripted inputs can be replayed
+    void Update(bool down, std::chrono::steady_clock::time_point now, std::chrono::milliseconds longPressThreshold = std::chrono::milliseconds(250)) {
+        resetFrameFlags();
+
+        // Rising edge - button just pressed
+        if (down && !wasDownLastFrame) {
+            pressStartTime = now;
+        }
+
+        // Pressed state - check for long press threshold
+        if (down) {
+            if (now - pressStartTime >= longPressThreshold) {
+                lastEvent = Event::LongPress;
+                longFired = true;
+                if (!longFired_stillPressed) {
+                    longFired_stillPressed = true;
+                    longFired_actedUpon = true;
+                }
+            }
+        }
+        else {
+            longFired_stillPressed = false;
+            longFired_actedUpon = false;
+        }
+
+        // Falling edge - button just released
+        if (!down && wasDownLastFrame) {
+            // Only register short press if long press didn't fire
+            if (!longFired) {
+                lastEvent = Event::ShortPress;
+            }
+            else
+                longFired = false; // reset long press fired flag
+        }
+
+        // Store current state for next frame
+        wasDownLastFrame = down;
+    }
+};
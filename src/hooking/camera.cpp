@@ -1,6 +1,8 @@
 #include "cemu_hooks.h"
 #include "instance.h"
 #include "rendering/openxr.h"
+#include "hooking/projection_cache.h"
+#include "utils/stereo_frustum.h"
 
 bool CemuHooks::UseMonoFrameBufferTemporarilyDuringMenusOrPictures() {
     return IsScreenOpen(ScreenId::PauseMenuInfo_00) || VRManager::instance().XR->GetRenderer()->IsGameCapturing3DFrameBuffer();
@@ -65,7 +67,7 @@ void CemuHooks::hook_UpdateCameraForGameplay(PPCInterpreter_t* hCPU) {
 
     Log::print<RENDERING>("[{}] Getting gameplay camera (pos = {})", side, oldCameraPosition);
 
-    if (GetSettings().GetCameraMode() == CameraMode::FIRST_PERSON) {
+    if (GetSettings()->GetCameraMode() == CameraMode::FIRST_PERSON) {
         // remove verticality from the camera position to avoid pitch changes that aren't from the VR headset
         oldCameraPosition.y = oldCameraTarget.y;
     }
@@ -134,7 +136,7 @@ void CemuHooks::hook_UpdateCameraForGameplay(PPCInterpreter_t* hCPU) {
             playerPos.y += 1.73f - playerHeight;
         }
         else {
-            playerPos.y += GetSettings().GetPlayerHeightOffset() - actualCrouchOffset;
+            playerPos.y += GetSettings()->GetPlayerHeightOffset() - actualCrouchOffset;
         }
 
 
@@ -230,10 +232,10 @@ void CemuHooks::hook_GetRenderCamera(PPCInterpreter_t* hCPU) {
             playerPos.y -= hardcodedRidingOffset;
         }
         else if (s_isSwimming) {
-            playerPos.y += hardcodedSwimOffset + GetSettings().GetPlayerHeightOffset();
+            playerPos.y += hardcodedSwimOffset + GetSettings()->GetPlayerHeightOffset();
         }
         else {
-            playerPos.y += GetSettings().GetPlayerHeightOffset() - actualCrouchOffset;
+            playerPos.y += GetSettings()->GetPlayerHeightOffset() - actualCrouchOffset;
         }
 
         basePos = playerPos;
@@ -287,49 +289,8 @@ constexpr uint32_t seadOrthoProjection = 0x1027B5BC;
 constexpr uint32_t seadPerspectiveProjection = 0x1027B54C;
 
 
-// https://github.com/KhronosGroup/OpenXR-SDK/blob/858912260ca616f4c23f7fb61c89228c353eb124/src/common/xr_linear.h#L564C1-L632C2
-// https://github.com/aboood40091/sead/blob/45b629fb032d88b828600a1b787729f2d398f19d/engine/library/modules/src/gfx/seadProjection.cpp#L166
-
-static data_VRProjectionMatrixOut calculateFOVAndOffset(XrFovf viewFOV) {
-    float totalHorizontalFov = viewFOV.angleRight - viewFOV.angleLeft;
-    float totalVerticalFov = viewFOV.angleUp - viewFOV.angleDown;
-
-    float aspectRatio = totalHorizontalFov / totalVerticalFov;
-    float fovY = totalVerticalFov;
-    float projectionCenter_offsetX = (viewFOV.angleRight + viewFOV.angleLeft) / 2.0f;
-    float projectionCenter_offsetY = (viewFOV.angleUp + viewFOV.angleDown) / 2.0f;
-
-    data_VRProjectionMatrixOut ret = {};
-    ret.aspectRatio = aspectRatio;
-    ret.fovY = fovY;
-    ret.offsetX = projectionCenter_offsetX;
-    ret.offsetY = projectionCenter_offsetY;
-
-    return ret;
-}
-
-static glm::mat4 calculateProjectionMatrix(float nearZ, float farZ, const XrFovf& fov) {
-    float l = tanf(fov.angleLeft) * nearZ;
-    float r = tanf(fov.angleRight) * nearZ;
-    float b = tanf(fov.angleDown) * nearZ;
-    float t = tanf(fov.angleUp) * nearZ;
-
-    float invW = 1.0f / (r - l);
-    float invH = 1.0f / (t - b);
-    float invD = 1.0f / (farZ - nearZ);
-
-    glm::mat4 dst = {};
-    dst[0][0] = 2.0f * nearZ * invW;
-    dst[1][1] = 2.0f * nearZ * invH;
-    dst[0][2] = (r + l) * invW;
-    dst[1][2] = (t + b) * invH;
-    dst[2][2] = -(farZ + nearZ) * invD;
-    dst[2][3] = -(2.0f * farZ * nearZ) * invD;
-    dst[3][2] = -1.0f;
-    dst[3][3] = 0.0f;
-
-    return dst;
-}
+// Cemu calls the projection hooks from its CPU threads, so every thread keeps its own cache
+static thread_local ProjectionCache s_projectionCache;
 
 void CemuHooks::hook_GetRenderProjection(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
@@ -356,42 +317,14 @@ void CemuHooks::hook_GetRenderProjection(PPCInterpreter_t* hCPU) {
         return;
     }
 
-    perspectiveProjection.zFar = GetSettings().GetZFar();
-    perspectiveProjection.zNear = GetSettings().GetZNear();
+    perspectiveProjection.zFar = GetSettings()->GetZFar();
+    perspectiveProjection.zNear = GetSettings()->GetZNear();
 
     if (!VRManager::instance().XR->GetRenderer()->GetFOV(side).has_value()) {
         return;
     }
     XrFovf currFOV = VRManager::instance().XR->GetRenderer()->GetFOV(side).value();
-    auto newProjection = calculateFOVAndOffset(currFOV);
-
-    perspectiveProjection.aspect = newProjection.aspectRatio;
-    perspectiveProjection.fovYRadiansOrAngle = newProjection.fovY;
-    float halfAngle = newProjection.fovY.getLE() * 0.5f;
-    perspectiveProjection.fovySin = sinf(halfAngle);
-    perspectiveProjection.fovyCos = cosf(halfAngle);
-    perspectiveProjection.fovyTan = tanf(halfAngle);
-    perspectiveProjection.offset.x = newProjection.offsetX;
-    perspectiveProjection.offset.y = newProjection.offsetY;
-
-    glm::fmat4 newMatrix = calculateProjectionMatrix(perspectiveProjection.zNear.getLE(), perspectiveProjection.zFar.getLE(), currFOV);
-    perspectiveProjection.matrix = newMatrix;
-
-    // calculate device matrix
-    glm::fmat4 newDeviceMatrix = newMatrix;
-
-    float zScale = perspectiveProjection.deviceZScale.getLE();
-    float zOffset = perspectiveProjection.deviceZOffset.getLE();
-
-    newDeviceMatrix[2][0] *= zScale;
-    newDeviceMatrix[2][1] *= zScale;
-    newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * zOffset) * zScale;
-    newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * zScale + newDeviceMatrix[3][3] * zOffset;
-
-    perspectiveProjection.deviceMatrix = newDeviceMatrix;
-
-    perspectiveProjection.dirty = false;
-    perspectiveProjection.deviceDirty = false;
+    s_projectionCache.Apply(side, perspectiveProjection, currFOV);
 
     writeMemory(projectionOut, &perspectiveProjection);
     hCPU->gpr[3] = projectionOut;
@@ -427,35 +360,7 @@ void CemuHooks::hook_ModifyLightPrePassProjectionMatrix(PPCInterpreter_t* hCPU)
 
 
     XrFovf currFOV = VRManager::instance().XR->GetRenderer()->GetFOV(side).value();
-    auto newProjection = calculateFOVAndOffset(currFOV);
-
-    perspectiveProjection.aspect = newProjection.aspectRatio;
-    perspectiveProjection.fovYRadiansOrAngle = newProjection.fovY;
-    float halfAngle = newProjection.fovY.getLE() * 0.5f;
-    perspectiveProjection.fovySin = sinf(halfAngle);
-    perspectiveProjection.fovyCos = cosf(halfAngle);
-    perspectiveProjection.fovyTan = tanf(halfAngle);
-    perspectiveProjection.offset.x = newProjection.offsetX;
-    perspectiveProjection.offset.y = newProjection.offsetY;
-
-    glm::fmat4 newMatrix = calculateProjectionMatrix(perspectiveProjection.zNear.getLE(), perspectiveProjection.zFar.getLE(), currFOV);
-    perspectiveProjection.matrix = newMatrix;
-
-    // calculate device matrix
-    glm::fmat4 newDeviceMatrix = newMatrix;
-
-    float zScale = perspectiveProjection.deviceZScale.getLE();
-    float zOffset = perspectiveProjection.deviceZOffset.getLE();
-
-    newDeviceMatrix[2][0] *= zScale;
-    newDeviceMatrix[2][1] *= zScale;
-    newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * zOffset) * zScale;
-    newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * zScale + newDeviceMatrix[3][3] * zOffset;
-
-    perspectiveProjection.deviceMatrix = newDeviceMatrix;
-
-    perspectiveProjection.dirty = false;
-    perspectiveProjection.deviceDirty = false;
+    s_projectionCache.Apply(side, perspectiveProjection, currFOV);
 
     writeMemory(projectionIn, &perspectiveProjection);
 }
@@ -555,49 +460,15 @@ void CemuHooks::hook_ModifyProjectionUsingCamera(PPCInterpreter_t* hCPU) {
     Log::print<RENDERING>("[{}] ModifyProjectionUsingCamera: {}", side, perspectiveProjection);
 
     XrFovf currFOV = VRManager::instance().XR->GetRenderer()->GetFOV(side).value();
-    auto newProjection = calculateFOVAndOffset(currFOV);
-
-    perspectiveProjection.aspect = newProjection.aspectRatio;
-    perspectiveProjection.fovYRadiansOrAngle = newProjection.fovY;
-    float halfAngle = newProjection.fovY.getLE() * 0.5f;
-    perspectiveProjection.fovySin = sinf(halfAngle);
-    perspectiveProjection.fovyCos = cosf(halfAngle);
-    perspectiveProjection.fovyTan = tanf(halfAngle);
-    perspectiveProjection.offset.x = newProjection.offsetX;
-    perspectiveProjection.offset.y = newProjection.offsetY;
-
-    glm::fmat4 newMatrix = calculateProjectionMatrix(perspectiveProjection.zNear.getLE(), perspectiveProjection.zFar.getLE(), currFOV);
-    perspectiveProjection.matrix = newMatrix;
-
-    // calculate device matrix
-    glm::fmat4 newDeviceMatrix = newMatrix;
-
-    float zScale = perspectiveProjection.deviceZScale.getLE();
-    float zOffset = perspectiveProjection.deviceZOffset.getLE();
-
-    newDeviceMatrix[2][0] *= zScale;
-    newDeviceMatrix[2][1] *= zScale;
-    newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * zOffset) * zScale;
-    newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * zScale + newDeviceMatrix[3][3] * zOffset;
-
-    perspectiveProjection.deviceMatrix = newDeviceMatrix;
-
-    perspectiveProjection.dirty = false;
-    perspectiveProjection.deviceDirty = false;
+    s_projectionCache.Apply(side, perspectiveProjection, currFOV);
 
     writeMemory(projectionPtr, &perspectiveProjection);
 }
 
-std::pair<glm::vec3, glm::fquat> CemuHooks::CalculateVRWorldPose(const BESeadLookAtCamera& camera, uint8_t side) {
-    // in-game camera
-    glm::mat4x3 viewMatrix = camera.mtx.getLEMatrix();
-    glm::mat4 worldGame = glm::inverse(glm::mat4(viewMatrix));
-    glm::vec3 basePos = glm::vec3(worldGame[3]);
-    glm::quat baseRot = glm::quat_cast(worldGame);
-
-    // overwrite with our stored camera pos/rot
-    basePos = s_wsCameraPosition;
-    baseRot = s_wsCameraRotation;
+CemuHooks::VRBasePose CemuHooks::CalculateVRBasePose() {
+    // our stored camera pos/rot
+    glm::vec3 basePos = s_wsCameraPosition;
+    glm::quat baseRot = s_wsCameraRotation;
 
     auto [swing, baseYaw] = swingTwistY(baseRot);
     if (IsFirstPerson()) {
@@ -613,7 +484,7 @@ std::pair<glm::vec3, glm::fquat> CemuHooks::CalculateVRWorldPose(const BESeadLoo
             playerPos.y += hardcodedSwimOffset;
         }
         else {
-            playerPos.y += GetSettings().GetPlayerHeightOffset() - actualCrouchOffset;
+            playerPos.y += GetSettings()->GetPlayerHeightOffset() - actualCrouchOffset;
         }
 
         basePos = playerPos;
@@ -625,22 +496,79 @@ std::pair<glm::vec3, glm::fquat> CemuHooks::CalculateVRWorldPose(const BESeadLoo
             }
         }
     }
+    return { basePos, baseRot, baseYaw };
+}
 
+std::pair<glm::vec3, glm::fquat> CemuHooks::CalculateVRWorldPose(const VRBasePose& base, uint8_t side) {
     // vr camera
     std::optional<XrPosef> currPoseOpt = VRManager::instance().XR->GetRenderer()->GetPose((OpenXR::EyeSide)side);
     if (!currPoseOpt.has_value()) {
-        return { basePos, baseRot };
+        return { base.position, base.rotation };
     }
 
     glm::fvec3 eyePos = ToGLM(currPoseOpt.value().position);
     glm::fquat eyeRot = ToGLM(currPoseOpt.value().orientation);
 
-    glm::vec3 newPos = basePos + (baseYaw * eyePos);
-    glm::fquat newRot = baseYaw * eyeRot;
+    glm::vec3 newPos = base.position + (base.yaw * eyePos);
+    glm::fquat newRot = base.yaw * eyeRot;
 
     return { newPos, newRot };
 }
 
+// The game checks the visibility of a lot of objects per frame against just a few cameras, so the combined frustum of both eyes
+// is kept for each camera until anything that goes into it changes. The base pose covers everything that moves the eyes in first-person,
+// like Link's position, riding, swimming, crouching and the height offset. Each guest core checks visibility on its own, so each keeps its own frusta.
+struct VisibilityFrustum {
+    uint32_t cameraPtr = 0;
+    float nearClip = 0.0f;
+    float farClip = 0.0f;
+    CemuHooks::VRBasePose basePose = {};
+    std::array<XrPosef, 2> poses = {};
+    std::array<XrFovf, 2> fovs = {};
+    StereoFrustum frustum;
+
+    bool Matches(uint32_t ptr, float nearZ, float farZ, const CemuHooks::VRBasePose& base, const std::array<XrView, 2>& views) const {
+        return cameraPtr == ptr && nearClip == nearZ && farClip == farZ && basePose == base &&
+               memcmp(&poses[0], &views[0].pose, sizeof(XrPosef)) == 0 && memcmp(&poses[1], &views[1].pose, sizeof(XrPosef)) == 0 &&
+               memcmp(&fovs[0], &views[0].fov, sizeof(XrFovf)) == 0 && memcmp(&fovs[1], &views[1].fov, sizeof(XrFovf)) == 0;
+    }
+};
+static thread_local std::array<VisibilityFrustum, 4> s_visibilityFrustums = {};
+static thread_local uint32_t s_nextVisibilityFrustum = 0;
+
+VisibilityFrustum* CemuHooks::GetVisibilityFrustum(uint32_t camPtr, float nearClip, float farClip) {
+    std::optional<std::array<XrView, 2>> views = VRManager::instance().XR->GetRenderer()->GetPoses();
+    if (!views.has_value()) {
+        return nullptr;
+    }
+
+    const VRBasePose base = CalculateVRBasePose();
+    auto cached = std::ranges::find_if(s_visibilityFrustums, [&](const VisibilityFrustum& entry) { return entry.Matches(camPtr, nearClip, farClip, base, views.value()); });
+    if (cached == s_visibilityFrustums.end()) {
+        cached = s_visibilityFrustums.begin() + s_nextVisibilityFrustum;
+        s_nextVisibilityFrustum = (s_nextVisibilityFrustum + 1) % s_visibilityFrustums.size();
+
+        std::array<StereoFrustum::Eye, 2> eyes = {};
+        for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+            auto [pos, rot] = CalculateVRWorldPose(base, side);
+
+            // pull the camera backwards a bit to account for it being a third-person game that encompassed a bigger area
+            pos += rot * glm::vec3(0.0f, 0.0f, 1.0f);
+
+            eyes[side] = { pos, rot, views.value()[side].fov };
+            cached->poses[side] = views.value()[side].pose;
+            cached->fovs[side] = views.value()[side].fov;
+        }
+        cached->frustum.Build(eyes, nearClip, farClip);
+        cached->cameraPtr = camPtr;
+        cached->nearClip = nearClip;
+        cached->farClip = farClip;
+        cached->basePose = base;
+    }
+
+    return &*cached;
+}
+
 void CemuHooks::hook_CheckIfCameraCanSeePos(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
@@ -655,44 +583,16 @@ void CemuHooks::hook_CheckIfCameraCanSeePos(PPCInterpreter_t* hCPU) {
     float nearClip = hCPU->fpr[2].fp0;
     float farClip = hCPU->fpr[3].fp0;
 
-    BESeadLookAtCamera camera = {};
-    readMemory(camPtr, &camera);
-
-    //uint32_t mainProjectionPtr = hCPU->gpr[5];
-    //BESeadPerspectiveProjection mainProjection = {};
-    //readMemory(mainProjectionPtr, &mainProjection);
-    //uint32_t altProjectionPtr = hCPU->gpr[6];
-    //BESeadPerspectiveProjection altProjection = {};
-    //readMemory(altProjectionPtr, &altProjection);
-
-    //Log::print<INFO>("Main Projection{}: {}", hCPU->gpr[0] == 0 ? " yes " : " no ", mainProjection);
-    //Log::print<INFO>("Alt Projection{}: {}", hCPU->gpr[0] == 1 ? " yes " : " no ", altProjection);
+    VisibilityFrustum* frustum = GetVisibilityFrustum(camPtr, nearClip, farClip);
+    if (frustum == nullptr) {
+        hCPU->gpr[3] = 0;
+        return;
+    }
 
     BEVec3 center;
     readMemory(posPtr, &center);
 
-    Frustum frustum;
-    bool visible = false;
-
-    for (int i = 0; i < 2; ++i) {
-        OpenXR::EyeSide side = (i == 0) ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
-        if (auto fovOpt = VRManager::instance().XR->GetRenderer()->GetFOV(side)) {
-            auto [pos, rot] = CalculateVRWorldPose(camera, side);
-
-            // pull the camera backwards a bit to account for it being a third-person game that encompassed a bigger area
-            pos += rot * glm::vec3(0.0f, 0.0f, 1.0f);
-
-            glm::mat4 view = glm::inverse(glm::translate(glm::mat4(1.0f), pos) * glm::mat4_cast(rot));
-            glm::mat4 proj = glm::transpose(calculateProjectionMatrix(nearClip, farClip, fovOpt.value()));
-            glm::mat4 vp = proj * view;
-
-            frustum.update(vp);
-            if (frustum.checkSphere(center.getLE(), radius)) {
-                visible = true;
-                break;
-            }
-        }
-    }
+    bool visible = frustum->frustum.CheckSphere(center.getLE(), radius);
 
     Log::print<PPC>("Checking visibility of {} (rad = {}, near = {}, far = {}): {}", center, radius, nearClip, farClip, visible ? "visible" : "invisible");
 
@@ -757,7 +657,7 @@ void CemuHooks::hook_UseCameraDistance(PPCInterpreter_t* hCPU) {
         hCPU->fpr[13].fp0 = 0.0f;
     }
     else {
-        hCPU->fpr[13].fp0 = GetSettings().thirdPlayerDistance;
+        hCPU->fpr[13].fp0 = GetSettings()->thirdPlayerDistance;
     }
 }
 
@@ -787,81 +687,81 @@ void CemuHooks::hook_CalculateModelOpacity(PPCInterpreter_t* hCPU) {
     }
 }
 
-std::string CemuHooks::s_currentEvent = {};
-CemuHooks::HybridEventSettings CemuHooks::s_currentEventSettings = {};
-std::unordered_map<std::string, CemuHooks::HybridEventSettings> CemuHooks::s_eventSettings = {};
+EventTable CemuHooks::s_events;
+std::atomic<CemuHooks::ResolvedEvent> CemuHooks::s_resolvedEvent = CemuHooks::ResolvedEvent{};
+static std::atomic<EventTable::EventId> s_currentEvent = EventTable::NO_EVENT; // only written by hook_GetEventName
+static uint64_t s_untrackedEventHash = 0; // active event that didn't fit in the event table anymore
 
-constexpr CemuHooks::HybridEventSettings defaultFirstPersonSettings = {
+constexpr HybridEventSettings defaultFirstPersonSettings = {
     .firstPerson = true,
     .disablePlayerDrivenLinkHands = false,
     .ignoreCameraRotation = true
 };
 
 void CemuHooks::initCutsceneDefaultSettings(uint32_t ppc_TableOfCutsceneEventsSettingsOffset) {
-    if (!s_eventSettings.empty()) {
+    static bool s_initialized = false;
+    if (s_initialized) {
         return;
     }
+    s_initialized = true;
 
-    char* currPtr = reinterpret_cast<char*>(s_memoryBaseAddress + ppc_TableOfCutsceneEventsSettingsOffset);
+    const char* currPtr = reinterpret_cast<const char*>(s_memoryBaseAddress + ppc_TableOfCutsceneEventsSettingsOffset);
     while (true) {
-        const std::string line(currPtr);
+        const std::string_view line(currPtr);
         if (line.empty()) {
             break;
         }
         size_t commaPos = line.find(',');
-        if (commaPos != std::string::npos) {
+        if (commaPos != std::string_view::npos) {
             HybridEventSettings entry = {};
-            std::string settingsStr = line.substr(commaPos + 1);
-            std::string eventName = line.substr(0, commaPos);
-            size_t pos = 0;
-            while ((pos = settingsStr.find(',')) != std::string::npos) {
-                std::string setting = settingsStr.substr(0, pos);
-                if (setting == "FP_ON") entry.firstPerson = true;
-                else if (setting == "FP_OFF")
-                    entry.firstPerson = false;
-                else if (setting == "HND_ON")
-                    entry.disablePlayerDrivenLinkHands = false;
-                else if (setting == "HND_OFF")
-                    entry.disablePlayerDrivenLinkHands = true;
-                else if (setting == "PAN_ON")
-                    entry.ignoreCameraRotation = false;
-                else if (setting == "PAN_OFF")
-                    entry.ignoreCameraRotation = true;
-                else if (setting == "CTRL_ON")
-                    entry.demoEnableCameraInput = false;
-                else if (setting == "CTRL_OFF")
-                    entry.demoEnableCameraInput = true;
-                else {
-                    Log::print<WARNING>("Unknown cutscene default setting: {}", setting);
-                }
-                settingsStr.erase(0, pos + 1);
-            }
-            // last setting
-            std::string setting = settingsStr;
-            if (setting == "FP_ON") entry.firstPerson = true;
-            else if (setting == "FP_OFF")
-                entry.firstPerson = false;
-            else if (setting == "HND_ON")
-                entry.disablePlayerDrivenLinkHands = false;
-            else if (setting == "HND_OFF")
-                entry.disablePlayerDrivenLinkHands = true;
-            else if (setting == "PAN_ON")
-                entry.ignoreCameraRotation = false;
-            else if (setting == "PAN_OFF")
-                entry.ignoreCameraRotation = true;
-            else if (setting == "CTRL_ON")
-                entry.demoEnableCameraInput = false;
-            else if (setting == "CTRL_OFF")
-                entry.demoEnableCameraInput = true;
-            else {
-                Log::print<WARNING>("Unknown cutscene default setting: {}", setting);
-            }
-            s_eventSettings.insert_or_assign(eventName, entry);
+            EventTable::ParseSettings(line.substr(commaPos + 1), entry);
+            s_events.Add(line.substr(0, commaPos), entry);
         }
         currPtr += line.length() + 1;
     }
 
-    Log::print<VERBOSE>("Initialized cutscene default settings for {} events.", s_eventSettings.size());
+    Log::print<VERBOSE>("Initialized cutscene default settings for {} events.", s_events.Size());
+    s_events.LoadOverrides(GetEventOverridesPath(), defaultFirstPersonSettings);
+}
+
+CemuHooks::ResolvedEvent CemuHooks::ResolveEvent(EventTable::EventId event, const ModSettings& settings) {
+    ResolvedEvent resolved = {};
+    resolved.event = event;
+    const EventMode mode = GetEventModeWithOverride(event, settings);
+    if (mode != EventMode::NO_EVENT && mode != EventMode::ALWAYS_THIRD_PERSON) {
+        // cutscene with first-person settings, unless the event itself wants third-person
+        resolved.hasSettings = true;
+        resolved.settings = s_events.GetOverride(event).value_or(s_events.GetDefaults(event));
+        resolved.firstPerson = mode != EventMode::FOLLOW_DEFAULT_EVENT_SETTINGS || resolved.settings.firstPerson;
+    }
+    else {
+        // no event. Check if gameplay is in first-person mode
+        resolved.firstPerson = settings.GetCameraMode() == CameraMode::FIRST_PERSON;
+    }
+    return resolved;
+}
+
+// Called by hook_GetEventName when the event changes and by hook_UpdateSettings every frame, which can run on different cores.
+// Whoever stores last has to have resolved the latest event, so a resolve that raced with an event change gets redone.
+void CemuHooks::ResolveActiveEvent() {
+    EventTable::EventId event = s_currentEvent.load();
+    while (true) {
+        s_resolvedEvent.store(ResolveEvent(event, *GetSettings()));
+        const EventTable::EventId latest = s_currentEvent.load();
+        if (latest == event) {
+            break;
+        }
+        event = latest;
+    }
+}
+
+void CemuHooks::SetEventOverride(EventTable::EventId event, const std::optional<HybridEventSettings>& settings) {
+    if (event == EventTable::NO_EVENT) {
+        return;
+    }
+    s_events.SetOverride(event, settings);
+    s_events.SaveOverrides(GetEventOverridesPath());
+    Log::print<INFO>("Cutscene override for event '{}' is now {}", s_events.GetName(event), settings.has_value() ? EventTable::FormatSettings(*settings) : "removed");
 }
 
 
@@ -876,35 +776,43 @@ void CemuHooks::hook_GetEventName(PPCInterpreter_t* hCPU) {
     uint32_t entryPointNamePtr = hCPU->gpr[5];
 
     if (isEventActive) {
-        std::string eventName = std::string((char*)s_memoryBaseAddress + eventNamePtr);
-        std::string entryPointName = std::string((char*)s_memoryBaseAddress + entryPointNamePtr);
-
-        if (s_currentEvent == eventName) {
+        const std::string_view eventName((const char*)s_memoryBaseAddress + eventNamePtr);
+        EventTable::EventId event = s_events.Find(eventName);
+        if (event != EventTable::NO_EVENT && s_currentEvent.load(std::memory_order_relaxed) == event) {
             return;
         }
+        if (event == EventTable::NO_EVENT && s_untrackedEventHash == EventTable::Hash(eventName)) {
+            return;
+        }
+        const std::string_view entryPointName((const char*)s_memoryBaseAddress + entryPointNamePtr);
         Log::print<INFO>("Event '{}' is now active (using entry point '{}').", eventName, entryPointName);
-        s_currentEvent = eventName;
 
-        auto it = s_eventSettings.find(eventName);
-        if (it != s_eventSettings.end()) {
-            HybridEventSettings settings = it->second;
+        if (event != EventTable::NO_EVENT) {
+            const HybridEventSettings settings = s_events.GetOverride(event).value_or(s_events.GetDefaults(event));
             Log::print<INFO>(" - First Person: {}", settings.firstPerson ? "ON" : "OFF");
             Log::print<INFO>(" - Ignore Camera Rotation: {}", settings.ignoreCameraRotation ? "ON" : "OFF");
             Log::print<INFO>(" - Disable Player-Driven Link Hands: {}", settings.disablePlayerDrivenLinkHands ? "ON" : "OFF");
-            s_currentEventSettings = settings;
+            if (s_events.GetOverride(event).has_value()) {
+                Log::print<INFO>(" - Using the user's override for this event");
+            }
         }
         else {
             Log::print<INFO>(" - No specific settings found for this event, using defaults.");
-            s_currentEventSettings = defaultFirstPersonSettings;
+            event = s_events.Add(eventName, defaultFirstPersonSettings);
         }
+        s_untrackedEventHash = event == EventTable::NO_EVENT ? EventTable::Hash(eventName) : 0;
+        s_currentEvent.store(event);
+        ResolveActiveEvent();
 
         // In cutscene's there's somethings a mention of Demo_EnableCameraInput/Demo_EnableCameraControlByUser/Demo_DisableCameraInput
         // These don't actually seem to be hooked up so won't do anything in real-time, but they do flag a cutscene as having camera control disabled for the player.
         // This can be read using the settings.demoEnableCameraInput in the HybridEventSettings struct.
     }
-    else if (!s_currentEvent.empty()) {
-        Log::print<INFO>("Event '{}' has now ended", s_currentEvent);
-        s_currentEvent = "";
+    else if (const EventTable::EventId event = s_currentEvent.load(std::memory_order_relaxed); event != EventTable::NO_EVENT || s_untrackedEventHash != 0) {
+        Log::print<INFO>("Event '{}' has now ended", s_events.GetName(event));
+        s_untrackedEventHash = 0;
+        s_currentEvent.store(EventTable::NO_EVENT);
+        ResolveActiveEvent();
     }
 }
 
@@ -926,7 +834,7 @@ void CemuHooks::hook_OverwriteCameraParam(PPCInterpreter_t* hCPU) {
 
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
-    if (GetSettings().GetCameraMode() == CameraMode::THIRD_PERSON) {
+    if (GetSettings()->GetCameraMode() == CameraMode::THIRD_PERSON) {
         uint32_t superLowAddress = 0x102B3150; // points to 0.0000011920929
         writeMemoryBE(hCPU->gpr[4], &superLowAddress);
         return;
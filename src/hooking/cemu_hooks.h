@@ -1,6 +1,8 @@
 #pragma once
 #include "entity_debugger.h"
+#include "event_table.h"
 
+struct VisibilityFrustum;
 
 class CemuHooks {
 public:
@@ -38,6 +40,7 @@ public:
         osLib_registerHLEFunction("coreinit", "hook_GetRenderProjection", &hook_GetRenderProjection);
         osLib_registerHLEFunction("coreinit", "hook_EndCameraSide", &hook_EndCameraSide);
         osLib_registerHLEFunction("coreinit", "hook_RouteActorJob", &hook_RouteActorJob);
+        osLib_registerHLEFunction("coreinit", "hook_RouteActorJobEnd", &hook_RouteActorJobEnd);
 
         osLib_registerHLEFunction("coreinit", "hook_UseCameraDistance", &hook_UseCameraDistance);
         osLib_registerHLEFunction("coreinit", "hook_ReplaceCameraMode", &hook_ReplaceCameraMode);
@@ -91,14 +94,6 @@ public:
     static glm::fvec3 s_playerPos;
     static glm::mat4 s_lastCameraMtx;
 
-    // If the user is unable to control the camera, we can guess that they're in a cutscene
-    struct HybridEventSettings {
-        bool firstPerson;                  // use Link's perspective, ignore the animated event camera
-        bool disablePlayerDrivenLinkHands; // let event control the hands instead of the VR controllers
-        bool ignoreCameraRotation;         // some events will pan the camera, but in first-person it should usually be ignored to avoid nausea. Doors opening is okay, but panning down to a chest is not.
-        bool demoEnableCameraInput;        // there's already events that allow user camera control. This isn't used or overwritten atm.
-    };
-
     static uint32_t GetFramesSinceLastCameraUpdate() { return s_framesSinceLastCameraUpdate.load(); }
     static bool IsInGame() {
         // todo: check if 3 frames is the right threshold
@@ -109,68 +104,59 @@ public:
     }
     static bool UseMonoFrameBufferTemporarilyDuringMenusOrPictures();
 
-    static std::string s_currentEvent;
-    static HybridEventSettings s_currentEventSettings;
-    static std::unordered_map<std::string, HybridEventSettings> s_eventSettings;
+    static EventTable s_events;
     static void initCutsceneDefaultSettings(uint32_t ppc_TableOfCutsceneEventsSettingsOffset);
 
+    // Everything the hooks need to know about the active event, resolved once per frame and whenever the event changes
+    // so that the camera and bone hooks only have to do a single load
+    struct alignas(8) ResolvedEvent {
+        EventTable::EventId event;
+        bool hasSettings;          // whether the event's settings apply, they don't when there's no event or it's forced to third-person
+        bool firstPerson;
+        HybridEventSettings settings;
+    };
+    static std::atomic<ResolvedEvent> s_resolvedEvent;
+    static ResolvedEvent ResolveEvent(EventTable::EventId event, const ModSettings& settings);
+    static void ResolveActiveEvent();
+
+    // Changes how one event plays until the override is removed again, and saves it for the next time the game starts
+    static void SetEventOverride(EventTable::EventId event, const std::optional<HybridEventSettings>& settings);
+    static std::filesystem::path GetEventOverridesPath();
+
     static bool HasActiveCutscene() {
-        return !s_currentEvent.empty();
+        return s_resolvedEvent.load(std::memory_order_relaxed).event != EventTable::NO_EVENT;
     }
 
-    static EventMode GetEventModeWithOverride() {
-        if (!HasActiveCutscene()) {
+    static EventMode GetEventModeWithOverride(EventTable::EventId event, const ModSettings& settings) {
+        if (event == EventTable::NO_EVENT) {
             return EventMode::NO_EVENT;
         }
 
-        EventMode mode = GetSettings().GetCutsceneCameraMode();
-        // todo: check if user has overriden the cutscene mode during active cutscenes
+        // the user's choice for this specific event wins over the cutscene mode
+        if (s_events.GetOverride(event).has_value()) {
+            return EventMode::FOLLOW_DEFAULT_EVENT_SETTINGS;
+        }
+        EventMode mode = settings.GetCutsceneCameraMode();
 
         // if the camera is controllable, treat it as no event
         // todo: Apparently this is a bad way to check it.
         if (IsInGame()) {
-            //Log::print<VERBOSE>("Camera is controllable during cutscene '{}' due to frames since last camera update being {}. Treating as no event.", s_currentEvent, GetFramesSinceLastCameraUpdate());
+            //Log::print<VERBOSE>("Camera is controllable during cutscene '{}' due to frames since last camera update being {}. Treating as no event.", s_events.GetName(event), GetFramesSinceLastCameraUpdate());
             //return EventMode::NO_EVENT;
         }
         return mode;
     }
 
     static std::optional<HybridEventSettings> GetFirstPersonSettingsForActiveEvent() {
-        auto mode = GetEventModeWithOverride();
-
-        if (mode == EventMode::NO_EVENT) {
-            return std::nullopt;
-        }
-        if (mode == EventMode::ALWAYS_THIRD_PERSON) {
+        const ResolvedEvent resolved = s_resolvedEvent.load(std::memory_order_relaxed);
+        if (!resolved.hasSettings) {
             return std::nullopt;
         }
-        // resolve settings if in hybrid mode
-        if (mode == EventMode::FOLLOW_DEFAULT_EVENT_SETTINGS) {
-            //if (!s_currentEventSettings.firstPerson) {
-            //    return std::nullopt;
-            //}
-        }
-
-        return s_currentEventSettings;
+        return resolved.settings;
     }
 
     static bool IsFirstPerson() {
-        if (auto settings = GetFirstPersonSettingsForActiveEvent(); settings.has_value()) {
-            // there's an active event
-            auto mode = GetEventModeWithOverride();
-            if (mode == EventMode::FOLLOW_DEFAULT_EVENT_SETTINGS && !settings->firstPerson) {
-                return false;
-            }
-            // cutscene with first-person settings
-            return true;
-        }
-        else {
-            // no event. Check if gameplay is in first-person mode
-            if (GetSettings().GetCameraMode() == CameraMode::FIRST_PERSON) {
-                return true;
-            }
-            return false;
-        }
+        return s_resolvedEvent.load(std::memory_order_relaxed).firstPerson;
     }
 
     static bool IsThirdPerson() {
@@ -178,11 +164,12 @@ public:
     }
 
     static bool UseBlackBarsDuringEvents() {
-        if (!HasActiveCutscene() || IsFirstPerson()) {
+        const ResolvedEvent resolved = s_resolvedEvent.load(std::memory_order_relaxed);
+        if (resolved.event == EventTable::NO_EVENT || resolved.firstPerson) {
             return false;
         }
 
-        return GetSettings().UseBlackBarsForCutscenes();
+        return GetSettings()->UseBlackBarsForCutscenes();
     }
     static bool IsScreenOpen(ScreenId screen);
 
@@ -199,7 +186,17 @@ private:
 
     static void InitWindowHandles();
 
-    static std::pair<glm::vec3, glm::fquat> CalculateVRWorldPose(const BESeadLookAtCamera& camera, uint8_t side);
+    // where the headset's tracking space is placed in the world, which is all that the eye poses depend on besides the headset itself
+    struct VRBasePose {
+        glm::fvec3 position;
+        glm::fquat rotation;
+        glm::fquat yaw;
+
+        bool operator==(const VRBasePose&) const = default;
+    };
+    static VRBasePose CalculateVRBasePose();
+    static std::pair<glm::vec3, glm::fquat> CalculateVRWorldPose(const VRBasePose& base, uint8_t side);
+    static VisibilityFrustum* GetVisibilityFrustum(uint32_t camPtr, float nearClip, float farClip);
 
     static void hook_UpdateSettings(PPCInterpreter_t* hCPU);
 
@@ -218,6 +215,7 @@ private:
     static void hook_GetRenderProjection(PPCInterpreter_t* hCPU);
     static void hook_EndCameraSide(PPCInterpreter_t* hCPU);
     static void hook_RouteActorJob(PPCInterpreter_t* hCPU);
+    static void hook_RouteActorJobEnd(PPCInterpreter_t* hCPU);
 
     static void hook_UseCameraDistance(PPCInterpreter_t* hCPU);
     static void hook_ReplaceCameraMode(PPCInterpreter_t* hCPU);
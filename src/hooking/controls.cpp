@@ -1,9 +1,10 @@
 #include "cemu_hooks.h"
 #include "../instance.h"
 #include "openxr_motion_bridge.h"
+#include "body_slots.h"
+#include "input_mapping.h"
 
-constexpr float AXIS_THRESHOLD = 0.5f;
-constexpr float HOLD_THRESHOLD = 0.1f;
+using InputMapping::AXIS_THRESHOLD;
 
 Direction getJoystickDirection(const XrVector2f& stick)
 {
@@ -17,18 +18,41 @@ Direction getJoystickDirection(const XrVector2f& stick)
 
 
 struct HandGestureState {
-    bool isBehindHead;
-    bool isBehindHeadWithWaistOffset;
-    bool isCloseToHead;
-    bool isCloseToMouth;
-    bool isCloseToWaist;
-    bool isNearChestHeight;
-    bool isOnLeftSide;  // true = left side of body, false = right side
-    bool isFarEnoughFromStoredPosition;
+    BodySlots::SlotMask slots;
     float magnesisForwardAmount;
     float magnesisVerticalAmount;
+
+    bool IsOver(BodySlots::Slot slot) const { return (slots & BodySlots::Bit(slot)) != 0; }
+    bool IsOverShoulder() const { return IsOver(BodySlots::Slot::LeftShoulder) || IsOver(BodySlots::Slot::RightShoulder); }
+    bool IsNotOverAnySlot() const { return (slots & BodySlots::REACHING_SLOTS) == 0; }
+};
+
+// What grabbing from a slot equips, in order of priority. Both hands can grab from every slot.
+struct SlotEquipBinding {
+    BodySlots::Slot slot;
+    EquipType equip;
+    VPADButtons button;
+    bool equipsLeftHand; // whether the item ends up in the left or the right hand
 };
 
+constexpr std::array SLOT_EQUIP_BINDINGS = {
+    SlotEquipBinding{ BodySlots::Slot::LeftShoulder, EquipType::Bow, VPAD_BUTTON_ZR, true },
+    SlotEquipBinding{ BodySlots::Slot::RightShoulder, EquipType::Melee, VPAD_BUTTON_Y, false },
+    SlotEquipBinding{ BodySlots::Slot::LeftWaist, EquipType::SheikahSlate, VPAD_BUTTON_L, true },
+};
+
+// Dropping the left hand's item from the right waist slot is broken right now, it makes the game think that the right hand is empty too
+constexpr std::array DROP_FROM_RIGHT_WAIST_SLOT = { false, true };
+
+const SlotEquipBinding* getSlotEquipBinding(BodySlots::SlotMask slots) {
+    for (const SlotEquipBinding& binding : SLOT_EQUIP_BINDINGS) {
+        if ((slots & BodySlots::Bit(binding.slot)) != 0) {
+            return &binding;
+        }
+    }
+    return nullptr;
+}
+
 int GetMagnesisForwardFrameInterval(float v)
 {
     if (v <= 0.0f)    return 0;
@@ -38,132 +62,51 @@ int GetMagnesisForwardFrameInterval(float v)
     return 1;
 }
 
-// Gesture detection functions
-HandGestureState calculateHandGesture(
+// Magnesis moves the object by how far the hand moved from where it was when the grip was pressed
+void calculateMagnesisGesture(
     OpenXR::GameState& gameState,
+    HandGestureState& gesture,
     const glm::fvec3& handPos,
-    const glm::fmat4& headsetMatrix,
-    const glm::fvec3& headsetPos,
-    const bool ProcessStoredPositionDistanceCheck,
+    const glm::fvec3& headsetForward,
     const glm::fvec3& storedHandPos
 ) {
-    HandGestureState gesture = {};
-    
-    // Calculate directional vectors
-    glm::fvec3 headsetForward = -glm::normalize(glm::fvec3(headsetMatrix[2]));
-    headsetForward.y = 0.0f;
-    headsetForward = glm::normalize(headsetForward);
-    
-    glm::fvec3 headsetRight = glm::normalize(glm::fvec3(headsetMatrix[0]));
-    glm::fvec3 headToHand = handPos - headsetPos;
-    
-    // Check if hand is behind head (for shoulder slots)
-    float forwardDot = glm::dot(headsetForward, headToHand);
-    gesture.isBehindHead = (forwardDot < 0.0f);
-    
-    // Check if hand is behind head (for waist slot) - uses flattened vectors
-    glm::vec3 flatForward = glm::normalize(glm::vec3(headsetForward.x, 0.0f, headsetForward.z));
-    glm::vec3 flatHandOffset = glm::vec3(headToHand.x, 0.0f, headToHand.z);
-    
-    constexpr float WAIST_BEHIND_OFFSET = -0.05f; //0.15f
-    float flatForwardDot = glm::dot(flatForward, flatHandOffset) + WAIST_BEHIND_OFFSET;
-    gesture.isBehindHeadWithWaistOffset = (flatForwardDot < 0.0f);
-    
-    // Check which side of body the hand is on
-    float rightDot = glm::dot(headsetRight, headToHand);
-    gesture.isOnLeftSide = (rightDot < 0.0f);
-    
-    // Check distance from head (for shoulder slots)
-    constexpr float SHOULDER_RADIUS = 0.35f;
-    constexpr float SHOULDER_RADIUS_SQ = SHOULDER_RADIUS * SHOULDER_RADIUS;
-    gesture.isCloseToHead = (glm::length2(headToHand) < SHOULDER_RADIUS_SQ);
-
-    // Check distance from head (for mouth slot)
-    constexpr float MOUTH_RADIUS = 0.2f;
-    constexpr float MOUTH_RADIUS_SQ = MOUTH_RADIUS * MOUTH_RADIUS;
-    gesture.isCloseToMouth = (glm::length2(headToHand) < MOUTH_RADIUS_SQ);
-    
-    // Check distance from waist (rough estimate)
-    glm::fvec3 waistPos = headsetPos - glm::fvec3(0.0f, 0.45f, 0.0f);
-    gesture.isCloseToWaist = (handPos.y < waistPos.y);
-
-    // Check hand height for shield (rough estimate)
-    glm::fvec3 chestPos = headsetPos - glm::fvec3(0.0f, 0.3f, 0.0f);
-    gesture.isNearChestHeight = (handPos.y > chestPos.y);
-
-    // Check distance from stored position
-    if (ProcessStoredPositionDistanceCheck) {
-        constexpr float DISTANCE_THRESHOLD = 0.015f;
-        constexpr float MAX_HAND_DISTANCE = 0.075f;
-        auto delta = handPos - storedHandPos;
-        auto distance = glm::length(delta);
-        gesture.isFarEnoughFromStoredPosition = distance > DISTANCE_THRESHOLD;
-
-        // Process magnesis gesture
-        if (!gesture.isFarEnoughFromStoredPosition) {
-            gesture.magnesisForwardAmount = gesture.magnesisVerticalAmount = 0.0f;
-        }
-        else {
-            const glm::vec3 headsetUp(0.0f, 1.0f, 0.0f);
-            auto forwardAmount = glm::dot(delta, headsetForward);
-            auto verticalAmount = glm::dot(delta, headsetUp);
-
-            auto remapSigned = [&](float value) {
-                float sign = glm::sign(value);
-                float absValue = glm::abs(value);
-
-                float t = (absValue - DISTANCE_THRESHOLD) /
-                          (MAX_HAND_DISTANCE - DISTANCE_THRESHOLD);
-
-                t = glm::clamp(t, 0.0f, 1.0f);
-                return t * sign;
-            };
-
-            gesture.magnesisForwardAmount = remapSigned(forwardAmount);
-            gesture.magnesisVerticalAmount = remapSigned(verticalAmount);
-            //Log::print<INFO>("magnesisForwardAmount frames skip : {}", gameState.magnesis_forward_frames_interval);
-            if (gameState.magnesis_forward_frames_interval > 0) {
-                gesture.magnesisForwardAmount = 0.0f;
-            }
-            else if (gameState.magnesis_forward_frames_interval <= -1)
-            {
-                gameState.magnesis_forward_frames_interval = GetMagnesisForwardFrameInterval(glm::abs(gesture.magnesisForwardAmount));
-            }
-            
-            gameState.magnesis_forward_frames_interval--;
-            //Log::print<INFO>("gesture.magnesisForwardAmount  : {}", gesture.magnesisForwardAmount);
-        }
+    constexpr float DISTANCE_THRESHOLD = 0.015f;
+    constexpr float MAX_HAND_DISTANCE = 0.075f;
+    auto delta = handPos - storedHandPos;
+    auto distance = glm::length(delta);
+    if (distance <= DISTANCE_THRESHOLD) {
+        gesture.magnesisForwardAmount = gesture.magnesisVerticalAmount = 0.0f;
+        return;
     }
 
-    return gesture;
-}
+    const glm::vec3 headsetUp(0.0f, 1.0f, 0.0f);
+    auto forwardAmount = glm::dot(delta, headsetForward);
+    auto verticalAmount = glm::dot(delta, headsetUp);
 
-bool isHandOverLeftShoulderSlot(const HandGestureState& gesture) {
-    return gesture.isBehindHead && gesture.isCloseToHead && gesture.isOnLeftSide;
-}
+    auto remapSigned = [&](float value) {
+        float sign = glm::sign(value);
+        float absValue = glm::abs(value);
 
-bool isHandOverRightShoulderSlot(const HandGestureState& gesture) {
-    return gesture.isBehindHead && gesture.isCloseToHead && !gesture.isOnLeftSide;
-}
+        float t = (absValue - DISTANCE_THRESHOLD) /
+                  (MAX_HAND_DISTANCE - DISTANCE_THRESHOLD);
 
-bool isHandOverLeftWaistSlot(const HandGestureState& gesture) {
-    return gesture.isBehindHeadWithWaistOffset && gesture.isCloseToWaist && gesture.isOnLeftSide;
-}
-
-bool isHandOverRightWaistSlot(const HandGestureState& gesture) {
-    return gesture.isBehindHeadWithWaistOffset && gesture.isCloseToWaist && !gesture.isOnLeftSide;
-}
-
-bool isHandOverMouthSlot(const HandGestureState& gesture) {
-    return gesture.isCloseToMouth && !gesture.isBehindHead;
-}
+        t = glm::clamp(t, 0.0f, 1.0f);
+        return t * sign;
+    };
 
-bool isHandFarEnoughFromStoredPosition(const HandGestureState& gesture) {
-    return gesture.isFarEnoughFromStoredPosition;
-}
+    gesture.magnesisForwardAmount = remapSigned(forwardAmount);
+    gesture.magnesisVerticalAmount = remapSigned(verticalAmount);
+    //Log::print<INFO>("magnesisForwardAmount frames skip : {}", gameState.magnesis_forward_frames_interval);
+    if (gameState.magnesis_forward_frames_interval > 0) {
+        gesture.magnesisForwardAmount = 0.0f;
+    }
+    else if (gameState.magnesis_forward_frames_interval <= -1)
+    {
+        gameState.magnesis_forward_frames_interval = GetMagnesisForwardFrameInterval(glm::abs(gesture.magnesisForwardAmount));
+    }
 
-bool isHandNotOverAnySlot(const HandGestureState& gesture) {
-    return !gesture.isBehindHead && !gesture.isBehindHeadWithWaistOffset && !gesture.isCloseToMouth;
+    gameState.magnesis_forward_frames_interval--;
+    //Log::print<INFO>("gesture.magnesisForwardAmount  : {}", gesture.magnesisForwardAmount);
 }
 
 bool handleDpadMenu(ButtonState::Event lastEvent, HandGestureState handGesture, uint32_t& buttonHold, OpenXR::GameState& gameState ) {
@@ -172,13 +115,13 @@ bool handleDpadMenu(ButtonState::Event lastEvent, HandGestureState handGesture,
         //eg : left hands hold bow, open bow menu with left shoulder, arrow menu with right shoulder
         bool isBowEquipped = gameState.last_item_held == EquipType::Bow;
         bool doesBowJustBroke = isBowEquipped && gameState.left_equip_type != EquipType::Bow;
-        if (isHandOverRightShoulderSlot(handGesture)) {
+        if (handGesture.IsOver(BodySlots::Slot::RightShoulder)) {
             buttonHold |= isBowEquipped ? VPAD_BUTTON_LEFT : VPAD_BUTTON_RIGHT;
             gameState.last_dpad_menu_open = isBowEquipped ? Direction::Left : Direction::Right;
             if (doesBowJustBroke)
                 buttonHold |= VPAD_BUTTON_ZR;
         }
-        else if (isHandOverLeftShoulderSlot(handGesture)) {
+        else if (handGesture.IsOver(BodySlots::Slot::LeftShoulder)) {
             buttonHold |= isBowEquipped ? VPAD_BUTTON_RIGHT : VPAD_BUTTON_LEFT;
             gameState.last_dpad_menu_open = isBowEquipped ? Direction::Right : Direction::Left;
             // Force a bow equip so the correct menu spawns even when the bow broke.
@@ -196,28 +139,21 @@ bool handleDpadMenu(ButtonState::Event lastEvent, HandGestureState handGesture,
     return false;
 }
 
-// Input handling functions
-void handleLeftHandInGameInput(
+// Shield and rune gestures that only exist for the left hand
+void handleLeftHandItemGestures(
     uint32_t& buttonHold,
     OpenXR::InputState& inputs,
     OpenXR::GameState& gameState,
     const HandGestureState& leftGesture,
-    Direction leftStickDir,
-    XrActionStateVector2f& leftStickSource,
-    XrActionStateVector2f& rightStickSource,
-    const std::chrono::steady_clock::time_point& now
+    XrActionStateVector2f& rightStickSource
 ) {
-    constexpr std::chrono::milliseconds INPUT_DELAY(400);
-    
     constexpr RumbleParameters leftRumbleRaise = { true, 0, RumbleType::Raising, 0.5f, false, 0.2, 1.0f, 1.0f };
     constexpr RumbleParameters leftRumbleFall = { true, 0, RumbleType::Falling, 0.5f, false, 0.3, 0.1f, 0.75f };
     constexpr RumbleParameters RuneRumble = { true, 0, RumbleType::OscillationSmooth, 1.0f, false, 1.0, 0.25f, 0.25f };
-    
+
     auto* rumbleMgr = VRManager::instance().XR->GetRumbleManager();
-    bool isGrabPressed = inputs.inGame.grabState[0].lastEvent == ButtonState::Event::ShortPress;
-    bool isGrabPressedLong = inputs.inGame.grabState[0].lastEvent == ButtonState::Event::LongPress;
-    bool isCurrentGrabPressed = inputs.inGame.grabState[0].wasDownLastFrame;
-    
+    const bool isNearChestHeight = leftGesture.IsOver(BodySlots::Slot::Chest);
+
     // Rune rumbles
     if (gameState.left_equip_type == EquipType::SheikahSlate)
         rumbleMgr->enqueueInputsRumbleCommand(RuneRumble);
@@ -226,7 +162,7 @@ void handleLeftHandInGameInput(
     // if shield with lock on isn't already being used with left trigger, use gesture to guard without lock on instead.
     // Gesture enabled only when both melee weapon and shield are in hands to prevent 2 handed weapons and quick drawing shield 
     // alone with Left Trigger to trigger it. So people can still move hands freely without the shield appearing when not wanted.
-    if (!inputs.inGame.useLeftItem.currentState && gameState.left_equip_type == EquipType::Shield && gameState.right_equip_type == EquipType::Melee && (leftGesture.isNearChestHeight)) {
+    if (!inputs.inGame.useLeftItem.currentState && gameState.left_equip_type == EquipType::Shield && gameState.right_equip_type == EquipType::Melee && isNearChestHeight) {
         buttonHold |= VPAD_BUTTON_ZL;
         rightStickSource.currentState.y = 0.2f; // Force disable the lock on view when holding shield
         gameState.is_shield_guarding = true;
@@ -241,291 +177,117 @@ void handleLeftHandInGameInput(
 
     // Handle Parry gesture
     auto handVelocity = glm::length(ToGLM(inputs.shared.poseVelocity[0].linearVelocity));
-    if (handVelocity > 4.0f && gameState.left_equip_type == EquipType::Shield && leftGesture.isNearChestHeight) {
+    if (handVelocity > 4.0f && gameState.left_equip_type == EquipType::Shield && isNearChestHeight) {
         buttonHold |= VPAD_BUTTON_A;
         rumbleMgr->enqueueInputsRumbleCommand(leftRumbleFall);
     }
-
-    // Handle shoulder slot interactions
-    if (isHandOverLeftShoulderSlot(leftGesture) || isHandOverRightShoulderSlot(leftGesture)) {
-        if (handleDpadMenu(inputs.inGame.grabState[0].lastEvent, leftGesture, buttonHold, gameState))
-            // Don't process normal input when opening dpad menu
-            return;
-
-        // Handle equip/unequip
-        if (!gameState.prevent_grab_inputs && isGrabPressed) {
-            rumbleMgr->enqueueInputsRumbleCommand(leftRumbleFall);
-            if (isHandOverLeftShoulderSlot(leftGesture)) {
-                // Left shoulder = Bow
-                if (gameState.left_equip_type != EquipType::Bow) {
-                    buttonHold |= VPAD_BUTTON_ZR;
-                    gameState.last_item_held = EquipType::Bow;
-                } else {
-                    buttonHold |= VPAD_BUTTON_B;  // Unequip
-                }
-            }
-            else {
-                // Right shoulder = Melee weapon
-                if (gameState.right_equip_type != EquipType::Melee) {
-                    buttonHold |= VPAD_BUTTON_Y;
-                    gameState.last_item_held = EquipType::Melee;
-                } else {
-                    buttonHold |= VPAD_BUTTON_B;  // Unequip
-                }
-            }
-            
-            gameState.prevent_grab_inputs = true;
-            gameState.prevent_grab_time = now;
-        }
-        return;  // Don't process normal input when over slots
-    }
-    
-    // Handle waist slot interaction (Rune)
-    if (isHandOverLeftWaistSlot(leftGesture)) {    
-        // Handle dpad menu
-        if (handleDpadMenu(inputs.inGame.grabState[0].lastEvent, leftGesture, buttonHold, gameState))
-            // Don't process normal input when opening dpad menu
-            return;
-
-        if (!gameState.prevent_grab_inputs && isGrabPressed) {
-            rumbleMgr->enqueueInputsRumbleCommand(leftRumbleFall);
-            if (gameState.left_equip_type != EquipType::SheikahSlate) {
-                buttonHold |= VPAD_BUTTON_L;
-                gameState.last_item_held = EquipType::SheikahSlate;
-            } else {
-                buttonHold |= VPAD_BUTTON_B;  // Unequip
-            }
-            
-            gameState.prevent_grab_inputs = true;
-            gameState.prevent_grab_time = now;
-        }
-        return;
-    }
-
-    if (isCurrentGrabPressed) {
-        // Magnesis motion controls
-        if (gameState.right_equip_type == EquipType::MagnetGlove) {
-            // null right joystick Y to let the magnesis motion controls handle it.
-            rightStickSource.currentState.y = 0.0f;
-
-            if (!gameState.left_hand_position_stored) {
-                gameState.stored_left_hand_position = ToGLM(inputs.shared.poseLocation[0].pose.position);
-                gameState.left_hand_position_stored = true;
-                rumbleMgr->enqueueInputsRumbleCommand(leftRumbleFall);
-            }
-
-            if (gameState.left_hand_position_stored) {
-                rightStickSource.currentState.y = leftGesture.magnesisVerticalAmount;
-                if (leftGesture.magnesisForwardAmount > 0.0f)
-                    buttonHold |= VPAD_BUTTON_UP;
-                else if (leftGesture.magnesisForwardAmount < 0.0f)
-                    buttonHold |= VPAD_BUTTON_DOWN;
-            }
-        }
-
-        // Pull gesture
-        if (gameState.left_hand_was_over_left_shoulder_slot) {
-            if (gameState.left_equip_type != EquipType::Bow) {
-                buttonHold |= VPAD_BUTTON_ZR;
-                gameState.last_item_held = EquipType::Bow;
-            }
-        }
-        else if (gameState.left_hand_was_over_right_shoulder_slot) {
-            if (gameState.right_equip_type != EquipType::Melee) {
-                buttonHold |= VPAD_BUTTON_Y;
-                gameState.last_item_held = EquipType::Melee;
-            }
-        }
-        else if (gameState.left_hand_was_over_left_waist_slot) {
-            if (gameState.left_equip_type != EquipType::SheikahSlate) {
-                buttonHold |= VPAD_BUTTON_L;
-                gameState.last_item_held = EquipType::SheikahSlate;
-            }
-        }
-    }
-    else
-        gameState.left_hand_position_stored = false;
-
-    // Left hand item drop broken rn, makes the game thinks link is empty handed in right hand too.
-    // Waiting for a fix before uncommenting
-    //if (isHandOverRightWaistSlot(leftGesture))
-    //{
-    //    if (isCurrentGrabPressed)
-    //        rumbleMgr->enqueueInputsRumbleCommand(grabSlotRumble);
-    //    //Handle drop action
-    //    if (isGrabPressedLong) {
-    //        inputs.inGame.drop_weapon[0] = true;
-    //        gameState.prevent_grab_inputs = true;
-    //        gameState.prevent_grab_time = now;
-    //    }
-    //    return;
-    //}
-    
-    if (isGrabPressed) {
-        // Handle grab action
-        if (!gameState.prevent_grab_inputs) {
-            buttonHold |= VPAD_BUTTON_A;
-        }
-    }
-
-    if (isHandNotOverAnySlot(leftGesture) && isGrabPressedLong) {
-        if (!gameState.prevent_grab_inputs) {
-            buttonHold |= VPAD_BUTTON_A;
-        }
-    }
 }
 
-void handleRightHandInGameInput(
+// Input handling for the slots and grabbing, which works the same for both hands
+void handleHandInGameInput(
+    OpenXR::EyeSide side,
     uint32_t& buttonHold,
     OpenXR::InputState& inputs,
     OpenXR::GameState& gameState,
-    const HandGestureState& rightGesture,
+    const HandGestureState& gesture,
     XrActionStateVector2f& rightStickSource,
-    Direction rightStickDir,
     const std::chrono::steady_clock::time_point& now
 ) {
-    constexpr std::chrono::milliseconds INPUT_DELAY(400);
-    
-    constexpr RumbleParameters rightRumbleFall = { true, 1, RumbleType::Falling, 0.5f, false, 0.3, 0.1f, 0.75f };
+    const RumbleParameters slotRumble = { true, side, RumbleType::Falling, 0.5f, false, 0.3, 0.1f, 0.75f };
     constexpr RumbleParameters rightRumbleInfiniteRaise = { true, 1, RumbleType::Raising, 0.5f, true, 1.0, 0.25f, 0.25f };
 
     auto* rumbleMgr = VRManager::instance().XR->GetRumbleManager();
-    bool isGrabPressedShort = inputs.inGame.grabState[1].lastEvent == ButtonState::Event::ShortPress;
-    bool isGrabPressedLong = inputs.inGame.grabState[1].lastEvent == ButtonState::Event::LongPress;
-    bool isCurrentGrabPressed = inputs.inGame.grabState[1].wasDownLastFrame;
-    bool isTriggerPressed = inputs.inGame.useRightItem.currentState;
-    
-    // Handle shoulder slot interactions
-    if (isHandOverLeftShoulderSlot(rightGesture) || isHandOverRightShoulderSlot(rightGesture)) {
-        // Handle dpad menu
-        if (handleDpadMenu(inputs.inGame.grabState[1].lastEvent, rightGesture, buttonHold, gameState))
-            // Don't process normal input when opening dpad menu
-            return;
+    const ButtonState& grabState = inputs.inGame.grabState[side];
+    bool isGrabPressedShort = grabState.lastEvent == ButtonState::Event::ShortPress;
+    bool isGrabPressedLong = grabState.lastEvent == ButtonState::Event::LongPress;
+    bool isCurrentGrabPressed = grabState.wasDownLastFrame;
 
-        // Handle equip/unequip
-        if (!gameState.prevent_grab_inputs && isGrabPressedShort) { 
-            rumbleMgr->enqueueInputsRumbleCommand(rightRumbleFall);
-            if (isHandOverRightShoulderSlot(rightGesture)) {
-                // Right shoulder = Melee weapon
-                if (gameState.right_equip_type != EquipType::Melee) {
-                    buttonHold |= VPAD_BUTTON_Y;
-                    gameState.last_item_held = EquipType::Melee;
-                } else {
-                    buttonHold |= VPAD_BUTTON_B;
-                }
-            }
-            else {
-                // Left shoulder = Bow
-                if (gameState.left_equip_type != EquipType::Bow) {
-                    buttonHold |= VPAD_BUTTON_ZR;
-                    gameState.last_item_held = EquipType::Bow;
-                } else {
-                    buttonHold |= VPAD_BUTTON_B;
-                }
-            }
-            
-            gameState.prevent_grab_inputs = true;
-            gameState.prevent_grab_time = now;
-        }
-
-        // Handle weapon throw when over shoulder slot
-        if (isTriggerPressed) {
-            rumbleMgr->enqueueInputsRumbleCommand(rightRumbleInfiniteRaise);
-            buttonHold |= VPAD_BUTTON_R;
-            gameState.weapon_throwed = true;
-        }
-        else if (gameState.weapon_throwed) {
-            rumbleMgr->stopInputsRumble(1, RumbleType::Raising);
-            gameState.weapon_throwed = false;
-        }
-        return;  // Don't process normal input when over slots
-    }
-    // if hand not on shoulder slot but trigger still pressed, stop throw rumbles
-    else if (gameState.weapon_throwed) {
+    // if hand isn't on a shoulder slot anymore but the trigger is still pressed, stop throw rumbles
+    if (side == OpenXR::EyeSide::RIGHT && !gesture.IsOverShoulder() && gameState.weapon_throwed) {
         rumbleMgr->stopInputsRumble(1, RumbleType::Raising);
         gameState.weapon_throwed = false;
     }
 
-    // Handle waist slot interaction (Rune)
-    if (isHandOverLeftWaistSlot(rightGesture)) {   
-        // Handle dpad menu
-        if (handleDpadMenu(inputs.inGame.grabState[1].lastEvent, rightGesture, buttonHold, gameState))
+    // Handle shoulder and waist slot interactions
+    if (const SlotEquipBinding* binding = getSlotEquipBinding(gesture.slots)) {
+        if (handleDpadMenu(grabState.lastEvent, gesture, buttonHold, gameState))
             // Don't process normal input when opening dpad menu
             return;
 
+        // Handle equip/unequip
         if (!gameState.prevent_grab_inputs && isGrabPressedShort) {
-            rumbleMgr->enqueueInputsRumbleCommand(rightRumbleFall);
-            if (gameState.left_equip_type != EquipType::SheikahSlate) {
-                buttonHold |= VPAD_BUTTON_L;
-                gameState.last_item_held = EquipType::SheikahSlate;
+            rumbleMgr->enqueueInputsRumbleCommand(slotRumble);
+            EquipType equipped = binding->equipsLeftHand ? gameState.left_equip_type : gameState.right_equip_type;
+            if (equipped != binding->equip) {
+                buttonHold |= binding->button;
+                gameState.last_item_held = binding->equip;
             } else {
                 buttonHold |= VPAD_BUTTON_B;  // Unequip
             }
-            
+
             gameState.prevent_grab_inputs = true;
             gameState.prevent_grab_time = now;
         }
-        return;
+
+        // Handle weapon throw when over shoulder slot
+        if (side == OpenXR::EyeSide::RIGHT && gesture.IsOverShoulder()) {
+            if (inputs.inGame.useRightItem.currentState) {
+                rumbleMgr->enqueueInputsRumbleCommand(rightRumbleInfiniteRaise);
+                buttonHold |= VPAD_BUTTON_R;
+                gameState.weapon_throwed = true;
+            }
+            else if (gameState.weapon_throwed) {
+                rumbleMgr->stopInputsRumble(1, RumbleType::Raising);
+                gameState.weapon_throwed = false;
+            }
+        }
+        return;  // Don't process normal input when over slots
     }
 
-    if (isHandOverRightWaistSlot(rightGesture))
-    {
+    if (DROP_FROM_RIGHT_WAIST_SLOT[side] && gesture.IsOver(BodySlots::Slot::RightWaist)) {
         //Handle drop action
         if (isGrabPressedLong) {
-            rumbleMgr->enqueueInputsRumbleCommand(rightRumbleFall);
-            inputs.inGame.drop_weapon[1] = true;
+            rumbleMgr->enqueueInputsRumbleCommand(slotRumble);
+            inputs.inGame.drop_weapon[side] = true;
             gameState.prevent_grab_inputs = true;
             gameState.prevent_grab_time = now;
         }
         return;
     }
-    
+
     if (isCurrentGrabPressed) {
         // Magnesis motion controls
         if (gameState.right_equip_type == EquipType::MagnetGlove) {
             // null right joystick Y to let the magnesis motion controls handle it.
             rightStickSource.currentState.y = 0.0f;
 
-            if (!gameState.right_hand_position_stored) {
-                gameState.stored_right_hand_position = ToGLM(inputs.shared.poseLocation[1].pose.position);
-                gameState.right_hand_position_stored = true;
-                rumbleMgr->enqueueInputsRumbleCommand(rightRumbleFall);
+            if (!gameState.hand_position_stored[side]) {
+                gameState.stored_hand_position[side] = ToGLM(inputs.shared.poseLocation[side].pose.position);
+                gameState.hand_position_stored[side] = true;
+                rumbleMgr->enqueueInputsRumbleCommand(slotRumble);
             }
 
-            if (gameState.right_hand_position_stored) {
-                rightStickSource.currentState.y = rightGesture.magnesisVerticalAmount;
-                if (rightGesture.magnesisForwardAmount > 0.0f)
+            if (gameState.hand_position_stored[side]) {
+                rightStickSource.currentState.y = gesture.magnesisVerticalAmount;
+                if (gesture.magnesisForwardAmount > 0.0f)
                     buttonHold |= VPAD_BUTTON_UP;
-                else if (rightGesture.magnesisForwardAmount < 0.0f)
+                else if (gesture.magnesisForwardAmount < 0.0f)
                     buttonHold |= VPAD_BUTTON_DOWN;
             }
         }
 
-        // Pull gesture
-        if (gameState.right_hand_was_over_left_shoulder_slot) {
-            if (gameState.left_equip_type != EquipType::Bow) {
-                rumbleMgr->enqueueInputsRumbleCommand(rightRumbleFall);
-                buttonHold |= VPAD_BUTTON_ZR;
-                gameState.last_item_held = EquipType::Bow;
-            }
-        }
-        else if (gameState.right_hand_was_over_right_shoulder_slot) {
-            if (gameState.right_equip_type != EquipType::Melee) {
-                rumbleMgr->enqueueInputsRumbleCommand(rightRumbleFall);
-                buttonHold |= VPAD_BUTTON_Y;
-                gameState.last_item_held = EquipType::Melee;
-            }
-        }
-        else if (gameState.right_hand_was_over_left_waist_slot) {
-            if (gameState.left_equip_type != EquipType::SheikahSlate) {
-                rumbleMgr->enqueueInputsRumbleCommand(rightRumbleFall);
-                buttonHold |= VPAD_BUTTON_L;
-                gameState.last_item_held = EquipType::SheikahSlate;
+        // Pull gesture: grabbed over a slot last frame and already pulling the item out of it
+        if (const SlotEquipBinding* binding = getSlotEquipBinding(gameState.hand_slots_last_frame[side])) {
+            EquipType equipped = binding->equipsLeftHand ? gameState.left_equip_type : gameState.right_equip_type;
+            if (equipped != binding->equip) {
+                rumbleMgr->enqueueInputsRumbleCommand(slotRumble);
+                buttonHold |= binding->button;
+                gameState.last_item_held = binding->equip;
             }
         }
     }
     else
-        gameState.right_hand_position_stored = false;
+        gameState.hand_position_stored[side] = false;
 
     if (isGrabPressedShort) {
         // Handle grab action
@@ -534,7 +296,7 @@ void handleRightHandInGameInput(
         }
     }
 
-    if (isHandNotOverAnySlot(rightGesture) && isGrabPressedLong) {
+    if (gesture.IsNotOverAnySlot() && isGrabPressedLong) {
         if (!gameState.prevent_grab_inputs) {
             buttonHold |= VPAD_BUTTON_A;
         }
@@ -586,7 +348,7 @@ void handleRightTriggerBindings(
 ) {
     auto* rumbleMgr = VRManager::instance().XR->GetRumbleManager();
 
-    if (isHandOverRightShoulderSlot(rightGesture))
+    if (rightGesture.IsOver(BodySlots::Slot::RightShoulder))
         return;
 
     if (!inputs.inGame.useRightItem.currentState) {
@@ -639,6 +401,44 @@ void handleRightTriggerBindings(
     }
 }
 
+static InputMapping::Mapper s_inputMapper;
+
+// Packs the OpenXR actions that InputMapping::BINDINGS uses into its sources
+static InputMapping::SourceStates readMappedSources(const OpenXR::InputState& inputs) {
+    using InputMapping::Pack;
+    using InputMapping::Source;
+    auto boolean = [](const XrActionStateBoolean& state) { return Pack(state.currentState == XR_TRUE, ButtonState::Event::None); };
+    auto button = [](const XrActionStateBoolean& state, const ButtonState& button) { return Pack(state.currentState == XR_TRUE, button.lastEvent); };
+
+    InputMapping::SourceStates sources = {};
+    sources[(size_t)Source::InventoryMap] = button(inputs.shared.inventory_map, inputs.shared.inventory_mapState);
+    sources[(size_t)Source::CrouchScope] = button(inputs.inGame.crouch_scope, inputs.inGame.crouch_scopeState);
+    sources[(size_t)Source::JumpCancel] = boolean(inputs.inGame.jump_cancel);
+    sources[(size_t)Source::UseRune] = button(inputs.inGame.useRune_dpadMenu, inputs.inGame.useRune_runeMenuState);
+    sources[(size_t)Source::MenuBack] = boolean(inputs.inMenu.back);
+    sources[(size_t)Source::MenuSelect] = boolean(inputs.inMenu.select);
+    sources[(size_t)Source::MenuLeftTrigger] = boolean(inputs.inMenu.leftTrigger);
+    sources[(size_t)Source::MenuRightTrigger] = boolean(inputs.inMenu.rightTrigger);
+    sources[(size_t)Source::MenuHold] = button(inputs.inMenu.hold, inputs.inMenu.holdState);
+    return sources;
+}
+
+// Maps everything in InputMapping::BINDINGS and applies the game state changes that go along with some of them
+void handleMappedInput(uint32_t& buttonHold, const OpenXR::InputState& inputs, OpenXR::GameState& gameState) {
+    const InputMapping::Context context = gameState.in_game ? InputMapping::Context::InGame : InputMapping::Context::InMenu;
+    const InputMapping::ActionMask actions = s_inputMapper.Update(readMappedSources(inputs), context, gameState.prevent_inputs);
+    buttonHold |= s_inputMapper.GetButtons();
+
+    if (actions & InputMapping::Bit(InputMapping::Action::OpenInventory))
+        gameState.map_open = false;
+    if (actions & InputMapping::Bit(InputMapping::Action::OpenMap))
+        gameState.map_open = true;
+    if (actions & InputMapping::Bit(InputMapping::Action::OpenRuneMenu))
+        gameState.rune_menu_open = true;
+    if (actions & InputMapping::Bit(InputMapping::Action::UseRune))
+        gameState.last_item_held = EquipType::SheikahSlate;
+}
+
 void handleMenuInput(
     uint32_t& buttonHold,
     OpenXR::InputState& inputs,
@@ -657,21 +457,14 @@ void handleMenuInput(
         }
     }
 
+    // back, select, tabs and hold are mapped by InputMapping::BINDINGS
     if (!gameState.prevent_inputs) {
-        buttonHold |= mapButton(inputs.inMenu.back, VPAD_BUTTON_B);
         if (gameState.map_open)
             buttonHold |= mapButton(inputs.shared.inventory_map, VPAD_BUTTON_MINUS);
         else
             buttonHold |= mapButton(inputs.shared.inventory_map, VPAD_BUTTON_PLUS);
     }
 
-    buttonHold |= mapButton(inputs.inMenu.select, VPAD_BUTTON_A);
-    buttonHold |= mapButton(inputs.inMenu.leftTrigger, VPAD_BUTTON_L);
-    buttonHold |= mapButton(inputs.inMenu.rightTrigger, VPAD_BUTTON_R);
-
-    if (inputs.inMenu.holdState.lastEvent == ButtonState::Event::ShortPress)
-        buttonHold |= VPAD_BUTTON_X;
-
     // handle optional quick rune menu
     if (gameState.rune_menu_open) {
         if (inputs.inMenu.sort.currentState)
@@ -707,23 +500,11 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
     // todo: revert this to unblock gamepad input
     readMemory(vpadStatusOffset, &vpadStatus);
 
-    static auto startBtnLastTime = std::chrono::steady_clock::now();
-    static bool startBtnWasDown = false;
-    static bool startBtnActionConsumed = false;
+    // everything below uses this time, so that all the delays in a frame agree with each other
+    const auto now = std::chrono::steady_clock::now();
 
-    if ((vpadStatus.hold.getLE() & VPAD_BUTTON_PLUS) != 0) {
-        if (!startBtnWasDown) {
-            startBtnLastTime = std::chrono::steady_clock::now();
-            startBtnActionConsumed = false;
-        }
-        else if (!startBtnActionConsumed && std::chrono::steady_clock::now() - startBtnLastTime > std::chrono::milliseconds(500)) {
-            VRManager::instance().XR->m_isMenuOpen = !VRManager::instance().XR->m_isMenuOpen;
-            startBtnActionConsumed = true;
-        }
-        startBtnWasDown = true;
-    }
-    else {
-        startBtnWasDown = false;
+    if (s_inputMapper.UpdateStartButton((vpadStatus.hold.getLE() & VPAD_BUTTON_PLUS) != 0, now)) {
+        VRManager::instance().XR->m_isMenuOpen = !VRManager::instance().XR->m_isMenuOpen;
     }
 
     if (imguiOverlay->ShouldBlockGameInput()) {
@@ -741,7 +522,6 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
     gameState.in_game = inputs.shared.in_game;
 
     // buttons
-    static uint32_t oldCombinedHold = 0; 
     uint32_t newXRBtnHold = 0;
 
     // fetching stick inputs
@@ -753,7 +533,6 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
 
     //Delay to wait before allowing specific inputs again
     constexpr std::chrono::milliseconds delay{ 400 };
-    const auto now = std::chrono::steady_clock::now();
 
 
     // check if we need to prevent inputs from happening
@@ -793,14 +572,17 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
 
     auto headsetPose = renderer->GetMiddlePose();
     if (headsetPose.has_value()) {
-        const auto headsetMtx = headsetPose.value();
-        const glm::fvec3 headsetPos(headsetMtx[3]);
-        
-        const auto leftHandPos = ToGLM(inputs.shared.poseLocation[0].pose.position);
-        const auto rightHandPos = ToGLM(inputs.shared.poseLocation[1].pose.position);
-        
-        leftGesture = calculateHandGesture(gameState, leftHandPos, headsetMtx, headsetPos, gameState.left_hand_position_stored, gameState.stored_left_hand_position);
-        rightGesture = calculateHandGesture(gameState, rightHandPos, headsetMtx, headsetPos, gameState.right_hand_position_stored, gameState.stored_right_hand_position);
+        const BodySlots::HeadsetFrame headset = BodySlots::GetHeadsetFrame(headsetPose.value());
+        const std::array handPositions = { ToGLM(inputs.shared.poseLocation[0].pose.position), ToGLM(inputs.shared.poseLocation[1].pose.position) };
+
+        const std::array<BodySlots::SlotMask, 2> handSlots = BodySlots::Evaluate(headset, handPositions);
+        leftGesture.slots = handSlots[OpenXR::EyeSide::LEFT];
+        rightGesture.slots = handSlots[OpenXR::EyeSide::RIGHT];
+
+        if (gameState.hand_position_stored[OpenXR::EyeSide::LEFT])
+            calculateMagnesisGesture(gameState, leftGesture, handPositions[OpenXR::EyeSide::LEFT], headset.forward, gameState.stored_hand_position[OpenXR::EyeSide::LEFT]);
+        if (gameState.hand_position_stored[OpenXR::EyeSide::RIGHT])
+            calculateMagnesisGesture(gameState, rightGesture, handPositions[OpenXR::EyeSide::RIGHT], headset.forward, gameState.stored_hand_position[OpenXR::EyeSide::RIGHT]);
     }
     
     // dpad menu toggle
@@ -886,40 +668,9 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
         }
     
 
-        if (!gameState.prevent_inputs) {
-            // prevent jump when exiting menus with B button
-            newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.jump_cancel, VPAD_BUTTON_X);
+        // jumping, crouching, the scope, the inventory/map and the optional rune inputs (for seated players)
+        handleMappedInput(newXRBtnHold, inputs, gameState);
 
-            //// Scope
-            if (inputs.inGame.crouch_scopeState.lastEvent == ButtonState::Event::LongPress) {
-                newXRBtnHold |= VPAD_BUTTON_STICK_R;
-            }
-
-            // Handle map and inventory menu toggle
-            if (inputs.shared.inventory_mapState.lastEvent == ButtonState::Event::ShortPress) {
-                newXRBtnHold |= VPAD_BUTTON_PLUS;
-                gameState.map_open = false;
-            }
-            if (inputs.shared.inventory_mapState.lastEvent == ButtonState::Event::LongPress) {
-                newXRBtnHold |= VPAD_BUTTON_MINUS;
-                gameState.map_open = true;
-            }
-        }
-
-        if (inputs.inGame.crouch_scopeState.lastEvent == ButtonState::Event::ShortPress) {
-            newXRBtnHold |= VPAD_BUTTON_STICK_L;
-        }
-        
-        // Optional rune inputs (for seated players)
-        if (inputs.inGame.useRune_runeMenuState.lastEvent == ButtonState::Event::LongPress) {
-            gameState.rune_menu_open = true;
-            newXRBtnHold |= VPAD_BUTTON_UP;  // Rune quick menu
-        }
-        if (inputs.inGame.useRune_runeMenuState.lastEvent == ButtonState::Event::ShortPress) {
-            newXRBtnHold |= VPAD_BUTTON_L;  // Use rune
-            gameState.last_item_held = EquipType::SheikahSlate;
-        }
-        
         // If climbing or paragliding, make the B button cancel instantly the action instead of long press to run
         if (gameState.is_climbing || gameState.is_paragliding) {
             newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.run_interact, VPAD_BUTTON_B);
@@ -938,7 +689,7 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
         }
 
         // Whistle gesture
-        if (isHandOverMouthSlot(leftGesture) && isHandOverMouthSlot(rightGesture)) {
+        if (leftGesture.IsOver(BodySlots::Slot::Mouth) && rightGesture.IsOver(BodySlots::Slot::Mouth)) {
             if (inputs.inGame.grabState[0].wasDownLastFrame && inputs.inGame.grabState[1].wasDownLastFrame) {
                 rumbleMgr->enqueueInputsRumbleCommand({ true, 0, RumbleType::OscillationRaisingSawtoothWave, 1.0f, false, 0.25, 0.2f, 0.2f });
                 newXRBtnHold |= VPAD_BUTTON_DOWN;
@@ -946,16 +697,16 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
         }
         
         // Hand-specific input
-        handleLeftHandInGameInput(newXRBtnHold, inputs, gameState, leftGesture, 
-                                   leftJoystickDir, leftStickSource, rightStickSource, now);
-        handleRightHandInGameInput(newXRBtnHold, inputs, gameState, rightGesture, rightStickSource,
-                                    rightJoystickDir, now);
+        handleLeftHandItemGestures(newXRBtnHold, inputs, gameState, leftGesture, rightStickSource);
+        handleHandInGameInput(OpenXR::EyeSide::LEFT, newXRBtnHold, inputs, gameState, leftGesture, rightStickSource, now);
+        handleHandInGameInput(OpenXR::EyeSide::RIGHT, newXRBtnHold, inputs, gameState, rightGesture, rightStickSource, now);
         
         // Trigger handling
         handleLeftTriggerBindings(newXRBtnHold, inputs, gameState, leftGesture);
         handleRightTriggerBindings(newXRBtnHold, inputs, gameState, rightGesture);
     }
     else {
+        handleMappedInput(newXRBtnHold, inputs, gameState);
         handleMenuInput(newXRBtnHold, inputs, gameState, leftJoystickDir);
     }
 
@@ -963,42 +714,16 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
     rumbleMgr->updateHaptics();
 
     // sticks
-    static VPADButtons oldXRStickHold = VPAD_BUTTON_NONE;
-    VPADButtons newXRStickHold = VPAD_BUTTON_NONE;
-
-    // movement/navigation stick
     vpadStatus.leftStick = { leftStickSource.currentState.x + vpadStatus.leftStick.x.getLE(), leftStickSource.currentState.y + vpadStatus.leftStick.y.getLE() };
-
-    if (leftStickSource.currentState.x <= -AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_L_EMULATION_LEFT) && leftStickSource.currentState.x <= -HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_L_EMULATION_LEFT;
-    else if (leftStickSource.currentState.x >= AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_L_EMULATION_RIGHT) && leftStickSource.currentState.x >= HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_L_EMULATION_RIGHT;
-
-    if (leftStickSource.currentState.y <= -AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_L_EMULATION_DOWN) && leftStickSource.currentState.y <= -HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_L_EMULATION_DOWN;
-    else if (leftStickSource.currentState.y >= AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_L_EMULATION_UP) && leftStickSource.currentState.y >= HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_L_EMULATION_UP;
-
-    vpadStatus.rightStick = {rightStickSource.currentState.x + vpadStatus.rightStick.x.getLE(), rightStickSource.currentState.y + vpadStatus.rightStick.y.getLE()};
-
-    if (rightStickSource.currentState.x <= -AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_R_EMULATION_LEFT) && rightStickSource.currentState.x <= -HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_R_EMULATION_LEFT;
-    else if (rightStickSource.currentState.x >= AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_R_EMULATION_RIGHT) && rightStickSource.currentState.x >= HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_R_EMULATION_RIGHT;
-
-    if (rightStickSource.currentState.y <= -AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_R_EMULATION_DOWN) && rightStickSource.currentState.y <= -HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_R_EMULATION_DOWN;
-    else if (rightStickSource.currentState.y >= AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_R_EMULATION_UP) && rightStickSource.currentState.y >= HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_R_EMULATION_UP;
-
-    oldXRStickHold = newXRStickHold;
+    vpadStatus.rightStick = { rightStickSource.currentState.x + vpadStatus.rightStick.x.getLE(), rightStickSource.currentState.y + vpadStatus.rightStick.y.getLE() };
+    const VPADButtons newXRStickHold = s_inputMapper.UpdateStickEmulation(leftStickSource.currentState, rightStickSource.currentState);
 
     // calculate new hold, trigger and release
     uint32_t combinedHold = (vpadStatus.hold.getLE() | (newXRBtnHold | newXRStickHold));
+    const InputMapping::Mapper::Edges edges = s_inputMapper.UpdateHold(combinedHold);
     vpadStatus.hold = combinedHold;
-    vpadStatus.trig = (combinedHold & ~oldCombinedHold);
-    vpadStatus.release = (~combinedHold & oldCombinedHold);
-    oldCombinedHold = combinedHold;
+    vpadStatus.trig = edges.trig;
+    vpadStatus.release = edges.release;
 
     // misc
     vpadStatus.vpadErr = 0;
@@ -1033,12 +758,7 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
     }
     
     // Pull gesture
-    gameState.right_hand_was_over_left_shoulder_slot = isHandOverLeftShoulderSlot(rightGesture);
-    gameState.right_hand_was_over_right_shoulder_slot = isHandOverRightShoulderSlot(rightGesture);
-    gameState.right_hand_was_over_left_waist_slot = isHandOverLeftWaistSlot(rightGesture);
-    gameState.left_hand_was_over_left_shoulder_slot = isHandOverLeftShoulderSlot(leftGesture);
-    gameState.left_hand_was_over_right_shoulder_slot = isHandOverRightShoulderSlot(leftGesture);
-    gameState.left_hand_was_over_left_waist_slot = isHandOverLeftWaistSlot(leftGesture);
+    gameState.hand_slots_last_frame = { leftGesture.slots, rightGesture.slots };
 
     VRManager::instance().XR->m_gameState.store(gameState);
     VRManager::instance().XR->m_input.store(inputs);
@@ -9,6 +9,7 @@
 
 std::mutex g_actorListMutex;
 std::unordered_map<uint32_t, std::pair<std::string, uint32_t>> s_knownActors;
+std::atomic<uint32_t> s_actorListAddress = 0;
 glm::fvec3 CemuHooks::s_playerPos = {};
 uint32_t CemuHooks::s_playerMtxAddress = 0;
 uint32_t CemuHooks::s_cameraMtxAddress = 0;
@@ -25,6 +26,7 @@ void CemuHooks::hook_UpdateActorList(PPCInterpreter_t* hCPU) {
     // clear actor list when reiterating actor list again
     if (hCPU->gpr[5] == 0) {
         s_knownActors.clear();
+        s_actorListAddress.store(hCPU->gpr[3], std::memory_order_relaxed);
     }
 
     uint32_t actorLinkPtr = hCPU->gpr[6] + offsetof(ActorWiiU, name) + offsetof(sead::FixedSafeString40, c_str);
@@ -636,7 +638,7 @@ void EntityDebugger::DrawFPSOverlay(RND_Renderer* renderer) {
 
 void EntityDebugger::DrawFPSOverlayContent(RND_Renderer* renderer, bool renderText) {
     const float predictedDisplayPeriodMs = (float)renderer->GetPredictedDisplayPeriodMs();
-    const float predictedHz = GetSettings().performanceOverlayFrequency;
+    const float predictedHz = GetSettings()->performanceOverlayFrequency;
 
     const float appMs = (float)renderer->GetLastFrameTimeMs();      // Total frame time (includes wait)
     const float workMs = (float)renderer->GetLastFrameWorkTimeMs(); // GPU Work time only (excludes wait)
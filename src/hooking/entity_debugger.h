@@ -8,6 +8,12 @@ struct MemoryRange {
     std::unique_ptr<MemoryEditor> editor;
 };
 
+// every actor that hook_UpdateActorList saw in the current actor list iteration, by actor id with their name and address
+extern std::mutex g_actorListMutex;
+extern std::unordered_map<uint32_t, std::pair<std::string, uint32_t>> s_knownActors;
+// address of the game's actor list that hook_UpdateActorList iterates, so that it can be walked again whenever the live actors are needed
+extern std::atomic<uint32_t> s_actorListAddress;
+
 using ValueVariant = std::variant<BEType<uint32_t>, BEType<int32_t>, BEType<uint16_t>, BEType<uint8_t>, BEType<float>, BEVec3, BEMatrix34, MemoryRange, std::string>;
 
 
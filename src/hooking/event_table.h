@@ -0,0 +1,186 @@
+#pragma once
+#include "pch.h"
+
+#include <filesystem>
+#include <fstream>
+
+
+// If the user is unable to control the camera, we can guess that they're in a cutscene
+struct HybridEventSettings {
+    bool firstPerson;                  // use Link's perspective, ignore the animated event camera
+    bool disablePlayerDrivenLinkHands; // let event control the hands instead of the VR controllers
+    bool ignoreCameraRotation;         // some events will pan the camera, but in first-person it should usually be ignored to avoid nausea. Doors opening is okay, but panning down to a chest is not.
+    bool demoEnableCameraInput;        // there's already events that allow user camera control. This isn't used or overwritten atm.
+};
+
+// Event names get interned to small IDs, so that finding the active event every frame only hashes the guest's string and probes a flat table
+// instead of building std::strings. The table is filled from the graphic pack's cutscene settings, and events that aren't in there get added the first time they play.
+// Entries never move since the table has a fixed capacity, so other threads can look events up while the game thread adds new ones.
+class EventTable {
+public:
+    using EventId = uint16_t;
+    static constexpr EventId NO_EVENT = 0;
+    static constexpr uint32_t MAX_EVENTS = 4096;
+    static constexpr uint32_t SLOT_COUNT = MAX_EVENTS * 2; // keeps probe sequences short
+
+    EventTable() : m_events(std::make_unique<std::array<Event, MAX_EVENTS + 1>>()) {}
+
+    static uint64_t Hash(std::string_view name) {
+        uint64_t hash = 0xCBF29CE484222325;
+        for (char c : name) {
+            hash = (hash ^ (uint8_t)c) * 0x100000001B3;
+        }
+        return hash;
+    }
+
+    EventId Find(std::string_view name) const {
+        const uint64_t hash = Hash(name);
+        for (uint32_t slot = (uint32_t)hash & (SLOT_COUNT - 1);; slot = (slot + 1) & (SLOT_COUNT - 1)) {
+            const EventId id = m_slots[slot].load(std::memory_order_acquire);
+            if (id == NO_EVENT) {
+                return NO_EVENT;
+            }
+            const Event& event = (*m_events)[id];
+            if (event.hash == hash && event.name == name) {
+                return id;
+            }
+        }
+    }
+
+    // Adds the event or replaces its default settings if it's already known. Only one thread is allowed to add events.
+    EventId Add(std::string_view name, const HybridEventSettings& defaults) {
+        if (const EventId id = Find(name); id != NO_EVENT) {
+            (*m_events)[id].defaults = defaults;
+            return id;
+        }
+        const uint32_t count = m_count.load(std::memory_order_relaxed);
+        if (count > MAX_EVENTS) {
+            if (!std::exchange(m_loggedFull, true)) {
+                Log::print<WARNING>("Ran out of room for event {}, it and any other new events will be treated as gameplay", name);
+            }
+            return NO_EVENT;
+        }
+
+        const EventId id = (EventId)count;
+        Event& event = (*m_events)[id];
+        event.name = name;
+        event.hash = Hash(name);
+        event.defaults = defaults;
+        m_count.store(count + 1, std::memory_order_release);
+
+        uint32_t slot = (uint32_t)event.hash & (SLOT_COUNT - 1);
+        while (m_slots[slot].load(std::memory_order_relaxed) != NO_EVENT) {
+            slot = (slot + 1) & (SLOT_COUNT - 1);
+        }
+        m_slots[slot].store(id, std::memory_order_release);
+        return id;
+    }
+
+    uint32_t Size() const { return m_count.load(std::memory_order_acquire) - 1; }
+
+    std::string_view GetName(EventId id) const { return id != NO_EVENT ? std::string_view((*m_events)[id].name) : std::string_view(); }
+
+    // Defaults are only replaced while the graphic pack's table is read, which happens before any event plays
+    const HybridEventSettings& GetDefaults(EventId id) const { return (*m_events)[id].defaults; }
+
+    std::optional<HybridEventSettings> GetOverride(EventId id) const {
+        const uint8_t packed = (*m_events)[id].override.load(std::memory_order_relaxed);
+        if ((packed & OVERRIDE_SET) == 0) {
+            return std::nullopt;
+        }
+        return HybridEventSettings{ (packed & 1) != 0, (packed & 2) != 0, (packed & 4) != 0, (packed & 8) != 0 };
+    }
+
+    void SetOverride(EventId id, const std::optional<HybridEventSettings>& settings) {
+        uint8_t packed = 0;
+        if (settings.has_value()) {
+            packed = OVERRIDE_SET | (settings->firstPerson ? 1 : 0) | (settings->disablePlayerDrivenLinkHands ? 2 : 0) | (settings->ignoreCameraRotation ? 4 : 0) | (settings->demoEnableCameraInput ? 8 : 0);
+        }
+        (*m_events)[id].override.store(packed, std::memory_order_relaxed);
+    }
+
+    // Applies a list like "FP_ON,PAN_OFF,HND_OFF,CTRL_ON" to the settings, returns false if there was an unknown setting in it
+    static bool ParseSettings(std::string_view list, HybridEventSettings& settings) {
+        bool known = true;
+        for (const auto part : std::views::split(list, ',')) {
+            const std::string_view setting(part.begin(), part.end());
+            if (setting == "FP_ON") settings.firstPerson = true;
+            else if (setting == "FP_OFF") settings.firstPerson = false;
+            else if (setting == "HND_ON") settings.disablePlayerDrivenLinkHands = false;
+            else if (setting == "HND_OFF") settings.disablePlayerDrivenLinkHands = true;
+            else if (setting == "PAN_ON") settings.ignoreCameraRotation = false;
+            else if (setting == "PAN_OFF") settings.ignoreCameraRotation = true;
+            else if (setting == "CTRL_ON") settings.demoEnableCameraInput = false;
+            else if (setting == "CTRL_OFF") settings.demoEnableCameraInput = true;
+            else {
+                Log::print<WARNING>("Unknown cutscene default setting: {}", setting);
+                known = false;
+            }
+        }
+        return known;
+    }
+
+    static std::string FormatSettings(const HybridEventSettings& settings) {
+        return std::format("{},{},{},{}", settings.firstPerson ? "FP_ON" : "FP_OFF", settings.ignoreCameraRotation ? "PAN_OFF" : "PAN_ON",
+            settings.disablePlayerDrivenLinkHands ? "HND_OFF" : "HND_ON", settings.demoEnableCameraInput ? "CTRL_OFF" : "CTRL_ON");
+    }
+
+    // The overrides are saved in the same "EventName,FP_ON,PAN_OFF,..." format as the graphic pack's table.
+    // Events that aren't in the table yet get added with the given defaults.
+    void LoadOverrides(const std::filesystem::path& filePath, const HybridEventSettings& unknownDefaults) {
+        std::ifstream file(filePath);
+        if (!file.is_open()) {
+            return;
+        }
+        uint32_t overrides = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            const size_t commaPos = line.find(',');
+            if (line.empty() || line[0] == '#' || commaPos == std::string::npos) {
+                continue;
+            }
+            const std::string_view eventName = std::string_view(line).substr(0, commaPos);
+            EventId id = Find(eventName);
+            if (id == NO_EVENT) {
+                id = Add(eventName, unknownDefaults);
+            }
+            HybridEventSettings settings = id != NO_EVENT ? GetDefaults(id) : HybridEventSettings{};
+            if (id != NO_EVENT && ParseSettings(std::string_view(line).substr(commaPos + 1), settings)) {
+                SetOverride(id, settings);
+                overrides++;
+            }
+        }
+        Log::print<INFO>("Loaded {} cutscene overrides from {}", overrides, filePath.string());
+    }
+
+    void SaveOverrides(const std::filesystem::path& filePath) const {
+        std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            Log::print<WARNING>("Failed to save the cutscene overrides to {}", filePath.string());
+            return;
+        }
+        file << "# BetterVR cutscene overrides, one event per line using the same settings as patch_Settings_Cutscenes.asm\n";
+        const uint32_t count = m_count.load(std::memory_order_acquire);
+        for (EventId id = 1; id < count; id++) {
+            if (auto settings = GetOverride(id)) {
+                file << (*m_events)[id].name << ',' << FormatSettings(*settings) << '\n';
+            }
+        }
+    }
+
+private:
+    static constexpr uint8_t OVERRIDE_SET = 0x80;
+
+    struct Event {
+        std::string name;
+        uint64_t hash = 0;
+        HybridEventSettings defaults = {};
+        std::atomic<uint8_t> override = 0;
+    };
+
+    std::array<std::atomic<EventId>, SLOT_COUNT> m_slots = {};
+    std::unique_ptr<std::array<Event, MAX_EVENTS + 1>> m_events; // index 0 is NO_EVENT
+    std::atomic<uint32_t> m_count = 1;
+    bool m_loggedFull = false;
+};
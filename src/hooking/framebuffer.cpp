@@ -1,41 +1,74 @@
 #include "framebuffer.h"
 #include "instance.h"
 #include "layer.h"
+#include "utils/image_table.h"
+#include "utils/submit_rewrite.h"
 #include "utils/vulkan_utils.h"
 
 
-std::mutex lockImageResolutions;
-std::unordered_map<VkImage, std::pair<VkExtent2D, VkFormat>> imageResolutions;
+using TrackedImageTable = ImageTable<4096>;
+TrackedImageTable s_trackedImages;
+
+using PendingCopyList = PendingCopyListOf<SharedTexture>;
 
 std::mutex s_activeCopyMutex;
-std::vector<std::pair<VkCommandBuffer, SharedTexture*>> s_activeCopyOperations;
+PendingCopyList s_activeCopyOperations;
+std::atomic_uint32_t s_pendingCopyCount = 0;
+std::atomic_bool s_loggedSubmitHeapFallback = false;
+std::atomic_bool s_loggedPendingCopyHeapFallback = false;
+
+static void QueueCopyOperation(VkCommandBuffer commandBuffer, SharedTexture* texture) {
+    std::lock_guard lk(s_activeCopyMutex);
+    s_activeCopyOperations.push_back({ commandBuffer, texture });
+    s_pendingCopyCount.store((uint32_t)s_activeCopyOperations.size(), std::memory_order_release);
+    if (!s_activeCopyOperations.IsInline() && !s_loggedPendingCopyHeapFallback.exchange(true)) {
+        Log::print<WARNING>("More than {} interop copies are waiting for their command buffers to be submitted, keeping them on the heap", PENDING_COPY_INLINE_CAPACITY);
+    }
+}
 
-VkImage s_curr3DColorImage = VK_NULL_HANDLE;
-VkImage s_curr3DDepthImage = VK_NULL_HANDLE;
+// take ownership of all pending copies by moving the list out, so that the lock is only held for that move
+static PendingCopyList TakePendingCopies() {
+    std::lock_guard lk(s_activeCopyMutex);
+    PendingCopyList pendingCopies = std::move(s_activeCopyOperations);
+    s_pendingCopyCount.store(0, std::memory_order_release);
+    return pendingCopies;
+}
+
+// hand back the copies that belong to command buffers that weren't part of this submission, consumed copies have their command buffer cleared
+static void ReturnUnconsumedCopies(const PendingCopyList& pendingCopies) {
+    if (std::ranges::none_of(pendingCopies, [](const auto& copyOperation) { return copyOperation.first != VK_NULL_HANDLE; })) {
+        return;
+    }
+    std::lock_guard lk(s_activeCopyMutex);
+    for (const auto& copyOperation : pendingCopies) {
+        if (copyOperation.first != VK_NULL_HANDLE) {
+            s_activeCopyOperations.push_back(copyOperation);
+        }
+    }
+    s_pendingCopyCount.store((uint32_t)s_activeCopyOperations.size(), std::memory_order_release);
+}
+
+std::atomic<VkImage> s_curr3DColorImage = VK_NULL_HANDLE;
+std::atomic<VkImage> s_curr3DDepthImage = VK_NULL_HANDLE;
 
 using namespace VRLayer;
 
 VkResult VkDeviceOverrides::CreateImage(const vkroots::VkDeviceDispatch& pDispatch, VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage) {
     VkResult res = pDispatch.CreateImage(device, pCreateInfo, pAllocator, pImage);
 
-    if (pCreateInfo->extent.width >= 1280 && pCreateInfo->extent.height >= 720) {
-        lockImageResolutions.lock();
-        checkAssert(imageResolutions.try_emplace(*pImage, std::make_pair(VkExtent2D{ pCreateInfo->extent.width, pCreateInfo->extent.height }, pCreateInfo->format)).second, "Couldn't insert image resolution into map!");
-        lockImageResolutions.unlock();
+    if (res == VK_SUCCESS && pCreateInfo->extent.width >= 1280 && pCreateInfo->extent.height >= 720) {
+        checkAssert(s_trackedImages.Insert(*pImage, VkExtent2D{ pCreateInfo->extent.width, pCreateInfo->extent.height }, pCreateInfo->format), "Couldn't insert image resolution into map!");
     }
     return res;
 }
 
 void VkDeviceOverrides::DestroyImage(const vkroots::VkDeviceDispatch& pDispatch, VkDevice device, VkImage image, const VkAllocationCallbacks* pAllocator) {
-    lockImageResolutions.lock();
-    imageResolutions.erase(image);
-    if (s_curr3DColorImage == image) {
-        s_curr3DColorImage = VK_NULL_HANDLE;
-    }
-    else if (s_curr3DDepthImage == image) {
-        s_curr3DDepthImage = VK_NULL_HANDLE;
+    s_trackedImages.Erase(image);
+    VkImage destroyedImage = image;
+    if (!s_curr3DColorImage.compare_exchange_strong(destroyedImage, VK_NULL_HANDLE)) {
+        destroyedImage = image;
+        s_curr3DDepthImage.compare_exchange_strong(destroyedImage, VK_NULL_HANDLE);
     }
-    lockImageResolutions.unlock();
 
     pDispatch.DestroyImage(device, image, pAllocator);
 }
@@ -89,12 +122,12 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
         // initialize the textures of both 2D and 3D layer if either is found since they share the same VkImage and resolution
         if (captureIdx == 0 || captureIdx == 2) {
             if (!layer2D) {
-                lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
+                if (const auto imageInfo = s_trackedImages.Find(image)) {
+                    StartupTimeline::ScopedStage stage("Layer textures and ImGui overlay");
                     auto viewConfs = VRManager::instance().XR->GetViewConfigurations();
 
-                    VkExtent2D renderRes = it->second.first;
-                    VkExtent2D swapchainRes = it->second.first;
+                    VkExtent2D renderRes = imageInfo->extent;
+                    VkExtent2D swapchainRes = imageInfo->extent;
                     if (VRManager::instance().XR->m_capabilities.isMetaSimulator) {
                         swapchainRes = VkExtent2D{ viewConfs[0].recommendedImageRectWidth, viewConfs[0].recommendedImageRectHeight };
                     }
@@ -115,14 +148,13 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
                         texture->Init(commandBuffer);
                     }
 
-                    Log::print<INFO>("Found rendering resolution {}x{} @ {} using capture #{}", renderRes.width, renderRes.height, it->second.second, captureIdx);
+                    Log::print<INFO>("Found rendering resolution {}x{} @ {} using capture #{}", renderRes.width, renderRes.height, imageInfo->format, captureIdx);
                     imguiOverlay = std::make_unique<RND_Renderer::ImGuiOverlay>(commandBuffer, renderRes, VK_FORMAT_A2B10G10R10_UNORM_PACK32);
                     VRManager::instance().Hooks->m_entityDebugger = std::make_unique<EntityDebugger>();
                 }
                 else {
                     checkAssert(false, "Couldn't find image resolution in map!");
                 }
-                lockImageResolutions.unlock();
             }
         }
 
@@ -152,13 +184,9 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
         if (captureIdx == 0) {
             // check if the color texture has the appropriate texture format
             if (s_curr3DColorImage == VK_NULL_HANDLE) {
-                lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
-                    if (it->second.second == VK_FORMAT_A2B10G10R10_UNORM_PACK32) {
-                        s_curr3DColorImage = it->first;
-                    }
+                if (const auto imageInfo = s_trackedImages.Find(image); imageInfo && imageInfo->classification == TrackedImageTable::ImageClass::Color3DCandidate) {
+                    s_curr3DColorImage = image;
                 }
-                lockImageResolutions.unlock();
             }
 
             // don't clear the image if we're in the faux 2D mode
@@ -168,7 +196,7 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
             }
 
             if (image != s_curr3DColorImage) {
-                Log::print<RENDERING>("Color image is not the same as the current 3D color image! ({} != {})", (void*)image, (void*)s_curr3DColorImage);
+                Log::print<RENDERING>("Color image is not the same as the current 3D color image! ({} != {})", (void*)image, (void*)s_curr3DColorImage.load());
                 returnToLayout();
                 return clearFramebuffer(!VRManager::instance().XR->GetRenderer()->IsRendering3D(frameIdx));
             }
@@ -188,10 +216,7 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
             SharedTexture* texture = layer3D->CopyColorToLayer(side, commandBuffer, image, frameIdx);
             renderer->On3DColorCopied(side, frameIdx);
 
-            {
-                std::lock_guard lk(s_activeCopyMutex);
-                s_activeCopyOperations.emplace_back(commandBuffer, texture);
-            }
+            QueueCopyOperation(commandBuffer, texture);
 
             if (CemuHooks::UseMonoFrameBufferTemporarilyDuringMenusOrPictures()) {
                 return;
@@ -242,10 +267,7 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
                     renderer->On2DCopied(frameIdx);
 
                     returnToLayout();
-                    {
-                        std::lock_guard lk(s_activeCopyMutex);
-                        s_activeCopyOperations.emplace_back(commandBuffer, texture);
-                    }
+                    QueueCopyOperation(commandBuffer, texture);
                     return;
                 }
             }
@@ -311,17 +333,13 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
         if (side == OpenXR::EyeSide::LEFT || side == OpenXR::EyeSide::RIGHT) {
             // 3D layer - depth texture for 3D rendering
             if (s_curr3DDepthImage == VK_NULL_HANDLE) {
-                lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
-                    if (it->second.second == VK_FORMAT_D32_SFLOAT) {
-                        s_curr3DDepthImage = it->first;
-                    }
+                if (const auto imageInfo = s_trackedImages.Find(image); imageInfo && imageInfo->classification == TrackedImageTable::ImageClass::Depth3DCandidate) {
+                    s_curr3DDepthImage = image;
                 }
-                lockImageResolutions.unlock();
             }
 
             if (image != s_curr3DDepthImage) {
-                Log::print<RENDERING>("Depth image is not the same as the current 3D depth image! ({} != {})", (void*)image, (void*)s_curr3DDepthImage);
+                Log::print<RENDERING>("Depth image is not the same as the current 3D depth image! ({} != {})", (void*)image, (void*)s_curr3DDepthImage.load());
                 returnToLayout();
                 return;
             }
@@ -344,10 +362,7 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
             SharedTexture* texture = layer3D->CopyDepthToLayer(side, commandBuffer, image, frameCounter);
             VRManager::instance().XR->GetRenderer()->On3DDepthCopied(side, frameCounter);
 
-            {
-                std::lock_guard lk(s_activeCopyMutex);
-                s_activeCopyOperations.emplace_back(commandBuffer, texture);
-            }
+            QueueCopyOperation(commandBuffer, texture);
             returnToLayout();
             return;
         }
@@ -359,122 +374,82 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
 
 VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkQueueDispatch& pDispatch, VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkFence fence) {
     VkResult result = VK_SUCCESS;
-    
-    size_t activeCopyCount;
-    {
-        std::lock_guard lk(s_activeCopyMutex);
-        activeCopyCount = s_activeCopyOperations.size();
-    }
 
-    if (activeCopyCount == 0) {
+    if (s_pendingCopyCount.load(std::memory_order_acquire) == 0) {
         result = pDispatch.QueueSubmit(queue, submitCount, pSubmits, fence);
     }
     else {
-        struct ModifiedSubmitInfo_t {
-            VkSubmitInfo submitInfoCopy; // Shadow copy of VkSubmitInfo
-            std::vector<VkSemaphore> waitSemaphores;
-            std::vector<uint64_t> timelineWaitValues;
-            std::vector<VkPipelineStageFlags> waitDstStageMasks;
-            std::vector<VkSemaphore> signalSemaphores;
-            std::vector<uint64_t> timelineSignalValues;
-
-            VkTimelineSemaphoreSubmitInfo timelineSemaphoreSubmitInfo = { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
-        };
-
-        // insert (possible) pipeline barriers for any active copy operations
-        std::vector<ModifiedSubmitInfo_t> modifiedSubmitInfos{ submitCount };
-        std::vector<VkSubmitInfo> shadowSubmits{ submitCount };
+        PendingCopyList pendingCopies = TakePendingCopies();
+        bool usedHeap = false;
+        result = RewriteSubmits(submitCount, pSubmits, pendingCopies, usedHeap, [&](const VkSubmitInfo* shadowSubmits) {
+            ReturnUnconsumedCopies(pendingCopies);
 
-        std::lock_guard lk(s_activeCopyMutex);
-
-        for (uint32_t i = 0; i < submitCount; i++) {
-            const VkSubmitInfo& submitInfo = pSubmits[i];
-            ModifiedSubmitInfo_t& modifiedSubmitInfo = modifiedSubmitInfos[i];
+            if (usedHeap && !s_loggedSubmitHeapFallback.exchange(true)) {
+                Log::print<WARNING>("QueueSubmit had to allocate to inject the interop semaphores ({} submits), consider raising the inline capacities", submitCount);
+            }
 
-            // AMD GPU FIX: Create shadow copy of original VkSubmitInfo
-            modifiedSubmitInfo.submitInfoCopy = submitInfo;
+            return pDispatch.QueueSubmit(queue, submitCount, shadowSubmits, fence);
+        });
+    }
 
-            // copy old semaphores into new vectors
-            modifiedSubmitInfo.waitSemaphores.assign(submitInfo.pWaitSemaphores, submitInfo.pWaitSemaphores + submitInfo.waitSemaphoreCount);
-            modifiedSubmitInfo.waitDstStageMasks.assign(submitInfo.pWaitDstStageMask, submitInfo.pWaitDstStageMask + submitInfo.waitSemaphoreCount);
-            modifiedSubmitInfo.timelineWaitValues.resize(submitInfo.waitSemaphoreCount, 0);
+    if (result != VK_SUCCESS) {
+        Log::print<ERROR>("QueueSubmit failed with error {}", result);
+    }
 
-            modifiedSubmitInfo.signalSemaphores.assign(submitInfo.pSignalSemaphores, submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount);
-            modifiedSubmitInfo.timelineSignalValues.resize(submitInfo.signalSemaphoreCount, 0);
+    return result;
+}
 
-            // find timeline semaphore submit info if already present
-            const VkTimelineSemaphoreSubmitInfo* existingTimelineInfo = nullptr;
+template <bool IsKHR>
+static VkResult QueueSubmit2Impl(const vkroots::VkQueueDispatch& pDispatch, VkQueue queue, uint32_t submitCount, const VkSubmitInfo2* pSubmits, VkFence fence) {
+    auto submit = [&](const VkSubmitInfo2* submits) {
+        if constexpr (IsKHR) {
+            return pDispatch.QueueSubmit2KHR(queue, submitCount, submits, fence);
+        }
+        else {
+            return pDispatch.QueueSubmit2(queue, submitCount, submits, fence);
+        }
+    };
 
-            const VkBaseInStructure* pNextIt = static_cast<const VkBaseInStructure*>(submitInfo.pNext);
-            while (pNextIt) {
-                if (pNextIt->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO) {
-                    existingTimelineInfo = reinterpret_cast<const VkTimelineSemaphoreSubmitInfo*>(pNextIt);
-                    break;
-                }
-                pNextIt = pNextIt->pNext;
-            }
+    VkResult result = VK_SUCCESS;
 
-            // copy any existing timeline values into new vectors
-            if (existingTimelineInfo) {
-                for (uint32_t j = 0; j < existingTimelineInfo->waitSemaphoreValueCount; j++) {
-                    modifiedSubmitInfo.timelineWaitValues[j] = existingTimelineInfo->pWaitSemaphoreValues[j];
-                }
-                for (uint32_t j = 0; j < existingTimelineInfo->signalSemaphoreValueCount; j++) {
-                    modifiedSubmitInfo.timelineSignalValues[j] = existingTimelineInfo->pSignalSemaphoreValues[j];
-                }
-            }
+    if (s_pendingCopyCount.load(std::memory_order_acquire) == 0) {
+        result = submit(pSubmits);
+    }
+    else {
+        PendingCopyList pendingCopies = TakePendingCopies();
+        bool usedHeap = false;
+        result = RewriteSubmits(submitCount, pSubmits, pendingCopies, usedHeap, [&](const VkSubmitInfo2* shadowSubmits) {
+            ReturnUnconsumedCopies(pendingCopies);
 
-            // Insert timeline semaphores for active copy operations
-            for (uint32_t j = 0; j < submitInfo.commandBufferCount; j++) {
-                for (auto it = s_activeCopyOperations.begin(); it != s_activeCopyOperations.end();) {
-                    if (submitInfo.pCommandBuffers[j] == it->first) {
-                        // Wait for D3D12/XR to finish with the previous shared texture render
-                        uint64_t waitValue = it->second->GetVulkanWaitValue();
-                        modifiedSubmitInfo.waitSemaphores.emplace_back(it->second->GetSemaphoreForWait(waitValue));
-                        modifiedSubmitInfo.waitDstStageMasks.emplace_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
-                        modifiedSubmitInfo.timelineWaitValues.emplace_back(waitValue);
-
-                        // Signal to D3D12/XR rendering that the shared texture can be rendered to VR headset
-                        uint64_t signalValue = it->second->GetVulkanSignalValue();
-                        modifiedSubmitInfo.signalSemaphores.emplace_back(it->second->GetSemaphoreForSignal(signalValue));
-                        modifiedSubmitInfo.timelineSignalValues.emplace_back(signalValue);
-                        it = s_activeCopyOperations.erase(it);
-                    }
-                    else {
-                        ++it;
-                    }
-                }
+            if (usedHeap && !s_loggedSubmitHeapFallback.exchange(true)) {
+                Log::print<WARNING>("QueueSubmit2 had to allocate to inject the interop semaphores ({} submits), consider raising the inline capacities", submitCount);
             }
 
-            // Update timeline semaphore submit info
-            modifiedSubmitInfo.timelineSemaphoreSubmitInfo.waitSemaphoreValueCount = (uint32_t)modifiedSubmitInfo.timelineWaitValues.size();
-            modifiedSubmitInfo.timelineSemaphoreSubmitInfo.pWaitSemaphoreValues = modifiedSubmitInfo.timelineWaitValues.data();
-            modifiedSubmitInfo.timelineSemaphoreSubmitInfo.signalSemaphoreValueCount = (uint32_t)modifiedSubmitInfo.timelineSignalValues.size();
-            modifiedSubmitInfo.timelineSemaphoreSubmitInfo.pSignalSemaphoreValues = modifiedSubmitInfo.timelineSignalValues.data();
-
-            // AMD GPU FIX: Preserve existing pNext chain - prepend our timeline struct
-            modifiedSubmitInfo.timelineSemaphoreSubmitInfo.pNext = submitInfo.pNext;
-
-            modifiedSubmitInfo.submitInfoCopy.pNext = &modifiedSubmitInfo.timelineSemaphoreSubmitInfo;
-            modifiedSubmitInfo.submitInfoCopy.waitSemaphoreCount = (uint32_t)modifiedSubmitInfo.waitSemaphores.size();
-            modifiedSubmitInfo.submitInfoCopy.pWaitSemaphores = modifiedSubmitInfo.waitSemaphores.data();
-            modifiedSubmitInfo.submitInfoCopy.pWaitDstStageMask = modifiedSubmitInfo.waitDstStageMasks.data();
-            modifiedSubmitInfo.submitInfoCopy.signalSemaphoreCount = (uint32_t)modifiedSubmitInfo.signalSemaphores.size();
-            modifiedSubmitInfo.submitInfoCopy.pSignalSemaphores = modifiedSubmitInfo.signalSemaphores.data();
-
-            shadowSubmits[i] = modifiedSubmitInfo.submitInfoCopy;
-        }
-        result = pDispatch.QueueSubmit(queue, submitCount, shadowSubmits.data(), fence);
+            return submit(shadowSubmits);
+        });
     }
 
     if (result != VK_SUCCESS) {
-        Log::print<ERROR>("QueueSubmit failed with error {}", result);
+        Log::print<ERROR>("QueueSubmit2 failed with error {}", result);
     }
 
     return result;
 }
 
+VkResult VkDeviceOverrides::QueueSubmit2(const vkroots::VkQueueDispatch& pDispatch, VkQueue queue, uint32_t submitCount, const VkSubmitInfo2* pSubmits, VkFence fence) {
+    return QueueSubmit2Impl<false>(pDispatch, queue, submitCount, pSubmits, fence);
+}
+
+VkResult VkDeviceOverrides::QueueSubmit2KHR(const vkroots::VkQueueDispatch& pDispatch, VkQueue queue, uint32_t submitCount, const VkSubmitInfo2* pSubmits, VkFence fence) {
+    return QueueSubmit2Impl<true>(pDispatch, queue, submitCount, pSubmits, fence);
+}
+
 VkResult VkDeviceOverrides::QueuePresentKHR(const vkroots::VkQueueDispatch& pDispatch, VkQueue queue, const VkPresentInfoKHR* pPresentInfo) {
+    // the OpenXR session might still be getting created on a worker thread, and a session becoming ready requires Vulkan to be set up
+    if (!VRManager::instance().IsInitialized()) {
+        return pDispatch.QueuePresentKHR(queue, pPresentInfo);
+    }
+
     VRManager::instance().XR->ProcessEvents();
 
     auto* renderer = VRManager::instance().XR->GetRenderer();
@@ -0,0 +1,176 @@
+#pragma once
+#include "pch.h"
+
+
+// Rumbles are described as an ADSR envelope with up to MAX_OSCILLATORS oscillators layered on top. Every curve is looked up in tables that are built once,
+// and a voice precomputes everything about its preset when it starts, so sampling a rumble each tick is just a few table lookups and multiplies.
+namespace HapticWaveforms {
+    constexpr uint32_t TABLE_SIZE = 256;
+    constexpr uint32_t MAX_OSCILLATORS = 2;
+    constexpr float HELD = std::numeric_limits<float>::infinity(); // hold until the voice is released
+    constexpr float PACKET_SECONDS = 0.03f; // slightly longer than a frame so that consecutive packets don't leave gaps
+
+    enum class Shape : uint8_t {
+        Flat,
+        Sine,          // 0 -> 1 -> 0 over one period
+        RisingSquare,  // t^2
+        FallingSquare, // (1 - t)^2
+        Count
+    };
+
+    // One period or ramp of every shape, with an extra entry at the end so that interpolating never has to wrap around
+    using Table = std::array<float, TABLE_SIZE + 1>;
+
+    inline const std::array<Table, (size_t)Shape::Count>& GetTables() {
+        static const std::array<Table, (size_t)Shape::Count> s_tables = [] {
+            std::array<Table, (size_t)Shape::Count> tables = {};
+            for (uint32_t i = 0; i <= TABLE_SIZE; i++) {
+                const float t = (float)i / (float)TABLE_SIZE;
+                tables[(size_t)Shape::Flat][i] = 1.0f;
+                tables[(size_t)Shape::Sine][i] = (sinf(t * 2.0f * glm::pi<float>()) + 1.0f) * 0.5f;
+                tables[(size_t)Shape::RisingSquare][i] = t * t;
+                tables[(size_t)Shape::FallingSquare][i] = (1.0f - t) * (1.0f - t);
+            }
+            return tables;
+        }();
+        return s_tables;
+    }
+
+    // position is in [0, 1]
+    inline float Sample(Shape shape, float position) {
+        const Table& table = GetTables()[(size_t)shape];
+        const float index = std::clamp(position, 0.0f, 1.0f) * (float)TABLE_SIZE;
+        const uint32_t i = std::min((uint32_t)index, TABLE_SIZE - 1);
+        return std::lerp(table[i], table[i + 1], index - (float)i);
+    }
+
+    // Attack rises from zero to full strength, decay falls to the sustain level, which is held for the hold time before the release fades it out.
+    // All times are in seconds.
+    struct Envelope {
+        float attack = 0.0f;
+        float decay = 0.0f;
+        float sustain = 1.0f;
+        float hold = 0.0f;
+        float release = 0.0f;
+    };
+
+    // Scales the envelope between 1 - depth and 1 as the shape repeats rate times per second
+    struct Oscillator {
+        Shape shape = Shape::Flat;
+        float rate = 0.0f;
+        float depth = 1.0f;
+    };
+
+    struct Preset {
+        Envelope envelope;
+        std::array<Oscillator, MAX_OSCILLATORS> oscillators = {};
+        uint32_t oscillatorCount = 0;
+        float frequency = 0.0f;
+        float amplitude = 0.0f;
+    };
+
+    struct Packet {
+        float frequency;
+        float amplitude;
+        float duration;
+    };
+
+    // The preset for an input rumble. The envelope and the oscillation scale both the strength and the frequency of the rumble,
+    // and rumbles that keep going until they're stopped hold their last level instead of ending.
+    inline Preset FromParameters(const RumbleParameters& params) {
+        const float duration = (float)params.effectDuration;
+        const float hold = params.keepRumblingOnEffectEnd ? HELD : 0.0f;
+        Preset preset = {};
+        preset.frequency = params.frequency;
+        preset.amplitude = params.amplitude;
+        switch (params.rumbleType) {
+            case RumbleType::Raising:
+                preset.envelope = { .attack = duration, .hold = hold };
+                break;
+            case RumbleType::Falling:
+                preset.envelope = { .decay = duration, .sustain = 0.0f, .hold = hold };
+                break;
+            case RumbleType::OscillationSmooth:
+                preset.envelope = { .hold = duration };
+                preset.oscillators[preset.oscillatorCount++] = { Shape::Sine, params.oscillationFrequency };
+                break;
+            case RumbleType::OscillationFallingSawtoothWave:
+                preset.envelope = { .hold = duration };
+                preset.oscillators[preset.oscillatorCount++] = { Shape::FallingSquare, params.oscillationFrequency };
+                break;
+            case RumbleType::OscillationRaisingSawtoothWave:
+                preset.envelope = { .hold = duration };
+                preset.oscillators[preset.oscillatorCount++] = { Shape::RisingSquare, params.oscillationFrequency };
+                break;
+            case RumbleType::Fixed:
+            default:
+                preset.envelope = { .hold = duration };
+                break;
+        }
+        return preset;
+    }
+
+    // A preset that's playing, time is in seconds since it started
+    class Voice {
+    public:
+        void Start(const Preset& preset) {
+            m_preset = preset;
+            const Envelope& envelope = preset.envelope;
+            m_invAttack = envelope.attack > 0.0f ? 1.0f / envelope.attack : 0.0f;
+            m_invDecay = envelope.decay > 0.0f ? 1.0f / envelope.decay : 0.0f;
+            m_invRelease = envelope.release > 0.0f ? 1.0f / envelope.release : 0.0f;
+            m_decayEnd = envelope.attack + envelope.decay;
+            m_releaseStart = m_decayEnd + envelope.hold;
+            m_releaseLevel = envelope.sustain;
+        }
+
+        // Starts the release early, for voices that are held or get stopped
+        void Release(float time) {
+            if (time >= m_releaseStart) {
+                return;
+            }
+            m_releaseLevel = HeldLevel(time);
+            m_releaseStart = time;
+        }
+
+        // How long the voice plays for, infinite while it's held
+        float Length() const {
+            return m_releaseStart + m_preset.envelope.release;
+        }
+
+        float Level(float time) const {
+            float level = time < m_releaseStart ? HeldLevel(time) : m_releaseLevel * Sample(Shape::FallingSquare, (time - m_releaseStart) * m_invRelease);
+            for (uint32_t i = 0; i < m_preset.oscillatorCount; i++) {
+                const Oscillator& oscillator = m_preset.oscillators[i];
+                const float phase = time * oscillator.rate;
+                level *= 1.0f - oscillator.depth + oscillator.depth * Sample(oscillator.shape, phase - floorf(phase));
+            }
+            return level;
+        }
+
+        Packet Render(float time) const {
+            const float level = Level(time);
+            return { m_preset.frequency * level, m_preset.amplitude * level, PACKET_SECONDS };
+        }
+
+    private:
+        float HeldLevel(float time) const {
+            const Envelope& envelope = m_preset.envelope;
+            if (time < envelope.attack) {
+                return Sample(Shape::RisingSquare, time * m_invAttack);
+            }
+            if (time < m_decayEnd) {
+                return envelope.sustain + (1.0f - envelope.sustain) * Sample(Shape::FallingSquare, (time - envelope.attack) * m_invDecay);
+            }
+            return envelope.sustain;
+        }
+
+        Preset m_preset = {};
+        float m_invAttack = 0.0f;
+        float m_invDecay = 0.0f;
+        float m_invRelease = 0.0f;
+        float m_decayEnd = 0.0f;
+        float m_releaseStart = 0.0f;
+        float m_releaseLevel = 0.0f;
+    };
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include "pch.h"
+#include "button_state.h"
+
+#include <bit>
+
+
+// The plain action -> VPAD button mappings, compiled into a table that's only re-evaluated for the sources that changed since the last frame.
+// Mappings that depend on the game state (running, riding, equipping from slots, ...) are still handled by the hook itself.
+// Everything that depends on time gets it passed in, so that a scripted sequence of inputs gives the same result every time it's replayed.
+namespace InputMapping {
+    using Clock = std::chrono::steady_clock;
+
+    enum class Source : uint8_t {
+        InventoryMap,
+        CrouchScope,
+        JumpCancel,
+        UseRune,
+        MenuBack,
+        MenuSelect,
+        MenuLeftTrigger,
+        MenuRightTrigger,
+        MenuHold,
+        Count
+    };
+
+    enum class Trigger : uint8_t {
+        Held,
+        ShortPress,
+        LongPress
+    };
+
+    enum class Context : uint8_t {
+        InGame,
+        InMenu
+    };
+
+    // Also the index of its binding, so that the hook can check which ones fired to update the game state alongside them
+    enum class Action : uint8_t {
+        Jump,
+        Scope,
+        OpenInventory,
+        OpenMap,
+        Crouch,
+        OpenRuneMenu,
+        UseRune,
+        MenuBack,
+        MenuSelect,
+        MenuPreviousTab,
+        MenuNextTab,
+        MenuHold,
+        Count
+    };
+
+    using ActionMask = uint32_t;
+    constexpr ActionMask Bit(Action action) { return 1u << (uint32_t)action; }
+
+    struct Binding {
+        Action action;
+        Context context;
+        Source source;
+        Trigger trigger;
+        VPADButtons button;
+        bool waitsForInputDelay; // ignored shortly after switching between the game and menus, so that the button that closed a menu doesn't also do something in-game
+    };
+
+    constexpr std::array BINDINGS = {
+        Binding{ Action::Jump, Context::InGame, Source::JumpCancel, Trigger::Held, VPAD_BUTTON_X, true },
+        Binding{ Action::Scope, Context::InGame, Source::CrouchScope, Trigger::LongPress, VPAD_BUTTON_STICK_R, true },
+        Binding{ Action::OpenInventory, Context::InGame, Source::InventoryMap, Trigger::ShortPress, VPAD_BUTTON_PLUS, true },
+        Binding{ Action::OpenMap, Context::InGame, Source::InventoryMap, Trigger::LongPress, VPAD_BUTTON_MINUS, true },
+        Binding{ Action::Crouch, Context::InGame, Source::CrouchScope, Trigger::ShortPress, VPAD_BUTTON_STICK_L, false },
+        Binding{ Action::OpenRuneMenu, Context::InGame, Source::UseRune, Trigger::LongPress, VPAD_BUTTON_UP, false },
+        Binding{ Action::UseRune, Context::InGame, Source::UseRune, Trigger::ShortPress, VPAD_BUTTON_L, false },
+        Binding{ Action::MenuBack, Context::InMenu, Source::MenuBack, Trigger::Held, VPAD_BUTTON_B, true },
+        Binding{ Action::MenuSelect, Context::InMenu, Source::MenuSelect, Trigger::Held, VPAD_BUTTON_A, false },
+        Binding{ Action::MenuPreviousTab, Context::InMenu, Source::MenuLeftTrigger, Trigger::Held, VPAD_BUTTON_L, false },
+        Binding{ Action::MenuNextTab, Context::InMenu, Source::MenuRightTrigger, Trigger::Held, VPAD_BUTTON_R, false },
+        Binding{ Action::MenuHold, Context::InMenu, Source::MenuHold, Trigger::ShortPress, VPAD_BUTTON_X, false },
+    };
+
+    constexpr bool IsIndexedByAction() {
+        for (size_t i = 0; i < BINDINGS.size(); i++) {
+            if ((size_t)BINDINGS[i].action != i) return false;
+        }
+        return BINDINGS.size() == (size_t)Action::Count && BINDINGS.size() <= sizeof(ActionMask) * 8;
+    }
+    static_assert(IsIndexedByAction(), "Every action needs exactly one binding at the index of the action");
+
+    // A source packed into a byte: whether it's held and the press event that it produced this frame
+    using SourceState = uint8_t;
+    using SourceStates = std::array<SourceState, (size_t)Source::Count>;
+
+    constexpr SourceState Pack(bool down, ButtonState::Event event) { return (SourceState)((down ? 1 : 0) | ((uint8_t)event << 1)); }
+
+    constexpr bool Matches(Trigger trigger, SourceState state) {
+        switch (trigger) {
+            case Trigger::Held: return (state & 1) != 0;
+            case Trigger::ShortPress: return (state >> 1) == (uint8_t)ButtonState::Event::ShortPress;
+            case Trigger::LongPress: return (state >> 1) == (uint8_t)ButtonState::Event::LongPress;
+        }
+        return false;
+    }
+    static_assert(Matches(Trigger::Held, Pack(true, ButtonState::Event::None)) && !Matches(Trigger::ShortPress, Pack(true, ButtonState::Event::LongPress)) && Matches(Trigger::LongPress, Pack(true, ButtonState::Event::LongPress)));
+
+    constexpr float AXIS_THRESHOLD = 0.5f;
+    constexpr float HOLD_THRESHOLD = 0.1f;
+    constexpr std::chrono::milliseconds START_BUTTON_HOLD_TIME{ 500 };
+
+    // Holds everything that the input hook needs to remember between frames
+    class Mapper {
+    public:
+        Mapper() {
+            for (const Binding& binding : BINDINGS) {
+                m_bindingsOfSource[(size_t)binding.source] |= Bit(binding.action);
+            }
+        }
+
+        // Returns the actions that are active this frame. Only the bindings of sources that changed are re-evaluated, unless the context changed.
+        ActionMask Update(const SourceStates& sources, Context context, bool inputDelayed) {
+            ActionMask dirty = 0;
+            if (!m_evaluatedOnce || context != m_lastContext || inputDelayed != m_lastInputDelayed) {
+                dirty = Bit(Action::Count) - 1;
+            }
+            else {
+                for (size_t source = 0; source < sources.size(); source++) {
+                    dirty |= sources[source] != m_lastSources[source] ? m_bindingsOfSource[source] : 0;
+                }
+            }
+            m_evaluatedOnce = true;
+            m_lastSources = sources;
+            m_lastContext = context;
+            m_lastInputDelayed = inputDelayed;
+            m_reevaluatedBindings += (uint64_t)std::popcount(dirty);
+
+            if (dirty == 0) {
+                return m_activeActions;
+            }
+
+            ActionMask active = m_activeActions & ~dirty;
+            for (ActionMask remaining = dirty; remaining != 0; remaining &= remaining - 1) {
+                const Binding& binding = BINDINGS[std::countr_zero(remaining)];
+                const bool allowed = binding.context == context && !(binding.waitsForInputDelay && inputDelayed);
+                active |= (allowed && Matches(binding.trigger, sources[(size_t)binding.source])) ? Bit(binding.action) : 0;
+            }
+
+            if (active != m_activeActions) {
+                m_activeActions = active;
+                m_activeButtons = 0;
+                for (ActionMask remaining = active; remaining != 0; remaining &= remaining - 1) {
+                    m_activeButtons |= BINDINGS[std::countr_zero(remaining)].button;
+                }
+            }
+            return m_activeActions;
+        }
+
+        uint32_t GetButtons() const { return m_activeButtons; }
+        uint64_t GetReevaluatedBindings() const { return m_reevaluatedBindings; }
+
+        // Holding the real gamepad's start button toggles the mod menu once per press
+        bool UpdateStartButton(bool down, Clock::time_point now) {
+            m_startButton.Update(down, now, START_BUTTON_HOLD_TIME);
+            if (m_startButton.longFired_actedUpon) {
+                m_startButton.longFired_actedUpon = false;
+                return true;
+            }
+            return false;
+        }
+
+        // Turns the sticks into the d-pad like emulated buttons, once a direction is held it stays held until the stick is almost centered again
+        VPADButtons UpdateStickEmulation(const XrVector2f& leftStick, const XrVector2f& rightStick) {
+            VPADButtons hold = VPAD_BUTTON_NONE;
+            auto axis = [&](float value, VPADButtons negative, VPADButtons positive) {
+                if (value <= -AXIS_THRESHOLD || (HAS_FLAG(m_stickHold, negative) && value <= -HOLD_THRESHOLD))
+                    hold |= negative;
+                else if (value >= AXIS_THRESHOLD || (HAS_FLAG(m_stickHold, positive) && value >= HOLD_THRESHOLD))
+                    hold |= positive;
+            };
+            axis(leftStick.x, VPAD_STICK_L_EMULATION_LEFT, VPAD_STICK_L_EMULATION_RIGHT);
+            axis(leftStick.y, VPAD_STICK_L_EMULATION_DOWN, VPAD_STICK_L_EMULATION_UP);
+            axis(rightStick.x, VPAD_STICK_R_EMULATION_LEFT, VPAD_STICK_R_EMULATION_RIGHT);
+            axis(rightStick.y, VPAD_STICK_R_EMULATION_DOWN, VPAD_STICK_R_EMULATION_UP);
+            m_stickHold = hold;
+            return hold;
+        }
+
+        struct Edges {
+            uint32_t trig;
+            uint32_t release;
+        };
+
+        Edges UpdateHold(uint32_t hold) {
+            const Edges edges = { hold & ~m_lastHold, ~hold & m_lastHold };
+            m_lastHold = hold;
+            return edges;
+        }
+
+    private:
+        std::array<ActionMask, (size_t)Source::Count> m_bindingsOfSource = {};
+        SourceStates m_lastSources = {};
+        Context m_lastContext = Context::InGame;
+        bool m_lastInputDelayed = false;
+        bool m_evaluatedOnce = false;
+        ActionMask m_activeActions = 0;
+        uint32_t m_activeButtons = 0;
+        uint64_t m_reevaluatedBindings = 0;
+
+        ButtonState m_startButton = {};
+        VPADButtons m_stickHold = VPAD_BUTTON_NONE;
+        uint32_t m_lastHold = 0;
+    };
+}
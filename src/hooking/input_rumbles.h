@@ -0,0 +1,87 @@
+#pragma once
+#include "pch.h"
+#include "utils/fixed_ring.h"
+#include "haptic_waveforms.h"
+
+
+// The rumbles that inputs trigger on each hand. Commands can come from several guest cores, so they're queued in a lock-free ring and
+// Update applies them on the input thread. Each hand is either idle, playing a rumble or playing a prioritized rumble:
+// a prioritized rumble ignores everything else until it ends, and a rumble of the same type as the one that's playing doesn't restart it.
+// Every rumble plays as a HapticWaveforms voice that's set up once from its parameters when it starts.
+class InputRumbleScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t QUEUE_CAPACITY = 16;
+
+    // Rumbles that aren't prioritized are only queued if nothing else is waiting to be applied
+    void Enqueue(const RumbleParameters& rumbleParameters) {
+        if (!rumbleParameters.prioritizeThisRumble && !m_commands.Empty()) {
+            return;
+        }
+        m_commands.TryPush(rumbleParameters);
+    }
+
+    // Needs to be called from the same thread as Update
+    void Stop(int hand, RumbleType rumbleType, Clock::time_point now) {
+        HandState& state = m_hands[hand & 1];
+        if (state.active && state.prioritized && rumbleType == state.rumbleType) {
+            const float elapsed = Seconds(now - state.startTime);
+            state.voice.Release(elapsed);
+            state.active = elapsed < state.voice.Length();
+            state.endTime = EndTime(state);
+        }
+    }
+
+    // Passes a packet for every hand that's rumbling to sink(size_t hand, const HapticWaveforms::Packet& packet)
+    template <typename Sink>
+    void Update(Clock::time_point now, Sink&& sink) {
+        for (HandState& state : m_hands) {
+            state.active = state.active && now < state.endTime;
+        }
+
+        RumbleParameters cmd;
+        while (m_commands.TryPop(cmd)) {
+            HandState& state = m_hands[cmd.hand & 1];
+            if (state.active && (state.prioritized || state.rumbleType == cmd.rumbleType)) {
+                continue;
+            }
+
+            state.active = true;
+            state.prioritized = cmd.prioritizeThisRumble;
+            state.rumbleType = cmd.rumbleType;
+            state.voice.Start(HapticWaveforms::FromParameters(cmd));
+            state.startTime = now;
+            state.endTime = EndTime(state);
+        }
+
+        for (size_t hand = 0; hand < 2; hand++) {
+            const HandState& state = m_hands[hand];
+            if (state.active) {
+                sink(hand, state.voice.Render(Seconds(now - state.startTime)));
+            }
+        }
+    }
+
+private:
+    struct HandState {
+        bool active = false;
+        bool prioritized = false;
+        RumbleType rumbleType = RumbleType::Fixed;
+        Clock::time_point startTime;
+        Clock::time_point endTime;
+        HapticWaveforms::Voice voice;
+    };
+
+    static float Seconds(Clock::duration duration) {
+        return std::chrono::duration<float>(duration).count();
+    }
+
+    static Clock::time_point EndTime(const HandState& state) {
+        const float length = state.voice.Length();
+        return length == HapticWaveforms::HELD ? Clock::time_point::max() : state.startTime + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(length));
+    }
+
+    FixedRing<RumbleParameters, QUEUE_CAPACITY> m_commands;
+    std::array<HandState, 2> m_hands = {}; // 0 = left, 1 = right
+};
@@ -13,6 +13,14 @@ namespace {
         return false;
     }
 
+    // The OpenXR instance is created on a worker thread during vkCreateInstance, and vkCreateInstance can return before waiting on it,
+    // so the GPU filtering hooks wait for it themselves. Returns nullptr if OpenXR failed to start, in which case every GPU is left alone.
+    const LUID* getVRAdapterLUID() {
+        VRManager::JoinInstanceStage();
+        const auto& xr = VRManager::instance().XR;
+        return xr ? &xr->m_capabilities.adapter : nullptr;
+    }
+
     // Helper to query functions from the Vulkan loader without adding a new link dependency
     template <typename TFunc>
     TFunc getLoaderFunction(const char* name) {
@@ -145,6 +153,9 @@ VkResult VRLayer::VkInstanceOverrides::CreateInstance(PFN_vkCreateInstance creat
         return VK_ERROR_INITIALIZATION_FAILED;
     }
 
+    // start creating the OpenXR instance while Cemu's Vulkan instance is being created
+    VRManager::BeginInstanceStage();
+
     // Check if we should skip all diagnostic/validation code (for compatibility)
     const bool skipDiagnostics = isEnvEnabled("BETTERVR_SKIP_DIAGNOSTICS");
     if (skipDiagnostics) {
@@ -354,6 +365,7 @@ VkResult VRLayer::VkInstanceOverrides::CreateInstance(PFN_vkCreateInstance creat
         }
     }
 
+    VRManager::JoinInstanceStage();
     VRManager::instance().vkVersion = modifiedCreateInfo.pApplicationInfo->apiVersion;
 
     Log::print<INFO>("Created Vulkan instance (using Vulkan {}.{}.{}) successfully!", VK_API_VERSION_MAJOR(modifiedCreateInfo.pApplicationInfo->apiVersion), VK_API_VERSION_MINOR(modifiedCreateInfo.pApplicationInfo->apiVersion), VK_API_VERSION_PATCH(modifiedCreateInfo.pApplicationInfo->apiVersion));
@@ -371,6 +383,7 @@ VkResult VRLayer::VkInstanceOverrides::EnumeratePhysicalDevices(const vkroots::V
 
     VkPhysicalDevice matchedDevice = VK_NULL_HANDLE;
     VkPhysicalDevice fallbackDevice = VK_NULL_HANDLE;
+    const LUID* vrAdapter = getVRAdapterLUID();
 
     for (const VkPhysicalDevice& device : internalDevices) {
         VkPhysicalDeviceIDProperties deviceId = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES };
@@ -378,7 +391,7 @@ VkResult VRLayer::VkInstanceOverrides::EnumeratePhysicalDevices(const vkroots::V
         properties.pNext = &deviceId;
         pDispatch.GetPhysicalDeviceProperties2(device, &properties);
 
-        if (deviceId.deviceLUIDValid && memcmp(&VRManager::instance().XR->m_capabilities.adapter, deviceId.deviceLUID, VK_LUID_SIZE) == 0) {
+        if (vrAdapter && deviceId.deviceLUIDValid && memcmp(vrAdapter, deviceId.deviceLUID, VK_LUID_SIZE) == 0) {
             matchedDevice = device;
             break;
         }
@@ -443,7 +456,8 @@ void VRLayer::VkInstanceOverrides::GetPhysicalDeviceProperties(const vkroots::Vk
         properties.pNext = &deviceId;
         pDispatch.GetPhysicalDeviceProperties2(physicalDevice, &properties);
 
-        if (deviceId.deviceLUIDValid && memcmp(&VRManager::instance().XR->m_capabilities.adapter, deviceId.deviceLUID, VK_LUID_SIZE) != 0) {
+        const LUID* vrAdapter = getVRAdapterLUID();
+        if (vrAdapter && deviceId.deviceLUIDValid && memcmp(vrAdapter, deviceId.deviceLUID, VK_LUID_SIZE) != 0) {
             pProperties->apiVersion = VK_API_VERSION_1_0;
         }
     }
@@ -458,7 +472,8 @@ void VRLayer::VkInstanceOverrides::GetPhysicalDeviceQueueFamilyProperties(const
     properties.pNext = &deviceId;
     pDispatch.GetPhysicalDeviceProperties2(physicalDevice, &properties);
 
-    if (deviceId.deviceLUIDValid && memcmp(&VRManager::instance().XR->m_capabilities.adapter, deviceId.deviceLUID, VK_LUID_SIZE) != 0) {
+    const LUID* vrAdapter = getVRAdapterLUID();
+    if (vrAdapter && deviceId.deviceLUIDValid && memcmp(vrAdapter, deviceId.deviceLUID, VK_LUID_SIZE) != 0) {
         *pQueueFamilyPropertyCount = 0;
         return;
     }
@@ -511,8 +526,10 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkPhysicalDev
 
     // Query supported features from the GPU
     VkPhysicalDeviceTimelineSemaphoreFeatures supportedTimelineSemaphoreFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES };
+    VkPhysicalDeviceSynchronization2Features supportedSynchronization2Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES };
     VkPhysicalDeviceFeatures2 supportedFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
-    supportedFeatures.pNext = &supportedTimelineSemaphoreFeatures;
+    supportedFeatures.pNext = &supportedSynchronization2Features;
+    supportedSynchronization2Features.pNext = &supportedTimelineSemaphoreFeatures;
 
 #if ENABLE_VK_ROBUSTNESS
     VkPhysicalDeviceImageRobustnessFeatures supportedImageRobustnessFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_ROBUSTNESS_FEATURES };
@@ -525,6 +542,7 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkPhysicalDev
 
     // Test if timeline semaphores are already enabled in the create info
     bool timelineSemaphoresEnabled = false;
+    std::optional<bool> synchronization2Enabled;
     bool imageRobustnessEnabled = false;
     bool robustness2Enabled = false;
     const void* current_pNext = pCreateInfo->pNext;
@@ -533,6 +551,12 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkPhysicalDev
         if (base->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES) {
             timelineSemaphoresEnabled = true;
         }
+        if (base->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES) {
+            synchronization2Enabled = reinterpret_cast<const VkPhysicalDeviceSynchronization2Features*>(base)->synchronization2 == VK_TRUE;
+        }
+        if (base->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES) {
+            synchronization2Enabled = reinterpret_cast<const VkPhysicalDeviceVulkan13Features*>(base)->synchronization2 == VK_TRUE;
+        }
 #if ENABLE_VK_ROBUSTNESS
         if (base->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_ROBUSTNESS_FEATURES) {
             imageRobustnessEnabled = true;
@@ -547,6 +571,9 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkPhysicalDev
     VkPhysicalDeviceTimelineSemaphoreFeatures createSemaphoreFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES };
     createSemaphoreFeatures.timelineSemaphore = true;
 
+    VkPhysicalDeviceSynchronization2Features createSynchronization2Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES };
+    createSynchronization2Features.synchronization2 = true;
+
     VkPhysicalDeviceImageRobustnessFeatures createImageRobustnessFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_ROBUSTNESS_FEATURES };
     createImageRobustnessFeatures.robustImageAccess = true;
 
@@ -582,6 +609,14 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkPhysicalDev
         Log::print<ERROR>("Timeline semaphores are not supported by this GPU! VR functionality may not work.");
     }
 
+    // synchronization2 allows the interop copies to use precise image barriers and vkQueueSubmit2 submissions to be rewritten
+    const bool synchronization2ExtEnabled = std::ranges::any_of(modifiedExtensions, [](const char* ext) { return std::strcmp(ext, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) == 0; });
+    if (!synchronization2Enabled.has_value() && synchronization2ExtEnabled && supportedSynchronization2Features.synchronization2) {
+        createSynchronization2Features.pNext = nextChain;
+        nextChain = &createSynchronization2Features;
+        synchronization2Enabled = true;
+    }
+
     VkDeviceCreateInfo modifiedCreateInfo = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
     modifiedCreateInfo.pNext = nextChain;
     modifiedCreateInfo.flags = pCreateInfo->flags;
@@ -620,6 +655,12 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkPhysicalDev
         return result;
     }
 
+    VRManager::instance().vkSynchronization2Enabled = synchronization2Enabled.value_or(false) && synchronization2ExtEnabled;
+    Log::print<INFO>("Synchronization2 is {}", VRManager::instance().vkSynchronization2Enabled ? "enabled, using precise barriers for interop copies" : "not available, using full barriers for interop copies");
+
+    // start creating the D3D12 device and OpenXR session in the background, the first frame joins it
+    VRManager::instance().BeginDeviceStage();
+
     // Initialize VRManager late if neither vkEnumeratePhysicalDevices and vkGetPhysicalDeviceProperties were called and used to filter the device
     if (!VRManager::instance().VK) {
         Log::print<WARNING>("Wasn't able to filter OpenXR-compatible devices for this instance!");
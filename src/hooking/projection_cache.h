@@ -0,0 +1,127 @@
+#pragma once
+#include "pch.h"
+
+
+// https://github.com/KhronosGroup/OpenXR-SDK/blob/858912260ca616f4c23f7fb61c89228c353eb124/src/common/xr_linear.h#L564C1-L632C2
+// https://github.com/aboood40091/sead/blob/45b629fb032d88b828600a1b787729f2d398f19d/engine/library/modules/src/gfx/seadProjection.cpp#L166
+
+static data_VRProjectionMatrixOut calculateFOVAndOffset(XrFovf viewFOV) {
+    float totalHorizontalFov = viewFOV.angleRight - viewFOV.angleLeft;
+    float totalVerticalFov = viewFOV.angleUp - viewFOV.angleDown;
+
+    float aspectRatio = totalHorizontalFov / totalVerticalFov;
+    float fovY = totalVerticalFov;
+    float projectionCenter_offsetX = (viewFOV.angleRight + viewFOV.angleLeft) / 2.0f;
+    float projectionCenter_offsetY = (viewFOV.angleUp + viewFOV.angleDown) / 2.0f;
+
+    data_VRProjectionMatrixOut ret = {};
+    ret.aspectRatio = aspectRatio;
+    ret.fovY = fovY;
+    ret.offsetX = projectionCenter_offsetX;
+    ret.offsetY = projectionCenter_offsetY;
+
+    return ret;
+}
+
+static glm::mat4 calculateProjectionMatrix(float nearZ, float farZ, const XrFovf& fov) {
+    float l = tanf(fov.angleLeft) * nearZ;
+    float r = tanf(fov.angleRight) * nearZ;
+    float b = tanf(fov.angleDown) * nearZ;
+    float t = tanf(fov.angleUp) * nearZ;
+
+    float invW = 1.0f / (r - l);
+    float invH = 1.0f / (t - b);
+    float invD = 1.0f / (farZ - nearZ);
+
+    glm::mat4 dst = {};
+    dst[0][0] = 2.0f * nearZ * invW;
+    dst[1][1] = 2.0f * nearZ * invH;
+    dst[0][2] = (r + l) * invW;
+    dst[1][2] = (t + b) * invH;
+    dst[2][2] = -(farZ + nearZ) * invD;
+    dst[2][3] = -(2.0f * farZ * nearZ) * invD;
+    dst[3][2] = -1.0f;
+    dst[3][3] = 0.0f;
+
+    return dst;
+}
+
+// Overwrites the projection with the one for the eye's field of view, keeping the game's clip distances and device depth range
+static void applyVRProjection(BESeadPerspectiveProjection& perspectiveProjection, const XrFovf& currFOV) {
+    auto newProjection = calculateFOVAndOffset(currFOV);
+
+    perspectiveProjection.aspect = newProjection.aspectRatio;
+    perspectiveProjection.fovYRadiansOrAngle = newProjection.fovY;
+    float halfAngle = newProjection.fovY.getLE() * 0.5f;
+    perspectiveProjection.fovySin = sinf(halfAngle);
+    perspectiveProjection.fovyCos = cosf(halfAngle);
+    perspectiveProjection.fovyTan = tanf(halfAngle);
+    perspectiveProjection.offset.x = newProjection.offsetX;
+    perspectiveProjection.offset.y = newProjection.offsetY;
+
+    glm::fmat4 newMatrix = calculateProjectionMatrix(perspectiveProjection.zNear.getLE(), perspectiveProjection.zFar.getLE(), currFOV);
+    perspectiveProjection.matrix = newMatrix;
+
+    // calculate device matrix
+    glm::fmat4 newDeviceMatrix = newMatrix;
+
+    float zScale = perspectiveProjection.deviceZScale.getLE();
+    float zOffset = perspectiveProjection.deviceZOffset.getLE();
+
+    newDeviceMatrix[2][0] *= zScale;
+    newDeviceMatrix[2][1] *= zScale;
+    newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * zOffset) * zScale;
+    newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * zScale + newDeviceMatrix[3][3] * zOffset;
+
+    perspectiveProjection.deviceMatrix = newDeviceMatrix;
+
+    perspectiveProjection.dirty = false;
+    perspectiveProjection.deviceDirty = false;
+}
+
+// The projection hooks run several times per eye per frame, but their inputs rarely change. So every eye keeps the finished projections for its last few inputs,
+// keyed on every field that applyVRProjection doesn't overwrite, which makes a hit return the exact same bytes as calculating it again.
+class ProjectionCache {
+public:
+    static constexpr size_t ENTRIES_PER_EYE = 4;
+
+    void Apply(uint8_t side, BESeadPerspectiveProjection& perspectiveProjection, const XrFovf& fov) {
+        const Key key = GetKey(perspectiveProjection, fov);
+        for (const Entry& entry : m_entries[side]) {
+            if (entry.valid && entry.key == key) {
+                perspectiveProjection = entry.projection;
+                return;
+            }
+        }
+
+        applyVRProjection(perspectiveProjection, fov);
+        m_entries[side][m_nextEntry[side]] = { true, key, perspectiveProjection };
+        m_nextEntry[side] = (m_nextEntry[side] + 1) % ENTRIES_PER_EYE;
+    }
+
+private:
+    // raw bits of the field of view followed by every field that's kept as is, so that -0.0f and NaNs are only equal to themselves
+    using Key = std::array<uint32_t, 11>;
+
+    static Key GetKey(const BESeadPerspectiveProjection& perspectiveProjection, const XrFovf& fov) {
+        Key key = {};
+        memcpy(&key[0], &fov, sizeof(XrFovf));
+        memcpy(&key[4], &perspectiveProjection.zNear, sizeof(float));
+        memcpy(&key[5], &perspectiveProjection.zFar, sizeof(float));
+        memcpy(&key[6], &perspectiveProjection.deviceZScale, sizeof(float));
+        memcpy(&key[7], &perspectiveProjection.deviceZOffset, sizeof(float));
+        memcpy(&key[8], &perspectiveProjection.devicePosture, sizeof(uint32_t));
+        memcpy(&key[9], &perspectiveProjection.__vftable, sizeof(uint32_t));
+        memcpy(&key[10], &perspectiveProjection.pad0, sizeof(uint8_t) * 2);
+        return key;
+    }
+    static_assert(sizeof(XrFovf) == sizeof(uint32_t) * 4);
+
+    struct Entry {
+        bool valid = false;
+        Key key = {};
+        BESeadPerspectiveProjection projection = {};
+    };
+    std::array<std::array<Entry, ENTRIES_PER_EYE>, 2> m_entries = {};
+    std::array<size_t, 2> m_nextEntry = {};
+};
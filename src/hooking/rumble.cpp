@@ -21,4 +21,4 @@ void CemuHooks::hook_XRRumble_VPADStopMotor(PPCInterpreter_t* hCPU) {
     uint32_t channel = hCPU->gpr[3];
 
     VRManager::instance().XR->GetRumbleManager()->stopMotor();
-}
\ No newline at end of file
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include "pch.h"
+#include "utils/fixed_ring.h"
+
+
+// VPAD rumble patterns are at most 120 bits where every 2 bits are one 60 Hz step, so a whole pattern fits into a single 64-bit mask
+struct RumblePattern {
+    static constexpr uint8_t MAX_STEPS = 60;
+
+    uint64_t steps = 0;
+    uint8_t stepCount = 0;
+    uint32_t stopGeneration = 0; // which stopMotor call this pattern came after
+
+    static RumblePattern Pack(const uint8_t* pattern, uint8_t length) {
+        RumblePattern packed = {};
+        length = std::min<uint8_t>(length, MAX_STEPS * 2);
+        for (uint32_t bit = 0; bit < length; bit += 2) {
+            const bool set = (pattern[bit / 8] & (3 << (bit % 8))) != 0;
+            packed.steps |= (uint64_t)set << packed.stepCount;
+            packed.stepCount++;
+        }
+        return packed;
+    }
+};
+
+// Plays the VPAD rumble patterns one step per tick. The game pushes patterns and stops the motor from its own thread while the rumble thread ticks,
+// so both sides only touch the lock-free command ring and the stop counter. Stopping discards every pattern that was pushed before it.
+// The rumble thread only ticks while a pattern is playing and otherwise sleeps on a signal that pushing and stopping change.
+class RumblePatternPlayer {
+public:
+    // Patterns that can wait behind the one that's playing, anything beyond that is dropped
+    static constexpr size_t QUEUE_CAPACITY = 4;
+    static constexpr auto TICK_PERIOD = std::chrono::milliseconds(1000 / 60);
+
+    bool Push(const uint8_t* pattern, uint8_t length) {
+        RumblePattern packed = RumblePattern::Pack(pattern, length);
+        packed.stopGeneration = m_stopGeneration.load(std::memory_order_acquire);
+        if (!m_commands.TryPush(packed)) {
+            return false;
+        }
+        Wake();
+        return true;
+    }
+
+    void Stop() {
+        m_stopGeneration.fetch_add(1, std::memory_order_acq_rel);
+        Wake();
+    }
+
+    // Doesn't block, the waiting thread gets woken up by the OS
+    void Wake() {
+        m_signal.fetch_add(1, std::memory_order_release);
+        m_signal.notify_one();
+    }
+
+    // Plays patterns until shutdown is set, which has to be followed by a call to Wake. setMotor(bool on) is only called when the motor should change.
+    template <typename SetMotor>
+    void Run(const std::atomic<bool>& shutdown, SetMotor&& setMotor) {
+        bool motorOn = false;
+        auto nextTick = std::chrono::steady_clock::now();
+        while (true) {
+            // anything that's pushed after this changes the signal, so the wait below can't miss it
+            const uint32_t signal = m_signal.load(std::memory_order_acquire);
+            if (shutdown.load()) {
+                break;
+            }
+
+            const std::optional<bool> step = Tick();
+            if (step.value_or(false) != motorOn) {
+                motorOn = step.value_or(false);
+                setMotor(motorOn);
+            }
+
+            if (step.has_value()) {
+                nextTick += TICK_PERIOD;
+                std::this_thread::sleep_until(nextTick);
+            }
+            else {
+                m_signal.wait(signal, std::memory_order_acquire);
+                nextTick = std::chrono::steady_clock::now();
+            }
+            m_wakeups.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // How often the thread in Run woke up, to check that it doesn't while there's nothing to play
+    uint64_t GetWakeups() const {
+        return m_wakeups.load(std::memory_order_relaxed);
+    }
+
+    // Returns whether the motor should be on for this step, or nothing when no pattern is playing
+    std::optional<bool> Tick() {
+        const uint32_t stopGeneration = m_stopGeneration.load(std::memory_order_acquire);
+        if (stopGeneration != m_seenStopGeneration) {
+            m_seenStopGeneration = stopGeneration;
+            m_playing = false;
+        }
+
+        RumblePattern next;
+        while (!m_playing && m_commands.TryPop(next)) {
+            if (next.stopGeneration == stopGeneration && next.stepCount != 0) {
+                m_current = next;
+                m_step = 0;
+                m_playing = true;
+            }
+        }
+        if (!m_playing) {
+            return std::nullopt;
+        }
+
+        const bool on = ((m_current.steps >> m_step) & 1) != 0;
+        if (++m_step >= m_current.stepCount) {
+            m_playing = false;
+        }
+        return on;
+    }
+
+private:
+    FixedRing<RumblePattern, QUEUE_CAPACITY> m_commands;
+    std::atomic<uint32_t> m_stopGeneration = 0;
+    std::atomic<uint32_t> m_signal = 0;
+    std::atomic<uint64_t> m_wakeups = 0;
+
+    // only used by the ticking thread
+    uint32_t m_seenStopGeneration = 0;
+    RumblePattern m_current = {};
+    uint8_t m_step = 0;
+    bool m_playing = false;
+};
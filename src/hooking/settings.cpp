@@ -2,57 +2,94 @@
 #include "imgui_internal.h"
 #include "instance.h"
 #include "hooking/entity_debugger.h"
+#include "hooking/actor_jobs.h"
+#include "utils/environment.h"
+#include "utils/settings_store.h"
+#include "utils/settings_profiles.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+static SettingsStore& GetSettingsStore() {
+    static SettingsStore s_store;
+    return s_store;
+}
+
+std::shared_ptr<const ModSettings> GetSettings() {
+    return GetSettingsStore().Get();
+}
+
+static SettingsProfiles& GetSettingsProfiles() {
+    static SettingsProfiles s_profiles(GetSettingsStore());
+    return s_profiles;
+}
+
+// Every change outside of the profiles is a change to the user's own settings
+void UpdateSettings(const std::function<void(ModSettings&)>& update) {
+    GetSettingsProfiles().Update(update);
+}
 
-ModSettings g_settings = {};
+// Reloads the profiles whenever Windows reports a change in their folder. Editors tend to save a file in several steps,
+// so the reload waits until the folder has been quiet for SETTLE_TIME. Runs once per frame from hook_UpdateSettings,
+// which makes the new settings apply between frames.
+static void PollSettingsProfiles(const std::function<SettingsProfiles::Target()>& getTarget) {
+    static constexpr auto SETTLE_TIME = std::chrono::milliseconds(250);
+    static constexpr auto RETRY_INTERVAL = std::chrono::seconds(2);
+    static const std::filesystem::path s_folder = GetCemuDirectory() / "BetterVR_profiles";
+    static HANDLE s_changes = INVALID_HANDLE_VALUE;
+    static std::chrono::steady_clock::time_point s_nextRetry = {};
+    static std::chrono::steady_clock::time_point s_changedAt = {};
+    static bool s_pending = false;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (s_changes == INVALID_HANDLE_VALUE) {
+        // the folder might not exist yet
+        if (now < s_nextRetry) {
+            return;
+        }
+        s_nextRetry = now + RETRY_INTERVAL;
+        s_changes = FindFirstChangeNotificationW(s_folder.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE);
+        if (s_changes == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        s_pending = true;
+        s_changedAt = now - SETTLE_TIME;
+    }
+    else if (WaitForSingleObject(s_changes, 0) == WAIT_OBJECT_0) {
+        s_pending = true;
+        s_changedAt = now;
+        if (!FindNextChangeNotification(s_changes)) {
+            // the folder got removed, so its profiles are reloaded as gone
+            FindCloseChangeNotification(s_changes);
+            s_changes = INVALID_HANDLE_VALUE;
+        }
+    }
 
-ModSettings& GetSettings() {
-    return g_settings;
+    if (s_pending && now - s_changedAt >= SETTLE_TIME) {
+        s_pending = false;
+        GetSettingsProfiles().Apply(SettingsProfiles::LoadFolder(s_folder), getTarget());
+    }
 }
 
 static void* Settings_ReadOpen(ImGuiContext*, ImGuiSettingsHandler*, const char* name) {
     if (strcmp(name, "Settings") != 0)
         return nullptr;
-    return &GetSettings();
+    // every line gets published as its own update, so there's no entry to parse into
+    return &GetSettingsStore();
 }
 
 static void Settings_ReadLine(ImGuiContext*, ImGuiSettingsHandler*, void* entry, const char* line) {
-    auto* s = (ModSettings*)entry;
-    int i_val;
-    float f_val;
-    if (sscanf(line, "CameraMode=%d", &i_val) == 1)      { s->cameraMode.store((CameraMode)i_val); return; }
-    if (sscanf(line, "PlayMode=%d", &i_val) == 1)        { s->playMode.store((PlayMode)i_val); return; }
-    if (sscanf(line, "ThirdPlayerDistance=%f", &f_val) == 1) { s->thirdPlayerDistance.store(f_val); return; }
-    if (sscanf(line, "CutsceneCameraMode=%d", &i_val) == 1) { s->cutsceneCameraMode.store((EventMode)i_val); return; }
-    if (sscanf(line, "UseBlackBarsForCutscenes=%d", &i_val) == 1) { s->useBlackBarsForCutscenes.store(i_val); return; }
-    if (sscanf(line, "PlayerHeightOffset=%f", &f_val) == 1) { s->playerHeightOffset.store(f_val); return; }
-    if (sscanf(line, "LeftHanded=%d", &i_val) == 1)      { s->leftHanded.store(i_val); return; }
-    if (sscanf(line, "UiFollowsGaze=%d", &i_val) == 1)   { s->uiFollowsGaze.store(i_val); return; }
-    if (sscanf(line, "CropFlatTo16x9=%d", &i_val) == 1)  { s->cropFlatTo16x9.store(i_val); return; }
-    if (sscanf(line, "EnableDebugOverlay=%d", &i_val) == 1) { s->enableDebugOverlay.store(i_val); return; }
-    if (sscanf(line, "BuggyAngularVelocity=%d", &i_val) == 1) { s->buggyAngularVelocity.store((AngularVelocityFixerMode)i_val); return; }
-    if (sscanf(line, "PerformanceOverlay=%d", &i_val) == 1) { s->performanceOverlay.store(i_val); return; }
-    if (sscanf(line, "PerformanceOverlayFrequency=%d", &i_val) == 1) { s->performanceOverlayFrequency.store(i_val); return; }
-    if (sscanf(line, "TutorialPromptShown=%d", &i_val) == 1) { s->tutorialPromptShown.store(i_val); return; }
+    UpdateSettings([&](ModSettings& settings) {
+        SettingsSchema::ParseLine(settings, line);
+    });
 }
 
 static void Settings_WriteAll(ImGuiContext* ctx, ImGuiSettingsHandler* handler, ImGuiTextBuffer* buf) {
-    auto& s = GetSettings();
-    buf->reserve(buf->size() + 1024);
+    const std::string lines = SettingsSchema::Serialize(GetSettingsProfiles().WithoutProfiles());
+    buf->reserve(buf->size() + (int)lines.size() + 64);
     buf->appendf("[%s][Settings]\n", handler->TypeName);
-    buf->appendf("CameraMode=%d\n", (int)s.cameraMode.load());
-    buf->appendf("PlayMode=%d\n", (int)s.playMode.load());
-    buf->appendf("ThirdPlayerDistance=%.3f\n", s.thirdPlayerDistance.load());
-    buf->appendf("CutsceneCameraMode=%d\n", (int)s.cutsceneCameraMode.load());
-    buf->appendf("UseBlackBarsForCutscenes=%d\n", (int)s.useBlackBarsForCutscenes.load());
-    buf->appendf("PlayerHeightOffset=%.3f\n", s.playerHeightOffset.load());
-    buf->appendf("LeftHanded=%d\n", (int)s.leftHanded.load());
-    buf->appendf("UiFollowsGaze=%d\n", (int)s.uiFollowsGaze.load());
-    buf->appendf("CropFlatTo16x9=%d\n", (int)s.cropFlatTo16x9.load());
-    buf->appendf("EnableDebugOverlay=%d\n", (int)s.enableDebugOverlay.load());
-    buf->appendf("BuggyAngularVelocity=%d\n", (int)s.buggyAngularVelocity.load());
-    buf->appendf("PerformanceOverlay=%d\n", (int)s.performanceOverlay.load());
-    buf->appendf("PerformanceOverlayFrequency=%d\n", s.performanceOverlayFrequency.load());
-    buf->appendf("TutorialPromptShown=%d\n", (int)s.tutorialPromptShown.load());
+    buf->append(lines.data(), lines.data() + lines.size());
     buf->appendf("\n");
 }
 
@@ -126,8 +163,13 @@ void CemuHooks::hook_UpdateSettings(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
     uint32_t ppc_tableOfCutsceneEventSettings = hCPU->gpr[6];
+
+    PollSettingsProfiles([] {
+        const OpenXR::Capabilities& capabilities = VRManager::instance().XR->m_capabilities;
+        return SettingsProfiles::Target{ VRManager::instance().Hooks->gameMeta_getTitleId(), capabilities.runtimeName, capabilities.systemName };
+    });
     
-    if (GetSettings().ShowDebugOverlay() && VRManager::instance().Hooks->m_entityDebugger) {
+    if (GetSettings()->ShowDebugOverlay() && VRManager::instance().Hooks->m_entityDebugger) {
         VRManager::instance().Hooks->m_entityDebugger->UpdateEntityMemory();
     }
 
@@ -159,11 +201,17 @@ void CemuHooks::hook_UpdateSettings(PPCInterpreter_t* hCPU) {
 
     static bool logSettings = true;
     if (logSettings) {
-        Log::print<INFO>("VR Settings:\n{}", g_settings.ToString());
+        Log::print<INFO>("VR Settings:\n{}", GetSettings()->ToString());
         logSettings = false;
     }
 
     initCutsceneDefaultSettings(ppc_tableOfCutsceneEventSettings);
+    // settings can change at any time, so the camera mode is resolved again every frame
+    ResolveActiveEvent();
+}
+
+std::filesystem::path CemuHooks::GetEventOverridesPath() {
+    return GetCemuDirectory() / "BetterVR_event_overrides.txt";
 }
 
 void CemuHooks::hook_OSReportToConsole(PPCInterpreter_t* hCPU) {
@@ -183,6 +231,53 @@ void CemuHooks::hook_OSReportToConsole(PPCInterpreter_t* hCPU) {
 }
 
 constexpr uint32_t playerVtable = 0x101E5FFC;
+
+void ActorJobRules::Load() {
+    const std::filesystem::path filePath = GetCemuDirectory() / "BetterVR_actor_jobs.txt";
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        return;
+    }
+
+    std::vector<ActorJobRule> loadedRules;
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        const size_t comment = line.find('#');
+        std::istringstream entry(line.substr(0, comment));
+        std::string actorName, jobName, left, right, extra;
+        if (!(entry >> actorName)) {
+            continue;
+        }
+
+        std::optional<JobRoute> leftRoute, rightRoute;
+        if (entry >> jobName >> left >> right) {
+            leftRoute = ParseRoute(left);
+            rightRoute = ParseRoute(right);
+        }
+        if (!leftRoute || !rightRoute || (entry >> extra)) {
+            Log::print<WARNING>("{}:{}: Ignoring '{}', expected '<actor or *> <job> <run|skip|altered> <run|skip|altered>'", filePath.filename().string(), lineNumber, line);
+            continue;
+        }
+        loadedRules.push_back({ actorName == "*" ? "" : actorName, jobName, { *leftRoute, *rightRoute } });
+    }
+    s_rules.insert(s_rules.begin(), loadedRules.begin(), loadedRules.end());
+    Log::print<INFO>("Loaded {} actor job rules from {}", loadedRules.size(), filePath.string());
+}
+
+// Set BETTERVR_ACTOR_JOB_PROFILE=1 to run the actor jobs on both eyes and periodically write BetterVR_actor_jobs_report.txt.
+// Actors can update twice per frame while this is enabled, so it's only meant for finding out which jobs can be skipped.
+static ActorJobProfiler* GetActorJobProfiler() {
+    static ActorJobProfiler* s_profiler = [] () -> ActorJobProfiler* {
+        const char* value = std::getenv("BETTERVR_ACTOR_JOB_PROFILE");
+        if (!value || value[0] == '\0' || value[0] == '0') return nullptr;
+        Log::print<WARNING>("Profiling actor jobs, every job runs on both eyes until the game is restarted without BETTERVR_ACTOR_JOB_PROFILE");
+        return new ActorJobProfiler();
+    }();
+    return s_profiler;
+}
+
 void CemuHooks::hook_RouteActorJob(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
@@ -190,78 +285,41 @@ void CemuHooks::hook_RouteActorJob(PPCInterpreter_t* hCPU) {
     uint32_t jobName = hCPU->gpr[4];
     uint32_t side = hCPU->gpr[5]; // 0 = left, 1 = right
 
-    std::string jobNameStr = std::string((char*)(s_memoryBaseAddress + jobName));
+    std::string_view jobNameStr = (const char*)(s_memoryBaseAddress + jobName);
 
     ActorWiiU actor;
     readMemory(actorPtr, &actor);
     std::string actorName = actor.name.getLE();
 
-#define SKIP_ON_LEFT_SIDE if (side == 0) { hCPU->gpr[3] = 1; }
-#define SKIP_ON_RIGHT_SIDE if (side == 1) { hCPU->gpr[3] = 1; }
-#define USE_ALTERED_PATH_ON_LEFT_SIDE if (side == 0) { hCPU->gpr[3] = 2; }
-#define USE_ALTERED_PATH_ON_RIGHT_SIDE if (side == 1) { hCPU->gpr[3] = 2; }
-
-    hCPU->gpr[3] = 0;
-    if (actorName == "GameROMPlayer") {
-        if (jobNameStr == "job0_1") {
-            // this only runs the climbing portion of this actor job on the left eye's side
-            // so that later jobs on the left side can use the state set by this portion of code
-            USE_ALTERED_PATH_ON_LEFT_SIDE
-        }
-        else if (jobNameStr == "job0_2") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job1_1") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job1_2") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job2_1_ragdoll_related") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job2_2") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job4") {
-            SKIP_ON_RIGHT_SIDE
-        }
-    }
-    else {
-        if (jobNameStr == "job0_1") {
-            SKIP_ON_LEFT_SIDE
-        }
-        else if (jobNameStr == "job0_2") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job1_1") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job1_2") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job2_1_ragdoll_related") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job2_2") {
-            SKIP_ON_RIGHT_SIDE
-        }
-        else if (jobNameStr == "job4") {
-            SKIP_ON_RIGHT_SIDE
-        }
-    }
-
-    if (hCPU->gpr[3] == 0) {
-        //Log::print<INFO>("[{}] Ran {}", actorName, jobNameStr);
-    }
-    else if (hCPU->gpr[3] == 2) {
-        //Log::print<INFO>("[{}] Ran ALTERED VERSION of {}", actorName, jobNameStr);
+    JobRoute route = ActorJobRules::Get(actorName, jobNameStr, side);
+    if (ActorJobProfiler* profiler = GetActorJobProfiler(); profiler != nullptr && route != JobRoute::Altered) {
+        profiler->Begin(hCPU, actorName, jobNameStr, side, (const uint8_t*)(s_memoryBaseAddress + actorPtr));
+        route = JobRoute::RunAndMeasure;
     }
 
     // exit r3:
     // 1 = skip job
     // 0 = perform job
     // 2 = altered job
+    // 3 = perform job and call hook_RouteActorJobEnd afterwards
+    hCPU->gpr[3] = std::to_underlying(route);
+}
+
+void CemuHooks::hook_RouteActorJobEnd(PPCInterpreter_t* hCPU) {
+    hCPU->instructionPointer = hCPU->sprNew.LR;
+
+    ActorJobProfiler* profiler = GetActorJobProfiler();
+    if (profiler == nullptr) {
+        return;
+    }
+    profiler->End(hCPU);
+
+    static std::atomic<std::chrono::steady_clock::time_point> s_lastReport = std::chrono::steady_clock::now();
+    auto lastReport = s_lastReport.load();
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastReport > std::chrono::seconds(30) && s_lastReport.compare_exchange_strong(lastReport, now)) {
+        profiler->WriteReport(GetCemuDirectory() / "BetterVR_actor_jobs_report.txt");
+    }
 }
 
 // todo: this only runs when it's shown for the first time!
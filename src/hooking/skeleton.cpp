@@ -1,261 +1,293 @@
 #include "instance.h"
 #include "cemu_hooks.h"
 #include "rendering/openxr.h"
+#include "skeleton.h"
 
-struct Bone {
-    std::string name;
-    glm::vec3 localPos;
-    glm::vec3 localRotEuler; // in radians
-    glm::mat4 localMatrix;
-    glm::mat4 worldMatrix;
-    int parentIndex = -1;
-    std::vector<int> childrenIndices;
-    int indentLevel = 0;
-};
+static bool isFaceBone(const std::string_view& boneName) {
+    if (boneName.starts_with("Eye" /*lid*/) || boneName.starts_with("Cheek") || boneName.starts_with("Lip") || boneName.starts_with("Hair")) {
+        return true;
+    }
+    if (boneName == "Nose" || boneName == "Ponytail_A_1" || boneName == "Neck" || boneName == "Head" || boneName.starts_with("Teeth_") || boneName.starts_with("Chin")) {
+        return true;
+    }
+    return false;
+}
 
-class Skeleton {
-public:
-    void Parse(const std::string& data) {
-        m_bones.clear();
-        m_boneNameMap.clear();
+static Skeleton s_skeleton;
+static bool s_skeletonInitialized = false;
+static glm::vec3 s_manualBodyOffset = glm::vec3(0.0f, 0.0f, -0.125f);
+static glm::mat4 s_handCorrectionRotationLeft = glm::mat4(1.0f);
+static glm::mat4 s_handCorrectionRotationRight = glm::mat4(1.0f);
 
-        std::stringstream ss(data);
-        std::string line;
+static void InitSkeleton() {
+    s_skeletonInitialized = true;
 
-        // this parses the bone hierarchy using the indentation levels to calculate parent-child relationships and model space transforms
-        std::vector<std::pair<int, int>> parentStack;
-        parentStack.push_back({ -1, -1 }); // Root parent is -1
+    glm::fquat wristRotationHardcodedLeft = glm::identity<glm::fquat>();
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(90.0f), glm::fvec3(0, 1, 0));
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(-90.0f), glm::fvec3(0, 0, 1));
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(-45.0f), glm::fvec3(1, 0, 0));
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(45.0f), glm::fvec3(1, 0, 0));
 
-        while (std::getline(ss, line)) {
-            if (line.empty()) continue;
+    glm::fquat wristRotationHardcodedRight = glm::identity<glm::fquat>();
+    wristRotationHardcodedRight *= glm::angleAxis(glm::radians(-90.0f), glm::fvec3(0, 0, 1));
+    wristRotationHardcodedRight *= glm::angleAxis(glm::radians(-180.0f), glm::fvec3(0, 1, 0));
+    wristRotationHardcodedRight *= glm::angleAxis(glm::radians(270.0f), glm::fvec3(1, 0, 0));
 
-            int indent = 0;
-            while (indent < line.length() && line[indent] == ' ') indent++;
+    // slightly tweak it for a nicer alignment of the virtual hands
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(30.0f), glm::fvec3(0, 0, 1));
+    wristRotationHardcodedRight *= glm::angleAxis(glm::radians(30.0f), glm::fvec3(0, 0, 1));
 
-            size_t start = line.find_first_not_of(" \t");
-            if (start == std::string::npos) continue;
+    s_handCorrectionRotationLeft = glm::mat4_cast(wristRotationHardcodedLeft);
+    s_handCorrectionRotationRight = glm::mat4_cast(wristRotationHardcodedRight);
+}
+
+// The game calls hook_ModifyBoneMatrix once per bone of the player model. Instead of re-reading the player, camera and controller state and
+// re-solving the IK for every one of those calls, the whole pose is solved once per pass over the model and the hook only copies out its bone.
+// A new pass starts whenever a bone gets requested that has already been handed out since the last solve.
+struct PoseSolveCache {
+    std::array<glm::mat4x3, Skeleton::BONE_COUNT> boneMatrices = {};
+    std::array<bool, Skeleton::BONE_COUNT> boneWritable = {}; // whether the controller for the bone's side was tracked during the solve
+    std::array<bool, Skeleton::BONE_COUNT> boneServed = {};
+    bool solved = false;
+};
 
-            std::string content = line.substr(start);
-            size_t p1 = content.find('|');
-            if (p1 == std::string::npos) continue;
+struct BoneHookSlot {
+    enum class Kind : uint8_t {
+        Ignored,
+        Face,
+        Skeleton
+    };
 
-            std::string currentName = content.substr(0, p1);
-            size_t lastChar = currentName.find_last_not_of(' ');
-            if (lastChar != std::string::npos) currentName = currentName.substr(0, lastChar + 1);
+    std::string name;
+    Kind kind = Kind::Ignored;
+    int boneIndex = -1;
+};
 
-            size_t p2 = content.find('|', p1 + 1);
-            if (p2 == std::string::npos) continue;
+static PoseSolveCache s_poseCache;
 
-            glm::vec3 pos, rotEuler;
-            std::stringstream ssPos(content.substr(p1 + 1, p2 - p1 - 1));
-            ssPos >> pos.x >> pos.y >> pos.z;
-            std::stringstream ssRot(content.substr(p2 + 1));
-            ssRot >> rotEuler.x >> rotEuler.y >> rotEuler.z;
+// bone names are stored in the model resource, so their guest address is stable and can be used to skip the name lookups
+static std::unordered_map<uint32_t, BoneHookSlot> s_boneHookSlots;
 
-            Bone bone;
-            bone.name = currentName;
-            bone.localPos = pos;
-            bone.localRotEuler = rotEuler;
-            bone.indentLevel = indent;
-            bone.localMatrix = glm::translate(glm::identity<glm::mat4>(), pos) * glm::eulerAngleZYX(rotEuler.x, rotEuler.y, rotEuler.z);
+static const BoneHookSlot& GetBoneHookSlot(uint32_t boneNamePtr, std::string_view boneName) {
+    auto it = s_boneHookSlots.find(boneNamePtr);
+    if (it != s_boneHookSlots.end() && it->second.name == boneName) {
+        return it->second;
+    }
 
-            while (parentStack.size() > 1 && parentStack.back().first >= indent) {
-                parentStack.pop_back();
-            }
+    BoneHookSlot slot;
+    slot.name = std::string(boneName);
+    if (isFaceBone(boneName)) {
+        slot.kind = BoneHookSlot::Kind::Face;
+    }
+    else if (int boneIndex = SkeletonData::FindBone(boneName); boneIndex != -1) {
+        slot.kind = BoneHookSlot::Kind::Skeleton;
+        slot.boneIndex = boneIndex;
+    }
+    return s_boneHookSlots.insert_or_assign(boneNamePtr, std::move(slot)).first->second;
+}
 
-            bone.parentIndex = parentStack.back().second;
+// Opt-in trace of how long the bone hooks take in total for each pass over the player model.
+// Unlike the solve itself, which skeleton_tests times, this needs the game calling the hooks, so it stays in the layer.
+struct BoneHookTrace {
+    static constexpr uint32_t PASSES_PER_REPORT = 600;
+
+    const bool enabled = [] {
+        const char* value = std::getenv("BETTERVR_BONE_HOOK_TRACE");
+        return value && value[0] != '\0' && value[0] != '0';
+    }();
+    std::chrono::steady_clock::duration passTime = {};
+    std::chrono::steady_clock::duration totalTime = {};
+    std::chrono::steady_clock::duration maxPassTime = {};
+    uint32_t passCalls = 0;
+    uint32_t totalCalls = 0;
+    uint32_t passes = 0;
+
+    void EndPass() {
+        if (passCalls == 0) return;
+        totalTime += passTime;
+        totalCalls += passCalls;
+        maxPassTime = std::max(maxPassTime, passTime);
+        passTime = {};
+        passCalls = 0;
+
+        if (++passes == PASSES_PER_REPORT) {
+            using micros = std::chrono::duration<double, std::micro>;
+            Log::print<INFO>("Bone hooks: {:.2f} us per pass on average ({:.2f} us max, {} calls per pass)", micros(totalTime).count() / passes, micros(maxPassTime).count(), totalCalls / passes);
+            totalTime = {};
+            maxPassTime = {};
+            totalCalls = 0;
+            passes = 0;
+        }
+    }
+};
 
-            int newIndex = (int)m_bones.size();
-            if (bone.parentIndex != -1) {
-                m_bones[bone.parentIndex].childrenIndices.push_back(newIndex);
-            }
+static BoneHookTrace s_boneHookTrace;
 
-            m_bones.push_back(bone);
-            m_boneNameMap[bone.name] = newIndex;
+static void SolvePlayerPose() {
+    s_poseCache.boneServed.fill(false);
+    s_poseCache.solved = true;
 
-            parentStack.push_back({ indent, newIndex });
-        }
+    // get player data
+    const glm::fmat4 playerMtx4 = glm::fmat4(CemuHooks::getMemory<BEMatrix34>(CemuHooks::s_playerMtxAddress).getLEMatrix());
+    const glm::fmat4 invPlayerMtx4 = glm::inverse(playerMtx4);
 
-        UpdateWorldMatrices();
-    }
+    // get camera data
+    const glm::mat4 cameraMtx = CemuHooks::s_lastCameraMtx;
 
-    void UpdateWorldMatrices() {
-        for (auto& bone : m_bones) {
-            if (bone.parentIndex == -1) {
-                bone.worldMatrix = bone.localMatrix;
-            }
-            else {
-                bone.worldMatrix = m_bones[bone.parentIndex].worldMatrix * bone.localMatrix;
-            }
-        }
-    }
+    // get vr controller positions and rotations
+    const OpenXR::InputState inputs = VRManager::instance().XR->m_input.load();
 
-    glm::mat4 CalculateLocalMatrixFromWorld(int boneIndex, const glm::mat4& targetWorldMatrix) {
-        if (boneIndex < 0 || boneIndex >= m_bones.size()) return glm::identity<glm::mat4>();
+    const int rootIndex = SkeletonData::SKL_ROOT;
 
-        const Bone& bone = m_bones[boneIndex];
-        if (bone.parentIndex == -1) {
-            return targetWorldMatrix;
-        }
+    Skeleton::UpperBodyTargets upperBodyTargets;
 
-        const glm::mat4& parentWorldMatrix = m_bones[bone.parentIndex].worldMatrix;
-        return glm::inverse(parentWorldMatrix) * targetWorldMatrix;
+    // override the root transform so the body aligns with the headset yaw
+    auto headsetPose = VRManager::instance().XR->GetRenderer()->GetMiddlePose();
+    glm::mat4 s_headsetMtx = headsetPose.value_or(ToMat4(glm::fvec3(0)));
+
+    // calculate eye offset from eyeball bones, and from the head bone that the spine bends towards
+    static glm::vec3 eyeOffset = glm::vec3(0.0f);
+    static glm::vec3 eyeOffsetFromHead = glm::vec3(0.0f);
+    static bool offsetCalculated = false;
+    if (!offsetCalculated) {
+        glm::vec3 eyePos = (s_skeleton.GetWorldMatrix(SkeletonData::EYEBALL_L)[3] + s_skeleton.GetWorldMatrix(SkeletonData::EYEBALL_R)[3]) * 0.5f;
+        eyeOffset = eyePos - s_skeleton.GetWorldMatrix(rootIndex)[3];
+        eyeOffsetFromHead = eyePos - s_skeleton.GetWorldMatrix(SkeletonData::HEAD)[3];
+        offsetCalculated = true;
     }
 
-    void SolveTwoBoneIK(int rootIdx, int midIdx, int endIdx, const glm::vec3& targetPos, const glm::vec3& poleVector, float boneForwardSign) {
-        if (rootIdx < 0 || rootIdx >= m_bones.size() ||
-            midIdx < 0 || midIdx >= m_bones.size() ||
-            endIdx < 0 || endIdx >= m_bones.size()) {
-            return;
-        }
+    // transform headset matrix to world space
+    glm::mat4 headsetWorld = cameraMtx * s_headsetMtx;
 
-        Bone& rootBone = m_bones[rootIdx];
-        Bone& midBone = m_bones[midIdx];
-        Bone& endBone = m_bones[endIdx];
+    // transform to model space (skeleton root space)
+    glm::mat4 headsetModel = invPlayerMtx4 * headsetWorld;
 
-        // get parent world matrix (clavicle)
-        glm::mat4 parentWorld = glm::identity<glm::mat4>();
-        if (rootBone.parentIndex != -1) {
-            parentWorld = m_bones[rootBone.parentIndex].worldMatrix;
-        }
+    // extract rotation
+    glm::quat headsetRot = glm::quat_cast(headsetModel);
 
-        glm::vec3 rootPos = glm::vec3(parentWorld * glm::vec4(rootBone.localPos, 1.0f));
+    // extract yaw (twist around y)
+    glm::vec3 axis(0, 1, 0);
+    glm::vec3 r(headsetRot.x, headsetRot.y, headsetRot.z);
+    float dot = glm::dot(r, axis);
+    glm::vec3 proj = axis * dot;
+    glm::quat yawRot(headsetRot.w, proj.x, proj.y, proj.z);
 
-        // get lengths
-        float l1 = glm::length(midBone.localPos);
-        float l2 = glm::length(endBone.localPos);
+    // normalize
+    float lenSq = glm::dot(yawRot, yawRot);
+    if (lenSq > 0.000001f) {
+        yawRot = yawRot * (1.0f / sqrtf(lenSq));
+    }
+    else {
+        yawRot = glm::identity<glm::quat>();
+    }
 
-        // solve IK
-        glm::vec3 dir = targetPos - rootPos;
-        float dist = glm::length(dir);
+    // how far the head is tilted away from looking straight ahead
+    const glm::quat headTilt = headsetRot * glm::inverse(yawRot);
 
-        // clamp distance
-        float epsilon = 0.001f;
-        dist = glm::clamp(dist, epsilon, l1 + l2 - epsilon);
+    // fix body inversion
+    yawRot = yawRot * glm::angleAxis(glm::radians(180.0f), glm::vec3(0, 1, 0));
 
-        // law of cosines for angle at shoulder (alpha)
-        float cosAlpha = (l1 * l1 + dist * dist - l2 * l2) / (2 * l1 * dist);
-        float alpha = glm::acos(glm::clamp(cosAlpha, -1.0f, 1.0f));
+    // calculate target position
+    // headset position in model space
+    glm::vec3 headsetPosModel = glm::vec3(headsetModel[3]);
+    // we want: rootpos + yawrot * eyeoffset = headsetpos
+    // so: rootpos = headsetpos - yawrot * eyeoffset
+    glm::vec3 targetPos = headsetPosModel - (yawRot * eyeOffset);
 
-        // plane construction
-        glm::vec3 dirNorm = glm::normalize(dir);
-        glm::vec3 planeNormal = glm::normalize(glm::cross(dirNorm, poleVector));
-        glm::vec3 ortho = glm::normalize(glm::cross(planeNormal, dirNorm));
+    // apply manual offset
+    targetPos += yawRot * s_manualBodyOffset;
 
-        // arm 1 direction (world)
-        glm::vec3 arm1Dir = glm::normalize(dirNorm * cos(alpha) + ortho * sin(alpha));
+    // update s_skeleton so that children bones (hands) are calculated correctly relative to the new root
+    s_skeleton.SetLocalMatrix(rootIndex, glm::mat4x3(glm::translate(glm::identity<glm::mat4>(), targetPos) * glm::mat4_cast(yawRot)));
+    const glm::quat rootRot = yawRot;
 
-        // arm 2 direction (world)
-        glm::vec3 elbowPos = rootPos + arm1Dir * l1;
-        glm::vec3 arm2Dir = glm::normalize(targetPos - elbowPos);
+    // bend the spine towards where the head would be with the headset's tilt, when looking straight ahead this matches the rest pose
+    upperBodyTargets.headPosition = headsetPosModel - headTilt * (yawRot * eyeOffsetFromHead) + yawRot * s_manualBodyOffset;
 
-        // construct rotation matrices
-        glm::vec3 x1 = arm1Dir * boneForwardSign;
-        glm::vec3 z1 = planeNormal;
-        glm::vec3 y1 = glm::cross(z1, x1);
-        glm::mat3 rot1World = glm::mat3(x1, -y1, -z1);
+    // solve the arm chains so the hands reach the vr controllers, and then align the wrist (and its weapon) with the controller pose
+    std::array<std::optional<glm::mat4>, 2> wristTargets;
+    for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        if (!inputs.shared.pose[side].isActive) {
+            continue;
+        }
 
-        glm::vec3 x2 = arm2Dir * boneForwardSign;
-        glm::vec3 z2 = planeNormal;
-        glm::vec3 y2 = glm::cross(z2, x2);
-        glm::mat3 rot2World = glm::mat3(x2, -y2, -z2);
+        const bool isLeft = side == OpenXR::EyeSide::LEFT;
+        const int wristIndex = SkeletonData::WRIST[side];
+        const int weaponIndex = SkeletonData::WEAPON[side];
 
-        // convert to local space
-        glm::mat4 arm1Local = glm::inverse(parentWorld) * glm::mat4(rot1World);
-        arm1Local[3] = glm::vec4(rootBone.localPos, 1.0f); // restore translation
+        const auto& pose = inputs.shared.poseLocation[side];
+        glm::fvec3 controllerPos = glm::fvec3();
+        glm::fquat controllerRot = glm::identity<glm::fquat>();
+        if (pose.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) {
+            controllerPos = ToGLM(pose.pose.position);
+        }
+        if (pose.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) {
+            controllerRot = ToGLM(pose.pose.orientation);
+        }
 
-        glm::mat4 arm1World = parentWorld * arm1Local;
-        glm::mat4 arm2Local = glm::inverse(arm1World) * glm::mat4(rot2World);
-        arm2Local[3] = glm::vec4(midBone.localPos, 1.0f); // restore translation
+        glm::mat4 handCorrectionMtx = isLeft ? s_handCorrectionRotationLeft : s_handCorrectionRotationRight;
 
-        // update skeleton
-        rootBone.localMatrix = arm1Local;
-        midBone.localMatrix = arm2Local;
-        UpdateWorldMatrices();
-    }
+        // construct controller matrix in tracking space
+        glm::mat4 controllerMat = glm::translate(glm::identity<glm::mat4>(), controllerPos) * glm::mat4_cast(controllerRot) * handCorrectionMtx;
 
-    int GetBoneIndex(const std::string& name) const {
-        auto it = m_boneNameMap.find(name);
-        if (it != m_boneNameMap.end()) return it->second;
-        return -1;
-    }
+        // transform to world space
+        // we treat the camera as the origin of the tracking space
+        glm::mat4 targetWorld = cameraMtx * controllerMat;
 
-    Bone* GetBone(int index) {
-        if (index < 0 || index >= m_bones.size()) return nullptr;
-        return &m_bones[index];
-    }
+        glm::vec3 weaponOffset = s_skeleton.GetLocalMatrix(weaponIndex)[3];
+        targetWorld = targetWorld * glm::translate(glm::identity<glm::mat4>(), -weaponOffset);
 
-    Bone* GetBone(const std::string& name) {
-        int idx = GetBoneIndex(name);
-        if (idx == -1) return nullptr;
-        return &m_bones[idx];
+        // convert targetWorld to model space
+        glm::mat4 targetModel = invPlayerMtx4 * targetWorld;
+
+        // pole vector (elbow direction)
+        // left: left-down-back, right: right-down-back
+        glm::vec3 poleDir = isLeft ? glm::vec3(1.0f, -1.0f, -0.5f) : glm::vec3(-1.0f, -1.0f, -0.5f);
+
+        // rotate pole vector by body rotation (Skl_Root)
+        upperBodyTargets.elbowPoles[side] = rootRot * poleDir;
+        upperBodyTargets.wristPositions[side] = glm::vec3(targetModel[3]);
+
+        wristTargets[side] = targetModel;
     }
 
-private:
-    std::vector<Bone> m_bones;
-    std::map<std::string, int> m_boneNameMap;
-};
+    s_skeleton.SolveUpperBody(upperBodyTargets);
 
-const std::string SKELETON_DATA = R"(
-Root | 0 0 0 | 0 0 0
-  Skl_Root | 0 0.99426 0 | 0 0 0
-    Spine_1 | 0 0 0 | 1.5708 0 1.5708
-      Spine_2 | 0.136 0 0 | 0 0 0
-        Clavicle_L | 0.23961 -0.00002 0.03291 | 0 -1.5708 0
-          Arm_1_L | 0.15 0 0.01074 | 0 0 0
-            Arm_1_Assist_L | 0.06 0.00002 0 | 0 0 0
-            Arm_2_L | 0.24 0 0 | 0 0 0
-              Elbow_L | 0.04151 -0.02934 0.00021 | 0 0 0
-              Wrist_Assist_L | 0.25809 0.00002 -0.00012 | 0 0 0
-              Wrist_L | 0.27718 0 0 | 0 0 0
-                Weapon_L | 0.1069 0.00002 0.02769 | 1.5708 0 3.14159
-          Clavicle_Assist_L | 0.116 0 0.0107 | 0 0 0
-        Clavicle_R | 0.2396 -0.00002 -0.03291 | 3.14159 -1.5708 0
-          Arm_1_R | -0.15 0 -0.01074 | 0 0 0
-            Arm_1_Assist_R | -0.06 -0.00002 0 | 0 0 0
-            Arm_2_R | -0.24 0 0 | 0 0 0
-              Elbow_R | -0.04151 0.02934 -0.0002 | 0 0 0
-              Wrist_Assist_R | -0.25809 -0.00002 0.00012 | 0 0 0
-              Wrist_R | -0.27718 0 0 | 0 0 0
-                Weapon_R | -0.1069 -0.00002 -0.02769 | 1.5708 0 0
-          Clavicle_Assist_R | -0.116 0 -0.0107 | 0 0 0
-        Neck | 0.26326 0 0 | 0 0 0
-          Head | 0.12447 0 0 | 0 0 0
-            Face_Root | 0 0 0 | 0 0 0
-              Chin | 0.04787 0.05757 0 | 0 0 2.53073
-              Eyeball_L | 0.07017 0.12036 0.04815 | 0 0 0
-              Eyeball_R | 0.07017 0.12036 -0.04815 | 0 0 0
-)";
-
-/*
-    Waist | 0 0 0 | 1.5708 0 -1.5708
-      Leg_1_L | 0.10854 0.0165 -0.11209 | 0 0 0
-        Knee_L | 0.39619 0.0308 0 | 0 0 0
-        Leg_2_L | 0.42 0 -0.08727 | 0 0 0
-      Leg_1_R | 0.10854 0.0165 0.11209 | 0 0 3.14159
-        Knee_R | -0.39619 -0.0308 0 | 0 0 0
-        Leg_2_R | -0.42 0 -0.08727 | 0 0 0
- */
+    // fill the cache with the solved local matrices, arm bones are only written if the controller for their side is being tracked
+    for (int i = 0; i < Skeleton::BONE_COUNT; i++) {
+        s_poseCache.boneMatrices[i] = s_skeleton.GetLocalMatrix(i);
 
-static bool isFaceBone(const std::string_view& boneName) {
-    if (boneName.starts_with("Eye" /*lid*/) || boneName.starts_with("Cheek") || boneName.starts_with("Lip") || boneName.starts_with("Hair")) {
-        return true;
+        const std::string_view boneName = s_skeleton.GetName(i);
+        if (boneName.ends_with("_L") || boneName.ends_with("_R")) {
+            const OpenXR::EyeSide side = boneName.ends_with("_L") ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
+            s_poseCache.boneWritable[i] = inputs.shared.pose[side].isActive;
+        }
+        else {
+            s_poseCache.boneWritable[i] = true;
+        }
     }
-    if (boneName == "Nose" || boneName == "Ponytail_A_1" || boneName == "Neck" || boneName == "Head" || boneName.starts_with("Teeth_") || boneName.starts_with("Chin")) {
-        return true;
+
+    // calculate local matrix to reach target model matrix
+    // note: this assumes the parent bones are in the pose defined by SkeletonData::SOURCE
+    for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        if (wristTargets[side]) {
+            const int wristIndex = SkeletonData::WRIST[side];
+            s_poseCache.boneMatrices[wristIndex] = glm::mat4x3(s_skeleton.CalculateLocalMatrixFromWorld(wristIndex, *wristTargets[side]));
+        }
     }
-    return false;
 }
 
-static Skeleton s_skeleton;
-static bool s_skeletonParsed = false;
-static glm::vec3 s_manualBodyOffset = glm::vec3(0.0f, 0.0f, -0.125f);
-static glm::mat4 s_handCorrectionRotationLeft = glm::mat4(1.0f);
-static glm::mat4 s_handCorrectionRotationRight = glm::mat4(1.0f);
-
 void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
+    const auto hookStart = s_boneHookTrace.enabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    auto endTrace = [hookStart]() {
+        if (s_boneHookTrace.enabled) {
+            s_boneHookTrace.passTime += std::chrono::steady_clock::now() - hookStart;
+            s_boneHookTrace.passCalls++;
+        }
+    };
+
     const uint32_t gsysModelPtr = hCPU->gpr[3];
     const uint32_t matrixPtr = hCPU->gpr[4];
     const uint32_t scalePtr = hCPU->gpr[5];
@@ -266,10 +298,7 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
     if (modelName.getLE() != "GameROMPlayer") return;
 
     // get bone data
-    std::string boneName((char*)(s_memoryBaseAddress + boneNamePtr));
-    const bool isLeft = boneName.ends_with("_L");
-    const OpenXR::EyeSide side = isLeft ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
-
+    const std::string_view boneName((char*)(s_memoryBaseAddress + boneNamePtr));
 
     if (IsThirdPerson()) {
         // head bones are set to 0.05, this just sets them back
@@ -281,8 +310,14 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
         return;
     }
 
+    if (!s_skeletonInitialized) {
+        InitSkeleton();
+    }
+
+    const BoneHookSlot& slot = GetBoneHookSlot(boneNamePtr, boneName);
+
     // reset face bones so they don't react to vr-driven poses
-    if (isFaceBone(boneName)) {
+    if (slot.kind == BoneHookSlot::Kind::Face) {
         BEMatrix34 finalMtx;
         finalMtx.setPos(glm::fvec3());
         finalMtx.setRotLE(glm::identity<glm::fquat>());
@@ -291,226 +326,26 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
         BEVec3 finalScale;
         finalScale = glm::fvec3(0.05);
         writeMemory(scalePtr, &finalScale);
-        return;
+        return endTrace();
     }
 
-    // get bone position data
-    glm::mat4x3 gameMtx = getMemory<BEMatrix34>(matrixPtr).getLEMatrix();
-    glm::vec3 bonePos = gameMtx[3];
-    glm::quat boneRot = glm::normalize(glm::quat_cast(glm::mat3(gameMtx)));
-    glm::fvec3 boneScale = getMemory<BEVec3>(scalePtr).getLE();
-
-    // get player data
-    const glm::fmat4 playerMtx4 = glm::fmat4(getMemory<BEMatrix34>(s_playerMtxAddress).getLEMatrix());
-    const glm::fmat4 playerPosMtx = glm::translate(glm::fmat4(1.0f), glm::fvec3(playerMtx4[3]));
-
-    // get camera data
-    glm::mat4 cameraMtx = s_lastCameraMtx;
-    glm::mat4 cameraPositionOnlyMtx = glm::translate(glm::identity<glm::fmat4>(), glm::fvec3(cameraMtx[3]));
-    glm::fquat cameraQuat = glm::quat_cast(cameraMtx);
-    glm::mat4 cameraRotationOnlyMtx = glm::mat4_cast(cameraQuat);
-
-    // get vr controller position and rotation
-    const OpenXR::InputState inputs = VRManager::instance().XR->m_input.load();
-    if (!inputs.shared.pose[side].isActive)
-        return;
-
-    const auto& pose = inputs.shared.poseLocation[side];
-    glm::fvec3 controllerPos = glm::fvec3();
-    glm::fquat controllerRot = glm::identity<glm::fquat>();
-    if (pose.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) {
-        controllerPos = ToGLM(pose.pose.position);
-    }
-    if (pose.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) {
-        controllerRot = ToGLM(pose.pose.orientation);
-    }
-
-    // initialize skeleton and hand correction rotations
-    if (!s_skeletonParsed) {
-        s_skeleton.Parse(SKELETON_DATA);
-        s_skeletonParsed = true;
-
-        glm::fquat wristRotationHardcodedLeft = glm::identity<glm::fquat>();
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(90.0f), glm::fvec3(0, 1, 0));
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(-90.0f), glm::fvec3(0, 0, 1));
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(-45.0f), glm::fvec3(1, 0, 0));
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(45.0f), glm::fvec3(1, 0, 0));
-
-        glm::fquat wristRotationHardcodedRight = glm::identity<glm::fquat>();
-        wristRotationHardcodedRight *= glm::angleAxis(glm::radians(-90.0f), glm::fvec3(0, 0, 1));
-        wristRotationHardcodedRight *= glm::angleAxis(glm::radians(-180.0f), glm::fvec3(0, 1, 0));
-        wristRotationHardcodedRight *= glm::angleAxis(glm::radians(270.0f), glm::fvec3(1, 0, 0));
-
-        // slightly tweak it for a nicer alignment of the virtual hands
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(30.0f), glm::fvec3(0, 0, 1));
-        wristRotationHardcodedRight *= glm::angleAxis(glm::radians(30.0f), glm::fvec3(0, 0, 1));
-
-        s_handCorrectionRotationLeft = glm::mat4_cast(wristRotationHardcodedLeft);
-        s_handCorrectionRotationRight = glm::mat4_cast(wristRotationHardcodedRight);
-    }
-
-    int boneIndex = s_skeleton.GetBoneIndex(boneName);
-    if (boneIndex == -1) {
-        return;
-    }
-    Bone* bone = s_skeleton.GetBone(boneIndex);
-
-    glm::mat4 calculatedLocalMat = bone->localMatrix;
-
-    // override the root transform so the body aligns with the headset yaw
-    if (boneName == "Skl_Root") {
-        auto headsetPose = VRManager::instance().XR->GetRenderer()->GetMiddlePose();
-        glm::mat4 s_headsetMtx = headsetPose.value_or(ToMat4(glm::fvec3(0)));
-
-        // calculate eye offset from eyeball bones
-        static glm::vec3 eyeOffset = glm::vec3(0.0f);
-        static bool offsetCalculated = false;
-        if (!offsetCalculated) {
-            Bone* eyeL = s_skeleton.GetBone("Eyeball_L");
-            Bone* eyeR = s_skeleton.GetBone("Eyeball_R");
-            Bone* sklRoot = s_skeleton.GetBone("Skl_Root");
-
-            if (eyeL && eyeR && sklRoot) {
-                glm::vec3 eyePos = (glm::vec3(eyeL->worldMatrix[3]) + glm::vec3(eyeR->worldMatrix[3])) * 0.5f;
-                glm::vec3 rootPos = glm::vec3(sklRoot->worldMatrix[3]);
-                eyeOffset = eyePos - rootPos;
-                offsetCalculated = true;
-            }
-        }
-
-        // transform headset matrix to world space
-        glm::mat4 headsetWorld = cameraMtx * s_headsetMtx;
-
-        // transform to model space (skeleton root space)
-        glm::mat4 headsetModel = glm::inverse(playerMtx4) * headsetWorld;
-
-        // extract rotation
-        glm::quat headsetRot = glm::quat_cast(headsetModel);
-
-        // extract yaw (twist around y)
-        glm::vec3 axis(0, 1, 0);
-        glm::vec3 r(headsetRot.x, headsetRot.y, headsetRot.z);
-        float dot = glm::dot(r, axis);
-        glm::vec3 proj = axis * dot;
-        glm::quat yawRot(headsetRot.w, proj.x, proj.y, proj.z);
-
-        // normalize
-        float lenSq = glm::dot(yawRot, yawRot);
-        if (lenSq > 0.000001f) {
-            yawRot = yawRot * (1.0f / sqrtf(lenSq));
-        }
-        else {
-            yawRot = glm::identity<glm::quat>();
-        }
-
-        // fix body inversion
-        yawRot = yawRot * glm::angleAxis(glm::radians(180.0f), glm::vec3(0, 1, 0));
-
-        // calculate target position
-        // headset position in model space
-        glm::vec3 headsetPosModel = glm::vec3(headsetModel[3]);
-        // we want: rootpos + yawrot * eyeoffset = headsetpos
-        // so: rootpos = headsetpos - yawrot * eyeoffset
-        glm::vec3 targetPos = headsetPosModel - (yawRot * eyeOffset);
-
-        // apply manual offset
-        targetPos += yawRot * s_manualBodyOffset;
-
-        // update s_skeleton so that children bones (hands) are calculated correctly relative to the new root
-        if (Bone* rootBone = s_skeleton.GetBone("Skl_Root")) {
-            rootBone->localMatrix = glm::translate(glm::identity<glm::mat4>(), targetPos) * glm::mat4_cast(yawRot);
-            s_skeleton.UpdateWorldMatrices();
-        }
-
-        BEMatrix34 finalMtx;
-        finalMtx.setPos(targetPos);
-        finalMtx.setRotLE(yawRot);
-        writeMemory(matrixPtr, &finalMtx);
-
-        BEVec3 finalScale;
-        finalScale = boneScale;
-        writeMemory(scalePtr, &finalScale);
-        return;
+    if (slot.kind != BoneHookSlot::Kind::Skeleton) {
+        return endTrace();
     }
 
-    // solve upper arm ik so the hands reach the vr controllers
-    if (boneName == "Arm_1_L" || boneName == "Arm_1_R" ||
-        boneName == "Elbow_L" || boneName == "Elbow_R" ||
-        boneName == "Wrist_Assist_L" || boneName == "Wrist_Assist_R") {
-        std::string arm1Name = isLeft ? "Arm_1_L" : "Arm_1_R";
-        std::string arm2Name = isLeft ? "Arm_2_L" : "Arm_2_R";
-        std::string wristName = isLeft ? "Wrist_L" : "Wrist_R";
-        std::string weaponName = isLeft ? "Weapon_L" : "Weapon_R";
-
-        int arm1Index = s_skeleton.GetBoneIndex(arm1Name);
-        int arm2Index = s_skeleton.GetBoneIndex(arm2Name);
-        int wristIndex = s_skeleton.GetBoneIndex(wristName);
-        Bone* weapon = s_skeleton.GetBone(weaponName);
-
-        if (arm1Index != -1 && arm2Index != -1 && wristIndex != -1) {
-            glm::mat4 handCorrectionMtx = isLeft ? s_handCorrectionRotationLeft : s_handCorrectionRotationRight;
-
-            // calculate target wrist world position
-            glm::mat4 controllerMat = glm::translate(glm::identity<glm::mat4>(), controllerPos) * glm::mat4_cast(controllerRot) * handCorrectionMtx;
-            glm::mat4 targetWorld = cameraMtx * controllerMat;
-
-            if (weapon) {
-                glm::vec3 weaponOffset = glm::vec3(weapon->localMatrix[3]);
-                targetWorld = targetWorld * glm::translate(glm::identity<glm::mat4>(), -weaponOffset);
-            }
-
-            // convert targetWorld to model space
-            glm::mat4 targetModel = glm::inverse(playerMtx4) * targetWorld;
-            glm::vec3 targetPos = glm::vec3(targetModel[3]);
-
-            // pole vector (elbow direction)
-            // left: left-down-back, right: right-down-back
-            glm::vec3 poleDir = isLeft ? glm::vec3(1.0f, -1.0f, -0.5f) : glm::vec3(-1.0f, -1.0f, -0.5f);
-
-            // rotate pole vector by body rotation (Skl_Root)
-            if (Bone* rootBone = s_skeleton.GetBone("Skl_Root")) {
-                glm::quat rootRot = glm::quat_cast(rootBone->localMatrix);
-                poleDir = rootRot * poleDir;
-            }
-
-            float forwardSign = isLeft ? 1.0f : -1.0f;
-
-            s_skeleton.SolveTwoBoneIK(arm1Index, arm2Index, wristIndex, targetPos, poleDir, forwardSign);
-
-            calculatedLocalMat = s_skeleton.GetBone(boneIndex)->localMatrix;
+    // solve the whole pose the first time a bone gets requested in this pass
+    if (!s_poseCache.solved || s_poseCache.boneServed[slot.boneIndex]) {
+        if (s_boneHookTrace.enabled) {
+            s_boneHookTrace.EndPass();
         }
+        SolvePlayerPose();
     }
+    s_poseCache.boneServed[slot.boneIndex] = true;
 
-    // align the wrist (and its weapon) with the controller pose.
-    if (boneName == "Wrist_L" || boneName == "Wrist_R") {
-        glm::mat4 handCorrectionMtx = isLeft ? s_handCorrectionRotationLeft : s_handCorrectionRotationRight;
-
-        // construct controller matrix in tracking space
-        glm::mat4 controllerMat = glm::translate(glm::identity<glm::mat4>(), controllerPos) * glm::mat4_cast(controllerRot) * handCorrectionMtx;
-
-        // transform to world space
-        // we treat the camera as the origin of the tracking space
-        glm::mat4 targetWorld = cameraMtx * controllerMat;
-
-        std::string weaponName = (boneName == "Wrist_L") ? "Weapon_L" : "Weapon_R";
-        if (Bone* weaponBone = s_skeleton.GetBone(weaponName)) {
-            glm::vec3 weaponOffset = glm::vec3(weaponBone->localMatrix[3]);
-            targetWorld = targetWorld * glm::translate(glm::identity<glm::mat4>(), -weaponOffset);
-        }
-
-        glm::mat4 targetModel = glm::inverse(playerMtx4) * targetWorld;
-
-        // calculate local matrix to reach target model matrix
-        // note: this assumes the parent bones are in the pose defined by SKELETON_DATA
-        calculatedLocalMat = s_skeleton.CalculateLocalMatrixFromWorld(boneIndex, targetModel);
+    if (s_poseCache.boneWritable[slot.boneIndex]) {
+        BEMatrix34 finalMatrix;
+        finalMatrix.setLEMatrix(s_poseCache.boneMatrices[slot.boneIndex]);
+        writeMemory(matrixPtr, &finalMatrix);
     }
-
-    glm::mat4x3 finalMtx = glm::mat4x3(calculatedLocalMat);
-    BEMatrix34 finalMatrix;
-    finalMatrix.setLEMatrix(finalMtx);
-    writeMemory(matrixPtr, &finalMatrix);
-
-    BEVec3 finalScale;
-    finalScale = boneScale;
-    writeMemory(scalePtr, &finalScale);
-}
\ No newline at end of file
+    return endTrace();
+}
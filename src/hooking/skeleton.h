@@ -0,0 +1,221 @@
+#pragma once
+#include "pch.h"
+#include "skeleton_data.h"
+#include "utils/ik_chain.h"
+
+
+// Bones are stored as a structure of arrays in the order of SkeletonData::BONES, which is a pre-order walk of the hierarchy.
+// That means that a parent always comes before its children and that every subtree is the contiguous range [bone, subtreeEnd).
+// Transforms are affine 4x3 matrices (glm::mat4x3, the same layout the game uses) so that there's no unused projective row to multiply.
+class Skeleton {
+public:
+    static constexpr int BONE_COUNT = (int)SkeletonData::BONE_COUNT;
+
+    Skeleton() {
+        for (int i = 0; i < BONE_COUNT; i++) {
+            const SkeletonData::BoneDef& bone = SkeletonData::BONES[i];
+            m_localPositions[i] = glm::vec3(bone.position[0], bone.position[1], bone.position[2]);
+            m_restLocalMatrices[i] = glm::mat4x3(glm::translate(glm::identity<glm::mat4>(), m_localPositions[i]) * glm::eulerAngleZYX(bone.rotation[0], bone.rotation[1], bone.rotation[2]));
+        }
+        m_localMatrices = m_restLocalMatrices;
+        UpdateAllWorldMatrices();
+    }
+
+    int GetBoneCount() const { return BONE_COUNT; }
+    int GetBoneIndex(std::string_view name) const { return SkeletonData::FindBone(name); }
+    int GetParentIndex(int boneIndex) const { return SkeletonData::BONES[boneIndex].parentIndex; }
+    std::string_view GetName(int boneIndex) const { return SkeletonData::BONES[boneIndex].name; }
+    const glm::vec3& GetLocalPosition(int boneIndex) const { return m_localPositions[boneIndex]; }
+    const glm::mat4x3& GetLocalMatrix(int boneIndex) const { return m_localMatrices[boneIndex]; }
+
+    const glm::mat4x3& GetWorldMatrix(int boneIndex) {
+        UpdateWorldMatrices();
+        return m_worldMatrices[boneIndex];
+    }
+
+    // marks the bone's whole subtree as dirty, the world matrices get recalculated the next time one of them is needed
+    void SetLocalMatrix(int boneIndex, const glm::mat4x3& localMatrix) {
+        m_localMatrices[boneIndex] = localMatrix;
+        m_dirtyBegin = std::min(m_dirtyBegin, boneIndex);
+        m_dirtyEnd = std::max(m_dirtyEnd, SkeletonData::BONES[boneIndex].subtreeEnd);
+    }
+
+    // only recomputes the range of bones that has been touched since the last update, which is usually just one or both arm chains
+    void UpdateWorldMatrices() {
+        for (int i = m_dirtyBegin; i < m_dirtyEnd; i++) {
+            const int parentIndex = SkeletonData::BONES[i].parentIndex;
+            m_worldMatrices[i] = parentIndex == -1 ? m_localMatrices[i] : MultiplyAffine(m_worldMatrices[parentIndex], m_localMatrices[i]);
+        }
+        m_dirtyBegin = INT_MAX;
+        m_dirtyEnd = 0;
+    }
+
+    // recomputes every bone regardless of what changed, used to set up the world matrices of the rest pose
+    void UpdateAllWorldMatrices() {
+        m_dirtyBegin = 0;
+        m_dirtyEnd = BONE_COUNT;
+        UpdateWorldMatrices();
+    }
+
+    glm::mat4 CalculateLocalMatrixFromWorld(int boneIndex, const glm::mat4& targetWorldMatrix) {
+        if (boneIndex < 0 || boneIndex >= GetBoneCount()) return glm::identity<glm::mat4>();
+
+        const int parentIndex = GetParentIndex(boneIndex);
+        if (parentIndex == -1) {
+            return targetWorldMatrix;
+        }
+
+        return glm::mat4(MultiplyAffine(InverseAffine(GetWorldMatrix(parentIndex)), glm::mat4x3(targetWorldMatrix)));
+    }
+
+    struct UpperBodyTargets {
+        std::optional<glm::vec3> headPosition;
+        std::array<std::optional<glm::vec3>, 2> wristPositions; // indexed by OpenXR::EyeSide
+        std::array<glm::vec3, 2> elbowPoles = {};
+    };
+
+    // Bends the spine so the head reaches its target, and then reaches both arms from the clavicles to the wrist targets.
+    // Everything is in model space, bones without a target keep their current pose.
+    void SolveUpperBody(const UpperBodyTargets& targets) {
+        if (targets.headPosition) {
+            // the neck and head get hidden as face bones in first-person, so the neck is moved to where it has to be for the head to reach its target
+            const glm::vec3 neckToHead = glm::vec3(GetWorldMatrix(SkeletonData::HEAD)[3]) - glm::vec3(GetWorldMatrix(SkeletonData::NECK)[3]);
+
+            SpineSolver::Chain chain;
+            chain.jointCount = SPINE_JOINTS;
+            chain.maxAngles = SPINE_MAX_ANGLES;
+            for (uint32_t i = 0; i < SPINE_JOINTS; i++) {
+                chain.positions[i][0] = GetWorldMatrix(SPINE_CHAIN[i])[3];
+                if (i + 1 < SPINE_JOINTS) {
+                    chain.segmentLengths[i][0] = glm::length(m_localPositions[SPINE_CHAIN[i + 1]]);
+                }
+            }
+            chain.baseDirections[0] = GetRestDirection(SPINE_CHAIN[0], SPINE_CHAIN[1]);
+            chain.targets[0] = *targets.headPosition - neckToHead;
+            SpineSolver::Solve(chain);
+
+            for (uint32_t i = 0; i + 1 < SPINE_JOINTS; i++) {
+                SwingTowards(SPINE_CHAIN[i], SPINE_CHAIN[i + 1], chain.positions[i + 1][0]);
+            }
+        }
+
+        if (!targets.wristPositions[0] && !targets.wristPositions[1]) {
+            return;
+        }
+
+        // both arms are solved together, an arm without a target just gets its current wrist position as the target
+        ArmSolver::Chain chain;
+        chain.jointCount = CHAIN_JOINTS;
+        chain.maxAngles = ARM_MAX_ANGLES;
+        for (size_t lane = 0; lane < 2; lane++) {
+            const auto& bones = ARM_CHAINS[lane];
+            for (uint32_t i = 0; i < CHAIN_JOINTS; i++) {
+                chain.positions[i][lane] = GetWorldMatrix(bones[i])[3];
+                if (i + 1 < CHAIN_JOINTS) {
+                    chain.segmentLengths[i][lane] = glm::length(m_localPositions[bones[i + 1]]);
+                }
+            }
+            chain.baseDirections[lane] = GetRestDirection(bones[0], bones[1]);
+            chain.targets[lane] = targets.wristPositions[lane].value_or(chain.positions[CHAIN_JOINTS - 1][lane]);
+
+            // nudge the elbow towards the pole so that the arm keeps bending in that direction
+            chain.positions[2][lane] += ArmSolver::SafeNormalize(targets.elbowPoles[lane], glm::vec3(0.0f)) * (0.25f * chain.segmentLengths[1][lane]);
+        }
+        ArmSolver::Solve(chain);
+
+        for (size_t lane = 0; lane < 2; lane++) {
+            if (!targets.wristPositions[lane]) {
+                continue;
+            }
+            const auto& bones = ARM_CHAINS[lane];
+            const glm::vec3 elbowPos = chain.positions[2][lane];
+            const glm::vec3 wristPos = chain.positions[3][lane];
+
+            SwingTowards(bones[0], bones[1], chain.positions[1][lane]);
+
+            // the upper and lower arm rotate in the plane that contains the shoulder, elbow and wrist
+            const glm::vec3 shoulderPos = GetWorldMatrix(bones[1])[3];
+            const glm::vec3 reachDir = ArmSolver::SafeNormalize(wristPos - shoulderPos, chain.baseDirections[lane]);
+            glm::vec3 bendDir = elbowPos - shoulderPos;
+            bendDir -= reachDir * glm::dot(bendDir, reachDir);
+            if (glm::dot(bendDir, bendDir) < 1e-8f) {
+                bendDir = targets.elbowPoles[lane];
+            }
+            const glm::vec3 planeNormal = ArmSolver::SafeNormalize(glm::cross(reachDir, bendDir), glm::vec3(0.0f, 0.0f, 1.0f));
+
+            const float forwardSign = lane == 0 ? 1.0f : -1.0f;
+            AlignHinge(bones[1], elbowPos, planeNormal, forwardSign);
+            AlignHinge(bones[2], wristPos, planeNormal, forwardSign);
+        }
+    }
+
+private:
+    static constexpr uint32_t CHAIN_JOINTS = 4;
+    static constexpr uint32_t SPINE_JOINTS = 3;
+    using SpineSolver = IKChainSolver<SPINE_JOINTS, 1>;
+    using ArmSolver = IKChainSolver<CHAIN_JOINTS, 2>;
+
+    // Spine_1 -> Spine_2 -> Neck, only allowed to bend a little so it follows the headset without folding over
+    static constexpr std::array<float, SPINE_JOINTS> SPINE_MAX_ANGLES = { glm::radians(8.0f), glm::radians(8.0f), 0.0f };
+    // Clavicle -> Arm_1 -> Arm_2 -> Wrist, the clavicle can shrug a bit while the shoulder and elbow get most of the range
+    static constexpr std::array<float, CHAIN_JOINTS> ARM_MAX_ANGLES = { glm::radians(15.0f), glm::radians(160.0f), glm::radians(150.0f), 0.0f };
+
+    static constexpr std::array<int, SPINE_JOINTS> SPINE_CHAIN = { SkeletonData::SPINE_1, SkeletonData::SPINE_2, SkeletonData::NECK };
+    static constexpr std::array<std::array<int, CHAIN_JOINTS>, 2> ARM_CHAINS = { {
+        { SkeletonData::CLAVICLE[0], SkeletonData::ARM_1[0], SkeletonData::ARM_2[0], SkeletonData::WRIST[0] },
+        { SkeletonData::CLAVICLE[1], SkeletonData::ARM_1[1], SkeletonData::ARM_2[1], SkeletonData::WRIST[1] },
+    } };
+
+    static_assert(SkeletonData::IsChain(SPINE_CHAIN) && SkeletonData::IsChain(ARM_CHAINS[0]) && SkeletonData::IsChain(ARM_CHAINS[1]), "IK chains have to be a direct line of parents and children");
+
+    glm::mat3 GetParentRotation(int boneIndex) {
+        const int parentIndex = GetParentIndex(boneIndex);
+        return parentIndex == -1 ? glm::mat3(1.0f) : glm::mat3(GetWorldMatrix(parentIndex));
+    }
+
+    // direction from the bone to its child if the bone were in its rest pose relative to its (current) parent
+    glm::vec3 GetRestDirection(int boneIndex, int childIndex) {
+        return glm::normalize(GetParentRotation(boneIndex) * glm::mat3(m_restLocalMatrices[boneIndex]) * m_localPositions[childIndex]);
+    }
+
+    // rotates the bone from its rest pose along the shortest arc so that its child ends up at the target, this doesn't drift over time unlike rotating from the current pose
+    void SwingTowards(int boneIndex, int childIndex, const glm::vec3& childTargetPos) {
+        const glm::mat3 parentRot = GetParentRotation(boneIndex);
+        const glm::mat3 restWorldRot = parentRot * glm::mat3(m_restLocalMatrices[boneIndex]);
+        const glm::vec3 restDir = glm::normalize(restWorldRot * m_localPositions[childIndex]);
+        const glm::vec3 newDir = SpineSolver::SafeNormalize(childTargetPos - GetWorldMatrix(boneIndex)[3], restDir);
+
+        glm::mat4x3 localMatrix = glm::mat4x3(glm::inverse(parentRot) * glm::mat3_cast(glm::quat(restDir, newDir)) * restWorldRot);
+        localMatrix[3] = m_localPositions[boneIndex];
+        SetLocalMatrix(boneIndex, localMatrix);
+    }
+
+    // points the bone's x axis at the target and its z axis along the bend plane's normal, which is how the arm bones are oriented
+    void AlignHinge(int boneIndex, const glm::vec3& targetPos, const glm::vec3& planeNormal, float boneForwardSign) {
+        const glm::mat3 parentRot = GetParentRotation(boneIndex);
+        const glm::vec3 x = ArmSolver::SafeNormalize(targetPos - GetWorldMatrix(boneIndex)[3], parentRot[0]) * boneForwardSign;
+        const glm::vec3 z = ArmSolver::SafeNormalize(planeNormal - x * glm::dot(planeNormal, x), parentRot[2]);
+        const glm::vec3 y = glm::cross(z, x);
+
+        glm::mat4x3 localMatrix = glm::mat4x3(glm::inverse(parentRot) * glm::mat3(x, -y, -z));
+        localMatrix[3] = m_localPositions[boneIndex];
+        SetLocalMatrix(boneIndex, localMatrix);
+    }
+
+    static glm::mat4x3 MultiplyAffine(const glm::mat4x3& a, const glm::mat4x3& b) {
+        const glm::mat3 rotA = glm::mat3(a);
+        return glm::mat4x3(rotA * b[0], rotA * b[1], rotA * b[2], rotA * b[3] + a[3]);
+    }
+
+    static glm::mat4x3 InverseAffine(const glm::mat4x3& m) {
+        const glm::mat3 invRot = glm::inverse(glm::mat3(m));
+        return glm::mat4x3(invRot[0], invRot[1], invRot[2], -(invRot * m[3]));
+    }
+
+    std::array<glm::vec3, BONE_COUNT> m_localPositions = {};
+    std::array<glm::mat4x3, BONE_COUNT> m_localMatrices = {};
+    std::array<glm::mat4x3, BONE_COUNT> m_restLocalMatrices = {};
+    std::array<glm::mat4x3, BONE_COUNT> m_worldMatrices = {};
+    int m_dirtyBegin = INT_MAX;
+    int m_dirtyEnd = 0;
+};
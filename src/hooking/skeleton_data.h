@@ -0,0 +1,200 @@
+#pragma once
+#include "pch.h"
+
+// The hierarchy and rest pose of the upper body of GameROMPlayer. Every line is "name | position | euler rotation (radians)" and the indentation
+// determines the parent, so the bones end up in pre-order: a parent always comes before its children and every subtree is a contiguous range.
+// This gets parsed at compile time so that there's no startup cost and so that bone indices can be used as constants in the hooks.
+namespace SkeletonData {
+    inline constexpr std::string_view SOURCE = R"(
+Root | 0 0 0 | 0 0 0
+  Skl_Root | 0 0.99426 0 | 0 0 0
+    Spine_1 | 0 0 0 | 1.5708 0 1.5708
+      Spine_2 | 0.136 0 0 | 0 0 0
+        Clavicle_L | 0.23961 -0.00002 0.03291 | 0 -1.5708 0
+          Arm_1_L | 0.15 0 0.01074 | 0 0 0
+            Arm_1_Assist_L | 0.06 0.00002 0 | 0 0 0
+            Arm_2_L | 0.24 0 0 | 0 0 0
+              Elbow_L | 0.04151 -0.02934 0.00021 | 0 0 0
+              Wrist_Assist_L | 0.25809 0.00002 -0.00012 | 0 0 0
+              Wrist_L | 0.27718 0 0 | 0 0 0
+                Weapon_L | 0.1069 0.00002 0.02769 | 1.5708 0 3.14159
+          Clavicle_Assist_L | 0.116 0 0.0107 | 0 0 0
+        Clavicle_R | 0.2396 -0.00002 -0.03291 | 3.14159 -1.5708 0
+          Arm_1_R | -0.15 0 -0.01074 | 0 0 0
+            Arm_1_Assist_R | -0.06 -0.00002 0 | 0 0 0
+            Arm_2_R | -0.24 0 0 | 0 0 0
+              Elbow_R | -0.04151 0.02934 -0.0002 | 0 0 0
+              Wrist_Assist_R | -0.25809 -0.00002 0.00012 | 0 0 0
+              Wrist_R | -0.27718 0 0 | 0 0 0
+                Weapon_R | -0.1069 -0.00002 -0.02769 | 1.5708 0 0
+          Clavicle_Assist_R | -0.116 0 -0.0107 | 0 0 0
+        Neck | 0.26326 0 0 | 0 0 0
+          Head | 0.12447 0 0 | 0 0 0
+            Face_Root | 0 0 0 | 0 0 0
+              Chin | 0.04787 0.05757 0 | 0 0 2.53073
+              Eyeball_L | 0.07017 0.12036 0.04815 | 0 0 0
+              Eyeball_R | 0.07017 0.12036 -0.04815 | 0 0 0
+)";
+
+    // not used yet since only the upper body is visible in first-person
+    /*
+        Waist | 0 0 0 | 1.5708 0 -1.5708
+          Leg_1_L | 0.10854 0.0165 -0.11209 | 0 0 0
+            Knee_L | 0.39619 0.0308 0 | 0 0 0
+            Leg_2_L | 0.42 0 -0.08727 | 0 0 0
+          Leg_1_R | 0.10854 0.0165 0.11209 | 0 0 3.14159
+            Knee_R | -0.39619 -0.0308 0 | 0 0 0
+            Leg_2_R | -0.42 0 -0.08727 | 0 0 0
+     */
+
+    struct BoneDef {
+        std::string_view name;
+        int parentIndex = -1;
+        int subtreeEnd = 0; // one past the last bone in this bone's subtree
+        std::array<float, 3> position = {};
+        std::array<float, 3> rotation = {};
+    };
+
+    namespace Parser {
+        constexpr bool IsSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        constexpr std::string_view Trim(std::string_view str) {
+            while (!str.empty() && IsSpace(str.front())) str.remove_prefix(1);
+            while (!str.empty() && IsSpace(str.back())) str.remove_suffix(1);
+            return str;
+        }
+
+        // parses plain decimals like -0.00002, which is all that the skeleton data uses
+        constexpr float ParseFloat(std::string_view& str) {
+            str = Trim(str);
+            bool negative = false;
+            if (!str.empty() && (str.front() == '-' || str.front() == '+')) {
+                negative = str.front() == '-';
+                str.remove_prefix(1);
+            }
+
+            double value = 0.0;
+            while (!str.empty() && str.front() >= '0' && str.front() <= '9') {
+                value = value * 10.0 + (str.front() - '0');
+                str.remove_prefix(1);
+            }
+            if (!str.empty() && str.front() == '.') {
+                str.remove_prefix(1);
+                double scale = 0.1;
+                while (!str.empty() && str.front() >= '0' && str.front() <= '9') {
+                    value += (str.front() - '0') * scale;
+                    scale *= 0.1;
+                    str.remove_prefix(1);
+                }
+            }
+            return (float)(negative ? -value : value);
+        }
+
+        constexpr std::array<float, 3> ParseVec3(std::string_view str) {
+            std::array<float, 3> result = {};
+            for (float& component : result) {
+                component = ParseFloat(str);
+            }
+            return result;
+        }
+
+        // calls the callback with the indentation and the three fields of every line that defines a bone
+        template <typename Callback>
+        constexpr void ForEachLine(std::string_view source, Callback&& callback) {
+            while (!source.empty()) {
+                const size_t lineEnd = source.find('\n');
+                std::string_view line = source.substr(0, lineEnd);
+                source.remove_prefix(lineEnd == std::string_view::npos ? source.size() : lineEnd + 1);
+
+                int indent = 0;
+                while (indent < (int)line.size() && line[indent] == ' ') indent++;
+
+                const std::string_view content = Trim(line);
+                const size_t p1 = content.find('|');
+                if (p1 == std::string_view::npos) continue;
+                const size_t p2 = content.find('|', p1 + 1);
+                if (p2 == std::string_view::npos) continue;
+
+                callback(indent, Trim(content.substr(0, p1)), content.substr(p1 + 1, p2 - p1 - 1), content.substr(p2 + 1));
+            }
+        }
+
+        constexpr size_t CountBones(std::string_view source) {
+            size_t count = 0;
+            ForEachLine(source, [&count](int, std::string_view, std::string_view, std::string_view) { count++; });
+            return count;
+        }
+
+        template <size_t Count>
+        constexpr std::array<BoneDef, Count> ParseBones(std::string_view source) {
+            std::array<BoneDef, Count> bones = {};
+            std::array<std::pair<int, int>, Count + 1> parentStack = {};
+            size_t stackSize = 1;
+            parentStack[0] = { -1, -1 }; // Root parent is -1
+            int boneCount = 0;
+
+            ForEachLine(source, [&](int indent, std::string_view name, std::string_view position, std::string_view rotation) {
+                while (stackSize > 1 && parentStack[stackSize - 1].first >= indent) {
+                    stackSize--;
+                }
+
+                const int newIndex = boneCount++;
+                bones[newIndex] = BoneDef{
+                    .name = name,
+                    .parentIndex = parentStack[stackSize - 1].second,
+                    .subtreeEnd = newIndex + 1,
+                    .position = ParseVec3(position),
+                    .rotation = ParseVec3(rotation)
+                };
+
+                // every bone that's still on the stack is an ancestor, so their subtrees grow to include this bone
+                for (size_t i = 1; i < stackSize; i++) {
+                    bones[parentStack[i].second].subtreeEnd = newIndex + 1;
+                }
+                parentStack[stackSize++] = { indent, newIndex };
+            });
+            return bones;
+        }
+    }
+
+    inline constexpr size_t BONE_COUNT = Parser::CountBones(SOURCE);
+    inline constexpr std::array<BoneDef, BONE_COUNT> BONES = Parser::ParseBones<BONE_COUNT>(SOURCE);
+
+    constexpr int FindBone(std::string_view name) {
+        for (size_t i = 0; i < BONES.size(); i++) {
+            if (BONES[i].name == name) return (int)i;
+        }
+        return -1;
+    }
+
+    // fails to compile if the bone doesn't exist, unlike FindBone
+    consteval int BoneIndex(std::string_view name) {
+        const int index = FindBone(name);
+        if (index == -1) throw "Bone doesn't exist in the skeleton data!";
+        return index;
+    }
+
+    // whether every bone is the direct child of the one before it
+    template <size_t N>
+    constexpr bool IsChain(const std::array<int, N>& bones) {
+        for (size_t i = 1; i < N; i++) {
+            if (BONES[bones[i]].parentIndex != bones[i - 1]) return false;
+        }
+        return true;
+    }
+
+    inline constexpr int SKL_ROOT = BoneIndex("Skl_Root");
+    inline constexpr int SPINE_1 = BoneIndex("Spine_1");
+    inline constexpr int SPINE_2 = BoneIndex("Spine_2");
+    inline constexpr int NECK = BoneIndex("Neck");
+    inline constexpr int HEAD = BoneIndex("Head");
+    inline constexpr int EYEBALL_L = BoneIndex("Eyeball_L");
+    inline constexpr int EYEBALL_R = BoneIndex("Eyeball_R");
+    inline constexpr std::array<int, 2> CLAVICLE = { BoneIndex("Clavicle_L"), BoneIndex("Clavicle_R") };
+    inline constexpr std::array<int, 2> ARM_1 = { BoneIndex("Arm_1_L"), BoneIndex("Arm_1_R") };
+    inline constexpr std::array<int, 2> ARM_2 = { BoneIndex("Arm_2_L"), BoneIndex("Arm_2_R") };
+    inline constexpr std::array<int, 2> WRIST = { BoneIndex("Wrist_L"), BoneIndex("Wrist_R") };
+    inline constexpr std::array<int, 2> WEAPON = { BoneIndex("Weapon_L"), BoneIndex("Weapon_R") };
+}
@@ -1,6 +1,13 @@
 #include "instance.h"
 #include "cemu_hooks.h"
+
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+
 #include "weapon.h"
+#include "utils/swept_collision.h"
+#include "utils/environment.h"
 
 
 std::array<WeaponMotionAnalyser, 2> CemuHooks::m_motionAnalyzers = {};
@@ -16,6 +23,106 @@ std::array s_cameraPositions = {
     glm::fvec3(0.0f)
 };
 
+static std::array<WeaponMotionRecorder, 2> s_motionRecorders;
+
+// Actors around the player that the held weapons are swept against, rebuilt once per frame
+static SweptCollision::SpatialHash<512> s_nearbyActors;
+
+struct WeaponCapsule {
+    uint32_t weaponPtr;
+    XrTime time;
+    glm::fvec3 base;
+    glm::fvec3 tip;
+    float radius;
+};
+static std::array<std::optional<WeaponCapsule>, 2> s_lastWeaponCapsules;
+
+// s_knownActors is only rebuilt when an actor gets created, so it can still hold actors that were deleted since.
+// Instead, walk the game's actor list every frame, which is a sead::OffsetList with the list node at the given offset inside each actor.
+static void UpdateNearbyActors() {
+    constexpr float MAX_ACTOR_DISTANCE = 10.0f;
+    constexpr float MAX_ACTOR_EXTENT = 20.0f; // anything larger is scenery that the weapon is always touching
+    constexpr uint32_t MAX_ACTORS = 4096;     // stops a list that's being changed by another core from being walked forever
+
+    s_nearbyActors.Clear();
+    const uint32_t listAddress = s_actorListAddress.load(std::memory_order_relaxed);
+    if (listAddress == 0) {
+        return;
+    }
+
+    const uint32_t count = std::min(CemuHooks::getMemory<BEType<uint32_t>>(listAddress + 0x08).getLE(), MAX_ACTORS);
+    const uint32_t nodeOffset = CemuHooks::getMemory<BEType<uint32_t>>(listAddress + 0x0C).getLE();
+    uint32_t node = CemuHooks::getMemory<BEType<uint32_t>>(listAddress + 0x04).getLE();
+    for (uint32_t i = 0; i < count && node != 0 && node != listAddress; i++, node = CemuHooks::getMemory<BEType<uint32_t>>(node + 0x04).getLE()) {
+        const uint32_t actorPtr = node - nodeOffset;
+        if (actorPtr == CemuHooks::s_playerAddress || actorPtr == CemuHooks::m_heldWeapons[0] || actorPtr == CemuHooks::m_heldWeapons[1]) {
+            continue;
+        }
+
+        BEVec3 aabbMin = CemuHooks::getMemory<BEVec3>(actorPtr + offsetof(ActorWiiU, aabb.minX));
+        BEVec3 aabbMax = CemuHooks::getMemory<BEVec3>(actorPtr + offsetof(ActorWiiU, aabb.maxX));
+        if (aabbMin.x.getLE() == 0.0f) {
+            continue;
+        }
+
+        BEMatrix34 mtx = CemuHooks::getMemory<BEMatrix34>(actorPtr + offsetof(ActorWiiU, mtx));
+        const SweptCollision::AABB box = SweptCollision::TransformBounds({ aabbMin.getLE(), aabbMax.getLE() }, mtx.getLEMatrix());
+        const glm::fvec3 extent = box.max - box.min;
+        if (std::max({ extent.x, extent.y, extent.z }) > MAX_ACTOR_EXTENT || glm::distance((box.min + box.max) * 0.5f, CemuHooks::s_playerPos) > MAX_ACTOR_DISTANCE) {
+            continue;
+        }
+        s_nearbyActors.Insert(actorPtr, box);
+    }
+}
+
+// The blade runs along the longest axis of the weapon's own box, and is as thick as the second longest one
+static std::optional<WeaponCapsule> GetWeaponCapsule(uint32_t weaponPtr, const Weapon& weapon, XrTime time) {
+    const glm::fvec3 aabbMin = glm::fvec3(weapon.aabb.minX.getLE(), weapon.aabb.minY.getLE(), weapon.aabb.minZ.getLE());
+    const glm::fvec3 aabbMax = glm::fvec3(weapon.aabb.maxX.getLE(), weapon.aabb.maxY.getLE(), weapon.aabb.maxZ.getLE());
+    const glm::fvec3 extent = aabbMax - aabbMin;
+    if (extent.x <= 0.0f || extent.y <= 0.0f || extent.z <= 0.0f) {
+        return std::nullopt;
+    }
+
+    const int longestAxis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    glm::fvec3 base = (aabbMin + aabbMax) * 0.5f;
+    glm::fvec3 tip = base;
+    base[longestAxis] = aabbMin[longestAxis];
+    tip[longestAxis] = aabbMax[longestAxis];
+    float thickness = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (axis != longestAxis) {
+            thickness = std::max(thickness, extent[axis]);
+        }
+    }
+
+    const glm::mat4x3 mtx = weapon.mtx.getLEMatrix();
+    return WeaponCapsule{ weaponPtr, time, mtx * glm::fvec4(base, 1.0f), mtx * glm::fvec4(tip, 1.0f), std::max(thickness * 0.5f, 0.05f) };
+}
+
+// Sweeps the weapon from where it is now to where it'll be next frame if it keeps moving the same way.
+// The game only checks the sensor at the weapon's pose during each frame, so a swing that's about to pass through an actor in between two frames
+// gets its sensor enabled now, while the blade is still on the near side. Swings that already went through can't be hit anymore, so they aren't checked.
+static bool PredictWeaponHit(uint32_t side, uint32_t weaponPtr, const Weapon& weapon, XrTime time) {
+    std::optional<WeaponCapsule> capsule = GetWeaponCapsule(weaponPtr, weapon, time);
+    std::optional<WeaponCapsule> last = std::exchange(s_lastWeaponCapsules[side], capsule);
+    if (!capsule || !last || last->weaponPtr != weaponPtr || (float)(time - last->time) / 1e9f > WeaponMotionAnalyser::MAX_SAMPLE_GAP_SECONDS) {
+        return false;
+    }
+
+    const SweptCollision::SweptCapsule upcoming = { capsule->base, capsule->tip, capsule->base * 2.0f - last->base, capsule->tip * 2.0f - last->tip, capsule->radius };
+    return s_nearbyActors.FindFirstHit(upcoming).has_value();
+}
+
+static std::filesystem::path GetTraceDirectory() {
+    return GetCemuDirectory() / "BetterVR_traces";
+}
+
+// the overrides sit next to Cemu's executable, the tests and the trace replay tool pick their own
+void WeaponProfiles::Load() {
+    LoadFile(GetCemuDirectory() / "BetterVR_weapon_profiles.txt");
+}
+
 static bool isDroppable(std::string actorName) {
     static const std::string_view nonDroppableItems[] = {
         "AncientArrow",
@@ -163,7 +270,7 @@ void CemuHooks::hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU) {
     glm::fvec3 cameraAt = camera.at.getLE();
     glm::fquat lookAtQuat = glm::quatLookAtRH(glm::normalize(cameraAt - cameraPos), { 0.0, 1.0, 0.0 });
     glm::fvec3 lookAtPos = cameraPos;
-    //lookAtPos.y += GetSettings().playerHeightOffset.getLE();
+    //lookAtPos.y += GetSettings()->playerHeightOffset.getLE();
 
     // read bone name
     if (boneNamePtr == 0)
@@ -314,7 +421,7 @@ void CemuHooks::hook_DropEquipment(PPCInterpreter_t* hCPU) {
 
 void CemuHooks::hook_GetContactLayerOfAttack(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
-    if (GetSettings().GetCameraMode() == CameraMode::THIRD_PERSON) {
+    if (GetSettings()->GetCameraMode() == CameraMode::THIRD_PERSON) {
         return;
     }
 
@@ -356,7 +463,7 @@ void CemuHooks::hook_EnableWeaponAttackSensor(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
 
-    if (GetSettings().GetCameraMode() == CameraMode::THIRD_PERSON)
+    if (GetSettings()->GetCameraMode() == CameraMode::THIRD_PERSON)
         return;
 
     uint32_t weaponPtr = hCPU->gpr[3];
@@ -383,6 +490,9 @@ void CemuHooks::hook_EnableWeaponAttackSensor(PPCInterpreter_t* hCPU) {
         Log::print<CONTROLS>("Skipping motion analysis for {}: already ran this frame", heldIndex);
         return;
     }
+    if (!currFrame.ranMotionAnalysis[0] && !currFrame.ranMotionAnalysis[1]) {
+        UpdateNearbyActors();
+    }
     currFrame.ranMotionAnalysis[heldIndex] = true;
 
     heldIndex = heldIndex == 0 ? 1 : 0;
@@ -396,12 +506,19 @@ void CemuHooks::hook_EnableWeaponAttackSensor(PPCInterpreter_t* hCPU) {
         return;
     }
 
+    const DebugSample handSample = WeaponMotionAnalyser::ToSample(inputs.shared.poseLocation[heldIndex], inputs.shared.poseVelocity[heldIndex], inputs.shared.inputTime);
     m_motionAnalyzers[heldIndex].ResetIfWeaponTypeChanged(weaponType);
-    m_motionAnalyzers[heldIndex].Update(inputs.shared.poseLocation[heldIndex], inputs.shared.poseVelocity[heldIndex], headset.value(), inputs.shared.inputTime);
+    // the attack lands when the game's next frame is shown, so check the travel against the latest predicted display time
+    const XrTime hitTime = VRManager::instance().XR->GetRenderer()->GetLastPredictedDisplayTime();
+    m_motionAnalyzers[heldIndex].Update(handSample, headset.value(), hitTime);
+    s_motionRecorders[heldIndex].Add(handSample, headset.value(), hitTime);
+
+    // Fast swings that are going to pass through an actor get their sensor enabled right away, even if the analyser hasn't locked onto the attack yet
+    const bool predictedHit = PredictWeaponHit(heldIndex, weaponPtr, weapon, handSample.time) && (m_motionAnalyzers[heldIndex].IsAttacking() || m_motionAnalyzers[heldIndex].handVelocityToggled);
 
     // Use the analysed motion to determine whether the weapon is swinging or stabbing, and whether the attackSensor should be active this frame
     bool CHEAT_alwaysEnableWeaponCollision = false;
-    if (isHeldByPlayer && (m_motionAnalyzers[heldIndex].IsAttacking() || CHEAT_alwaysEnableWeaponCollision)) {
+    if (isHeldByPlayer && (m_motionAnalyzers[heldIndex].IsAttacking() || predictedHit || CHEAT_alwaysEnableWeaponCollision)) {
         m_motionAnalyzers[heldIndex].SetHitboxEnabled(true);
         //Log::print("!! Activate sensor for {}: isHeldByPlayer={}, weaponType={}", heldIndex, isHeldByPlayer, (int)weaponType);
         weapon.setupAttackSensor.resetAttack = 1;
@@ -532,6 +649,173 @@ void CemuHooks::hook_ModifyHandModelAccessSearch(PPCInterpreter_t* hCPU) {
 #endif
 }
 
+void WeaponMotionAnalyser::DrawDebugOverlay() const {
+    ImGui::TextColored(ImVec4(1, 1, 0, 1), "Weapon Motion Debugger");
+    ImGui::Text("Weapon Type: %d", static_cast<int>(m_weaponType));
+    ImGui::Text("Sample %d / %d", m_lastSampleIdx, MAX_SAMPLES);
+    ImGui::Text("Slash detected for %.0f ms   Stab detected for %.0f ms   Out of margins for %.0f ms", m_slashCandidateTime * 1000.0f, m_stabCandidateTime * 1000.0f, m_badTime * 1000.0f);
+
+    const auto oldestIdx = [this](uint32_t j) { return (m_lastSampleIdx + 1 + j) % MAX_SAMPLES; };
+    // the plots are over time instead of samples since the sample rate depends on the headset and the game's frame rate
+    static constexpr float PLOT_SECONDS = 1.0f;
+    const auto sampleAge = [this](uint32_t idx) {
+        const XrTime time = m_samples.time[idx];
+        return time == 0 ? -PLOT_SECONDS : std::max(-PLOT_SECONDS, (float)(time - m_samples.time[m_lastSampleIdx]) / 1e9f);
+    };
+
+    auto drawSnapshot = [](const char* title, const glm::vec3& currDir, glm::vec3& lastDir, bool& lastValid, float threshold, const ImVec4& colLast, const ImVec4& colCurr) {
+        const float mag = glm::length(currDir);
+        glm::vec3 unit = mag > 0.f ? currDir / mag : glm::vec3{ 0 };
+        if (mag >= threshold) {
+            lastDir = unit;
+            lastValid = true;
+        }
+
+        const float lastS[6] = { 0, 0, 0, lastDir.x, lastDir.z, lastDir.y };
+        const float currS[6] = { 0, 0, 0, unit.x, unit.z, unit.y };
+
+        if (ImPlot3D::BeginPlot(title, { 0, 230 }, ImPlot3DFlags_NoTitle)) {
+            ImPlot3D::SetupAxes("X", "Z", "Y", ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax, ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax, ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax);
+            ImPlot3D::SetupAxisLimits(ImAxis3D_X, -1.1f, 1.1f, ImPlot3DCond_Always);
+            ImPlot3D::SetupAxisLimits(ImAxis3D_Y, -1.1f, 1.1f, ImPlot3DCond_Always);
+            ImPlot3D::SetupAxisLimits(ImAxis3D_Z, -1.1f, 1.1f, ImPlot3DCond_Always);
+
+            if (lastValid) {
+                ImPlot3D::SetNextLineStyle(colLast, 3);
+                ImPlot3D::PlotLine("Last", lastS, lastS + 1, lastS + 2, 2, ImPlot3DLineFlags_Segments, 0, sizeof(float) * 3);
+            }
+            if (mag > 0) {
+                ImPlot3D::SetNextLineStyle(colCurr, 2);
+                ImPlot3D::PlotLine("Curr", currS, currS + 1, currS + 2, 2, ImPlot3DLineFlags_Segments, 0, sizeof(float) * 3);
+            }
+            ImPlot3D::EndPlot();
+        }
+        ImGui::SameLine();
+    };
+
+    std::array<float, MAX_SAMPLES> posX{}, posY{}, posZ{};
+    std::array<float, MAX_SAMPLES * 2> velLineX{}, velLineY{}, velLineZ{};
+    float xMin = FLT_MAX, xMax = -FLT_MAX, yMin = FLT_MAX, yMax = -FLT_MAX, zMin = FLT_MAX, zMax = -FLT_MAX;
+
+    for (uint32_t j = 0; j < MAX_SAMPLES; ++j) {
+        const uint32_t idx = oldestIdx(j);
+
+        posX[j] = m_samples.positionX[idx];
+        posY[j] = m_samples.positionZ[idx]; // swap Y/Z for nicer view
+        posZ[j] = m_samples.positionY[idx];
+
+        xMin = std::min(xMin, posX[j]);
+        xMax = std::max(xMax, posX[j]);
+        yMin = std::min(yMin, posY[j]);
+        yMax = std::max(yMax, posY[j]);
+        zMin = std::min(zMin, posZ[j]);
+        zMax = std::max(zMax, posZ[j]);
+
+        const auto av = m_samples.LocalAngularVelocity(idx) * 0.05f;
+
+        velLineX[j * 2] = posX[j];
+        velLineX[j * 2 + 1] = posX[j] + av.x;
+        velLineY[j * 2] = posY[j];
+        velLineY[j * 2 + 1] = posY[j] + av.y;
+        velLineZ[j * 2] = posZ[j];
+        velLineZ[j * 2 + 1] = posZ[j] + av.z;
+    }
+
+    if (ImPlot3D::BeginPlot("Weapon Motion", { 0, 300 }, ImPlot3DFlags_NoTitle)) {
+        ImPlot3D::SetupAxes("X", "Z", "Y", ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax, ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax, ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax);
+        ImPlot3D::SetupAxisLimits(ImAxis3D_X, xMin - 0.1f, xMax + 0.1f, ImPlot3DCond_Always);
+        ImPlot3D::SetupAxisLimits(ImAxis3D_Y, yMin - 0.1f, yMax + 0.1f, ImPlot3DCond_Always);
+        ImPlot3D::SetupAxisLimits(ImAxis3D_Z, zMin - 0.1f, zMax + 0.1f, ImPlot3DCond_Always);
+
+        ImPlot3D::SetNextMarkerStyle(ImPlot3DMarker_Circle, 1.5f);
+        ImPlot3D::PlotScatter("Pos", posX.data(), posY.data(), posZ.data(), MAX_SAMPLES);
+
+        ImPlot3D::SetNextLineStyle(ImVec4(0, 1, 0.5f, 0.5f), 1.2f);
+        ImPlot3D::PlotLine("AngVel", velLineX.data(), velLineY.data(), velLineZ.data(), MAX_SAMPLES * 2, ImPlot3DLineFlags_Segments);
+        ImPlot3D::EndPlot();
+    }
+    ImGui::SameLine();
+
+    {
+        std::array<float, MAX_SAMPLES> t{}, avX{}, avY{}, avZ{}, maskSlash{}, maskStab{}, velLengthTriggered{};
+        for (uint32_t j = 0; j < MAX_SAMPLES; ++j) {
+            const uint32_t idx = oldestIdx(j);
+            t[j] = sampleAge(idx);
+            avX[j] = m_samples.localAngularVelocityX[idx];
+            avY[j] = m_samples.localAngularVelocityY[idx];
+            avZ[j] = m_samples.localAngularVelocityZ[idx];
+            maskSlash[j] = (m_samples.attackType[idx] == AttackType::Slash) ? 100.0f : -100.0f;
+            maskStab[j] = (m_samples.attackType[idx] == AttackType::Stab) ? 100.0f : -100.0f;
+            velLengthTriggered[j] = m_samples.velocityLengthTriggered[idx] ? 100.0f : -100.0f;
+        }
+
+        if (ImPlot::BeginPlot("Weapon Steadiness", { 0, 300 }, ImPlotFlags_NoTitle)) {
+            ImPlot::SetupAxes("Seconds", "Angular Velocity", ImPlotAxisFlags_Lock, ImPlotAxisFlags_Lock);
+            ImPlot::SetupAxisLimits(ImAxis_X1, -PLOT_SECONDS, 0, ImPlotCond_Always);
+            ImPlot::SetupAxisLimits(ImAxis_Y1, -15, 15, ImPlotCond_Always);
+
+            ImPlot::SetNextLineStyle(ImVec4(0, 1, 0, 0.3f), 3);
+            ImPlot::PlotShaded("Slash", t.data(), maskSlash.data(), MAX_SAMPLES, -100.0f);
+            ImPlot::SetNextLineStyle(ImVec4(1, 0.5f, 0, 0.3f), 3);
+            ImPlot::PlotShaded("Stab", t.data(), maskStab.data(), MAX_SAMPLES, -100.0f);
+            ImPlot::SetNextLineStyle(ImVec4(0, 0, 0.8f, 0.3f), 3);
+            ImPlot::PlotShaded("VelLengthEnabled", t.data(), velLengthTriggered.data(), MAX_SAMPLES, -100.0f);
+
+            ImPlot::SetNextLineStyle(ImVec4(0, 1, 0.5f, 0.5f), 2);
+            ImPlot::PlotLine("X", t.data(), avX.data(), MAX_SAMPLES);
+            ImPlot::PlotLine("Y", t.data(), avY.data(), MAX_SAMPLES);
+            ImPlot::PlotLine("Z", t.data(), avZ.data(), MAX_SAMPLES);
+            ImPlot::EndPlot();
+        }
+        ImGui::SameLine();
+    }
+
+    {
+        std::array<float, MAX_SAMPLES> t{}, avX{}, avY{}, avZ{}, avddX{}, maskSlash{}, maskStab{};
+        for (uint32_t j = 0; j < MAX_SAMPLES; ++j) {
+            const uint32_t idx = oldestIdx(j);
+            t[j] = sampleAge(idx);
+            avX[j] = m_samples.localLinearVelocityX[idx];
+            avddX[j] = m_samples.localLinearAccelerationX[idx];
+            avY[j] = m_samples.localLinearVelocityY[idx];
+            avZ[j] = m_samples.localLinearVelocityZ[idx];
+            maskSlash[j] = (m_samples.attackType[idx] == AttackType::Slash) ? 100.0f : -100.0f;
+            maskStab[j] = (m_samples.attackType[idx] == AttackType::Stab) ? 100.0f : -100.0f;
+        }
+
+        if (ImPlot::BeginPlot("Controller Linear Velocity", { 0, 300 }, ImPlotFlags_NoTitle)) {
+            ImPlot::SetupAxes("Seconds", "Linear Velocity", ImPlotAxisFlags_Lock, ImPlotAxisFlags_Lock);
+            ImPlot::SetupAxisLimits(ImAxis_X1, -PLOT_SECONDS, 0, ImPlotCond_Always);
+            ImPlot::SetupAxisLimits(ImAxis_Y1, -6, 6, ImPlotCond_Always);
+
+            ImPlot::SetNextLineStyle(ImVec4(0, 1, 0, 0.01f), 3);
+            ImPlot::PlotShaded("Slash", t.data(), maskSlash.data(), MAX_SAMPLES, -100.0f);
+            ImPlot::SetNextLineStyle(ImVec4(1, 0.5f, 0, 0.01f), 3);
+            ImPlot::PlotShaded("Stab", t.data(), maskStab.data(), MAX_SAMPLES, -100.0f);
+
+            ImPlot::SetNextLineStyle(ImVec4(0, 1, 0.5f, 0.5f), 2);
+            ImPlot::PlotLine("X", t.data(), avX.data(), MAX_SAMPLES);
+            ImPlot::PlotLine("Y", t.data(), avY.data(), MAX_SAMPLES);
+            ImPlot::PlotLine("Z", t.data(), avZ.data(), MAX_SAMPLES);
+            ImPlot::PlotLine("ddX", t.data(), avddX.data(), MAX_SAMPLES);
+            ImPlot::EndPlot();
+        }
+        ImGui::SameLine();
+    }
+
+    // pass references to be manipulated in the drawSnapshot function
+    glm::vec3& lastAngDir = m_debugLastAngDir;
+    bool& angValid = m_debugAngValid;
+    glm::vec3& lastLinDir = m_debugLastLinDir;
+    bool& linValid = m_debugLinValid;
+
+    const glm::vec3 currAng = m_samples.LocalAngularVelocity(m_lastSampleIdx);
+    const glm::vec3 currLin = m_samples.LocalLinearVelocity(m_lastSampleIdx);
+
+    drawSnapshot("AngVel Snapshot", currAng, lastAngDir, angValid, 1.5f, ImVec4(1, 0, 0, 1), ImVec4(0.4f, 0.7f, 1, 0.25f));
+    drawSnapshot("LinVel Snapshot", currLin, lastLinDir, linValid, 1.5f, ImVec4(0, 1, 0, 1), ImVec4(1, 0.7f, 0.2f, 0.25f));
+}
+
 void CemuHooks::DrawDebugOverlays() {
     if (ImGui::Begin("Weapon Motion Debugger")) {
         for (auto it = m_motionAnalyzers.rbegin(); it != m_motionAnalyzers.rend(); ++it) {
@@ -541,6 +825,35 @@ void CemuHooks::DrawDebugOverlays() {
             ImGui::EndGroup();
             ImGui::PopID();
         }
+
+        // record traces that can be replayed with the weapon_trace_replay tool to compare profile changes against the same motions
+        ImGui::SeparatorText("Motion Trace Recording");
+        static int s_traceLabel = 0;
+        static int s_traceAttacks = 0;
+        ImGui::Combo("Performed attack", &s_traceLabel, "None\0Slash\0Stab\0");
+        ImGui::InputInt("Times performed", &s_traceAttacks);
+        s_traceAttacks = std::max(s_traceAttacks, 0);
+        for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+            const char* sideName = side == OpenXR::EyeSide::LEFT ? "left" : "right";
+            WeaponMotionRecorder& recorder = s_motionRecorders[side];
+            if (!recorder.IsRecording()) {
+                if (ImGui::Button(std::format("Record {} hand", sideName).c_str())) {
+                    recorder.Start(m_motionAnalyzers[side].GetWeaponType());
+                }
+            }
+            else if (ImGui::Button(std::format("Save {} hand ({} samples)", sideName, recorder.GetSampleCount()).c_str())) {
+                std::error_code ec;
+                std::filesystem::create_directories(GetTraceDirectory(), ec);
+                const auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+                const char* labelNames[] = { "none", "slash", "stab" };
+                const std::filesystem::path path = GetTraceDirectory() / std::format("{}_{}x_{}_{}.wmt", labelNames[s_traceLabel], s_traceAttacks, sideName, timestamp);
+                if (recorder.StopAndSave(path, (AttackType)s_traceLabel, (uint32_t)s_traceAttacks)) {
+                    Log::print<INFO>("Saved weapon motion trace to {}", path.string());
+                }
+            }
+            ImGui::SameLine();
+        }
+        ImGui::NewLine();
     }
     ImGui::End();
 }
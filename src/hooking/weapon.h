@@ -1,6 +1,12 @@
+#pragma once
+#include "pch.h"
+
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+
 // some ideas for improvements:
 // - movement inaccuracy for more difficulty
-// - good-samples based on time instead of samples
 // - rotate sword 90 deg around z
 // - add a cooldown to attacks
 //     - add penalty to attacking within cooldown
@@ -18,22 +24,9 @@ struct DebugSample {
     glm::fquat rotation;
     glm::fvec3 linearVelocity;
     glm::fvec3 angularVelocity;
-
-
-    AttackType debug_attackType;
-    bool debug_expVelocityLengthEnabled;
-
-    glm::fvec3 rotLinearAccel;
-
-    glm::fvec3 rotatedVelocity() const { return glm::inverse(rotation) * linearVelocity; }
-    glm::fvec3 rotatedAngularVelocity() const { return glm::inverse(rotation) * angularVelocity; }
-    glm::fvec3 rotatedLinearVelocity() const { return glm::inverse(rotation) * linearVelocity; }
 };
 
 struct WeaponProfile {
-    float swing_detectionThreshold; // minimum speed for swing detection
-    std::chrono::nanoseconds swing_detectionUnderThreshold; // time in nanoseconds to still consider a swing if the speed is under the threshold
-
     // float SmoothingBufferLength; // samples off which the median is used to perform calculations (used to remove outliers/spasms)
 
     // float stab_DotThreshold; // dot product threshold for stab detection
@@ -48,25 +41,181 @@ struct WeaponProfile {
     float slash_SteadinessThreshold; // maximum angular velocity away from swing direction
     float slash_travelAngle; // angle in [rad] before slash activates
     float slash_AccDriftThreshold; // angular velocity allowed between vectors of angular velocity from sample to sample
+
+    float attack_CooldownSeconds; // time before another attack of the same type can start
+    float attack_ConfirmSeconds; // how long the start of a stab or slash has to be detected before it locks in
+    float attack_BadToleranceSeconds; // how long a locked attack can stay outside of its steadiness margins before it's cancelled
 };
 
-struct SpearProfile : WeaponProfile {
-    SpearProfile() {
-        swing_detectionThreshold = 0.1f;
-        swing_detectionUnderThreshold = std::chrono::milliseconds(20);
+// Tuned values for every melee weapon type. These can be overridden per weapon type with BetterVR_weapon_profiles.txt next to Cemu's executable:
+//   [Spear]
+//   stab_travelDistance = 0.2
+// Every key is the name of a WeaponProfile field, in the same units as the field.
+class WeaponProfiles {
+public:
+    static const WeaponProfile& Get(WeaponType weaponType) {
+        std::call_once(s_loaded, Load);
+        return s_profiles[std::min((uint32_t)weaponType, (uint32_t)WeaponType::UnknownWeapon)];
+    }
+
+    // the values tuned in-game for swords, also used for any weapon type that doesn't have its own
+    static constexpr WeaponProfile DEFAULT = {
+        .stab_SpeedThreshold = 0.05f, // m/s
+        .stab_AccThreshold = 5.0f, // m/s squared
+        .stab_LinearSteadinessThreshold = 0.76604444f, // cos(40 deg) accuracy cone
+        .stab_AngularSteadinessThreshold = 4.5f, // [rad/s]
+        .stab_travelDistance = 0.15f,
+        .slash_SpeedThreshold = 1.0f,
+        .slash_AccThreshold = 20.0f,
+        .slash_SteadinessThreshold = 0.70710678f, // cos(45 deg) / portion of direction vector of normalized angular velocity pointed in the right direction
+        .slash_travelAngle = glm::pi<float>() / 6.0f, // 30 deg minimum
+        .slash_AccDriftThreshold = 10.0f, // use [rad/s^2]
+        .attack_CooldownSeconds = 0.0f, // TODO: DIFFERENT COOLDOWN FOR STABS AND SWINGS
+        .attack_ConfirmSeconds = 0.02f, // two samples at 90 Hz
+        .attack_BadToleranceSeconds = 0.0f, // cancel on the first bad sample
+    };
+
+    // spears stab further and need a straighter, faster push, and only faster swings count as slashes.
+    // The steadiness and drift limits stay at the sword's since tracking noise alone goes past the older spear limits.
+    static constexpr WeaponProfile SPEAR = {
+        .stab_SpeedThreshold = 0.2f, // m/s
+        .stab_AccThreshold = 5.0f, // m/s squared
+        .stab_LinearSteadinessThreshold = 0.8660254f, // cos(30 deg) accuracy cone
+        .stab_AngularSteadinessThreshold = 4.5f, // [rad/s]
+        .stab_travelDistance = 0.3f,
+        .slash_SpeedThreshold = 7.0f,
+        .slash_AccThreshold = 7.0f,
+        .slash_SteadinessThreshold = 0.70710678f, // cos(45 deg)
+        .slash_travelAngle = glm::pi<float>() / 6.0f, // 30 deg minimum
+        .slash_AccDriftThreshold = 10.0f, // use [rad/s^2]
+        .attack_CooldownSeconds = 0.0f,
+        .attack_ConfirmSeconds = 0.02f,
+        .attack_BadToleranceSeconds = 0.0f,
+    };
+
+    // Replaces the tuned values with the ones in filePath, missing files are ignored
+    static void LoadFile(const std::filesystem::path& filePath) {
+        std::ifstream file(filePath);
+        if (!file.is_open()) {
+            return;
+        }
+
+        static constexpr std::array<std::pair<std::string_view, WeaponType>, 3> SECTIONS = { {
+            { "SmallSword", WeaponType::SmallSword },
+            { "LargeSword", WeaponType::LargeSword },
+            { "Spear", WeaponType::Spear },
+        } };
+        static constexpr std::array<std::pair<std::string_view, float WeaponProfile::*>, 13> FIELDS = { {
+            { "stab_SpeedThreshold", &WeaponProfile::stab_SpeedThreshold },
+            { "stab_AccThreshold", &WeaponProfile::stab_AccThreshold },
+            { "stab_LinearSteadinessThreshold", &WeaponProfile::stab_LinearSteadinessThreshold },
+            { "stab_AngularSteadinessThreshold", &WeaponProfile::stab_AngularSteadinessThreshold },
+            { "stab_travelDistance", &WeaponProfile::stab_travelDistance },
+            { "slash_SpeedThreshold", &WeaponProfile::slash_SpeedThreshold },
+            { "slash_AccThreshold", &WeaponProfile::slash_AccThreshold },
+            { "slash_SteadinessThreshold", &WeaponProfile::slash_SteadinessThreshold },
+            { "slash_travelAngle", &WeaponProfile::slash_travelAngle },
+            { "slash_AccDriftThreshold", &WeaponProfile::slash_AccDriftThreshold },
+            { "attack_CooldownSeconds", &WeaponProfile::attack_CooldownSeconds },
+            { "attack_ConfirmSeconds", &WeaponProfile::attack_ConfirmSeconds },
+            { "attack_BadToleranceSeconds", &WeaponProfile::attack_BadToleranceSeconds },
+        } };
+
+        auto trim = [](std::string_view str) {
+            const size_t first = str.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos) return std::string_view();
+            return str.substr(first, str.find_last_not_of(" \t\r") - first + 1);
+        };
 
-        // stab_DotThreshold = 0.85f;
-        stab_SpeedThreshold = 0.2f; // m/s
-        stab_AccThreshold = 5.0f;                                  // m/s squared
-        stab_LinearSteadinessThreshold = glm::cos(glm::pi<float>()/6); // use 30 deg cone for steadiness
-        stab_AngularSteadinessThreshold = glm::pi<float>() / 18; // [rad] Use 10 deg cone
-        stab_travelDistance = 0.3f;
+        WeaponProfile* current = nullptr;
+        std::string line;
+        uint32_t lineNumber = 0;
+        uint32_t overrides = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            std::string_view entry = trim(line);
+            if (entry.empty() || entry.starts_with('#') || entry.starts_with(';')) {
+                continue;
+            }
 
-        slash_SpeedThreshold = 7.0f;
-        slash_AccThreshold = 7.0f;
-        slash_SteadinessThreshold = glm::cos(glm::pi<float>() / 4); // 45 deg / portion of direction vector of normalized angular velocity pointed in the right direction
-        slash_travelAngle = glm::pi<float>()/6.0f; // 30 deg minimum
-        slash_AccDriftThreshold = 0.2f;
+            if (entry.starts_with('[') && entry.ends_with(']')) {
+                const std::string_view sectionName = trim(entry.substr(1, entry.size() - 2));
+                auto section = std::ranges::find(SECTIONS, sectionName, &decltype(SECTIONS)::value_type::first);
+                current = section != SECTIONS.end() ? &s_profiles[section->second] : nullptr;
+                if (current == nullptr) {
+                    Log::print<WARNING>("{}:{}: Unknown weapon type [{}], expected SmallSword, LargeSword or Spear", filePath.filename().string(), lineNumber, sectionName);
+                }
+                continue;
+            }
+
+            const size_t separator = entry.find('=');
+            if (current == nullptr || separator == std::string_view::npos) {
+                Log::print<WARNING>("{}:{}: Ignoring '{}'", filePath.filename().string(), lineNumber, entry);
+                continue;
+            }
+
+            const std::string_view key = trim(entry.substr(0, separator));
+            const std::string_view valueStr = trim(entry.substr(separator + 1));
+            auto field = std::ranges::find(FIELDS, key, &decltype(FIELDS)::value_type::first);
+            float value = 0.0f;
+            if (field == FIELDS.end() || std::from_chars(valueStr.data(), valueStr.data() + valueStr.size(), value).ec != std::errc()) {
+                Log::print<WARNING>("{}:{}: Ignoring '{}'", filePath.filename().string(), lineNumber, entry);
+                continue;
+            }
+            (*current).*(field->second) = value;
+            overrides++;
+        }
+        Log::print<INFO>("Loaded {} weapon profile overrides from {}", overrides, filePath.string());
+    }
+
+private:
+    // defined by whatever uses the profiles, the layer loads BetterVR_weapon_profiles.txt next to Cemu's executable
+    static void Load();
+
+    inline static std::once_flag s_loaded;
+    // indexed by WeaponType, bows and shields don't attack with motions but keep a profile so that any weapon type can be looked up
+    inline static std::array<WeaponProfile, (size_t)WeaponType::UnknownWeapon + 1> s_profiles = {
+        DEFAULT, // SmallSword
+        DEFAULT, // LargeSword
+        SPEAR, // Spear
+        DEFAULT, // Bow
+        DEFAULT, // Shield
+        DEFAULT, // UnknownWeapon
+    };
+};
+
+// The last MAX_SAMPLES controller samples, stored as separate arrays so that the debug plots and anything else that walks the history
+// only touch the components that they need. Velocities are stored in controller space since that's all the detection uses.
+template <size_t N>
+struct MotionSampleHistory {
+    std::array<XrTime, N> time = {};
+    std::array<float, N> positionX = {}, positionY = {}, positionZ = {};
+    std::array<float, N> localLinearVelocityX = {}, localLinearVelocityY = {}, localLinearVelocityZ = {};
+    std::array<float, N> localLinearAccelerationX = {}, localLinearAccelerationY = {}, localLinearAccelerationZ = {};
+    std::array<float, N> localAngularVelocityX = {}, localAngularVelocityY = {}, localAngularVelocityZ = {};
+    std::array<AttackType, N> attackType = {};
+    std::array<bool, N> velocityLengthTriggered = {};
+
+    glm::fvec3 Position(size_t i) const { return { positionX[i], positionY[i], positionZ[i] }; }
+    glm::fvec3 LocalLinearVelocity(size_t i) const { return { localLinearVelocityX[i], localLinearVelocityY[i], localLinearVelocityZ[i] }; }
+    glm::fvec3 LocalAngularVelocity(size_t i) const { return { localAngularVelocityX[i], localAngularVelocityY[i], localAngularVelocityZ[i] }; }
+
+    void Set(size_t i, const DebugSample& sample, const glm::fvec3& localLinearVelocity, const glm::fvec3& localLinearAcceleration, const glm::fvec3& localAngularVelocity) {
+        time[i] = sample.time;
+        positionX[i] = sample.position.x;
+        positionY[i] = sample.position.y;
+        positionZ[i] = sample.position.z;
+        localLinearVelocityX[i] = localLinearVelocity.x;
+        localLinearVelocityY[i] = localLinearVelocity.y;
+        localLinearVelocityZ[i] = localLinearVelocity.z;
+        localLinearAccelerationX[i] = localLinearAcceleration.x;
+        localLinearAccelerationY[i] = localLinearAcceleration.y;
+        localLinearAccelerationZ[i] = localLinearAcceleration.z;
+        localAngularVelocityX[i] = localAngularVelocity.x;
+        localAngularVelocityY[i] = localAngularVelocity.y;
+        localAngularVelocityZ[i] = localAngularVelocity.z;
+        attackType[i] = AttackType::None;
+        velocityLengthTriggered[i] = false;
     }
 };
 
@@ -75,20 +224,14 @@ public:
     WeaponMotionAnalyser() = default;
 
     static constexpr int MAX_SAMPLES = 90;
-    static constexpr int BAD_SAMPLES_BUFFER = 1;
-    static constexpr std::chrono::nanoseconds GOOD_SAMPLES_BEFORE_GOOD_STAB = std::chrono::milliseconds(4);
+    static constexpr float MAX_SAMPLE_GAP_SECONDS = 0.1f; // anything longer (game hitches, pausing) isn't differentiated across
+    static constexpr float MAX_EXTRAPOLATION_SECONDS = 0.05f; // how far samples get extrapolated towards the frame that the hit lands on
+    static constexpr float FULL_IMPULSE_SECONDS = 0.055f; // how long an attack has to be detected for before it has full impulse
 
     static constexpr float HAND_VELOCITY_LENGTH_THRESHOLD = 2.0f;
 
     static constexpr float dist_threshold = 0.6f; // max distance from head to consider attack
-    XrTime COOLDOWN_TIME = int(1e9*2.0f); // 0.5 s in nano seconds
 
-    WeaponProfile profile = SpearProfile();
-
-    // New member variables for angular velocity plot
-    glm::fvec3 m_lastPlottedAngularVelocity = {0.0f, 0.0f, 0.0f};
-    bool m_hasValidLastPlottedAngularVelocity = false;
-    static constexpr float ANGULAR_VELOCITY_THRESHOLD = 0.1f;
     float max_range = 0.0f;
     glm::fvec3 prev_lin_vel = glm::fvec3(0.0f);
     glm::fvec3 prev_ang_vel = glm::fvec3(.0f);
@@ -101,112 +244,89 @@ public:
     bool handVelocityToggled = false;
     float handVelocityLength = 0.0f;
 
-    void Update(const XrSpaceLocation& handLocation, const XrSpaceVelocity& handVelocity, const glm::fmat4& headsetMtx, const XrTime inputTime) {
-        // Get velocity expressed in controller space
-        const glm::fvec3 linearVelocity = ToGLM(handVelocity.linearVelocity);
-        const glm::fvec3 angularVelocity = ToGLM(handVelocity.angularVelocity);
+    static DebugSample ToSample(const XrSpaceLocation& handLocation, const XrSpaceVelocity& handVelocity, const XrTime inputTime) {
+        return {
+            .time = inputTime,
+            .position = ToGLM(handLocation.pose.position),
+            .rotation = ToGLM(handLocation.pose.orientation), // rotation of controller w.r.t. world
+            .linearVelocity = ToGLM(handVelocity.linearVelocity),
+            .angularVelocity = ToGLM(handVelocity.angularVelocity), // angular velocity in world space
+        };
+    }
+
+    // Samples can arrive at any rate and with irregular spacing, so everything is based on the time between samples instead of how many there were.
+    // hitTime is when the frame that the attack sensor is updated for gets displayed, the travel checks extrapolate the pose to that time.
+    void Update(const DebugSample& sample, const glm::fmat4& headsetMtx, XrTime hitTime = 0) {
+        const XrTime inputTime = sample.time;
+        if (prev_sample != 0 && inputTime <= prev_sample) {
+            return; // same input sample as last time, happens when the game runs faster than the runtime updates the inputs
+        }
 
-        const glm::fquat rotation = ToGLM(handLocation.pose.orientation); // rotation of controller w.r.t. world
-        const glm::fvec3 position = ToGLM(handLocation.pose.position);
+        const glm::fvec3& linearVelocity = sample.linearVelocity;
+        const glm::fvec3& angularVelocity = sample.angularVelocity;
+        const glm::fquat& rotation = sample.rotation;
+        const glm::fvec3& position = sample.position;
 
         const glm::fvec3 headsetPostion = glm::fvec3(headsetMtx[3]);
-        const glm::fquat headsetRotation = glm::quat_cast(headsetMtx); // Angular rotation vector
 
         // new variant of attack detection based on velocity threshold
         handVelocityLength = glm::length(linearVelocity);
         handVelocityToggled = handVelocityLength >= HAND_VELOCITY_LENGTH_THRESHOLD;
 
-        m_rollingSamples[m_rollingSamplesIt] = {
-            .time = inputTime,
-            .position = position,
-            .rotation = rotation,
-            .linearVelocity = linearVelocity,
-            .angularVelocity = angularVelocity, // angular velocity in world space
-            .debug_attackType = AttackType::None,
-            .debug_expVelocityLengthEnabled = handVelocityToggled
-        };
-        m_lastSampleIdx = m_rollingSamplesIt;
-        m_rollingSamplesIt = (m_rollingSamplesIt + 1) % MAX_SAMPLES;
-
         // Determine max range from hand positions
         float curr_distance = glm::distance(position, headsetPostion);
         max_range = glm::max(max_range, dist_threshold*curr_distance); // maximum reached value currently (decreased using factor 'dist_threshold' to avoid outliers)
-        //Log::print("!! range: {}/{}", curr_distance, max_range);
-
-        // ----- Find if rotation is towards center of view -----
-        const glm::fvec3 pos_rot_axis = glm::cross(headsetRotation * glm::fvec3(0, 0, -1), rotation * glm::fvec3(0, 0, 1)); // cross product from sword x to forward camera axis
-        const bool swing_is_forwards = glm::dot(pos_rot_axis, angularVelocity) > 0;
-        //Log::print("!! is forward: {}", swing_is_forwards ? "true" : "false");
-        //const float ang = glm::asin(glm::length(pos_rot_axis));
 
-        //Log::print("!! is_attacking: );
         // ---- Find local velocities & accelerations -----
-        const glm::fvec3 localLinearVelocity = glm::inverse(rotation) * linearVelocity;
+        // controller orientations are unit quaternions, so the conjugate is the inverse
+        const glm::fquat invRotation = glm::conjugate(rotation);
+        const glm::fvec3 localLinearVelocity = invRotation * linearVelocity;
         float dt = (float)(inputTime - prev_sample) / 1000000000.0f;
-        const glm::fvec3 localLinearAcceleration = (localLinearVelocity - prev_lin_vel) / glm::fvec3(dt); // TODO: add stab_acc threshold | Make stab continue as long as velocity follows acceleration (<0)
-
-        // ---- find angular velocity drift ----
-        // Log::print<CONTROLS>("angvel: {} \n prev_av: {}\ndt: {}\n dot: {}\nacos: {}", angularVelocity, prev_AngularVelocity, dt, glm::dot(angularVelocity, prev_AngularVelocity), acos(glm::dot(angularVelocity, prev_AngularVelocity)));
-
-        float angular_drift = acos(glm::dot(glm::normalize(angularVelocity), glm::normalize(prev_AngularVelocity)))/dt; // Angular velocity drift (defined as the angular velocity of the rotating angular velocity i.e. how much rad/s the orthogonal vector of rotation moves)
-
-        m_rollingSamples[m_lastSampleIdx].rotLinearAccel = localLinearAcceleration;
-
-
-
-        //Log::print("!! Acc: {} {} {}", localLinearAcceleration.x, localLinearAcceleration.y, localLinearAcceleration.z);
+        const bool continuous = prev_sample != 0 && dt <= MAX_SAMPLE_GAP_SECONDS;
+        if (!continuous) {
+            // nothing to differentiate against, so any attack that was starting has to start over from this sample
+            dt = 0.0f;
+            m_stabCandidateTime = 0.0f;
+            m_slashCandidateTime = 0.0f;
+        }
+        const glm::fvec3 localLinearAcceleration = continuous ? (localLinearVelocity - prev_lin_vel) / dt : glm::fvec3(0.0f); // TODO: add stab_acc threshold | Make stab continue as long as velocity follows acceleration (<0)
 
         // For virtual desktop via steam vr -> use inv(rotation) * angular velocity
-        const glm::fvec3 localAngularVelocity = m_rollingSamples[m_lastSampleIdx].rotatedAngularVelocity(); //glm::inverse(rotation) * angularVelocity;
+        const glm::fvec3 localAngularVelocity = invRotation * angularVelocity;
+
+        m_lastSampleIdx = m_rollingSamplesIt;
+        m_rollingSamplesIt = (m_rollingSamplesIt + 1) % MAX_SAMPLES;
+        m_samples.Set(m_lastSampleIdx, sample, localLinearVelocity, localLinearAcceleration, localAngularVelocity);
+        m_samples.velocityLengthTriggered[m_lastSampleIdx] = handVelocityToggled;
 
-        
         // --- Get approximation of angular acceleration over xy plane ---
-        glm::fvec3 flat_ang_vel = localAngularVelocity - (glm::fvec3(.0, .0, localAngularVelocity.z)); // Get rotation vector over xy plane
-        float flat_ang_acc = (glm::length(flat_ang_vel) - glm::length(prev_ang_vel))/dt;
+        glm::fvec3 flat_ang_vel = glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0f); // Get rotation vector over xy plane
+        float flat_ang_acc = continuous ? (glm::length(flat_ang_vel) - glm::length(prev_ang_vel)) / dt : 0.0f;
 
         prev_ang_vel = flat_ang_vel;
-        
-        //Log::print("!! position_world: {}", position);
-        //Log::print("!! v_local: {}", localLinearVelocity);
-        profile.stab_SpeedThreshold = 0.05f;
-        profile.stab_AccThreshold = 5.0f;
-        profile.stab_LinearSteadinessThreshold = glm::cos(glm::pi<float>() / 4.5); // 15 deg accuracy cone
-        profile.stab_AngularSteadinessThreshold = 4.5; // [rad/s]
-        profile.stab_travelDistance = 0.15f;
-        profile.slash_SpeedThreshold = 1.0f;
-        profile.slash_AccThreshold = 20.0f;
-        profile.slash_AccDriftThreshold = 10.0f; // use [rad/s^2]
-        COOLDOWN_TIME = 0.0f*1e9; // TODO: DIFFERENT COOLDOWN FOR STABS AND SWINGS
-
-        //Log::print("!! steadiness: {} / {}", glm::normalize(localAngularVelocity).y, profile.slash_SteadinessThreshold);
-        profile.slash_travelAngle = glm::pi<float>() / 6;
+
+        const float lead = std::clamp((float)(hitTime - inputTime) / 1000000000.0f, 0.0f, MAX_EXTRAPOLATION_SECONDS);
+
         // Detect velocity threshold -> set attack type if not in attack & store original angle/position
         AttackType prev_attack = m_lockedAttackType;
 
-        detect_attack_type(localLinearVelocity, localLinearAcceleration, localAngularVelocity, flat_ang_acc, position, rotation, swing_is_forwards);
-
-        // Log::print("!! attack_state: {}", (int)m_lockedAttackType);
+        detect_attack_type(localLinearVelocity, localLinearAcceleration, localAngularVelocity, flat_ang_acc, position, rotation, dt);
 
         // Check if attack falls within weaponprofile velocity & angle margins -> if not cancel attack & go back to checking for attack
-        check_attack_steadiness(localLinearVelocity, localAngularVelocity, angular_drift);
-        //Log::print("!! m_badSampleCtr: {}", m_badSampleCtr);
+        check_attack_steadiness(localLinearVelocity, localAngularVelocity, angularVelocity, dt);
 
         // Check if delta_angle/delta_translation is enough to enable attack mode
-        set_attack_activity(rotation, position);
-
-        // Log::print("!! AttackType: {} - IsAttacking = {} - bad_samples: {} - v_world: ({}): ", (int)m_lockedAttackType, IsAttacking() ? "true": "false", m_badSampleCtr, localLinearVelocity);
+        set_attack_activity(ExtrapolateRotation(rotation, angularVelocity, lead), position + linearVelocity * lead);
 
-        m_rollingSamples[m_lastSampleIdx].debug_attackType = IsAttacking() ? m_lockedAttackType: AttackType::None;
+        m_samples.attackType[m_lastSampleIdx] = IsAttacking() ? m_lockedAttackType : AttackType::None;
 
-        // Log::print<CONTROLS>("{}", time_since_last_attack);
         // time since last attack update
         for (int i = 0; i < 2; i++) {
-            time_since_last_attack[i] += inputTime - prev_sample;
-            time_since_last_attack[i]  = std::min(time_since_last_attack[i], COOLDOWN_TIME);
+            time_since_last_attack[i] += prev_sample == 0 ? m_cooldownTime : inputTime - prev_sample;
+            time_since_last_attack[i] = std::min(time_since_last_attack[i], m_cooldownTime);
         }
 
         if (m_lockedAttackType != AttackType::None && prev_attack != m_lockedAttackType) { // if start of new attack
-            // Log::print<CONTROLS>("Switched attack to: {}", m_lockedAttackType == AttackType::Slash ? "slash" : "stab");
             time_since_last_attack[static_cast<int>(m_lockedAttackType) - 1] = 0; // reset timer for this attack type
         }
 
@@ -215,104 +335,91 @@ public:
         prev_sample = inputTime;
     }
 
-    void detect_attack_type(const glm::fvec3 localLinearVelocity, const glm::fvec3 localLinearAcceleration, const glm::fvec3 localAngularVelocity, const float flag_ang_acc, const glm::fvec3 position, const glm::fquat rotation, const bool swing_is_forward) {
-        // Log::print<CONTROLS>("[WeaponMotionAnalyser] Detecting attack type with linear velocity: {}, attack type = {}, active: {}", localLinearVelocity, static_cast<int>(m_lockedAttackType), static_cast<int>(m_attackActivity));
-
-        if (m_lockedAttackType == AttackType::None) {
-            glm::fvec3 dir_ang = glm::normalize(localAngularVelocity);
-            glm::fvec3 stab_ang = glm::normalize(localLinearVelocity);
+    static glm::fquat ExtrapolateRotation(const glm::fquat& rotation, const glm::fvec3& angularVelocity, float seconds) {
+        const float angle = glm::length(angularVelocity) * seconds;
+        if (angle < 1e-6f) {
+            return rotation;
+        }
+        return glm::angleAxis(angle, angularVelocity / glm::length(angularVelocity)) * rotation;
+    }
 
-            //Log::print<CONTROLS>("controller angular velocity {}, {}, {}", abs(localAngularVelocity).x, abs(localAngularVelocity).y, abs(localAngularVelocity).z);
-            //Log::print<CONTROLS>("linear acc reached {}", -localLinearAcceleration.z > profile.stab_AccThreshold);
+    // |v.component| / |v| compared against a cosine threshold without normalizing v, a zero vector never passes either comparison
+    static bool IsAlignedWithin(float component, const glm::fvec3& v, float cosThreshold) {
+        return component * component > cosThreshold * cosThreshold * glm::dot(v, v);
+    }
+    static bool IsAlignedOutside(float component, const glm::fvec3& v, float cosThreshold) {
+        return component * component < cosThreshold * cosThreshold * glm::dot(v, v);
+    }
 
-            if (abs(localAngularVelocity).x < profile.stab_AngularSteadinessThreshold && abs(localAngularVelocity).y < profile.stab_AngularSteadinessThreshold && abs(-stab_ang.z) > profile.stab_LinearSteadinessThreshold && -localLinearAcceleration.z > profile.stab_AccThreshold) {
-                if (time_since_last_attack[int(AttackType::Stab)-1] >= COOLDOWN_TIME) {
-                    // Log::print<CONTROLS>("Failed due to: {}", );
+    void detect_attack_type(const glm::fvec3 localLinearVelocity, const glm::fvec3 localLinearAcceleration, const glm::fvec3 localAngularVelocity, const float flag_ang_acc, const glm::fvec3 position, const glm::fquat rotation, const float dt) {
+        if (m_lockedAttackType == AttackType::None) {
+            if (abs(localAngularVelocity).x < m_profile.stab_AngularSteadinessThreshold && abs(localAngularVelocity).y < m_profile.stab_AngularSteadinessThreshold && IsAlignedWithin(localLinearVelocity.z, localLinearVelocity, m_profile.stab_LinearSteadinessThreshold) && -localLinearAcceleration.z > m_profile.stab_AccThreshold) {
+                if (time_since_last_attack[int(AttackType::Stab)-1] >= m_cooldownTime) {
                     m_lockedPosition = position;
-                    m_goodStabSampleCtr++;
+                    m_stabCandidateTime += dt;
                     Log::print<CONTROLS>("Stab detect attack");
-                    if (m_goodStabSampleCtr > 1) {
+                    if (m_stabCandidateTime >= m_profile.attack_ConfirmSeconds) {
                         m_lockedAttackType = AttackType::Stab;
                     }
                 };
                 
             }else {
-                m_goodStabSampleCtr = 0;
-            }
-            if (flag_ang_acc > profile.slash_AccThreshold && !swing_is_forward) {
-                Log::print<CONTROLS>("Slash detected but not forward");
+                m_stabCandidateTime = 0.0f;
             }
-            if (/*abs(dir_ang.x) > profile.slash_SteadinessThreshold &&*/ flag_ang_acc > profile.slash_AccThreshold /*&& swing_is_forward*/) {
-                if (time_since_last_attack[int(AttackType::Slash)-1] >= COOLDOWN_TIME) {
-                    // Log::print<CONTROLS>("cooldown currently: {}/{}", time_since_last_attack[int(AttackType::Slash) - 1], COOLDOWN_TIME);
-
-                    m_goodSwingSampleCtr++;
+            if (/*abs(dir_ang.x) > m_profile.slash_SteadinessThreshold &&*/ flag_ang_acc > m_profile.slash_AccThreshold /*&& swing_is_forward*/) {
+                if (time_since_last_attack[int(AttackType::Slash)-1] >= m_cooldownTime) {
+                    m_slashCandidateTime += dt;
                     m_lockedAngle = rotation * glm::fvec3(0.0f, 0.0f, 1.0f); // store z-axis
                     Log::print<CONTROLS>("slash attack detected");
-                    if (m_goodSwingSampleCtr > 1) {
+                    if (m_slashCandidateTime >= m_profile.attack_ConfirmSeconds) {
                         m_lockedAttackType = AttackType::Slash;
-                        //Log::print<CONTROLS>("Initiate swing");
                     }
                 }
             }
             else {
-                m_goodSwingSampleCtr = 0;
+                m_slashCandidateTime = 0.0f;
             }
         }
     }
 
-    void check_attack_steadiness(const glm::fvec3 localLinearVelocity, const glm::fvec3 localAngularVelocity, const float angular_drift) {
+    void check_attack_steadiness(const glm::fvec3 localLinearVelocity, const glm::fvec3 localAngularVelocity, const glm::fvec3 angularVelocity, const float dt) {
         // check steadiness condition for attack types
+        bool badSample = false;
         switch (m_lockedAttackType) {
             case AttackType::None: { 
-                //m_badSampleCtr = 0;
                 return;
             }
             case AttackType::Stab: {
-                glm::fvec3 stab_ang = glm::normalize(localLinearVelocity);
-
-                if (abs(stab_ang.z) < profile.stab_LinearSteadinessThreshold || -localLinearVelocity.z < profile.stab_SpeedThreshold || glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0)) > profile.stab_AngularSteadinessThreshold || abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold) {
-                    m_badSampleCtr++;
-                    bool speed_issue = abs(stab_ang.z) < profile.stab_LinearSteadinessThreshold && abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold && abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold;
-                    // Log::print<CONTROLS>("Failed due to {}", speed_issue ? "Speed is too low" : "Steadiness is too shit");
-                    //if (speed_issue) {
-                        //Log::print<CONTROLS>(" Speed is {}/{}", -localLinearVelocity.z, profile.stab_SpeedThreshold);
-                    //}
-                }
-                else {
-                    m_badSampleCtr = 0;
-                    //Log::print<CONTROLS>("Speed is {}", -localLinearVelocity);
+                if (IsAlignedOutside(localLinearVelocity.z, localLinearVelocity, m_profile.stab_LinearSteadinessThreshold) || -localLinearVelocity.z < m_profile.stab_SpeedThreshold || glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0)) > m_profile.stab_AngularSteadinessThreshold || abs(localAngularVelocity).x > m_profile.stab_AngularSteadinessThreshold) {
+                    badSample = true;
                 }
                 break;
             }
             case AttackType::Slash: {
-                glm::fvec3 dir_ang = glm::normalize(localAngularVelocity);
-                // Log::print<CONTROLS>("velocity ok: {}/{}: {}", glm::length(localAngularVelocity - glm::fvec3(.0, .0, localAngularVelocity.z)), profile.slash_SpeedThreshold, glm::length(localAngularVelocity - glm::fvec3(.0, .0, localAngularVelocity.z)) < profile.slash_SpeedThreshold);
+                // Angular velocity drift (defined as the angular velocity of the rotating angular velocity i.e. how much rad/s the orthogonal vector of rotation moves)
+                // only needed while slashing, so the acos is skipped for every other sample
+                const float angular_drift = dt > 0.0f ? acos(glm::dot(glm::normalize(angularVelocity), glm::normalize(prev_AngularVelocity))) / dt : 0.0f;
 
-                // Log::print<CONTROLS>("angular drift: {}/{}: {}", angular_drift, profile.slash_AccDriftThreshold, angular_drift > profile.slash_AccDriftThreshold);
-                if (/*abs(dir_ang.x) < profile.slash_SteadinessThreshold ||*/ angular_drift > profile.slash_AccDriftThreshold || glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0f)) < profile.slash_SpeedThreshold) { // abs( - localAngularVelocity.x) < profile.slash_SpeedThreshold * 0.2f TODO: SLash speed should be directional (i.e. reversing slash direction should end it). During locking: store sign of swing direction, check if this is still valid here.
-                    bool drift_fail = angular_drift > profile.slash_AccDriftThreshold;
+                if (/*abs(dir_ang.x) < m_profile.slash_SteadinessThreshold ||*/ angular_drift > m_profile.slash_AccDriftThreshold || glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0f)) < m_profile.slash_SpeedThreshold) { // abs( - localAngularVelocity.x) < m_profile.slash_SpeedThreshold * 0.2f TODO: SLash speed should be directional (i.e. reversing slash direction should end it). During locking: store sign of swing direction, check if this is still valid here.
+                    bool drift_fail = angular_drift > m_profile.slash_AccDriftThreshold;
                     
                     if (drift_fail) {
-                        Log::print<CONTROLS>("[FAIL]: Drift: {}/{}",  angular_drift, profile.slash_AccDriftThreshold);
+                        Log::print<CONTROLS>("[FAIL]: Drift: {}/{}",  angular_drift, m_profile.slash_AccDriftThreshold);
                     }
                     else {
-                        Log::print<CONTROLS>("[FAIL]: Angular velocity: {}/{}", glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0f)), profile.slash_SpeedThreshold);
+                        Log::print<CONTROLS>("[FAIL]: Angular velocity: {}/{}", glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0f)), m_profile.slash_SpeedThreshold);
                     }
                     
-                    m_badSampleCtr++;
-                }
-                else {
-                    m_badSampleCtr  = 0;
+                    badSample = true;
                 }
                 break;
             }
         }
         
-        // Remove attack type if too many bad samples
-        if (m_badSampleCtr >= BAD_SAMPLES_BUFFER) {
-            m_badSampleCtr = 0;
-            //Log::print<CONTROLS>("removed attack due to bad samples");
+        // Remove attack type if it's been outside of its margins for too long
+        m_badTime = badSample ? m_badTime + dt : 0.0f;
+        if (badSample && m_badTime >= m_profile.attack_BadToleranceSeconds) {
+            m_badTime = 0.0f;
             m_lockedAttackType = AttackType::None;
         }
     }
@@ -326,7 +433,7 @@ public:
                 case AttackType::Stab: {
                     const float travel_dist = glm::length(position - m_lockedPosition);
                     Log::print<CONTROLS>("travel distance: {}", travel_dist);
-                    if (travel_dist > profile.stab_travelDistance) {
+                    if (travel_dist > m_profile.stab_travelDistance) {
                         m_attackActivity = true;
                     }
                     break;
@@ -335,13 +442,12 @@ public:
                     // Assumptions:
                     // - Rotation (wind-up) only occures along x axis
                     // - detection angle is smaller than 180 deg (calculated angle decreases after 180 degrees)
+                    // compares against the cosine of the travel angle, since acos is decreasing this is the same as ang_difference > slash_travelAngle
                     const glm::fvec3 z_start = m_lockedAngle;
                     const glm::fvec3 z_now = rotation * glm::fvec3(0.0f, 0.0f, 1.0f);
                     const float dot_product = glm::dot(z_now, z_start);
-                    const float ang_difference = glm::acos(dot_product); // would be more performant to dot_product as comparison value and change profile.slash_travelAngle to cos(angle) instead of angle
-                    //Log::print<CONTROLS>("angle_dif: {}", ang_difference);
 
-                    if (ang_difference > profile.slash_travelAngle) {
+                    if (dot_product < m_slashTravelAngleCos) {
                         m_attackActivity = true;
                     }
                     break;
@@ -368,237 +474,301 @@ public:
 
     float GetAttackImpulse() const {
         if (m_lockedAttackType == AttackType::Slash) {
-            return std::clamp((float)m_goodSwingSampleCtr / 5.0f, 0.0f, 1.0f);
+            return std::clamp(m_slashCandidateTime / FULL_IMPULSE_SECONDS, 0.0f, 1.0f);
         }
         else if (m_lockedAttackType == AttackType::Stab) {
-            return std::clamp((float)m_goodStabSampleCtr / 5.0f, 0.0f, 1.0f);
+            return std::clamp(m_stabCandidateTime / FULL_IMPULSE_SECONDS, 0.0f, 1.0f);
         }
         return 0.0f;
     }
 
     float GetAttackDamage() const {
         if (m_lockedAttackType == AttackType::Slash) {
-            return std::clamp((float)m_goodSwingSampleCtr / 5.0f, 0.0f, 1.0f);
+            return std::clamp(m_slashCandidateTime / FULL_IMPULSE_SECONDS, 0.0f, 1.0f);
         }
         else if (m_lockedAttackType == AttackType::Stab) {
-            return std::clamp((float)m_goodStabSampleCtr / 5.0f, 0.0f, 1.0f);
+            return std::clamp(m_stabCandidateTime / FULL_IMPULSE_SECONDS, 0.0f, 1.0f);
         }
         return 0.0f;
     }
 
     void ResetSwing() {
-        m_goodSwingSampleCtr = 0;
-        m_badSwingSampleCtr = 0;
+        m_slashCandidateTime = 0.0f;
         if (m_lockedAttackType == AttackType::Slash) {
             m_lockedAttackType = AttackType::None;
         }
     }
 
     void ResetStab() {
-        m_goodStabSampleCtr = 0;
-        m_badStabSampleCtr = 0;
+        m_stabCandidateTime = 0.0f;
         if (m_lockedAttackType == AttackType::Stab) {
             m_lockedAttackType = AttackType::None;
         }
     }
 
     void Reset() {
-        m_rollingSamples.fill({});
+        m_samples = {};
         ResetSwing();
         ResetStab();
     }
 
     void ResetIfWeaponTypeChanged(WeaponType weaponType) {
-        if (m_weaponType != weaponType) {
+        if (m_weaponType != weaponType || !m_profileLoaded) {
             m_weaponType = weaponType;
+            SetProfile(WeaponProfiles::Get(weaponType));
             Reset();
         }
     }
 
+    void SetProfile(const WeaponProfile& profile) {
+        m_profile = profile;
+        m_profileLoaded = true;
+        m_cooldownTime = (XrTime)(profile.attack_CooldownSeconds * 1e9f);
+        m_slashTravelAngleCos = cosf(profile.slash_travelAngle);
+    }
 
-    void DrawDebugOverlay() const {
-        ImGui::TextColored(ImVec4(1, 1, 0, 1), "Weapon Motion Debugger");
-        ImGui::Text("Weapon Type: %d", static_cast<int>(m_weaponType));
-        ImGui::Text("Sample %d / %d", m_lastSampleIdx, MAX_SAMPLES);
-        ImGui::Text("Bad samples: %d   Good samples: %d", m_badSwingSampleCtr, m_goodSwingSampleCtr);
-
-        const auto oldestIdx = [this](uint32_t j) { return (m_lastSampleIdx + j) % MAX_SAMPLES; };
+    WeaponType GetWeaponType() const {
+        return m_weaponType;
+    }
 
-        auto drawSnapshot = [](const char* title, const glm::vec3& currDir, glm::vec3& lastDir, bool& lastValid, float threshold, const ImVec4& colLast, const ImVec4& colCurr) {
-            const float mag = glm::length(currDir);
-            glm::vec3 unit = mag > 0.f ? currDir / mag : glm::vec3{ 0 };
-            if (mag >= threshold) {
-                lastDir = unit;
-                lastValid = true;
-            }
+    AttackType GetActiveAttackType() const {
+        return m_attackActivity ? m_lockedAttackType : AttackType::None;
+    }
 
-            const float lastS[6] = { 0, 0, 0, lastDir.x, lastDir.z, lastDir.y };
-            const float currS[6] = { 0, 0, 0, unit.x, unit.z, unit.y };
 
-            if (ImPlot3D::BeginPlot(title, { 0, 230 }, ImPlot3DFlags_NoTitle)) {
-                ImPlot3D::SetupAxes("X", "Z", "Y", ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax, ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax, ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax);
-                ImPlot3D::SetupAxisLimits(ImAxis3D_X, -1.1f, 1.1f, ImPlot3DCond_Always);
-                ImPlot3D::SetupAxisLimits(ImAxis3D_Y, -1.1f, 1.1f, ImPlot3DCond_Always);
-                ImPlot3D::SetupAxisLimits(ImAxis3D_Z, -1.1f, 1.1f, ImPlot3DCond_Always);
+    void DrawDebugOverlay() const;
 
-                if (lastValid) {
-                    ImPlot3D::SetNextLineStyle(colLast, 3);
-                    ImPlot3D::PlotLine("Last", lastS, lastS + 1, lastS + 2, 2, ImPlot3DLineFlags_Segments, 0, sizeof(float) * 3);
-                }
-                if (mag > 0) {
-                    ImPlot3D::SetNextLineStyle(colCurr, 2);
-                    ImPlot3D::PlotLine("Curr", currS, currS + 1, currS + 2, 2, ImPlot3DLineFlags_Segments, 0, sizeof(float) * 3);
-                }
-                ImPlot3D::EndPlot();
-            }
-            ImGui::SameLine();
-        };
-
-        std::array<float, MAX_SAMPLES> posX{}, posY{}, posZ{};
-        std::array<float, MAX_SAMPLES * 2> velLineX{}, velLineY{}, velLineZ{};
-        float xMin = FLT_MAX, xMax = -FLT_MAX, yMin = FLT_MAX, yMax = -FLT_MAX, zMin = FLT_MAX, zMax = -FLT_MAX;
+private:
+    WeaponType m_weaponType = LargeSword;
+    WeaponProfile m_profile = WeaponProfiles::DEFAULT;
+    bool m_profileLoaded = false;
+    XrTime m_cooldownTime = (XrTime)(WeaponProfiles::DEFAULT.attack_CooldownSeconds * 1e9f);
+    float m_slashTravelAngleCos = cosf(WeaponProfiles::DEFAULT.slash_travelAngle);
 
-        for (uint32_t j = 0; j < MAX_SAMPLES; ++j) {
-            const auto& s = m_rollingSamples[oldestIdx(j)];
+    MotionSampleHistory<MAX_SAMPLES> m_samples = {};
+    uint32_t m_lastSampleIdx = 0;
+    uint32_t m_rollingSamplesIt = 0;
 
-            posX[j] = s.position.x;
-            posY[j] = s.position.z; // swap Y/Z for nicer view
-            posZ[j] = s.position.y;
+    float m_slashCandidateTime = 0.0f;
+    bool m_attackActivity = false;
+    bool m_isHitboxEnabled = false;
+    float m_badTime = 0.0f;
+    AttackType m_lockedAttackType = AttackType::None;
+    glm::fvec3 m_lockedPosition = {};
+    glm::fvec3 m_lockedAngle = {};
+    float m_stabCandidateTime = 0.0f;
 
-            xMin = std::min(xMin, posX[j]);
-            xMax = std::max(xMax, posX[j]);
-            yMin = std::min(yMin, posY[j]);
-            yMax = std::max(yMax, posY[j]);
-            zMin = std::min(zMin, posZ[j]);
-            zMax = std::max(zMax, posZ[j]);
+    mutable glm::vec3 m_debugLastAngDir = {1, 0, 0};
+    mutable bool m_debugAngValid = false;
+    mutable glm::vec3 m_debugLastLinDir = { 1, 0, 0 };
+    mutable bool m_debugLinValid = false;
+};
 
-            const auto av = s.rotatedAngularVelocity() * 0.05f;
+// Controller samples of one hand that are recorded while playing and can be replayed through WeaponMotionAnalyser later, so that profile
+// changes and performance can be compared against the exact same motions. Every recording is labeled with the attack that was performed and how often.
+class WeaponMotionTrace {
+public:
+    static constexpr uint32_t MAGIC = 0x52544D57; // "WMTR"
+    static constexpr uint32_t VERSION = 2; // version 1 didn't record the display time of each sample
+
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint32_t label = 0; // AttackType
+        uint32_t expectedAttacks = 0;
+        uint32_t weaponType = 0;
+        uint32_t sampleCount = 0;
+    };
+    static_assert(sizeof(Header) == 24);
+
+    // hand pose, hand velocities and headset pose without any padding, along with the predicted display time that the analyser got for the sample
+    struct PackedSample {
+        XrTime time;
+        XrTime hitTime;
+        float values[20];
+    };
+    static_assert(sizeof(PackedSample) == 96);
+
+    struct ReplayResult {
+        uint32_t correctAttacks = 0;
+        uint32_t wrongAttacks = 0;
+        uint32_t expectedAttacks = 0;
+        uint64_t updates = 0;
+        std::chrono::steady_clock::duration updateTime = {};
+
+        void operator+=(const ReplayResult& other) {
+            correctAttacks += other.correctAttacks;
+            wrongAttacks += other.wrongAttacks;
+            expectedAttacks += other.expectedAttacks;
+            updates += other.updates;
+            updateTime += other.updateTime;
+        }
+        float Precision() const { return correctAttacks + wrongAttacks == 0 ? 1.0f : (float)correctAttacks / (float)(correctAttacks + wrongAttacks); }
+        float Recall() const { return expectedAttacks == 0 ? 1.0f : (float)std::min(correctAttacks, expectedAttacks) / (float)expectedAttacks; }
+        double NanosPerUpdate() const { return updates == 0 ? 0.0 : std::chrono::duration<double, std::nano>(updateTime).count() / (double)updates; }
+    };
+
+    WeaponMotionTrace() = default;
+    explicit WeaponMotionTrace(WeaponType weaponType) : m_header{ .weaponType = (uint32_t)weaponType } {}
+
+    size_t GetSampleCount() const { return m_samples.size(); }
+    AttackType GetLabel() const { return (AttackType)m_header.label; }
+
+    void Add(const DebugSample& hand, const glm::fmat4& headsetMtx, XrTime hitTime) {
+        const glm::fvec3 headsetPosition = glm::fvec3(headsetMtx[3]);
+        const glm::fquat headsetRotation = glm::quat_cast(headsetMtx);
+        m_samples.push_back({ hand.time, hitTime, {
+            hand.position.x, hand.position.y, hand.position.z,
+            hand.rotation.x, hand.rotation.y, hand.rotation.z, hand.rotation.w,
+            hand.linearVelocity.x, hand.linearVelocity.y, hand.linearVelocity.z,
+            hand.angularVelocity.x, hand.angularVelocity.y, hand.angularVelocity.z,
+            headsetPosition.x, headsetPosition.y, headsetPosition.z,
+            headsetRotation.x, headsetRotation.y, headsetRotation.z, headsetRotation.w,
+        } });
+    }
 
-            velLineX[j * 2] = posX[j];
-            velLineX[j * 2 + 1] = posX[j] + av.x;
-            velLineY[j * 2] = posY[j];
-            velLineY[j * 2 + 1] = posY[j] + av.y;
-            velLineZ[j * 2] = posZ[j];
-            velLineZ[j * 2 + 1] = posZ[j] + av.z;
+    bool Save(const std::filesystem::path& path, AttackType label, uint32_t expectedAttacks) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            Log::print<ERROR>("Failed to open {} to save the weapon motion trace", path.string());
+            return false;
         }
+        return Save(file, label, expectedAttacks);
+    }
 
-        if (ImPlot3D::BeginPlot("Weapon Motion", { 0, 300 }, ImPlot3DFlags_NoTitle)) {
-            ImPlot3D::SetupAxes("X", "Z", "Y", ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax, ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax, ImPlot3DAxisFlags_LockMin | ImPlot3DAxisFlags_LockMax);
-            ImPlot3D::SetupAxisLimits(ImAxis3D_X, xMin - 0.1f, xMax + 0.1f, ImPlot3DCond_Always);
-            ImPlot3D::SetupAxisLimits(ImAxis3D_Y, yMin - 0.1f, yMax + 0.1f, ImPlot3DCond_Always);
-            ImPlot3D::SetupAxisLimits(ImAxis3D_Z, zMin - 0.1f, zMax + 0.1f, ImPlot3DCond_Always);
+    bool Save(std::ostream& stream, AttackType label, uint32_t expectedAttacks) {
+        m_header.label = (uint32_t)label;
+        m_header.expectedAttacks = expectedAttacks;
+        m_header.sampleCount = (uint32_t)m_samples.size();
+        stream.write((const char*)&m_header, sizeof(m_header));
+        stream.write((const char*)m_samples.data(), (std::streamsize)(m_samples.size() * sizeof(PackedSample)));
+        return stream.good();
+    }
 
-            ImPlot3D::SetNextMarkerStyle(ImPlot3DMarker_Circle, 1.5f);
-            ImPlot3D::PlotScatter("Pos", posX.data(), posY.data(), posZ.data(), MAX_SAMPLES);
+    static std::optional<WeaponMotionTrace> Load(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return Load(file, path.string());
+    }
 
-            ImPlot3D::SetNextLineStyle(ImVec4(0, 1, 0.5f, 0.5f), 1.2f);
-            ImPlot3D::PlotLine("AngVel", velLineX.data(), velLineY.data(), velLineZ.data(), MAX_SAMPLES * 2, ImPlot3DLineFlags_Segments);
-            ImPlot3D::EndPlot();
+    // The header is checked against the size of the stream before anything gets allocated, so a corrupt or hostile sample count is rejected up front
+    static std::optional<WeaponMotionTrace> Load(std::istream& stream, const std::string& name) {
+        WeaponMotionTrace trace;
+        if (!stream.read((char*)&trace.m_header, sizeof(trace.m_header)) || trace.m_header.magic != MAGIC || trace.m_header.version == 0 || trace.m_header.version > VERSION) {
+            Log::print<WARNING>("{} isn't a weapon motion trace of version {}", name, VERSION);
+            return std::nullopt;
+        }
+        if (trace.m_header.label > (uint32_t)AttackType::Stab || trace.m_header.weaponType > (uint32_t)WeaponType::UnknownWeapon) {
+            Log::print<WARNING>("{} has an unknown attack label {} or weapon type {}", name, trace.m_header.label, trace.m_header.weaponType);
+            return std::nullopt;
         }
-        ImGui::SameLine();
-
-        {
-            std::array<float, MAX_SAMPLES> t{}, avX{}, avY{}, avZ{}, maskSlash{}, maskStab{}, velLengthTriggered{};
-            for (uint32_t j = 0; j < MAX_SAMPLES; ++j) {
-                const auto& s = m_rollingSamples[oldestIdx(j)];
-                t[j] = static_cast<float>(j);
-                avX[j] = s.rotatedAngularVelocity().x;
-                avY[j] = s.rotatedAngularVelocity().y;
-                avZ[j] = s.rotatedAngularVelocity().z;
-                maskSlash[j] = (s.debug_attackType == AttackType::Slash) ? 100.0f : -100.0f;
-                maskStab[j] = (s.debug_attackType == AttackType::Stab) ? 100.0f : -100.0f;
-                velLengthTriggered[j] = s.debug_expVelocityLengthEnabled ? 100.0f : -100.0f;
-            }
 
-            if (ImPlot::BeginPlot("Weapon Steadiness", { 0, 300 }, ImPlotFlags_NoTitle)) {
-                ImPlot::SetupAxes("Sample", "Angular Velocity", ImPlotAxisFlags_Lock, ImPlotAxisFlags_Lock);
-                ImPlot::SetupAxisLimits(ImAxis_X1, 0, MAX_SAMPLES - 1, ImPlotCond_Always);
-                ImPlot::SetupAxisLimits(ImAxis_Y1, -15, 15, ImPlotCond_Always);
-
-                ImPlot::SetNextLineStyle(ImVec4(0, 1, 0, 0.3f), 3);
-                ImPlot::PlotShaded("Slash", t.data(), maskSlash.data(), MAX_SAMPLES, -100.0f);
-                ImPlot::SetNextLineStyle(ImVec4(1, 0.5f, 0, 0.3f), 3);
-                ImPlot::PlotShaded("Stab", t.data(), maskStab.data(), MAX_SAMPLES, -100.0f);
-                ImPlot::SetNextLineStyle(ImVec4(0, 0, 0.8f, 0.3f), 3);
-                ImPlot::PlotShaded("VelLengthEnabled", t.data(), velLengthTriggered.data(), MAX_SAMPLES, -100.0f);
-
-                ImPlot::SetNextLineStyle(ImVec4(0, 1, 0.5f, 0.5f), 2);
-                ImPlot::PlotLine("X", t.data(), avX.data(), MAX_SAMPLES);
-                ImPlot::PlotLine("Y", t.data(), avY.data(), MAX_SAMPLES);
-                ImPlot::PlotLine("Z", t.data(), avZ.data(), MAX_SAMPLES);
-                ImPlot::EndPlot();
-            }
-            ImGui::SameLine();
+        const std::streampos samplesStart = stream.tellg();
+        stream.seekg(0, std::ios::end);
+        const std::streamoff remainingBytes = stream.tellg() - samplesStart;
+        stream.seekg(samplesStart);
+        // version 1 didn't store the display time
+        const uint64_t sampleSize = trace.m_header.version == 1 ? sizeof(PackedSample::time) + sizeof(PackedSample::values) : sizeof(PackedSample);
+        if (!stream || remainingBytes < 0 || (uint64_t)remainingBytes < trace.m_header.sampleCount * sampleSize) {
+            Log::print<WARNING>("{} is truncated, expected {} samples but only has room for {}", name, trace.m_header.sampleCount, remainingBytes < 0 ? 0 : (uint64_t)remainingBytes / sampleSize);
+            return std::nullopt;
         }
 
-        {
-            std::array<float, MAX_SAMPLES> t{}, avX{}, avY{}, avZ{}, avddX{}, maskSlash{}, maskStab{};
-            XrTime prevDelta = 0;
-            for (uint32_t j = 0; j < MAX_SAMPLES; ++j) {
-                const auto& s = m_rollingSamples[oldestIdx(j)];
-                t[j] = static_cast<float>(j);
-                avX[j] = s.rotatedLinearVelocity().x;
-                avddX[j] = s.rotLinearAccel.x;
-                avY[j] = s.rotatedLinearVelocity().y;
-                avZ[j] = s.rotatedLinearVelocity().z;
-                maskSlash[j] = (s.debug_attackType == AttackType::Slash) ? 100.0f : -100.0f;
-                maskStab[j] = (s.debug_attackType == AttackType::Stab) ? 100.0f : -100.0f;
+        trace.m_samples.resize(trace.m_header.sampleCount);
+        bool complete = true;
+        if (trace.m_header.version == 1) {
+            // without a display time the analyser falls back to checking the travel at the sample's own time
+            for (PackedSample& sample : trace.m_samples) {
+                sample.hitTime = 0;
+                complete = complete && stream.read((char*)&sample.time, sizeof(sample.time)) && stream.read((char*)sample.values, sizeof(sample.values));
             }
+            trace.m_header.version = VERSION;
+        }
+        else {
+            complete = (bool)stream.read((char*)trace.m_samples.data(), (std::streamsize)(trace.m_samples.size() * sizeof(PackedSample)));
+        }
+        if (!complete) {
+            Log::print<WARNING>("{} is truncated, expected {} samples", name, trace.m_header.sampleCount);
+            return std::nullopt;
+        }
+        return trace;
+    }
 
-            if (ImPlot::BeginPlot("Controller Linear Velocity", { 0, 300 }, ImPlotFlags_NoTitle)) {
-                ImPlot::SetupAxes("Sample", "Linear Velocity", ImPlotAxisFlags_Lock, ImPlotAxisFlags_Lock);
-                ImPlot::SetupAxisLimits(ImAxis_X1, 0, MAX_SAMPLES - 1, ImPlotCond_Always);
-                ImPlot::SetupAxisLimits(ImAxis_Y1, -6, 6, ImPlotCond_Always);
-
-                ImPlot::SetNextLineStyle(ImVec4(0, 1, 0, 0.01f), 3);
-                ImPlot::PlotShaded("Slash", t.data(), maskSlash.data(), MAX_SAMPLES, -100.0f);
-                ImPlot::SetNextLineStyle(ImVec4(1, 0.5f, 0, 0.01f), 3);
-                ImPlot::PlotShaded("Stab", t.data(), maskStab.data(), MAX_SAMPLES, -100.0f);
-
-                ImPlot::SetNextLineStyle(ImVec4(0, 1, 0.5f, 0.5f), 2);
-                ImPlot::PlotLine("X", t.data(), avX.data(), MAX_SAMPLES);
-                ImPlot::PlotLine("Y", t.data(), avY.data(), MAX_SAMPLES);
-                ImPlot::PlotLine("Z", t.data(), avZ.data(), MAX_SAMPLES);
-                ImPlot::PlotLine("ddX", t.data(), avddX.data(), MAX_SAMPLES);
-                ImPlot::EndPlot();
-            }
-            ImGui::SameLine();
+    // Runs the samples through a fresh analyser with the current profile of the recorded weapon type. Every time an attack starts it counts as
+    // correct if it's the type the trace was labeled with, and as wrong otherwise.
+    ReplayResult Replay(uint32_t repetitions) const {
+        std::vector<std::tuple<DebugSample, glm::fmat4, XrTime>> samples;
+        samples.reserve(m_samples.size());
+        for (const PackedSample& packed : m_samples) {
+            const float* v = packed.values;
+            const DebugSample hand = {
+                .time = packed.time,
+                .position = { v[0], v[1], v[2] },
+                .rotation = glm::fquat(v[6], v[3], v[4], v[5]),
+                .linearVelocity = { v[7], v[8], v[9] },
+                .angularVelocity = { v[10], v[11], v[12] },
+            };
+            const glm::fmat4 headsetMtx = glm::translate(glm::identity<glm::fmat4>(), glm::fvec3(v[13], v[14], v[15])) * glm::mat4_cast(glm::fquat(v[19], v[16], v[17], v[18]));
+            samples.emplace_back(hand, headsetMtx, packed.hitTime);
         }
 
-        // pass references to be manipulated in the drawSnapshot function
-        glm::vec3& lastAngDir = m_debugLastAngDir;
-        bool& angValid = m_debugAngValid;
-        glm::vec3& lastLinDir = m_debugLastLinDir;
-        bool& linValid = m_debugLinValid;
+        ReplayResult result = { .expectedAttacks = m_header.expectedAttacks };
+        const AttackType label = (AttackType)m_header.label;
+        for (uint32_t repetition = 0; repetition < repetitions; repetition++) {
+            WeaponMotionAnalyser analyser;
+            analyser.SetProfile(WeaponProfiles::Get((WeaponType)m_header.weaponType));
+
+            AttackType previous = AttackType::None;
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto& [hand, headsetMtx, hitTime] : samples) {
+                analyser.Update(hand, headsetMtx, hitTime);
+                const AttackType detected = analyser.GetActiveAttackType();
+                if (repetition == 0 && detected != AttackType::None && detected != previous) {
+                    (detected == label ? result.correctAttacks : result.wrongAttacks)++;
+                }
+                previous = detected;
+            }
+            result.updateTime += std::chrono::steady_clock::now() - start;
+            result.updates += samples.size();
+        }
+        return result;
+    }
 
-        const glm::vec3 currAng = m_rollingSamples[m_lastSampleIdx].rotatedAngularVelocity();
-        const glm::vec3 currLin = glm::inverse(m_rollingSamples[m_lastSampleIdx].rotation) * m_rollingSamples[m_lastSampleIdx].linearVelocity;
+private:
+    Header m_header = {};
+    std::vector<PackedSample> m_samples;
+};
 
-        drawSnapshot("AngVel Snapshot", currAng, lastAngDir, angValid, 1.5f, ImVec4(1, 0, 0, 1), ImVec4(0.4f, 0.7f, 1, 0.25f));
-        drawSnapshot("LinVel Snapshot", currLin, lastLinDir, linValid, 1.5f, ImVec4(0, 1, 0, 1), ImVec4(1, 0.7f, 0.2f, 0.25f));
+// Records the samples of one hand into a trace. The game thread adds samples while the debug window starts and saves recordings,
+// the label is picked when saving so that it can be decided after performing the attacks.
+class WeaponMotionRecorder {
+public:
+    void Start(WeaponType weaponType) {
+        std::lock_guard lock(m_mutex);
+        m_trace = WeaponMotionTrace(weaponType);
+        m_recording = true;
     }
 
-private:
-    WeaponType m_weaponType = LargeSword;
-    WeaponProfile m_profile = {};
+    bool IsRecording() const { return m_recording; }
 
-    std::array<DebugSample, MAX_SAMPLES> m_rollingSamples = {};
-    uint32_t m_lastSampleIdx = 0;
-    uint32_t m_rollingSamplesIt = 0;
+    void Add(const DebugSample& hand, const glm::fmat4& headsetMtx, XrTime hitTime) {
+        if (!m_recording) return;
+        std::lock_guard lock(m_mutex);
+        m_trace.Add(hand, headsetMtx, hitTime);
+    }
 
-    uint32_t m_goodSwingSampleCtr = 0;
-    uint32_t m_badSwingSampleCtr = 0;
-    bool m_attackActivity = false;
-    bool m_isHitboxEnabled = false;
-    uint32_t m_badSampleCtr = 0;
-    AttackType m_lockedAttackType = AttackType::None;
-    glm::fvec3 m_lockedPosition = {};
-    glm::fvec3 m_lockedAngle = {};
-    uint32_t m_goodStabSampleCtr = 0;
-    uint32_t m_badStabSampleCtr = 0;
+    size_t GetSampleCount() {
+        std::lock_guard lock(m_mutex);
+        return m_trace.GetSampleCount();
+    }
 
-    mutable glm::vec3 m_debugLastAngDir = {1, 0, 0};
-    mutable bool m_debugAngValid = false;
-    mutable glm::vec3 m_debugLastLinDir = { 1, 0, 0 };
-    mutable bool m_debugLinValid = false;
-};
\ No newline at end of file
+    bool StopAndSave(const std::filesystem::path& path, AttackType label, uint32_t expectedAttacks) {
+        m_recording = false;
+        std::lock_guard lock(m_mutex);
+        return m_trace.Save(path, label, expectedAttacks);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::atomic_bool m_recording = false;
+    WeaponMotionTrace m_trace;
+};
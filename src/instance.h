@@ -7,8 +7,12 @@
 #include "rendering/openxr.h"
 #include "rendering/renderer.h"
 #include "rendering/vulkan.h"
+#include "utils/startup_timeline.h"
 #include "utils/update_checker.h"
 
+#include <future>
+#include <mutex>
+
 class VRManager {
 public:
     static VRManager& instance() {
@@ -19,33 +23,86 @@ public:
     VRManager(VRManager const&) = delete;
     void operator=(VRManager const&) = delete;
 
+    // Startup is split into stages that are started as soon as their inputs exist, so that they run on worker threads while Cemu is still
+    // setting up its own Vulkan instance/device. Only the parts that need Cemu's VkDevice or a command buffer are done on the render thread.
+
+    // Stage 1 (vkCreateInstance): the OpenXR instance is needed to pick the VR GPU, the update check is independent of everything else
+    static void BeginInstanceStage() {
+        static std::once_flag started;
+        std::call_once(started, []() {
+            // the logger gets created here so that it's set up before any other thread can log
+            VRManager& manager = VRManager::instance();
+            s_instanceStage = std::async(std::launch::async, [&manager]() {
+                StartupTimeline::ScopedStage stage("OpenXR instance");
+                manager.XR = std::make_unique<OpenXR>();
+            });
+            UpdateChecker::CheckForUpdates();
+        });
+    }
+
+    // Called from vkCreateInstance and from every hook that needs the OpenXR instance before the device stage, only the first call waits
+    static void JoinInstanceStage() {
+        std::scoped_lock lock(s_instanceStageMutex);
+        if (s_instanceStage.valid()) {
+            StartupTimeline::ScopedStage stage("Waiting on OpenXR instance");
+            s_instanceStage.get();
+        }
+    }
+
+    // Stage 2 (vkCreateDevice): the D3D12 device and the OpenXR session only depend on the OpenXR instance
+    void BeginDeviceStage() {
+        std::call_once(m_deviceStageStarted, [this]() {
+            JoinInstanceStage();
+            m_deviceStage = std::async(std::launch::async, [this]() {
+                {
+                    StartupTimeline::ScopedStage stage("D3D12 device");
+                    D3D12 = std::make_unique<RND_D3D12>();
+                }
+                {
+                    StartupTimeline::ScopedStage stage("OpenXR session and actions");
+                    XrGraphicsBindingD3D12KHR d3d12Binding = { XR_TYPE_GRAPHICS_BINDING_D3D12_KHR };
+                    d3d12Binding.device = D3D12->GetDevice();
+                    d3d12Binding.queue = D3D12->GetCommandQueue();
+                    XR->CreateSession(d3d12Binding);
+                    XR->CreateActions();
+                }
+            });
+        });
+    }
+
+    // Stage 3 (first vkCmdClearColorImage): wraps Cemu's VkDevice and joins the previous stages, rethrowing any errors they ran into
     void Init(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device) {
-        D3D12 = std::make_unique<RND_D3D12>();
-        VK = std::make_unique<RND_Vulkan>(instance, physicalDevice, device);
+        BeginDeviceStage();
+        {
+            StartupTimeline::ScopedStage stage("Vulkan interop setup");
+            VK = std::make_unique<RND_Vulkan>(instance, physicalDevice, device);
+        }
+        {
+            StartupTimeline::ScopedStage stage("Waiting on D3D12 device and OpenXR session");
+            m_deviceStage.get();
+        }
         Log::print<INFO>("Initialized VRManager instance...");
-        UpdateChecker::CheckForUpdates();
     }
 
     void InitSession() {
-        XrGraphicsBindingD3D12KHR d3d12Binding = { XR_TYPE_GRAPHICS_BINDING_D3D12_KHR };
-        d3d12Binding.device = D3D12->GetDevice();
-        d3d12Binding.queue = D3D12->GetCommandQueue();
-        XR->CreateSession(d3d12Binding);
-        XR->CreateActions();
+        StartupTimeline::ScopedStage stage("Cemu hooks");
         Hooks = std::make_unique<CemuHooks>();
+        m_initialized = true;
     }
 
+    bool IsInitialized() const { return m_initialized; }
+
     std::unique_ptr<OpenXR> XR;
     std::unique_ptr<RND_D3D12> D3D12;
     std::unique_ptr<RND_Vulkan> VK;
     std::unique_ptr<CemuHooks> Hooks;
 
     uint32_t vkVersion = 0;
+    bool vkSynchronization2Enabled = false;
 
 private:
     VRManager() {
         m_logger = std::make_unique<Log>();
-        XR = std::make_unique<OpenXR>();
     };
 
     ~VRManager() {
@@ -58,4 +115,10 @@ private:
     };
 
     std::unique_ptr<Log> m_logger;
+
+    inline static std::future<void> s_instanceStage;
+    inline static std::mutex s_instanceStageMutex;
+    std::once_flag m_deviceStageStarted;
+    std::future<void> m_deviceStage;
+    std::atomic_bool m_initialized = false;
 };
\ No newline at end of file
@@ -182,6 +182,8 @@ OpenXR::OpenXR() {
     checkXRResult(func_xrGetD3D12GraphicsRequirementsKHR(m_instance, m_systemId, &graphicsRequirements), "Couldn't get D3D12 requirements for the given VR headset!");
     m_capabilities.adapter = graphicsRequirements.adapterLuid;
     m_capabilities.minFeatureLevel = graphicsRequirements.minFeatureLevel;
+    m_capabilities.runtimeName = properties.runtimeName;
+    m_capabilities.systemName = xrSystemProperties.systemName;
 
     // Print configuration used, mostly for debugging purposes
     Log::print<INFO>("Acquired system to be used:");
@@ -482,50 +484,6 @@ void OpenXR::CreateActions() {
     m_rumbleManager.get()->initializeXrPathsAndStartTime(m_instance);
 }
 
-void CheckButtonState(bool buttonPressed, ButtonState& buttonState) {
-    buttonState.resetFrameFlags();
-    
-    constexpr std::chrono::milliseconds longPressThreshold{ 250 };
-    const bool down = buttonPressed;
-    const auto now = std::chrono::steady_clock::now();
-    
-    // Rising edge - button just pressed
-    if (down && !buttonState.wasDownLastFrame) {
-        buttonState.pressStartTime = now;
-    }
-    
-    // Pressed state - check for long press threshold
-    if (down) {
-        auto pressDuration = now - buttonState.pressStartTime;
-        
-        if (pressDuration >= longPressThreshold) {
-            buttonState.lastEvent = ButtonState::Event::LongPress;
-            buttonState.longFired = true;
-            if (!buttonState.longFired_stillPressed) {
-                buttonState.longFired_stillPressed = true;
-                buttonState.longFired_actedUpon = true;
-            }
-        }
-    }
-    else {
-        buttonState.longFired_stillPressed = false;
-        buttonState.longFired_actedUpon = false;
-    }
-    
-    // Falling edge - button just released
-    if (!down && buttonState.wasDownLastFrame) {
-        // Only register short press if long press didn't fire
-        if (!buttonState.longFired) {
-            buttonState.lastEvent = ButtonState::Event::ShortPress;
-        }
-        else
-            buttonState.longFired = false; // reset long press fired flag
-    }
-    
-    // Store current state for next frame
-    buttonState.wasDownLastFrame = down;
-}
-
 std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTime, glm::fquat controllerRotation, bool inMenu) {
     XrActiveActionSet activeActionSet = { (inMenu ? m_menuActionSet : m_gameplayActionSet), XR_NULL_PATH };
 
@@ -536,6 +494,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
 
     InputState newState = m_input.load();
     newState.shared.in_game = !inMenu;
+    const auto now = std::chrono::steady_clock::now();
     newState.shared.inputTime = predictedFrameTime;
 
     for (EyeSide side : { EyeSide::LEFT, EyeSide::RIGHT }) {
@@ -558,7 +517,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
 
                 if ((spaceLocation.locationFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) != 0 && (spaceLocation.locationFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) != 0) {
                     // rotate angular velocity to world space when it's using a buggy runtime
-                    auto mode = GetSettings().AngularVelocityFixer_GetMode();
+                    auto mode = GetSettings()->AngularVelocityFixer_GetMode();
                     bool isUsingQuestRuntime = m_capabilities.isOculusLinkRuntime;
                     if ((mode == AngularVelocityFixerMode::AUTO && isUsingQuestRuntime) || mode == AngularVelocityFixerMode::FORCED_ON) {
                         glm::vec3 angularVelocity = ToGLM(spaceVelocity.angularVelocity);
@@ -583,7 +542,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
     auto& inventory_mapButtonState = newState.shared.inventory_mapState;
     if (inventory_mapAction.isActive == XR_TRUE) {
         auto buttonPressed = inventory_mapAction.currentState == XR_TRUE;
-        CheckButtonState(buttonPressed, inventory_mapButtonState); 
+        inventory_mapButtonState.Update(buttonPressed, now);
     }
 
     XrActionStateGetInfo getModMenuInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
@@ -596,7 +555,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
     auto& modMenuButtonState = newState.shared.modMenuState;
     if (modMenuAction.isActive == XR_TRUE) {
         auto buttonPressed = modMenuAction.currentState == XR_TRUE;
-        CheckButtonState(buttonPressed, modMenuButtonState);
+        modMenuButtonState.Update(buttonPressed, now);
     }
 
     // update in-menu or in-game actions
@@ -634,7 +593,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
         auto& holdButtonState = newState.inMenu.holdState;
         if (newState.inMenu.hold.isActive == XR_TRUE) {
             auto buttonPressed = newState.inMenu.hold.currentState == XR_TRUE;
-            CheckButtonState(buttonPressed, holdButtonState);
+            holdButtonState.Update(buttonPressed, now);
         }
 
         XrActionStateGetInfo getLeftGripInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
@@ -678,7 +637,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
             auto& buttonState = newState.inGame.grabState[side];
             if (newState.inGame.grab[side].isActive == XR_TRUE) {
                 auto buttonPressed = newState.inGame.grab[side].currentState > 0.75f;
-                CheckButtonState(buttonPressed, buttonState);
+                buttonState.Update(buttonPressed, now);
             }
         }
 
@@ -691,7 +650,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
         auto& crouch_scopeButtonState = newState.inGame.crouch_scopeState;
         if (newState.inGame.crouch_scope.isActive == XR_TRUE) {
             auto buttonPressed = newState.inGame.crouch_scope.currentState == XR_TRUE;
-            CheckButtonState(buttonPressed, crouch_scopeButtonState);
+            crouch_scopeButtonState.Update(buttonPressed, now);
         }
 
         XrActionStateGetInfo getMoveInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
@@ -719,7 +678,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
         auto& runButtonState = newState.inGame.runState;
         if (newState.inGame.run_interact.isActive == XR_TRUE) {
             auto buttonPressed = newState.inGame.run_interact.currentState == XR_TRUE;
-            CheckButtonState(buttonPressed, runButtonState);
+            runButtonState.Update(buttonPressed, now);
         }
 
         XrActionStateGetInfo getUseRuneInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
@@ -731,7 +690,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
         auto& useRuneButtonState = newState.inGame.useRune_runeMenuState;
         if (newState.inGame.useRune_dpadMenu.isActive == XR_TRUE) {
             auto buttonPressed = newState.inGame.useRune_dpadMenu.currentState == XR_TRUE;
-            CheckButtonState(buttonPressed, useRuneButtonState);
+            useRuneButtonState.Update(buttonPressed, now);
         }
 
         XrActionStateGetInfo getUseRightItemInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "hooking/button_state.h"
 #include "hooking/rumble.h"
 
 class OpenXR {
@@ -22,35 +23,11 @@ public:
         bool supportsMutatableFOV;
         bool isOculusLinkRuntime;
         bool isMetaSimulator;
+        std::string runtimeName;
+        std::string systemName;
     } m_capabilities = {};
 
     struct InputState {
-        struct ButtonState {
-            enum class Event {
-                None,
-                ShortPress,
-                LongPress,
-                //DoublePress
-            };
-
-            bool wasDownLastFrame = false;
-            bool longFired = false;
-            bool waitingForSecond = false;
-            bool longFired_actedUpon = false;
-            bool longFired_stillPressed = false;
-            std::chrono::steady_clock::time_point pressStartTime;
-            std::chrono::steady_clock::time_point lastReleaseTime;
-
-            Event lastEvent = Event::None;
-
-            void resetFrameFlags() { lastEvent = Event::None; }
-            void resetButtonState() {
-                wasDownLastFrame = false;
-                longFired = false;
-                waitingForSecond = false;
-            }
-        };
-
         struct Shared {
             bool in_game = true;
             XrTime inputTime;
@@ -128,12 +105,7 @@ public:
         std::chrono::steady_clock::time_point prevent_grab_time;
 
         //Pull gesture
-        bool right_hand_was_over_left_shoulder_slot = false;
-        bool right_hand_was_over_right_shoulder_slot = false;
-        bool right_hand_was_over_left_waist_slot = false;
-        bool left_hand_was_over_left_shoulder_slot = false;
-        bool left_hand_was_over_right_shoulder_slot = false;
-        bool left_hand_was_over_left_waist_slot = false;
+        std::array<uint32_t, 2> hand_slots_last_frame = {}; // BodySlots::SlotMask of each hand, LEFT/RIGHT
 
         EquipType right_equip_type = EquipType::None;
         EquipType left_equip_type = EquipType::None;
@@ -153,10 +125,8 @@ public:
         bool is_paragliding = false;
 
         float left_hand_velocity = 0.0f;
-        glm::fvec3 stored_left_hand_position = glm::fvec3(0.0f, 0.0f, 0.0f);
-        bool left_hand_position_stored = false;
-        glm::fvec3 stored_right_hand_position = glm::fvec3(0.0f, 0.0f, 0.0f);
-        bool right_hand_position_stored = false;
+        std::array<glm::fvec3, 2> stored_hand_position = {}; // LEFT/RIGHT
+        std::array<bool, 2> hand_position_stored = {};       // LEFT/RIGHT
         int magnesis_forward_frames_interval = 0;
         bool weapon_throwed = false;
     };
@@ -256,7 +226,6 @@ private:
     PFN_xrCreateDebugUtilsMessengerEXT func_xrCreateDebugUtilsMessengerEXT = nullptr;
     PFN_xrDestroyDebugUtilsMessengerEXT func_xrDestroyDebugUtilsMessengerEXT = nullptr;
 };
-using ButtonState = OpenXR::InputState::ButtonState;
 using EyeSide = OpenXR::EyeSide;
 
 template <>
@@ -154,6 +154,10 @@ void RND_Renderer::EndFrame() {
     if (XR_FAILED(xrResult)) {
         Log::print<ERROR>("xrEndFrame #{} FAILED with result {}", s_endFrameCount, (int)xrResult);
     }
+    else if (!compositionLayers.empty()) {
+        StartupTimeline::Mark("First frame submitted to the headset");
+        StartupTimeline::Report();
+    }
 
     VRManager::instance().D3D12->EndFrame();
 }
@@ -326,8 +330,8 @@ const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::Fi
         },
         .minDepth = 0.0f,
         .maxDepth = 1.0f,
-        .nearZ = GetSettings().GetZNear(),
-        .farZ = GetSettings().GetZFar(),
+        .nearZ = GetSettings()->GetZNear(),
+        .farZ = GetSettings()->GetZFar(),
     };
     m_projectionViews[EyeSide::RIGHT] = {
         .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW,
@@ -359,8 +363,8 @@ const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::Fi
         },
         .minDepth = 0.0f,
         .maxDepth = 1.0f,
-        .nearZ = GetSettings().GetZNear(),
-        .farZ = GetSettings().GetZFar(),
+        .nearZ = GetSettings()->GetZNear(),
+        .farZ = GetSettings()->GetZFar(),
     };
     // clang-format on
     return m_projectionViews;
@@ -458,7 +462,7 @@ std::vector<XrCompositionLayerQuad> RND_Renderer::Layer2D::FinishRendering(XrTim
     XrPosef layerPose = { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } };
 
     // todo: switch to following UI whenever the player holds a bow
-    if (GetSettings().DoesUIFollowGaze()) {
+    if (GetSettings()->DoesUIFollowGaze()) {
         m_currentOrientation = glm::slerp(m_currentOrientation, headOrientation, LERP_SPEED);
         glm::vec3 forwardDirection = headOrientation * glm::vec3(0.0f, 0.0f, -1.0f);
 
@@ -5,6 +5,7 @@
 #include "openxr.h"
 #include "swapchain.h"
 #include "texture.h"
+#include "utils/help_images.h"
 
 class SharedTexture;
 
@@ -194,6 +195,9 @@ public:
             VkDescriptorSet m_imageDS = VK_NULL_HANDLE;
         };
         std::vector<std::vector<HelpImage>> m_helpImagePages;
+        std::future<std::vector<HelpImages::DecodedPage>> m_helpImagesDecoding;
+        bool m_helpImagesRequested = false;
+        void UploadDecodedHelpImages(VkCommandBuffer cb);
 
         VkSampler m_sampler = VK_NULL_HANDLE;
         VkExtent2D m_outputRes = {};
@@ -218,6 +222,9 @@ public:
     void SignalGameCapturing3DFrameBuffer() {
         m_cameraIsCapturing3DFrameBuffer = 1;
     }
+    XrTime GetLastPredictedDisplayTime() const {
+        return m_lastPredictedDisplayTime;
+    }
 
 protected:
     XrSession m_session;
@@ -230,7 +237,7 @@ protected:
     std::atomic_uint8_t m_cameraIsCapturing3DFrameBuffer = 0;
 
     // Full-frame timing derived from OpenXR timestamps (XrTime is in nanoseconds)
-    XrTime m_lastPredictedDisplayTime = 0;
+    std::atomic<XrTime> m_lastPredictedDisplayTime = 0;
 
     std::chrono::high_resolution_clock::time_point m_frameStartTime;
 
@@ -517,8 +517,33 @@ void SharedTexture::CopyFromVkImage(VkCommandBuffer cmdBuffer, VkImage srcImage)
         .extent = { (uint32_t)this->m_d3d12Texture->GetDesc().Width, (uint32_t)this->m_d3d12Texture->GetDesc().Height, 1 }
     };
 
-    // Copy using the correct layouts
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
+    if (!VRManager::instance().vkSynchronization2Enabled) {
+        // Copy using the correct layouts
+        VulkanUtils::DebugPipelineBarrier(cmdBuffer);
+        dispatch->CmdCopyImage(cmdBuffer, srcImage, VK_IMAGE_LAYOUT_GENERAL, this->m_vkImage, VK_IMAGE_LAYOUT_GENERAL, 1, &copyRegion);
+        VulkanUtils::DebugPipelineBarrier(cmdBuffer);
+        return;
+    }
+
+    // only wait on the stages that actually touch both images instead of draining the whole pipeline around the copy
+    constexpr VulkanUtils::InteropCopyBarrierPlan COLOR_PLAN = VulkanUtils::PlanInteropCopyBarriers(false);
+    constexpr VulkanUtils::InteropCopyBarrierPlan DEPTH_PLAN = VulkanUtils::PlanInteropCopyBarriers(true);
+    const VulkanUtils::InteropCopyBarrierPlan& plan = VulkanUtils::IsDepthFormat(m_vkFormat) ? DEPTH_PLAN : COLOR_PLAN;
+
+    std::array<VkImageMemoryBarrier2, 2> preCopyBarriers = {
+        VulkanUtils::MakeImageBarrier(plan.srcBefore, srcImage, aspectMask),
+        VulkanUtils::MakeImageBarrier(plan.dstBefore, this->m_vkImage, aspectMask)
+    };
+    VkDependencyInfo preCopyDependency = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    preCopyDependency.imageMemoryBarrierCount = (uint32_t)preCopyBarriers.size();
+    preCopyDependency.pImageMemoryBarriers = preCopyBarriers.data();
+    dispatch->CmdPipelineBarrier2(cmdBuffer, &preCopyDependency);
+
     dispatch->CmdCopyImage(cmdBuffer, srcImage, VK_IMAGE_LAYOUT_GENERAL, this->m_vkImage, VK_IMAGE_LAYOUT_GENERAL, 1, &copyRegion);
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
+
+    VkImageMemoryBarrier2 postCopyBarrier = VulkanUtils::MakeImageBarrier(plan.srcAfter, srcImage, aspectMask);
+    VkDependencyInfo postCopyDependency = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    postCopyDependency.imageMemoryBarrierCount = 1;
+    postCopyDependency.pImageMemoryBarriers = &postCopyBarrier;
+    dispatch->CmdPipelineBarrier2(cmdBuffer, &postCopyDependency);
 }
\ No newline at end of file
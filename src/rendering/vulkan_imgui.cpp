@@ -1,6 +1,7 @@
 ﻿#include "hooking/cemu_hooks.h"
 #include "hooking/entity_debugger.h"
 #include "instance.h"
+#include "utils/help_images.h"
 #include "utils/vulkan_utils.h"
 #include "vulkan.h"
 
@@ -10,7 +11,6 @@
 // include font and assets
 #include "font_kenney.h"
 #include "font_roboto.h"
-#include "utils/controller_image.h"
 
 
 void SetupImGuiStyle() {
@@ -294,37 +294,6 @@ RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, VkExtent2D fbRes, V
         frame.hudWithoutAlphaFramebufferDS = ImGui_ImplVulkan_AddTexture(m_sampler, frame.hudWithoutAlphaFramebuffer->GetImageView(), VK_IMAGE_LAYOUT_GENERAL);
     }
 
-    // create VulkanTexture
-    auto createHelpImage = [&](stbi_uc const* imageData, int imageSize) {
-        // load png image using stb_image
-        int width, height, channels;
-        unsigned char* img = stbi_load_from_memory(imageData, imageSize, &width, &height, &channels, STBI_rgb_alpha);
-
-        // create VulkanTexture from image data
-        HelpImage image;
-        image.m_image = new VulkanTexture{ (uint32_t)width, (uint32_t)height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT };
-        image.m_image->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
-        image.m_image->vkUpload(cb, img, width * height * 4);
-        image.m_image->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
-
-        stbi_image_free(img);
-
-        image.m_imageDS = ImGui_ImplVulkan_AddTexture(m_sampler, image.m_image->GetImageView(), VK_IMAGE_LAYOUT_GENERAL);
-        return image;
-    };
-
-    std::vector<HelpImage> page1;
-    page1.emplace_back(createHelpImage((stbi_uc const*)controls, sizeof(controls)));
-    m_helpImagePages.push_back(page1);
-
-    std::vector<HelpImage> page2;
-    page2.push_back(createHelpImage((stbi_uc const*)equip, sizeof(equip)));
-    m_helpImagePages.push_back(page2);
-
-    std::vector<HelpImage> page3;
-    page3.push_back(createHelpImage((stbi_uc const*)swing, sizeof(swing)));
-    m_helpImagePages.push_back(page3);
-
     VulkanUtils::DebugPipelineBarrier(cb);
 
     // start the first frame right away
@@ -352,6 +321,10 @@ RND_Renderer::ImGuiOverlay::~ImGuiOverlay() {
             frame.imguiFramebuffer.reset();
     }
 
+    // the decoding thread only touches its own buffers, but it can't outlive the DLL
+    if (m_helpImagesDecoding.valid())
+        m_helpImagesDecoding.wait();
+
     for (auto& imagePage : m_helpImagePages) {
         for (auto& helpImage : imagePage) {
             ImGui_ImplVulkan_RemoveTexture(helpImage.m_imageDS);
@@ -431,7 +404,7 @@ void RND_Renderer::ImGuiOverlay::Update() {
         ImGui::GetIO().AddMouseButtonEvent(2, GetAsyncKeyState(VK_MBUTTON) & 0x8000);
     }
 
-    if (GetSettings().ShowDebugOverlay() && isWindowFocused) {
+    if (GetSettings()->ShowDebugOverlay() && isWindowFocused) {
         VRManager::instance().Hooks->m_entityDebugger->UpdateKeyboardControls();
     }
 }
@@ -465,7 +438,7 @@ void RND_Renderer::ImGuiOverlay::Render(long frameIdx, bool renderBackground) {
     };
 
     if (renderBackground || CemuHooks::UseBlackBarsDuringEvents()) {
-        const bool shouldCrop3DTo16_9 = GetSettings().cropFlatTo16x9 == 1;
+        const bool shouldCrop3DTo16_9 = GetSettings()->cropFlatTo16x9 == 1;
 
         bool shouldRender3DBackground = VRManager::instance().XR->GetRenderer()->IsRendering3D(frameIdx) || CemuHooks::UseBlackBarsDuringEvents();
         bool shouldRenderHUDWithAlpha = shouldRender3DBackground && !CemuHooks::UseBlackBarsDuringEvents();
@@ -507,12 +480,12 @@ void RND_Renderer::ImGuiOverlay::Render(long frameIdx, bool renderBackground) {
         renderHUDBackground(VRManager::instance().XR->GetRenderer()->IsRendering3D(frameIdx));
     }
 
-    if (GetSettings().ShowDebugOverlay()) {
+    if (GetSettings()->ShowDebugOverlay()) {
         VRManager::instance().Hooks->m_entityDebugger->DrawEntityInspector();
         VRManager::instance().Hooks->DrawDebugOverlays();
     }
 
-    if (((renderBackground && GetSettings().performanceOverlay == 1) || GetSettings().performanceOverlay == 2) && !VRManager::instance().XR->m_isMenuOpen) {
+    if (((renderBackground && GetSettings()->performanceOverlay == 1) || GetSettings()->performanceOverlay == 2) && !VRManager::instance().XR->m_isMenuOpen) {
         EntityDebugger::DrawFPSOverlay(renderer);
     }
 
@@ -646,14 +619,14 @@ void RND_Renderer::ImGuiOverlay::ProcessInputs(OpenXR::InputState& inputs) {
 
 void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
     auto& isMenuOpen = VRManager::instance().XR->m_isMenuOpen;
-    auto& settings = GetSettings();
+    const std::shared_ptr<const ModSettings> settings = GetSettings();
 
-    float alphaForNotify = settings.tutorialPromptShown ? 0.9f : 0.98f;
-    float timeLimit = settings.tutorialPromptShown ? 14.0f : 60.0f;
+    float alphaForNotify = settings->tutorialPromptShown ? 0.9f : 0.98f;
+    float timeLimit = settings->tutorialPromptShown ? 14.0f : 60.0f;
 
-    if (!settings.tutorialPromptShown) {
+    if (!settings->tutorialPromptShown) {
         if (isMenuOpen || ImGui::GetTime() > timeLimit) {
-            settings.tutorialPromptShown = true;
+            UpdateSettings([&](ModSettings& s) { s.tutorialPromptShown = true; });
             ImGui::SaveIniSettingsToDisk("BetterVR_settings.ini");
         }
     }
@@ -663,7 +636,7 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
         ImGui::SetNextWindowBgAlpha(alphaForNotify);
         ImGui::SetNextWindowPos(fullWindowWidth * 0.5f, ImGuiCond_Always, ImVec2(0.5f, 0.5f));
         if (ImGui::Begin("HelpNotify", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoInputs)) {
-            if (!settings.tutorialPromptShown) {
+            if (!settings->tutorialPromptShown) {
                 ImGui::Text("First-Time Setup:");
                 ImGui::Separator();
                 ImGui::Text("To get started, open the BetterVR menu to configure various settings and to see the controller guide.");
@@ -695,6 +668,12 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
         wasMenuPrevOpened = true;
     }
 
+    // the controller guide is only decoded once the menu is opened for the first time
+    if (!m_helpImagesRequested) {
+        m_helpImagesDecoding = HelpImages::DecodeAsync();
+        m_helpImagesRequested = true;
+    }
+
     ImVec2 fullWindowWidth = ImVec2(ImGui::GetIO().DisplaySize.x, ImGui::GetIO().DisplaySize.y);
     ImVec2 windowWidth = fullWindowWidth * ImVec2(0.75f, 1.0f);
 
@@ -732,18 +711,18 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
 
             if (ImGui::BeginTabBar("HelpMenuTabs")) {
                 if (ImGui::BeginTabItem(ICON_KI_COG "Settings", nullptr, (setTab && selectedTab == 0) ? ImGuiTabItemFlags_SetSelected : 0)) {
-                    auto& settings = GetSettings();
+                    const std::shared_ptr<const ModSettings> settings = GetSettings();
 
                     ImGui::Separator();
-                    int cameraMode = (int)settings.cameraMode.load();
+                    int cameraMode = (int)settings->cameraMode;
                     DrawSettingRow("Camera Mode", [&]() {
                         if (ImGui::RadioButton("First Person (Recommended)", &cameraMode, 1)) {
-                            settings.cameraMode = CameraMode::FIRST_PERSON;
+                            UpdateSettings([&](ModSettings& s) { s.cameraMode = CameraMode::FIRST_PERSON; });
                             changed = true;
                         }
                         ImGui::SameLine();
                         if (ImGui::RadioButton("Third Person", &cameraMode, 0)) {
-                            settings.cameraMode = CameraMode::THIRD_PERSON;
+                            UpdateSettings([&](ModSettings& s) { s.cameraMode = CameraMode::THIRD_PERSON; });
                             changed = true;
                         }
                     });
@@ -754,34 +733,34 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
                     ImGui::Text("Camera / Player Options");
                     ImGui::PopStyleColor();
                     if (cameraMode == 0) {
-                        float distance = settings.thirdPlayerDistance;
+                        float distance = settings->thirdPlayerDistance;
                         DrawSettingRow("Camera Distance", [&]() {
                             if (ImGui::SliderFloat("##CameraDistance", &distance, 0.4f, 1.1f, "%.2f")) {
-                                settings.thirdPlayerDistance = distance;
+                                UpdateSettings([&](ModSettings& s) { s.thirdPlayerDistance = distance; });
                                 changed = true;
                             }
                         });
                     }
                     else {
-                        float height = settings.playerHeightOffset;
+                        float height = settings->playerHeightOffset;
                         std::string heightOffsetValueStr = std::format("{0}{1:.02f} meters / {0}{2:.02f} feet", (height > 0.0f ? "+" : ""), height, height * 3.28084f);
                         DrawSettingRow("Height Offset", [&]() {
                             ImGui::PushItemWidth(windowWidth.x * 0.35f);
                             if (ImGui::SliderFloat("##HeightOffset", &height, -0.5f, 1.0f, heightOffsetValueStr.c_str())) {
-                                settings.playerHeightOffset = height;
+                                UpdateSettings([&](ModSettings& s) { s.playerHeightOffset = height; });
                                 changed = true;
                             }
                             ImGui::PopItemWidth();
                             ImGui::SameLine();
                             if (ImGui::Button("Reset")) {
-                                settings.playerHeightOffset = 0.0f;
+                                UpdateSettings([&](ModSettings& s) { s.playerHeightOffset = 0.0f; });
                                 changed = true;
                             }
                         });
 
-                        //bool leftHanded = settings.leftHanded;
+                        //bool leftHanded = settings->leftHanded;
                         //if (ImGui::Checkbox("Left Handed Mode", &leftHanded)) {
-                        //    settings.leftHanded = leftHanded ? 1 : 0;
+                        //    settings->leftHanded = leftHanded ? 1 : 0;
                         //    changed = true;
                         //}
                     }
@@ -792,71 +771,89 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
                     ImGui::Text("Cutscenes");
                     ImGui::PopStyleColor();
 
-                    int cutsceneMode = (int)settings.cutsceneCameraMode.load();
+                    int cutsceneMode = (int)settings->cutsceneCameraMode;
                     int currentCutsceneModeIdx = cutsceneMode - 1;
                     if (currentCutsceneModeIdx < 0) currentCutsceneModeIdx = 1;
 
                     DrawSettingRow("Camera In Cutscenes", [&]() {
                         if (ImGui::Combo("##CutsceneCamera", &currentCutsceneModeIdx, "First Person (Always)\0Optimal Settings (Mix Of Third/First)\0Third Person (Always)\0\0")) {
-                            settings.cutsceneCameraMode = (EventMode)(currentCutsceneModeIdx + 1);
+                            UpdateSettings([&](ModSettings& s) { s.cutsceneCameraMode = (EventMode)(currentCutsceneModeIdx + 1); });
                             changed = true;
                         }
                     });
 
-                    bool blackBars = settings.useBlackBarsForCutscenes;
+                    bool blackBars = settings->useBlackBarsForCutscenes;
                     DrawSettingRow("Black Bars In Third-Person Cutscenes", [&]() {
                         if (ImGui::Checkbox("##BlackBars", &blackBars)) {
-                            settings.useBlackBarsForCutscenes = blackBars ? 1 : 0;
+                            UpdateSettings([&](ModSettings& s) { s.useBlackBarsForCutscenes = blackBars; });
                             changed = true;
                         }
                     });
 
+                    // lets the user pick how the cutscene that's playing right now should look, which is remembered for the next time it plays
+                    const EventTable::EventId activeEvent = CemuHooks::s_resolvedEvent.load(std::memory_order_relaxed).event;
+                    if (activeEvent != EventTable::NO_EVENT) {
+                        const std::optional<HybridEventSettings> eventOverride = CemuHooks::s_events.GetOverride(activeEvent);
+                        int eventOverrideIdx = !eventOverride.has_value() ? 0 : (eventOverride->firstPerson ? 1 : 2);
+                        const std::string label = std::format("Current Cutscene ({})", CemuHooks::s_events.GetName(activeEvent));
+                        DrawSettingRow(label.c_str(), [&]() {
+                            if (ImGui::Combo("##CurrentCutscene", &eventOverrideIdx, "Use Setting Above\0First Person\0Third Person\0\0")) {
+                                std::optional<HybridEventSettings> newOverride = std::nullopt;
+                                if (eventOverrideIdx != 0) {
+                                    newOverride = CemuHooks::s_events.GetDefaults(activeEvent);
+                                    newOverride->firstPerson = eventOverrideIdx == 1;
+                                }
+                                CemuHooks::SetEventOverride(activeEvent, newOverride);
+                            }
+                        });
+                    }
+
                     ImGui::Spacing();
                     ImGui::Separator();
                     ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_HeaderActive));
                     ImGui::Text("UI");
                     ImGui::PopStyleColor();
                     if (cameraMode == 1) {
-                        bool guiFollow = settings.uiFollowsGaze;
+                        bool guiFollow = settings->uiFollowsGaze;
                         DrawSettingRow("UI Follows Where You Look", [&]() {
                             if (ImGui::Checkbox("##UIFollow", &guiFollow)) {
-                                settings.uiFollowsGaze = guiFollow ? 1 : 0;
+                                UpdateSettings([&](ModSettings& s) { s.uiFollowsGaze = guiFollow; });
                                 changed = true;
                             }
                         });
                     }
 
                     if (ImGui::CollapsingHeader("Advanced Settings")) {
-                        bool crop16x9 = settings.cropFlatTo16x9;
+                        bool crop16x9 = settings->cropFlatTo16x9;
                         DrawSettingRow("Crop VR Image To 16:9 For Cemu Window", [&]() {
                             if (ImGui::Checkbox("##Crop16x9", &crop16x9)) {
-                                settings.cropFlatTo16x9 = crop16x9 ? 1 : 0;
+                                UpdateSettings([&](ModSettings& s) { s.cropFlatTo16x9 = crop16x9; });
                                 changed = true;
                             }
                         });
 
-                        bool debugOverlay = settings.ShowDebugOverlay();
+                        bool debugOverlay = settings->ShowDebugOverlay();
                         DrawSettingRow("Show Debugging Overlays (for developers)", [&]() {
                             if (ImGui::Checkbox("##DebugOverlay", &debugOverlay)) {
-                                settings.enableDebugOverlay = debugOverlay ? 1 : 0;
+                                UpdateSettings([&](ModSettings& s) { s.enableDebugOverlay = debugOverlay; });
                                 changed = true;
                             }
                         });
 
                         if (VRManager::instance().XR->m_capabilities.isOculusLinkRuntime) {
-                            int angularFix = (int)settings.buggyAngularVelocity.load();
+                            int angularFix = (int)settings->buggyAngularVelocity;
                             const char* angularOptions[] = { "Auto (Oculus Link)", "Forced On", "Forced Off" };
                             if (angularFix < 0 || angularFix > 2) angularFix = 0;
 
                             DrawSettingRow("Angular Velocity Fixer", [&]() {
                                 if (ImGui::Combo("##AngularVelocity", &angularFix, angularOptions, 3)) {
-                                    settings.buggyAngularVelocity = (AngularVelocityFixerMode)angularFix;
+                                    UpdateSettings([&](ModSettings& s) { s.buggyAngularVelocity = (AngularVelocityFixerMode)angularFix; });
                                     changed = true;
                                 }
                             });
                         }
-                        else {
-                            settings.buggyAngularVelocity = AngularVelocityFixerMode::AUTO;
+                        else if (settings->buggyAngularVelocity != AngularVelocityFixerMode::AUTO) {
+                            UpdateSettings([](ModSettings& s) { s.buggyAngularVelocity = AngularVelocityFixerMode::AUTO; });
                         }
                     }
 
@@ -866,6 +863,11 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
                 if (ImGui::BeginTabItem(ICON_KI_INFO_CIRCLE " Help & Controller Guide", nullptr, (setTab && selectedTab == 1) ? ImGuiTabItemFlags_SetSelected : 0)) {
                     ImGui::PushItemWidth(windowWidth.x * 0.5f);
 
+                    if (m_helpImagePages.empty()) {
+                        ImGui::Dummy(ImVec2(0.0f, 10.0f));
+                        ImGui::TextDisabled("Loading controller guide...");
+                    }
+
                     for (const auto& imagePage : m_helpImagePages) {
                         for (const auto& image : imagePage) {
                             ImGui::PushID(&image);
@@ -887,22 +889,22 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
                 if (ImGui::BeginTabItem(ICON_KI_PODIUM " FPS Overlay", nullptr, (setTab && selectedTab == 2) ? ImGuiTabItemFlags_SetSelected : 0)) {
                     ImGui::Dummy(ImVec2(0.0f, 10.0f));
 
-                    auto& settings = GetSettings();
+                    const std::shared_ptr<const ModSettings> settings = GetSettings();
 
-                    int performanceOverlay = settings.performanceOverlay;
+                    int performanceOverlay = settings->performanceOverlay;
                     const char* fpsOverlayOptions[] = { "Disable", "Only show in Cemu window", "Show in both Cemu and VR" };
                     if (performanceOverlay < 0 || performanceOverlay > 2) performanceOverlay = 0;
 
                     DrawSettingRow("Show FPS Overlay", [&]() {
                         if (ImGui::Combo("##FPSOverlay", &performanceOverlay, fpsOverlayOptions, 3)) {
-                            settings.performanceOverlay = performanceOverlay;
+                            UpdateSettings([&](ModSettings& s) { s.performanceOverlay = performanceOverlay; });
                             changed = true;
                         }
                     });
 
                     if (performanceOverlay >= 0) {
                         static const int freqOptions[] = { 30, 60, 72, 80, 90, 120, 144 };
-                        int currentFreq = (int)settings.performanceOverlayFrequency.load();
+                        int currentFreq = (int)settings->performanceOverlayFrequency;
                         int freqIdx = 5; // Default to 90
                         for (int i = 0; i < std::size(freqOptions); i++) {
                             if (freqOptions[i] == currentFreq) {
@@ -913,7 +915,7 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
 
                         DrawSettingRow("Refresh Rate Of VR Headset For Graph", [&]() {
                             if (ImGui::SliderInt("##RefreshRate", &freqIdx, 0, (int)std::size(freqOptions) - 1, std::format("{} Hz", freqOptions[freqIdx]).c_str())) {
-                                settings.performanceOverlayFrequency = freqOptions[freqIdx];
+                                UpdateSettings([&](ModSettings& s) { s.performanceOverlayFrequency = freqOptions[freqIdx]; });
                                 changed = true;
                             }
                         });
@@ -999,6 +1001,26 @@ void RND_Renderer::ImGuiOverlay::DrawHUDLayerAsBackground(VkCommandBuffer cb, Vk
     frame.hudWithoutAlphaFramebuffer->vkCopyFromImage(cb, srcImage);
 }
 
+void RND_Renderer::ImGuiOverlay::UploadDecodedHelpImages(VkCommandBuffer cb) {
+    if (!m_helpImagesDecoding.valid() || m_helpImagesDecoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    for (auto& page : m_helpImagesDecoding.get()) {
+        if (page.rgba.empty())
+            continue;
+
+        HelpImage image;
+        image.m_image = new VulkanTexture{ page.width, page.height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+        image.m_image->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
+        image.m_image->vkUpload(cb, page.rgba.data(), page.rgba.size());
+        image.m_image->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
+        image.m_imageDS = ImGui_ImplVulkan_AddTexture(m_sampler, image.m_image->GetImageView(), VK_IMAGE_LAYOUT_GENERAL);
+        m_helpImagePages.push_back({ image });
+    }
+
+    VulkanUtils::DebugPipelineBarrier(cb);
+}
+
 void RND_Renderer::ImGuiOverlay::DrawAndCopyToImage(VkCommandBuffer cb, VkImage destImage, long frameIdx) {
     ImGui::Render();
 
@@ -1008,8 +1030,10 @@ void RND_Renderer::ImGuiOverlay::DrawAndCopyToImage(VkCommandBuffer cb, VkImage
 
     frame.imguiFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
 
+    UploadDecodedHelpImages(cb);
+
     // try to delete the staging buffer of the controller scheme textures if possible
-    for (auto imagePage : m_helpImagePages) {
+    for (auto& imagePage : m_helpImagePages) {
         for (auto& helpImage : imagePage) {
             helpImage.m_image->vkTryToFinishAnyUploads(cb);
         }
@@ -0,0 +1,14 @@
+#pragma once
+#include "pch.h"
+
+#include <filesystem>
+
+
+// The folder that holds Cemu's executable, which is where BetterVR keeps its settings, profiles and traces
+inline std::filesystem::path GetCemuDirectory() {
+    char path[MAX_PATH] = {};
+    if (GetModuleFileNameA(nullptr, path, MAX_PATH) == 0) {
+        return {};
+    }
+    return std::filesystem::path(path).parent_path();
+}
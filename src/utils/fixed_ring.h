@@ -0,0 +1,75 @@
+#pragma once
+#include "pch.h"
+
+#include <bit>
+
+
+// Bounded lock-free queue that never allocates after construction, based on Dmitry Vyukov's bounded queue.
+// Every slot has a sequence number that tells a producer whether the slot is free for its position and the consumer whether it's filled,
+// so pushing from several threads is safe too. A full queue rejects new values instead of waiting.
+template <typename T, size_t Capacity>
+class FixedRing {
+    static_assert(std::has_single_bit(Capacity), "FixedRing capacity needs to be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "FixedRing only supports simple types");
+
+public:
+    FixedRing() {
+        for (size_t i = 0; i < Capacity; i++) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    FixedRing(const FixedRing&) = delete;
+    FixedRing& operator=(const FixedRing&) = delete;
+
+    bool TryPush(const T& value) {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &m_slots[position & (Capacity - 1)];
+            const intptr_t diff = (intptr_t)slot->sequence.load(std::memory_order_acquire) - (intptr_t)position;
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only one thread is allowed to pop
+    bool TryPop(T& value) {
+        const size_t position = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[position & (Capacity - 1)];
+        if ((intptr_t)slot.sequence.load(std::memory_order_acquire) - (intptr_t)(position + 1) < 0) {
+            return false;
+        }
+        value = slot.value;
+        slot.sequence.store(position + Capacity, std::memory_order_release);
+        m_head.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Only a hint while other threads are pushing
+    bool Empty() const {
+        return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::array<Slot, Capacity> m_slots;
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+};
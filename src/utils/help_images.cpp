@@ -0,0 +1,59 @@
+#include "help_images.h"
+#include "stb_image.h"
+
+#include <span>
+
+namespace HelpImages {
+    static std::span<const uint8_t> GetPageBytes(int resourceId) {
+        HMODULE module = nullptr;
+        if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)&GetPageBytes, &module)) {
+            return {};
+        }
+
+        HRSRC resource = FindResource(module, MAKEINTRESOURCE(resourceId), RT_RCDATA);
+        if (resource == nullptr) {
+            return {};
+        }
+
+        HGLOBAL resourceHandle = LoadResource(module, resource);
+        if (resourceHandle == nullptr) {
+            return {};
+        }
+
+        // resources are memory-mapped with the DLL image, so this doesn't copy anything until the pages are touched
+        return { (const uint8_t*)LockResource(resourceHandle), (size_t)SizeofResource(module, resource) };
+    }
+
+    static std::vector<DecodedPage> DecodeAll() {
+        LARGE_INTEGER startTime;
+        QueryPerformanceCounter(&startTime);
+
+        std::vector<DecodedPage> pages(PAGES.size());
+        for (size_t i = 0; i < PAGES.size(); i++) {
+            std::span<const uint8_t> bytes = GetPageBytes(PAGES[i].resourceId);
+            if (bytes.empty()) {
+                Log::print<WARNING>("Couldn't find the {} page of the controller guide in the DLL resources", PAGES[i].name);
+                continue;
+            }
+
+            int width, height, channels;
+            stbi_uc* img = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &channels, STBI_rgb_alpha);
+            if (img == nullptr) {
+                Log::print<WARNING>("Failed to decode the {} page of the controller guide: {}", PAGES[i].name, stbi_failure_reason());
+                continue;
+            }
+
+            pages[i].width = (uint32_t)width;
+            pages[i].height = (uint32_t)height;
+            pages[i].rgba.assign(img, img + (size_t)width * height * 4);
+            stbi_image_free(img);
+        }
+
+        Log::printTimeElapsed("Decoded controller guide pages", startTime);
+        return pages;
+    }
+
+    std::future<std::vector<DecodedPage>> DecodeAsync() {
+        return std::async(std::launch::async, DecodeAll);
+    }
+}
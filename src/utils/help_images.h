@@ -0,0 +1,33 @@
+#pragma once
+
+// resource IDs of the controller guide pages, shared with help_images.rc
+#define IDR_HELP_CONTROLS 201
+#define IDR_HELP_EQUIP 202
+#define IDR_HELP_SWING 203
+
+#ifndef RC_INVOKED
+#include <future>
+
+namespace HelpImages {
+    struct PageAsset {
+        int resourceId;
+        const char* name;
+    };
+
+    // index of the PNG pages that are packed into the DLL's resource section, in the order they're shown in the help menu
+    constexpr std::array<PageAsset, 3> PAGES = { {
+        { IDR_HELP_CONTROLS, "controls" },
+        { IDR_HELP_EQUIP, "equip" },
+        { IDR_HELP_SWING, "swing" },
+    } };
+
+    struct DecodedPage {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> rgba;
+    };
+
+    // decodes all pages into RGBA8 on a worker thread, pages that fail to load are left empty
+    std::future<std::vector<DecodedPage>> DecodeAsync();
+}
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+#include "pch.h"
+
+
+// Allocation-free FABRIK solver for chains of up to MaxJoints joints (including the end effector).
+// Lanes chains with the same layout, like both arms, are solved in lockstep. Their data is stored as [joint][lane] so that the inner loops
+// run over the lanes and stay branch-free, which lets the compiler keep them in vector registers.
+// Every segment can be limited to a cone around the direction of the segment before it, or around the base direction for the first segment.
+template <size_t MaxJoints, size_t Lanes = 1>
+class IKChainSolver {
+public:
+    static constexpr uint32_t MAX_ITERATIONS = 10;
+    static constexpr float TOLERANCE = 0.0005f;
+
+    struct Chain {
+        uint32_t jointCount = 0;
+        std::array<std::array<glm::vec3, Lanes>, MaxJoints> positions = {};
+        std::array<std::array<float, Lanes>, MaxJoints> segmentLengths = {}; // from joint i to joint i + 1
+        std::array<float, MaxJoints> maxAngles = {};                         // cone limit of segment i in radians, anything >= pi disables it
+        std::array<glm::vec3, Lanes> baseDirections = {};                    // what the first segment's cone limit is relative to
+        std::array<glm::vec3, Lanes> targets = {};
+    };
+
+    // Moves the joints of every lane towards its target, the first joint stays in place. Returns how far each end effector ended up from its target.
+    static std::array<float, Lanes> Solve(Chain& chain) {
+        std::array<float, Lanes> remaining = {};
+        if (chain.jointCount < 2) {
+            return remaining;
+        }
+        const uint32_t segmentCount = chain.jointCount - 1;
+
+        std::array<float, MaxJoints> cosLimits = {};
+        std::array<float, MaxJoints> sinLimits = {};
+        for (uint32_t i = 0; i < segmentCount; i++) {
+            cosLimits[i] = chain.maxAngles[i] >= glm::pi<float>() ? -1.0f : cosf(chain.maxAngles[i]);
+            sinLimits[i] = chain.maxAngles[i] >= glm::pi<float>() ? 0.0f : sinf(chain.maxAngles[i]);
+        }
+
+        const std::array<glm::vec3, Lanes> basePositions = chain.positions[0];
+
+        for (uint32_t iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+            // backward pass: pin the end effector to the target and pull the rest of the chain after it
+            chain.positions[segmentCount] = chain.targets;
+            for (int32_t i = (int32_t)segmentCount - 1; i >= 0; i--) {
+                for (size_t lane = 0; lane < Lanes; lane++) {
+                    const glm::vec3 dir = SafeNormalize(chain.positions[i][lane] - chain.positions[i + 1][lane], -chain.baseDirections[lane]);
+                    chain.positions[i][lane] = chain.positions[i + 1][lane] + dir * chain.segmentLengths[i][lane];
+                }
+            }
+
+            // forward pass: pin the base back in place and apply the joint limits on the way out
+            chain.positions[0] = basePositions;
+            for (uint32_t i = 0; i < segmentCount; i++) {
+                for (size_t lane = 0; lane < Lanes; lane++) {
+                    const glm::vec3 reference = i == 0 ? chain.baseDirections[lane] : SafeNormalize(chain.positions[i][lane] - chain.positions[i - 1][lane], chain.baseDirections[lane]);
+                    glm::vec3 dir = SafeNormalize(chain.positions[i + 1][lane] - chain.positions[i][lane], reference);
+                    dir = ConstrainToCone(dir, reference, cosLimits[i], sinLimits[i]);
+                    chain.positions[i + 1][lane] = chain.positions[i][lane] + dir * chain.segmentLengths[i][lane];
+                }
+            }
+
+            float worstDistance = 0.0f;
+            for (size_t lane = 0; lane < Lanes; lane++) {
+                remaining[lane] = glm::distance(chain.positions[segmentCount][lane], chain.targets[lane]);
+                worstDistance = std::max(worstDistance, remaining[lane]);
+            }
+            if (worstDistance < TOLERANCE) {
+                break;
+            }
+        }
+        return remaining;
+    }
+
+    static glm::vec3 SafeNormalize(const glm::vec3& v, const glm::vec3& fallback) {
+        const float lengthSq = glm::dot(v, v);
+        return lengthSq > 1e-12f ? v * (1.0f / sqrtf(lengthSq)) : fallback;
+    }
+
+    // Clamps a unit direction to the cone of the given angle around a unit reference direction
+    static glm::vec3 ConstrainToCone(const glm::vec3& dir, const glm::vec3& reference, float cosLimit, float sinLimit) {
+        const float cosAngle = glm::dot(dir, reference);
+        if (cosAngle >= cosLimit) {
+            return dir;
+        }
+
+        glm::vec3 perpendicular = dir - reference * cosAngle;
+        if (glm::dot(perpendicular, perpendicular) < 1e-12f) {
+            // pointing straight back, any side works
+            perpendicular = glm::cross(reference, std::abs(reference.x) < 0.9f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0));
+        }
+        return reference * cosLimit + glm::normalize(perpendicular) * sinLimit;
+    }
+};
@@ -0,0 +1,175 @@
+#pragma once
+#include "pch.h"
+
+#include <mutex>
+
+
+// Lock-free open-addressing table that tracks the size and format of the VkImages that Cemu creates, so that the capture path in
+// vkCmdClearColorImage/vkCmdClearDepthStencilImage never has to take a mutex to figure out what image it's looking at.
+//
+// Each slot is a key (the VkImage handle) and a packed value. Slots are claimed by CAS'ing the key from EMPTY/TOMBSTONE to BUSY, after which
+// the value gets written and the real key is published with release semantics. Lookups probe until they either find the key or hit an EMPTY slot,
+// and check the key again after reading the value so that they never return the value of a slot that got erased or reused in the meantime.
+// Vulkan handles are unique while alive, so a handle can't be present twice and reusing tombstones is safe.
+//
+// Images are only created and destroyed a few times per frame at most, so inserts and erases are serialized with a mutex. That lets an erase turn
+// its slot and the tombstones before it back into EMPTY slots whenever the slot after them is EMPTY, which keeps misses from probing the whole table
+// after many images came and went. No key's probe sequence can cross an EMPTY slot that was turned back like that, so lookups stay correct.
+template <size_t Capacity>
+class ImageTable {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    enum class ImageClass : uint8_t {
+        Other = 0,
+        Color3DCandidate = 1, // matches the format of the game's 3D color framebuffer
+        Depth3DCandidate = 2, // matches the format of the game's 3D depth framebuffer
+    };
+
+    struct ImageInfo {
+        VkExtent2D extent;
+        VkFormat format;
+        ImageClass classification;
+    };
+
+    static constexpr ImageClass Classify(VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+                return ImageClass::Color3DCandidate;
+            case VK_FORMAT_D32_SFLOAT:
+                return ImageClass::Depth3DCandidate;
+            default:
+                return ImageClass::Other;
+        }
+    }
+
+    bool Insert(VkImage image, VkExtent2D extent, VkFormat format) {
+        const uint64_t key = ToKey(image);
+        const uint64_t value = Pack(extent, format);
+        std::scoped_lock lock(m_writeMutex);
+
+        for (size_t probe = 0, idx = Hash(key); probe < Capacity; probe++, idx = (idx + 1) & (Capacity - 1)) {
+            Slot& slot = m_slots[idx];
+            uint64_t expected = slot.key.load(std::memory_order_relaxed);
+            if (expected != EMPTY_KEY && expected != TOMBSTONE_KEY) {
+                continue;
+            }
+            if (!slot.key.compare_exchange_strong(expected, BUSY_KEY, std::memory_order_acquire, std::memory_order_relaxed)) {
+                continue;
+            }
+            // pairs with the fence in Find, a lookup that reads the new value is guaranteed to see that the key changed
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.value.store(value, std::memory_order_relaxed);
+            slot.key.store(key, std::memory_order_release);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool Erase(VkImage image) {
+        std::scoped_lock lock(m_writeMutex);
+        Slot* slot = FindSlot(ToKey(image));
+        if (slot == nullptr) {
+            return false;
+        }
+        m_count.fetch_sub(1, std::memory_order_relaxed);
+
+        size_t idx = (size_t)(slot - m_slots.data());
+        if (m_slots[(idx + 1) & (Capacity - 1)].key.load(std::memory_order_relaxed) != EMPTY_KEY) {
+            slot->key.store(TOMBSTONE_KEY, std::memory_order_release);
+            return true;
+        }
+
+        // nothing probes past this slot, so it and the tombstones right before it can all become EMPTY again
+        slot->key.store(EMPTY_KEY, std::memory_order_release);
+        for (size_t i = 1; i < Capacity; i++) {
+            Slot& previous = m_slots[(idx - i) & (Capacity - 1)];
+            if (previous.key.load(std::memory_order_relaxed) != TOMBSTONE_KEY) {
+                break;
+            }
+            previous.key.store(EMPTY_KEY, std::memory_order_release);
+        }
+        return true;
+    }
+
+    std::optional<ImageInfo> Find(VkImage image) const {
+        const uint64_t key = ToKey(image);
+        const Slot* slot = FindSlot(key);
+        if (slot == nullptr) {
+            return std::nullopt;
+        }
+        const uint64_t value = slot->value.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->key.load(std::memory_order_relaxed) != key) {
+            return std::nullopt;
+        }
+        return Unpack(value);
+    }
+
+    size_t Size() const { return m_count.load(std::memory_order_relaxed); }
+
+    // slots that are still tombstones, which lookups that miss have to probe past
+    size_t TombstoneCount() const {
+        return (size_t)std::ranges::count_if(m_slots, [](const Slot& slot) { return slot.key.load(std::memory_order_relaxed) == TOMBSTONE_KEY; });
+    }
+
+private:
+    static constexpr uint64_t EMPTY_KEY = 0;
+    static constexpr uint64_t TOMBSTONE_KEY = 1;
+    static constexpr uint64_t BUSY_KEY = 2;
+
+    struct Slot {
+        std::atomic_uint64_t key = EMPTY_KEY;
+        std::atomic_uint64_t value = 0;
+    };
+
+    static uint64_t ToKey(VkImage image) {
+        uint64_t key = (uint64_t)image;
+        checkAssert(key > BUSY_KEY, "VkImage handle collides with a reserved key of the image table!");
+        return key;
+    }
+
+    static size_t Hash(uint64_t key) {
+        // handles are usually aligned pointers, so mix the bits before masking
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return (size_t)key & (Capacity - 1);
+    }
+
+    static uint64_t Pack(VkExtent2D extent, VkFormat format) {
+        checkAssert(extent.width <= 0xFFFF && extent.height <= 0xFFFF, "Image is too large to be tracked!");
+        return (uint64_t)extent.width | ((uint64_t)extent.height << 16) | ((uint64_t)(uint32_t)format << 32);
+    }
+
+    static ImageInfo Unpack(uint64_t value) {
+        VkFormat format = (VkFormat)(uint32_t)(value >> 32);
+        return ImageInfo{
+            .extent = { (uint32_t)(value & 0xFFFF), (uint32_t)((value >> 16) & 0xFFFF) },
+            .format = format,
+            .classification = Classify(format)
+        };
+    }
+
+    const Slot* FindSlot(uint64_t key) const {
+        for (size_t probe = 0, idx = Hash(key); probe < Capacity; probe++, idx = (idx + 1) & (Capacity - 1)) {
+            uint64_t slotKey = m_slots[idx].key.load(std::memory_order_acquire);
+            if (slotKey == key) {
+                return &m_slots[idx];
+            }
+            if (slotKey == EMPTY_KEY) {
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    Slot* FindSlot(uint64_t key) {
+        return const_cast<Slot*>(std::as_const(*this).FindSlot(key));
+    }
+
+    std::array<Slot, Capacity> m_slots = {};
+    std::atomic_size_t m_count = 0;
+    std::mutex m_writeMutex;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include "pch.h"
+
+
+namespace VulkanUtils {
+    // Stage and access masks for one side of an image barrier
+    struct ImageBarrierMasks {
+        VkPipelineStageFlags2 srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 srcAccessMask = VK_ACCESS_2_NONE;
+        VkPipelineStageFlags2 dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 dstAccessMask = VK_ACCESS_2_NONE;
+
+        constexpr bool operator==(const ImageBarrierMasks&) const = default;
+    };
+
+    // Barriers needed around copying one of Cemu's framebuffers into an interop texture, both of which stay in the GENERAL layout.
+    // There's no barrier for the interop texture after the copy since the timeline semaphore signal already makes the copy visible to D3D12.
+    struct InteropCopyBarrierPlan {
+        ImageBarrierMasks srcBefore; // Cemu's rendering into the framebuffer -> our copy reading it
+        ImageBarrierMasks dstBefore; // the previous frame's copy into the interop texture -> our copy writing it
+        ImageBarrierMasks srcAfter;  // our copy reading the framebuffer -> Cemu rendering or transferring into it again
+    };
+
+    static constexpr InteropCopyBarrierPlan PlanInteropCopyBarriers(bool isDepth) {
+        const VkPipelineStageFlags2 attachmentStages = isDepth ? (VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT) : VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        const VkAccessFlags2 attachmentWrite = isDepth ? VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+
+        return InteropCopyBarrierPlan{
+            .srcBefore = {
+                .srcStageMask = attachmentStages | VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+                .srcAccessMask = attachmentWrite | VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT,
+            },
+            .dstBefore = {
+                .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            },
+            // write-after-read only needs an execution dependency
+            .srcAfter = {
+                .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .srcAccessMask = VK_ACCESS_2_NONE,
+                .dstStageMask = attachmentStages | VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+                .dstAccessMask = VK_ACCESS_2_NONE,
+            },
+        };
+    }
+
+    static constexpr VkImageMemoryBarrier2 MakeImageBarrier(const ImageBarrierMasks& masks, VkImage image, VkImageAspectFlags aspectMask, VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL) {
+        VkImageMemoryBarrier2 barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+        barrier.srcStageMask = masks.srcStageMask;
+        barrier.srcAccessMask = masks.srcAccessMask;
+        barrier.dstStageMask = masks.dstStageMask;
+        barrier.dstAccessMask = masks.dstAccessMask;
+        barrier.oldLayout = layout;
+        barrier.newLayout = layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {
+            .aspectMask = aspectMask,
+            .baseMipLevel = 0,
+            .levelCount = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount = VK_REMAINING_ARRAY_LAYERS
+        };
+        return barrier;
+    }
+}
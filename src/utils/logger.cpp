@@ -60,5 +60,5 @@ Log::~Log() {
 void Log::printTimeElapsed(const char* message_prefix, LARGE_INTEGER time) {
     LARGE_INTEGER timeNow;
     QueryPerformanceCounter(&timeNow);
-    Log::print<INFO>("{}: {} ms", message_prefix, double(time.QuadPart - timeNow.QuadPart) / timeFrequency);
+    Log::print<INFO>("{}: {} ms", message_prefix, double(timeNow.QuadPart - time.QuadPart) / timeFrequency);
 }
\ No newline at end of file
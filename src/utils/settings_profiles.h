@@ -0,0 +1,169 @@
+#pragma once
+#include "pch.h"
+#include "utils/settings_store.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+
+// Settings that only apply to one version of the game or one headset. Every .ini file in the BetterVR_profiles folder next to Cemu's executable is a profile:
+//   # only applies when every Title/Runtime/System line matches, leave a line out to match anything
+//   Title=00050000-101C9400
+//   Runtime=Oculus
+//   System=Quest 3
+//   PlayerHeightOffset=0.100
+//   PerformanceOverlay=2
+// The other lines use the keys from BetterVR_settings.ini and replace those settings while the profile matches.
+// Runtime and System match when the OpenXR runtime or headset name contains the text. When several profiles match,
+// the ones with more match lines are applied last so that they win. The user's own settings are kept apart from the profiles, so a setting that a profile
+// replaces keeps its saved value in BetterVR_settings.ini, and changing it in the menu changes that saved value.
+class SettingsProfiles {
+public:
+    explicit SettingsProfiles(SettingsStore& store) : m_store(store) {}
+
+    struct Target {
+        uint64_t titleId;
+        std::string runtimeName;
+        std::string systemName;
+    };
+
+    struct Profile {
+        std::string name;
+        std::optional<uint64_t> titleId;
+        std::string runtimeName;
+        std::string systemName;
+        std::vector<std::pair<const SettingsSchema::Field*, std::string>> values;
+
+        uint32_t Specificity() const {
+            return (titleId.has_value() ? 1 : 0) + (runtimeName.empty() ? 0 : 1) + (systemName.empty() ? 0 : 1);
+        }
+
+        bool Matches(const Target& target) const {
+            return (!titleId.has_value() || *titleId == target.titleId) && target.runtimeName.contains(runtimeName) && target.systemName.contains(systemName);
+        }
+    };
+
+    static std::optional<Profile> Parse(const std::string& name, std::istream& stream) {
+        auto trim = [](std::string_view str) {
+            const size_t first = str.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos) return std::string_view();
+            return str.substr(first, str.find_last_not_of(" \t\r") - first + 1);
+        };
+
+        Profile profile = {};
+        profile.name = name;
+        ModSettings scratch = {};
+        std::string line;
+        uint32_t lineNumber = 0;
+        while (std::getline(stream, line)) {
+            lineNumber++;
+            const std::string_view entry = trim(line);
+            if (entry.empty() || entry[0] == '#' || entry[0] == ';') {
+                continue;
+            }
+            const size_t separator = entry.find('=');
+            const std::string_view key = trim(entry.substr(0, std::min(separator, entry.size())));
+            const std::string_view value = separator != std::string_view::npos ? trim(entry.substr(separator + 1)) : std::string_view();
+
+            if (key == "Title") {
+                std::string digits;
+                std::ranges::copy_if(value, std::back_inserter(digits), [](char c) { return c != '-'; });
+                uint64_t titleId = 0;
+                if (std::from_chars(digits.data(), digits.data() + digits.size(), titleId, 16).ec != std::errc()) {
+                    Log::print<WARNING>("Settings profile {} line {}: \"{}\" isn't a title ID, the profile is ignored", name, lineNumber, value);
+                    return std::nullopt;
+                }
+                profile.titleId = titleId;
+            }
+            else if (key == "Runtime") {
+                profile.runtimeName = value;
+            }
+            else if (key == "System") {
+                profile.systemName = value;
+            }
+            else if (const SettingsSchema::Field* field = SettingsSchema::FindField(key); field != nullptr && field->parse(scratch, value)) {
+                profile.values.emplace_back(field, value);
+            }
+            else {
+                Log::print<WARNING>("Settings profile {} line {}: skipped unknown setting \"{}\"", name, lineNumber, entry);
+            }
+        }
+        return profile;
+    }
+
+    // Reads every profile in the folder, ordered so that the most specific ones come last
+    static std::vector<Profile> LoadFolder(const std::filesystem::path& folder) {
+        std::vector<Profile> profiles;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(folder, error)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".ini") {
+                continue;
+            }
+            std::ifstream file(entry.path());
+            if (!file.is_open()) {
+                Log::print<WARNING>("Failed to open settings profile {}", entry.path().string());
+                continue;
+            }
+            if (auto profile = Parse(entry.path().filename().string(), file)) {
+                profiles.emplace_back(std::move(*profile));
+            }
+        }
+        std::ranges::sort(profiles, [](const Profile& a, const Profile& b) {
+            return std::pair(a.Specificity(), a.name) < std::pair(b.Specificity(), b.name);
+        });
+        return profiles;
+    }
+
+    // Replaces the matching profiles and publishes the user's settings with the profiles that match now on top, all in one snapshot
+    void Apply(const std::vector<Profile>& profiles, const Target& target) {
+        std::scoped_lock lock(m_mutex);
+        std::vector<std::string_view> names;
+        m_active.clear();
+        for (const Profile& profile : profiles) {
+            if (profile.Matches(target)) {
+                m_active.insert(m_active.end(), profile.values.begin(), profile.values.end());
+                names.emplace_back(profile.name);
+            }
+        }
+        m_store.Update([&](ModSettings& settings) {
+            Compose(settings);
+        });
+
+        std::string list;
+        for (std::string_view name : names) {
+            std::format_to(std::back_inserter(list), "{}{}", list.empty() ? "" : ", ", name);
+        }
+        Log::print<INFO>("Applied {} of {} settings profiles for title {:016X} on {} ({}){}{}", names.size(), profiles.size(), target.titleId, target.systemName, target.runtimeName, names.empty() ? "" : ": ", list);
+    }
+
+    // Changes the user's own settings, like the ones loaded from BetterVR_settings.ini or edited in the menu. The matching profiles still win over them.
+    void Update(const std::function<void(ModSettings&)>& update) {
+        std::scoped_lock lock(m_mutex);
+        m_store.Update([&](ModSettings& settings) {
+            update(m_user);
+            Compose(settings);
+        });
+    }
+
+    // The settings as they'd be without any profile, which is what gets saved
+    ModSettings WithoutProfiles() {
+        std::scoped_lock lock(m_mutex);
+        return m_user;
+    }
+
+private:
+    void Compose(ModSettings& settings) const {
+        const uint64_t version = settings.version;
+        settings = m_user;
+        settings.version = version;
+        for (const auto& [field, value] : m_active) {
+            field->parse(settings, value);
+        }
+    }
+
+    SettingsStore& m_store;
+    std::mutex m_mutex;
+    ModSettings m_user = {};
+    std::vector<std::pair<const SettingsSchema::Field*, std::string>> m_active; // values of the matching profiles, in the order they're applied
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include "pch.h"
+
+#include <charconv>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+
+// Parsing and saving of every setting in BETTERVR_SETTINGS as "Key=Value" lines
+namespace SettingsSchema {
+    template <typename T>
+    bool ParseValue(std::string_view str, T& value) {
+        if constexpr (std::is_floating_point_v<T>) {
+            return std::from_chars(str.data(), str.data() + str.size(), value).ec == std::errc();
+        }
+        else {
+            int64_t integer = 0;
+            if (std::from_chars(str.data(), str.data() + str.size(), integer).ec != std::errc()) {
+                return false;
+            }
+            value = (T)integer;
+            return true;
+        }
+    }
+
+    template <typename T>
+    void FormatValue(std::string& out, std::string_view key, const T& value) {
+        if constexpr (std::is_floating_point_v<T>) {
+            std::format_to(std::back_inserter(out), "{}={:.3f}\n", key, value);
+        }
+        else {
+            std::format_to(std::back_inserter(out), "{}={}\n", key, (int64_t)value);
+        }
+    }
+
+    struct Field {
+        std::string_view key;
+        bool (*parse)(ModSettings& settings, std::string_view value);
+        void (*format)(const ModSettings& settings, std::string& out);
+    };
+
+#define BETTERVR_SETTING_SCHEMA(name, type, key, defaultValue) \
+    Field{ key, \
+        [](ModSettings& settings, std::string_view value) { return ParseValue(value, settings.name); }, \
+        [](const ModSettings& settings, std::string& out) { FormatValue(out, key, settings.name); } },
+    inline constexpr std::array FIELDS = { BETTERVR_SETTINGS(BETTERVR_SETTING_SCHEMA) };
+#undef BETTERVR_SETTING_SCHEMA
+
+    inline const Field* FindField(std::string_view key) {
+        static const std::unordered_map<std::string_view, const Field*> s_fieldsByKey = [] {
+            std::unordered_map<std::string_view, const Field*> fieldsByKey;
+            for (const Field& field : FIELDS) {
+                fieldsByKey.emplace(field.key, &field);
+            }
+            return fieldsByKey;
+        }();
+        auto it = s_fieldsByKey.find(key);
+        return it != s_fieldsByKey.end() ? it->second : nullptr;
+    }
+
+    // Returns false for lines that aren't a known setting or have a value that doesn't parse
+    inline bool ParseLine(ModSettings& settings, std::string_view line) {
+        const size_t separator = line.find('=');
+        if (separator == std::string_view::npos) {
+            return false;
+        }
+        const Field* field = FindField(line.substr(0, separator));
+        return field != nullptr && field->parse(settings, line.substr(separator + 1));
+    }
+
+    inline std::string Serialize(const ModSettings& settings) {
+        std::string out;
+        for (const Field& field : FIELDS) {
+            field.format(settings, out);
+        }
+        return out;
+    }
+}
+
+// Publishes the settings as immutable snapshots, read-copy-update style. Readers get the current snapshot with one atomic load and never see it change,
+// while writers copy it, change the copy and swap the pointer under a lock. Every reader shares ownership of its snapshot, so a replaced snapshot
+// is only freed once the last reader that still holds it lets go of it.
+class SettingsStore {
+public:
+    SettingsStore() : m_current(std::make_shared<const ModSettings>()) {}
+
+    SettingsStore(const SettingsStore&) = delete;
+    SettingsStore& operator=(const SettingsStore&) = delete;
+
+    std::shared_ptr<const ModSettings> Get() const {
+        return m_current.load(std::memory_order_acquire);
+    }
+
+    template <typename F>
+    void Update(F&& update) {
+        std::scoped_lock lock(m_writeMutex);
+        const std::shared_ptr<const ModSettings> previous = m_current.load(std::memory_order_relaxed);
+        std::shared_ptr<ModSettings> next = std::make_shared<ModSettings>(*previous);
+        update(*next);
+        next->version = previous->version + 1;
+        m_current.store(std::move(next), std::memory_order_release);
+    }
+
+private:
+    std::atomic<std::shared_ptr<const ModSettings>> m_current;
+    std::mutex m_writeMutex;
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include "pch.h"
+
+
+// Vector that keeps up to N elements inline and only moves to the heap once it outgrows that, for hot paths that are expected to stay small.
+// Pointers returned by data() are invalidated by any operation that grows the vector, same as std::vector.
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_default_constructible_v<T> && std::is_trivially_destructible_v<T>, "SmallVector only supports simple types");
+
+public:
+    SmallVector() = default;
+    explicit SmallVector(size_t count) { resize(count); }
+
+    SmallVector(const SmallVector&) = delete;
+    SmallVector& operator=(const SmallVector&) = delete;
+
+    SmallVector(SmallVector&& other) noexcept { *this = std::move(other); }
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        m_inline = other.m_inline;
+        m_heap = std::move(other.m_heap);
+        m_size = std::exchange(other.m_size, 0);
+        other.m_heap.clear();
+        return *this;
+    }
+
+    void push_back(const T& value) {
+        if (m_heap.empty() && m_size < N) {
+            m_inline[m_size++] = value;
+            return;
+        }
+        Spill();
+        m_heap.push_back(value);
+        m_size++;
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        push_back(T{ std::forward<Args>(args)... });
+        return back();
+    }
+
+    void assign(const T* first, const T* last) {
+        clear();
+        for (const T* it = first; it != last; ++it) {
+            push_back(*it);
+        }
+    }
+
+    void resize(size_t count, const T& value = T{}) {
+        while (m_size > count) {
+            pop_back();
+        }
+        while (m_size < count) {
+            push_back(value);
+        }
+    }
+
+    void pop_back() {
+        if (!m_heap.empty()) {
+            m_heap.pop_back();
+        }
+        m_size--;
+    }
+
+    void clear() {
+        m_heap.clear();
+        m_size = 0;
+    }
+
+    T* data() { return m_heap.empty() ? m_inline.data() : m_heap.data(); }
+    const T* data() const { return m_heap.empty() ? m_inline.data() : m_heap.data(); }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool IsInline() const { return m_heap.empty(); }
+
+    T& operator[](size_t idx) { return data()[idx]; }
+    const T& operator[](size_t idx) const { return data()[idx]; }
+    T& back() { return data()[m_size - 1]; }
+    T* begin() { return data(); }
+    T* end() { return data() + m_size; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + m_size; }
+
+private:
+    void Spill() {
+        if (m_heap.empty()) {
+            m_heap.reserve(N * 2);
+            m_heap.assign(m_inline.begin(), m_inline.begin() + m_size);
+        }
+    }
+
+    std::array<T, N> m_inline = {};
+    std::vector<T> m_heap;
+    size_t m_size = 0;
+};
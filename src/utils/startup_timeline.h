@@ -0,0 +1,76 @@
+#pragma once
+
+#include <mutex>
+
+// Collects when each part of the mod's startup ran (and on which thread) so that the time from the layer being loaded to the first frame being
+// submitted to the headset can be inspected in the log, and so that regressions in the staged initialization are easy to spot.
+namespace StartupTimeline {
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage {
+        const char* name;
+        Clock::time_point start;
+        Clock::time_point end;
+        DWORD threadId;
+    };
+
+    inline const Clock::time_point s_layerLoadTime = Clock::now();
+    inline std::mutex s_stagesMutex;
+    inline std::vector<Stage> s_stages;
+    inline std::atomic_bool s_reported = false;
+
+    inline void Record(const char* name, Clock::time_point start, Clock::time_point end) {
+        if (s_reported) {
+            return;
+        }
+        std::scoped_lock lock(s_stagesMutex);
+        if (!s_reported) {
+            s_stages.emplace_back(Stage{ name, start, end, GetCurrentThreadId() });
+        }
+    }
+
+    inline void Mark(const char* name) {
+        auto now = Clock::now();
+        Record(name, now, now);
+    }
+
+    class ScopedStage {
+    public:
+        explicit ScopedStage(const char* name): m_name(name), m_start(Clock::now()) {}
+        ~ScopedStage() { Record(m_name, m_start, Clock::now()); }
+
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+
+    private:
+        const char* m_name;
+        Clock::time_point m_start;
+    };
+
+    // Prints all recorded stages once, sorted by when they started. Later calls are ignored.
+    inline void Report() {
+        if (s_reported) {
+            return;
+        }
+        std::scoped_lock lock(s_stagesMutex);
+        if (s_reported) {
+            return;
+        }
+        s_reported = true;
+
+        std::ranges::sort(s_stages, [](const Stage& a, const Stage& b) { return a.start < b.start; });
+
+        auto toMs = [](Clock::time_point time) { return std::chrono::duration<double, std::milli>(time - s_layerLoadTime).count(); };
+        Log::print<INFO>("Startup timeline (ms since the layer was loaded):");
+        for (const Stage& stage : s_stages) {
+            if (stage.start == stage.end) {
+                Log::print<INFO>(" - {:>9.1f}            {} [thread {}]", toMs(stage.start), stage.name, stage.threadId);
+            }
+            else {
+                Log::print<INFO>(" - {:>9.1f} .. {:>9.1f} {} took {:.1f} ms [thread {}]", toMs(stage.start), toMs(stage.end), stage.name, toMs(stage.end) - toMs(stage.start), stage.threadId);
+            }
+        }
+        s_stages.clear();
+        s_stages.shrink_to_fit();
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "pch.h"
+
+
+// Single frustum that contains the frusta of both eyes, so that a visibility check is one sphere test instead of building and testing one frustum per eye.
+// Its apex is pulled back behind both eyes far enough that the side planes contain both of them, and its angles cover every corner of both eyes'
+// fields of view, which also works for headsets with canted displays. The planes are stored as separate arrays of their components,
+// padded to 8 lanes with planes that never cull anything, so that the sphere test is a branch-free loop that the compiler can vectorize.
+class StereoFrustum {
+public:
+    static constexpr size_t LANES = 8;
+    static constexpr size_t PLANE_COUNT = 6;
+
+    struct Eye {
+        glm::fvec3 position;
+        glm::fquat rotation;
+        XrFovf fov;
+    };
+
+    void Build(const std::array<Eye, 2>& eyes, float nearClip, float farClip) {
+        const glm::fvec3 middlePos = (eyes[0].position + eyes[1].position) * 0.5f;
+        const glm::fquat middleRot = glm::slerp(eyes[0].rotation, eyes[1].rotation, 0.5f);
+        const glm::fquat toMiddle = glm::conjugate(middleRot);
+
+        // tangents of the combined field of view, relative to the middle of both eyes
+        float tanLeft = -MIN_TANGENT, tanRight = MIN_TANGENT, tanDown = -MIN_TANGENT, tanUp = MIN_TANGENT;
+        for (const Eye& eye : eyes) {
+            for (const glm::fvec3& corner : GetCorners(eye.fov)) {
+                const glm::fvec3 dir = toMiddle * (eye.rotation * corner);
+                const float depth = std::max(-dir.z, MIN_TANGENT);
+                tanLeft = std::min(tanLeft, dir.x / depth);
+                tanRight = std::max(tanRight, dir.x / depth);
+                tanDown = std::min(tanDown, dir.y / depth);
+                tanUp = std::max(tanUp, dir.y / depth);
+            }
+        }
+
+        // pull the apex back until both eyes are inside of the side planes
+        float pullBack = 0.0f;
+        for (const Eye& eye : eyes) {
+            const glm::fvec3 offset = toMiddle * (eye.position - middlePos);
+            pullBack = std::max({ pullBack, offset.x / tanLeft + offset.z, offset.x / tanRight + offset.z, offset.y / tanDown + offset.z, offset.y / tanUp + offset.z });
+        }
+        const glm::fvec3 apex = middlePos + middleRot * glm::fvec3(0.0f, 0.0f, pullBack);
+
+        // the near and far planes need to contain the near and far planes of both eyes, which are tilted for canted displays
+        float nearDepth = std::numeric_limits<float>::max();
+        float farDepth = std::numeric_limits<float>::lowest();
+        for (const Eye& eye : eyes) {
+            for (const glm::fvec3& corner : GetCorners(eye.fov)) {
+                const glm::fvec3 dir = eye.rotation * corner;
+                nearDepth = std::min(nearDepth, -(toMiddle * (eye.position + dir * nearClip - apex)).z);
+                farDepth = std::max(farDepth, -(toMiddle * (eye.position + dir * farClip - apex)).z);
+            }
+        }
+
+        // planes in the middle's space with the apex at the origin, looking down -Z, pointing inwards
+        const std::array<glm::fvec4, PLANE_COUNT> localPlanes = {
+            glm::fvec4(glm::normalize(glm::fvec3(1.0f, 0.0f, tanLeft)), 0.0f),
+            glm::fvec4(glm::normalize(glm::fvec3(-1.0f, 0.0f, -tanRight)), 0.0f),
+            glm::fvec4(glm::normalize(glm::fvec3(0.0f, 1.0f, tanDown)), 0.0f),
+            glm::fvec4(glm::normalize(glm::fvec3(0.0f, -1.0f, -tanUp)), 0.0f),
+            glm::fvec4(0.0f, 0.0f, -1.0f, -nearDepth),
+            glm::fvec4(0.0f, 0.0f, 1.0f, farDepth),
+        };
+        for (size_t i = 0; i < LANES; i++) {
+            if (i < localPlanes.size()) {
+                const glm::fvec3 normal = middleRot * glm::fvec3(localPlanes[i]);
+                m_normalX[i] = normal.x;
+                m_normalY[i] = normal.y;
+                m_normalZ[i] = normal.z;
+                m_distance[i] = localPlanes[i].w - glm::dot(normal, apex);
+            }
+            else {
+                m_normalX[i] = m_normalY[i] = m_normalZ[i] = 0.0f;
+                m_distance[i] = std::numeric_limits<float>::max();
+            }
+        }
+    }
+
+    bool CheckSphere(const glm::fvec3& center, float radius) const {
+        bool inside = true;
+        for (size_t i = 0; i < LANES; i++) {
+            inside &= m_normalX[i] * center.x + m_normalY[i] * center.y + m_normalZ[i] * center.z + m_distance[i] >= -radius;
+        }
+        return inside;
+    }
+
+private:
+    // keeps the side planes from becoming parallel to the view direction when a field of view doesn't reach past the center
+    static constexpr float MIN_TANGENT = 1e-3f;
+
+    static std::array<glm::fvec3, 4> GetCorners(const XrFovf& fov) {
+        const float left = tanf(fov.angleLeft), right = tanf(fov.angleRight), down = tanf(fov.angleDown), up = tanf(fov.angleUp);
+        return { glm::fvec3(left, down, -1.0f), glm::fvec3(right, down, -1.0f), glm::fvec3(left, up, -1.0f), glm::fvec3(right, up, -1.0f) };
+    }
+
+    alignas(32) std::array<float, LANES> m_normalX = {};
+    alignas(32) std::array<float, LANES> m_normalY = {};
+    alignas(32) std::array<float, LANES> m_normalZ = {};
+    alignas(32) std::array<float, LANES> m_distance = {};
+};
@@ -0,0 +1,194 @@
+#pragma once
+#include "pch.h"
+#include "utils/small_vector.h"
+
+
+// Cemu rarely has more than a few copies waiting for their command buffer to be submitted, so only more than this many go to the heap
+constexpr size_t PENDING_COPY_INLINE_CAPACITY = 32;
+
+// Copies that were recorded into one of Cemu's command buffers, which need their interop semaphores injected once that command buffer gets submitted.
+// Texture is SharedTexture in the layer, anything with the same semaphore getters works.
+template <typename Texture>
+using PendingCopyListOf = SmallVector<std::pair<VkCommandBuffer, Texture*>, PENDING_COPY_INLINE_CAPACITY>;
+
+// Copy of one submit's semaphore arrays with room for the interop semaphores, specialized for VkSubmitInfo and VkSubmitInfo2
+template <typename SubmitInfo>
+struct ModifiedSubmitInfo;
+
+template <>
+struct ModifiedSubmitInfo<VkSubmitInfo> {
+    SmallVector<VkSemaphore, 8> waitSemaphores;
+    SmallVector<uint64_t, 8> timelineWaitValues;
+    SmallVector<VkPipelineStageFlags, 8> waitDstStageMasks;
+    SmallVector<VkSemaphore, 8> signalSemaphores;
+    SmallVector<uint64_t, 8> timelineSignalValues;
+
+    VkTimelineSemaphoreSubmitInfo timelineSemaphoreSubmitInfo = { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+
+    static VkCommandBuffer GetCommandBuffer(const VkSubmitInfo& submitInfo, uint32_t idx) { return submitInfo.pCommandBuffers[idx]; }
+    static uint32_t GetCommandBufferCount(const VkSubmitInfo& submitInfo) { return submitInfo.commandBufferCount; }
+
+    bool IsInline() const {
+        return waitSemaphores.IsInline() && timelineWaitValues.IsInline() && waitDstStageMasks.IsInline() && signalSemaphores.IsInline() && timelineSignalValues.IsInline();
+    }
+
+    void CopyFrom(const VkSubmitInfo& submitInfo) {
+        // copy old semaphores into new arrays
+        waitSemaphores.assign(submitInfo.pWaitSemaphores, submitInfo.pWaitSemaphores + submitInfo.waitSemaphoreCount);
+        waitDstStageMasks.assign(submitInfo.pWaitDstStageMask, submitInfo.pWaitDstStageMask + submitInfo.waitSemaphoreCount);
+        timelineWaitValues.resize(submitInfo.waitSemaphoreCount, 0);
+
+        signalSemaphores.assign(submitInfo.pSignalSemaphores, submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount);
+        timelineSignalValues.resize(submitInfo.signalSemaphoreCount, 0);
+
+        // find timeline semaphore submit info if already present
+        const VkTimelineSemaphoreSubmitInfo* existingTimelineInfo = nullptr;
+
+        const VkBaseInStructure* pNextIt = static_cast<const VkBaseInStructure*>(submitInfo.pNext);
+        while (pNextIt) {
+            if (pNextIt->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO) {
+                existingTimelineInfo = reinterpret_cast<const VkTimelineSemaphoreSubmitInfo*>(pNextIt);
+                break;
+            }
+            pNextIt = pNextIt->pNext;
+        }
+
+        // copy any existing timeline values
+        if (existingTimelineInfo) {
+            for (uint32_t j = 0; j < existingTimelineInfo->waitSemaphoreValueCount; j++) {
+                timelineWaitValues[j] = existingTimelineInfo->pWaitSemaphoreValues[j];
+            }
+            for (uint32_t j = 0; j < existingTimelineInfo->signalSemaphoreValueCount; j++) {
+                timelineSignalValues[j] = existingTimelineInfo->pSignalSemaphoreValues[j];
+            }
+        }
+    }
+
+    // vkQueueSubmit can only wait at a stage per semaphore without knowing which command does the copy, so this blocks the whole submit
+    void AddWait(VkSemaphore semaphore, uint64_t value) {
+        waitSemaphores.emplace_back(semaphore);
+        waitDstStageMasks.emplace_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        timelineWaitValues.emplace_back(value);
+    }
+
+    void AddSignal(VkSemaphore semaphore, uint64_t value) {
+        signalSemaphores.emplace_back(semaphore);
+        timelineSignalValues.emplace_back(value);
+    }
+
+    void WriteShadowSubmit(const VkSubmitInfo& submitInfo, VkSubmitInfo& shadowSubmit) {
+        // Update timeline semaphore submit info
+        timelineSemaphoreSubmitInfo.waitSemaphoreValueCount = (uint32_t)timelineWaitValues.size();
+        timelineSemaphoreSubmitInfo.pWaitSemaphoreValues = timelineWaitValues.data();
+        timelineSemaphoreSubmitInfo.signalSemaphoreValueCount = (uint32_t)timelineSignalValues.size();
+        timelineSemaphoreSubmitInfo.pSignalSemaphoreValues = timelineSignalValues.data();
+
+        // AMD GPU FIX: Preserve existing pNext chain - prepend our timeline struct
+        timelineSemaphoreSubmitInfo.pNext = submitInfo.pNext;
+
+        // AMD GPU FIX: Submit a shadow copy of the original VkSubmitInfo
+        shadowSubmit = submitInfo;
+        shadowSubmit.pNext = &timelineSemaphoreSubmitInfo;
+        shadowSubmit.waitSemaphoreCount = (uint32_t)waitSemaphores.size();
+        shadowSubmit.pWaitSemaphores = waitSemaphores.data();
+        shadowSubmit.pWaitDstStageMask = waitDstStageMasks.data();
+        shadowSubmit.signalSemaphoreCount = (uint32_t)signalSemaphores.size();
+        shadowSubmit.pSignalSemaphores = signalSemaphores.data();
+    }
+};
+
+// vkQueueSubmit2 carries the timeline values and stages per semaphore, so only the semaphore arrays need to be extended and no pNext chain has to be patched
+template <>
+struct ModifiedSubmitInfo<VkSubmitInfo2> {
+    SmallVector<VkSemaphoreSubmitInfo, 8> waitSemaphoreInfos;
+    SmallVector<VkSemaphoreSubmitInfo, 8> signalSemaphoreInfos;
+
+    static VkCommandBuffer GetCommandBuffer(const VkSubmitInfo2& submitInfo, uint32_t idx) { return submitInfo.pCommandBufferInfos[idx].commandBuffer; }
+    static uint32_t GetCommandBufferCount(const VkSubmitInfo2& submitInfo) { return submitInfo.commandBufferInfoCount; }
+
+    bool IsInline() const {
+        return waitSemaphoreInfos.IsInline() && signalSemaphoreInfos.IsInline();
+    }
+
+    void CopyFrom(const VkSubmitInfo2& submitInfo) {
+        waitSemaphoreInfos.assign(submitInfo.pWaitSemaphoreInfos, submitInfo.pWaitSemaphoreInfos + submitInfo.waitSemaphoreInfoCount);
+        signalSemaphoreInfos.assign(submitInfo.pSignalSemaphoreInfos, submitInfo.pSignalSemaphoreInfos + submitInfo.signalSemaphoreInfoCount);
+    }
+
+    // only the copy into the interop texture has to wait for D3D12/XR
+    void AddWait(VkSemaphore semaphore, uint64_t value) {
+        VkSemaphoreSubmitInfo waitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+        waitInfo.semaphore = semaphore;
+        waitInfo.value = value;
+        waitInfo.stageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        waitSemaphoreInfos.push_back(waitInfo);
+    }
+
+    void AddSignal(VkSemaphore semaphore, uint64_t value) {
+        VkSemaphoreSubmitInfo signalInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+        signalInfo.semaphore = semaphore;
+        signalInfo.value = value;
+        signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        signalSemaphoreInfos.push_back(signalInfo);
+    }
+
+    void WriteShadowSubmit(const VkSubmitInfo2& submitInfo, VkSubmitInfo2& shadowSubmit) {
+        shadowSubmit = submitInfo;
+        shadowSubmit.waitSemaphoreInfoCount = (uint32_t)waitSemaphoreInfos.size();
+        shadowSubmit.pWaitSemaphoreInfos = waitSemaphoreInfos.data();
+        shadowSubmit.signalSemaphoreInfoCount = (uint32_t)signalSemaphoreInfos.size();
+        shadowSubmit.pSignalSemaphoreInfos = signalSemaphoreInfos.data();
+    }
+};
+
+// Adds the interop semaphores of the pending copies to the submits that contain their command buffers and hands the rewritten submits to submit().
+// Works for both VkSubmitInfo and VkSubmitInfo2. Consumed copies get their command buffer cleared.
+// Everything stays on the stack unless usedHeap reports that the submission was too large for that.
+template <typename Texture, typename SubmitInfo, typename Submit>
+VkResult RewriteSubmits(uint32_t submitCount, const SubmitInfo* pSubmits, PendingCopyListOf<Texture>& pendingCopies, bool& usedHeap, Submit&& submit) {
+    using ModifiedSubmitInfo_t = ModifiedSubmitInfo<SubmitInfo>;
+
+    // Cemu submits one VkSubmitInfo at a time, so only fall back to the heap for unusually large batches
+    constexpr uint32_t MAX_INLINE_SUBMITS = 4;
+    std::array<ModifiedSubmitInfo_t, MAX_INLINE_SUBMITS> inlineModifiedSubmitInfos;
+    std::unique_ptr<ModifiedSubmitInfo_t[]> heapModifiedSubmitInfos;
+    ModifiedSubmitInfo_t* modifiedSubmitInfos = inlineModifiedSubmitInfos.data();
+    if (submitCount > MAX_INLINE_SUBMITS) {
+        heapModifiedSubmitInfos = std::make_unique<ModifiedSubmitInfo_t[]>(submitCount);
+        modifiedSubmitInfos = heapModifiedSubmitInfos.get();
+    }
+    SmallVector<SubmitInfo, MAX_INLINE_SUBMITS> shadowSubmits(submitCount);
+    usedHeap = heapModifiedSubmitInfos != nullptr;
+
+    for (uint32_t i = 0; i < submitCount; i++) {
+        const SubmitInfo& submitInfo = pSubmits[i];
+        ModifiedSubmitInfo_t& modifiedSubmitInfo = modifiedSubmitInfos[i];
+        modifiedSubmitInfo.CopyFrom(submitInfo);
+
+        // Insert timeline semaphores for active copy operations
+        for (uint32_t j = 0; j < ModifiedSubmitInfo_t::GetCommandBufferCount(submitInfo); j++) {
+            const VkCommandBuffer cmdBuffer = ModifiedSubmitInfo_t::GetCommandBuffer(submitInfo, j);
+            for (auto& [copyCmdBuffer, texture] : pendingCopies) {
+                if (cmdBuffer != copyCmdBuffer) {
+                    continue;
+                }
+
+                // Wait for D3D12/XR to finish with the previous shared texture render
+                uint64_t waitValue = texture->GetVulkanWaitValue();
+                modifiedSubmitInfo.AddWait(texture->GetSemaphoreForWait(waitValue), waitValue);
+
+                // Signal to D3D12/XR rendering that the shared texture can be rendered to VR headset
+                uint64_t signalValue = texture->GetVulkanSignalValue();
+                modifiedSubmitInfo.AddSignal(texture->GetSemaphoreForSignal(signalValue), signalValue);
+
+                // mark as consumed
+                copyCmdBuffer = VK_NULL_HANDLE;
+            }
+        }
+
+        modifiedSubmitInfo.WriteShadowSubmit(submitInfo, shadowSubmits[i]);
+        usedHeap |= !modifiedSubmitInfo.IsInline();
+    }
+
+    return submit(shadowSubmits.data());
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include "pch.h"
+
+
+// Continuous collision between a moving weapon and the boxes of the actors around it. The game only checks the attack sensor where the weapon
+// is during a frame, so a fast swing at 30 FPS can pass right through an enemy in between two frames. Here the weapon is a capsule from its base
+// to its tip that gets swept from one pose to the next, which catches everything it passed through on the way.
+// This has no dependencies on the game or the hooks, so swept_collision_tests checks it against brute force on its own.
+namespace SweptCollision {
+    struct AABB {
+        glm::fvec3 min;
+        glm::fvec3 max;
+    };
+
+    // Capsule of the given radius around the base-tip segment, moving from its start pose to its end pose
+    struct SweptCapsule {
+        glm::fvec3 baseStart;
+        glm::fvec3 tipStart;
+        glm::fvec3 baseEnd;
+        glm::fvec3 tipEnd;
+        float radius;
+    };
+
+    struct Hit {
+        uint32_t id;
+        float time; // fraction of the sweep at which the capsule first touches the box
+    };
+
+    // Angle that the blade rotates by during the sweep
+    inline float BladeAngle(const SweptCapsule& sweep) {
+        const glm::fvec3 bladeStart = sweep.tipStart - sweep.baseStart;
+        const glm::fvec3 bladeEnd = sweep.tipEnd - sweep.baseEnd;
+        const float lengths = glm::length(bladeStart) * glm::length(bladeEnd);
+        return lengths > 1e-12f ? acosf(std::clamp(glm::dot(bladeStart, bladeEnd) / lengths, -1.0f, 1.0f)) : 0.0f;
+    }
+
+    inline AABB Bounds(const SweptCapsule& sweep) {
+        // the tip's arc can bulge out of the box around both poses by up to the sagitta of the arc
+        const float bladeLength = std::max(glm::distance(sweep.baseStart, sweep.tipStart), glm::distance(sweep.baseEnd, sweep.tipEnd));
+        const float margin = sweep.radius + bladeLength * (1.0f - cosf(BladeAngle(sweep) * 0.5f));
+        const glm::fvec3 min = glm::min(glm::min(sweep.baseStart, sweep.tipStart), glm::min(sweep.baseEnd, sweep.tipEnd));
+        const glm::fvec3 max = glm::max(glm::max(sweep.baseStart, sweep.tipStart), glm::max(sweep.baseEnd, sweep.tipEnd));
+        return { min - glm::fvec3(margin), max + glm::fvec3(margin) };
+    }
+
+    inline bool Overlaps(const AABB& a, const AABB& b) {
+        return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+    }
+
+    // Transforms a box that's local to an actor into a world-space box that contains it
+    inline AABB TransformBounds(const AABB& local, const glm::mat4x3& mtx) {
+        const glm::fvec3 center = mtx * glm::fvec4((local.min + local.max) * 0.5f, 1.0f);
+        const glm::fvec3 halfExtent = (local.max - local.min) * 0.5f;
+        const glm::fvec3 worldHalfExtent = glm::abs(glm::fvec3(mtx[0])) * halfExtent.x + glm::abs(glm::fvec3(mtx[1])) * halfExtent.y + glm::abs(glm::fvec3(mtx[2])) * halfExtent.z;
+        return { center - worldHalfExtent, center + worldHalfExtent };
+    }
+
+    // Slab test of the segment against the box, returns whether any point of the segment is inside of it
+    inline bool SegmentIntersects(const glm::fvec3& from, const glm::fvec3& to, const AABB& box) {
+        const glm::fvec3 dir = to - from;
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            if (std::abs(dir[axis]) < 1e-8f) {
+                if (from[axis] < box.min[axis] || from[axis] > box.max[axis]) {
+                    return false;
+                }
+                continue;
+            }
+            const float invDir = 1.0f / dir[axis];
+            float t0 = (box.min[axis] - from[axis]) * invDir;
+            float t1 = (box.max[axis] - from[axis]) * invDir;
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            if (tMin > tMax) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns the earliest fraction of the sweep at which the capsule touches the box.
+    // The base moves in a straight line while the blade rotates around it, so the tip follows the arc of a swing instead of cutting across it.
+    // The sweep is split into steps where neither end moves more than the radius, so the capsules of neighbouring steps always overlap and nothing
+    // can slip through in between, however far the sweep goes. Capsules thinner than 1 cm still step 1 cm at a time to bound the work.
+    // The capsule is tested as its segment against the box grown by the radius, which is slightly generous at the corners.
+    inline std::optional<float> SweepAgainstBox(const SweptCapsule& sweep, const AABB& box) {
+        const glm::fvec3 bladeStart = sweep.tipStart - sweep.baseStart;
+        const glm::fvec3 bladeEnd = sweep.tipEnd - sweep.baseEnd;
+        const float lengthStart = glm::length(bladeStart);
+        const float lengthEnd = glm::length(bladeEnd);
+        const glm::fvec3 dirStart = lengthStart > 1e-6f ? bladeStart / lengthStart : glm::fvec3(0.0f);
+        const glm::fvec3 dirEnd = lengthEnd > 1e-6f ? bladeEnd / lengthEnd : dirStart;
+        const float bladeAngle = BladeAngle(sweep);
+        const float invSinAngle = bladeAngle > 1e-3f && bladeAngle < glm::pi<float>() - 1e-3f ? 1.0f / sinf(bladeAngle) : 0.0f;
+
+        const AABB grownBox = { box.min - glm::fvec3(sweep.radius), box.max + glm::fvec3(sweep.radius) };
+        const float travel = glm::distance(sweep.baseStart, sweep.baseEnd) + bladeAngle * std::max(lengthStart, lengthEnd);
+        const uint32_t steps = std::max((uint32_t)std::ceil(travel / std::max(sweep.radius, 0.01f)), 1u);
+        for (uint32_t i = 0; i <= steps; i++) {
+            const float t = (float)i / (float)steps;
+            const glm::fvec3 dir = invSinAngle != 0.0f ? (dirStart * sinf((1.0f - t) * bladeAngle) + dirEnd * sinf(t * bladeAngle)) * invSinAngle : glm::mix(dirStart, dirEnd, t);
+            const glm::fvec3 base = glm::mix(sweep.baseStart, sweep.baseEnd, t);
+            if (SegmentIntersects(base, base + dir * glm::mix(lengthStart, lengthEnd, t), grownBox)) {
+                return t;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Allocation-free broad-phase over a uniform grid. Cells are hashed into a fixed number of buckets, each bucket is a linked list of the boxes
+    // that overlap any cell that hashes to it. Boxes that would cover too many cells are kept in a separate list that every query checks.
+    template <size_t MaxEntries, size_t MaxNodes = MaxEntries * 8, size_t BucketCount = 1024>
+    class SpatialHash {
+        static_assert((BucketCount & (BucketCount - 1)) == 0, "BucketCount must be a power of two");
+
+    public:
+        static constexpr int32_t MAX_CELLS_PER_ENTRY = 27;
+        static constexpr int32_t MAX_CELLS_PER_QUERY = 512;
+
+        explicit SpatialHash(float cellSize = 1.0f): m_invCellSize(1.0f / cellSize) {
+            Clear();
+        }
+
+        void Clear() {
+            m_heads.fill(-1);
+            m_entryCount = 0;
+            m_nodeCount = 0;
+            m_oversizedCount = 0;
+        }
+
+        bool Insert(uint32_t id, const AABB& box) {
+            if (m_entryCount >= MaxEntries) {
+                return false;
+            }
+            const int32_t entryIdx = (int32_t)m_entryCount;
+            const glm::ivec3 minCell = ToCell(box.min);
+            const glm::ivec3 maxCell = ToCell(box.max);
+            const int64_t cellCount = CellCount(minCell, maxCell);
+            if (cellCount > MAX_CELLS_PER_ENTRY || m_nodeCount + cellCount > MaxNodes) {
+                m_oversized[m_oversizedCount++] = entryIdx;
+            }
+            else {
+                for (int32_t x = minCell.x; x <= maxCell.x; x++) {
+                    for (int32_t y = minCell.y; y <= maxCell.y; y++) {
+                        for (int32_t z = minCell.z; z <= maxCell.z; z++) {
+                            const size_t bucket = Hash(x, y, z);
+                            m_nodes[m_nodeCount] = { entryIdx, m_heads[bucket] };
+                            m_heads[bucket] = (int32_t)m_nodeCount++;
+                        }
+                    }
+                }
+            }
+            m_ids[entryIdx] = id;
+            m_boxes[entryIdx] = box;
+            m_visitStamps[entryIdx] = m_queryStamp;
+            m_entryCount++;
+            return true;
+        }
+
+        // Calls func(id, box) once for every box that overlaps the query box
+        template <typename Func>
+        void Query(const AABB& query, Func&& func) const {
+            const glm::ivec3 minCell = ToCell(query.min);
+            const glm::ivec3 maxCell = ToCell(query.max);
+            if (CellCount(minCell, maxCell) > MAX_CELLS_PER_QUERY) {
+                // walking the cells would take longer than just checking everything
+                for (size_t i = 0; i < m_entryCount; i++) {
+                    if (Overlaps(m_boxes[i], query)) {
+                        func(m_ids[i], m_boxes[i]);
+                    }
+                }
+                return;
+            }
+
+            // stamps make sure that boxes that overlap multiple cells only get reported once
+            const uint32_t stamp = ++m_queryStamp;
+            auto visit = [&](int32_t entryIdx) {
+                if (m_visitStamps[entryIdx] == stamp) {
+                    return;
+                }
+                m_visitStamps[entryIdx] = stamp;
+                if (Overlaps(m_boxes[entryIdx], query)) {
+                    func(m_ids[entryIdx], m_boxes[entryIdx]);
+                }
+            };
+            for (int32_t x = minCell.x; x <= maxCell.x; x++) {
+                for (int32_t y = minCell.y; y <= maxCell.y; y++) {
+                    for (int32_t z = minCell.z; z <= maxCell.z; z++) {
+                        for (int32_t node = m_heads[Hash(x, y, z)]; node != -1; node = m_nodes[node].next) {
+                            visit(m_nodes[node].entry);
+                        }
+                    }
+                }
+            }
+            for (size_t i = 0; i < m_oversizedCount; i++) {
+                visit(m_oversized[i]);
+            }
+        }
+
+        // Returns the box that the capsule touches first during the sweep
+        std::optional<Hit> FindFirstHit(const SweptCapsule& sweep) const {
+            std::optional<Hit> firstHit;
+            Query(Bounds(sweep), [&](uint32_t id, const AABB& box) {
+                if (std::optional<float> time = SweepAgainstBox(sweep, box); time && (!firstHit || *time < firstHit->time)) {
+                    firstHit = Hit{ id, *time };
+                }
+            });
+            return firstHit;
+        }
+
+        size_t Size() const { return m_entryCount; }
+
+    private:
+        struct Node {
+            int32_t entry;
+            int32_t next;
+        };
+
+        glm::ivec3 ToCell(const glm::fvec3& position) const {
+            return glm::ivec3(glm::floor(position * m_invCellSize));
+        }
+
+        static int64_t CellCount(const glm::ivec3& minCell, const glm::ivec3& maxCell) {
+            return (int64_t)(maxCell.x - minCell.x + 1) * (int64_t)(maxCell.y - minCell.y + 1) * (int64_t)(maxCell.z - minCell.z + 1);
+        }
+
+        static size_t Hash(int32_t x, int32_t y, int32_t z) {
+            return (size_t)(((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u)) & (BucketCount - 1);
+        }
+
+        float m_invCellSize;
+        std::array<int32_t, BucketCount> m_heads = {};
+        std::array<Node, MaxNodes> m_nodes = {};
+        std::array<uint32_t, MaxEntries> m_ids = {};
+        std::array<AABB, MaxEntries> m_boxes = {};
+        std::array<int32_t, MaxEntries> m_oversized = {};
+        mutable std::array<uint32_t, MaxEntries> m_visitStamps = {};
+        mutable uint32_t m_queryStamp = 0;
+        size_t m_entryCount = 0;
+        size_t m_nodeCount = 0;
+        size_t m_oversizedCount = 0;
+    };
+}
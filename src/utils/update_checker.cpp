@@ -1,6 +1,7 @@
 #include "update_checker.h"
 #include "pch.h"
 #include "utils/logger.h"
+#include "utils/environment.h"
 #include <fstream>
 #include <string>
 #include <thread>
@@ -67,14 +68,7 @@ namespace UpdateChecker {
     }
 
     static std::string LoadIgnoredVersionOnce() {
-        char path[MAX_PATH] = {};
-        if (GetModuleFileNameA(nullptr, path, MAX_PATH) == 0) {
-            return {};
-        }
-        std::string exePath(path);
-        const size_t lastSlash = exePath.find_last_of("\\/");
-        const std::string dir = (lastSlash == std::string::npos) ? std::string() : exePath.substr(0, lastSlash + 1);
-        const std::string filePath = dir + "BetterVR_update_ignore_once.txt";
+        const std::filesystem::path filePath = GetCemuDirectory() / "BetterVR_update_ignore_once.txt";
 
         std::ifstream f(filePath, std::ios::in);
         if (!f.is_open()) {
@@ -86,14 +80,7 @@ namespace UpdateChecker {
     }
 
     static void SaveIgnoredVersionOnce(const std::string& version) {
-        char path[MAX_PATH] = {};
-        if (GetModuleFileNameA(nullptr, path, MAX_PATH) == 0) {
-            return;
-        }
-        std::string exePath(path);
-        const size_t lastSlash = exePath.find_last_of("\\/");
-        const std::string dir = (lastSlash == std::string::npos) ? std::string() : exePath.substr(0, lastSlash + 1);
-        const std::string filePath = dir + "BetterVR_update_ignore_once.txt";
+        const std::filesystem::path filePath = GetCemuDirectory() / "BetterVR_update_ignore_once.txt";
 
         std::ofstream f(filePath, std::ios::out | std::ios::trunc);
         if (!f.is_open()) {
@@ -1,5 +1,6 @@
 #pragma once
 #include "pch.h"
+#include "utils/interop_barriers.h"
 
 
 namespace VulkanUtils {
@@ -0,0 +1,82 @@
+#include "test_utils.h"
+#include "hooking/body_slots.h"
+
+using namespace BodySlots;
+
+static bool IsIn(const SlotVolume& volume, float forward, float right, float height) {
+    return volume.Contains({ forward, right, height, forward * forward + right * right + height * height });
+}
+
+static const SlotVolume& VolumeOf(Slot slot) {
+    return *std::ranges::find(SLOTS, slot, &SlotVolume::slot);
+}
+
+// The edges of the volumes that keep neighbouring slots apart
+static void TestVolumes() {
+    // hands behind the head on either side
+    Check(IsIn(VolumeOf(Slot::LeftShoulder), -0.1f, -0.1f, 0.0f) && !IsIn(VolumeOf(Slot::LeftShoulder), -0.1f, 0.1f, 0.0f) && IsIn(VolumeOf(Slot::RightShoulder), -0.1f, 0.1f, 0.0f), "Body slots: the shoulders aren't split into left and right behind the head");
+    // the mouth is in front of the face, so it can't overlap with the shoulders
+    Check(IsIn(VolumeOf(Slot::Mouth), 0.1f, 0.0f, -0.1f) && !IsIn(VolumeOf(Slot::Mouth), -0.01f, 0.0f, -0.1f) && !IsIn(VolumeOf(Slot::LeftShoulder), 0.0f, -0.1f, 0.0f), "Body slots: the mouth and shoulders overlap at the face");
+    // hip height and slightly behind the body
+    Check(IsIn(VolumeOf(Slot::LeftWaist), 0.02f, -0.2f, -0.6f) && !IsIn(VolumeOf(Slot::LeftWaist), 0.1f, -0.2f, -0.6f) && !IsIn(VolumeOf(Slot::LeftWaist), 0.02f, -0.2f, -0.4f), "Body slots: the left waist isn't at hip height slightly behind the body");
+}
+
+// Turning the headset doesn't change which slot a hand is in, as long as the hand turns with it
+static void TestHeadsetYaw() {
+    const glm::fvec3 localHand = glm::fvec3(0.2f, -0.6f, 0.02f); // right hip, slightly behind
+    for (float yaw : { 0.0f, 1.0f, 2.5f, -2.0f }) {
+        const glm::fmat4 headsetMtx = glm::translate(glm::identity<glm::fmat4>(), glm::fvec3(1.0f, 1.6f, -2.0f)) * glm::eulerAngleY(yaw);
+        const HeadsetFrame headset = GetHeadsetFrame(headsetMtx);
+        const glm::fvec3 hand = glm::fvec3(headsetMtx * glm::fvec4(localHand, 1.0f));
+        const std::array<SlotMask, 2> masks = Evaluate(headset, { hand, hand });
+        Check(masks[0] == masks[1] && (masks[0] & Bit(Slot::RightWaist)) != 0 && (masks[0] & Bit(Slot::LeftWaist)) == 0, "Body slots: a hand at the right hip with the headset turned by {} rad is in slots {:#x}", yaw, masks[0]);
+    }
+}
+
+// Moves both hands along loops around the body that pass through every slot at 90 Hz, checks that no hand is ever in two slots that should
+// exclude each other and that every slot got reached, and times the evaluation
+static void TestTrajectory(uint32_t seconds) {
+    const uint32_t sampleCount = seconds * 90;
+    const glm::fmat4 headsetMtx = glm::translate(glm::identity<glm::fmat4>(), glm::fvec3(0.0f, 1.6f, 0.0f));
+    const HeadsetFrame headset = GetHeadsetFrame(headsetMtx);
+
+    std::vector<std::array<glm::fvec3, 2>> trajectory;
+    trajectory.reserve(sampleCount);
+    for (uint32_t i = 0; i < sampleCount; i++) {
+        const float t = (float)i / 90.0f;
+        // circling around the body while going up and down between the hips and above the head, the left hand mirrors the right one
+        const float angle = t * 2.3f;
+        const float radius = 0.15f + 0.25f * (0.5f + 0.5f * sinf(t * 0.7f));
+        const glm::fvec3 offset = glm::fvec3(radius * cosf(angle), 0.2f - 0.9f * (0.5f + 0.5f * sinf(t * 1.3f)), radius * sinf(angle));
+        trajectory.push_back({ headset.position + glm::fvec3(-offset.x, offset.y, offset.z), headset.position + offset });
+    }
+
+    std::array<uint32_t, (size_t)Slot::Count> samplesInSlot = {};
+    uint32_t conflicts = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& handPositions : trajectory) {
+        for (SlotMask mask : Evaluate(headset, handPositions)) {
+            const bool bothShoulders = (mask & Bit(Slot::LeftShoulder)) && (mask & Bit(Slot::RightShoulder));
+            const bool bothWaists = (mask & Bit(Slot::LeftWaist)) && (mask & Bit(Slot::RightWaist));
+            const bool mouthAndShoulder = (mask & Bit(Slot::Mouth)) && (mask & (Bit(Slot::LeftShoulder) | Bit(Slot::RightShoulder)));
+            conflicts += (bothShoulders || bothWaists || mouthAndShoulder) ? 1 : 0;
+            for (uint32_t slot = 0; slot < (uint32_t)Slot::Count; slot++) {
+                samplesInSlot[slot] += (mask >> slot) & 1;
+            }
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    Check(conflicts == 0, "Body slots: {} samples were in conflicting slots", conflicts);
+    for (uint32_t slot = 0; slot < (uint32_t)Slot::Count; slot++) {
+        Check(samplesInSlot[slot] != 0, "Body slots: slot {} was never reached", slot);
+    }
+    Log::print<INFO>("Body slots: {:.0f} ns per evaluation of both hands", NsPer(elapsed, trajectory.size()));
+}
+
+int main() {
+    TestVolumes();
+    TestHeadsetYaw();
+    TestTrajectory(60);
+    return FinishTests("Body slots");
+}
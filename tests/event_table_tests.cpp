@@ -0,0 +1,114 @@
+#include "test_utils.h"
+#include "hooking/event_table.h"
+
+#include <unordered_map>
+
+static HybridEventSettings SettingsOf(uint32_t i) {
+    return { (i & 1) != 0, (i & 2) != 0, (i & 4) != 0, (i & 8) != 0 };
+}
+
+static bool Equal(const HybridEventSettings& a, const HybridEventSettings& b) {
+    return memcmp(&a, &b, sizeof(HybridEventSettings)) == 0;
+}
+
+// Settings lists apply to the defaults they're parsed into, and unknown settings are reported without losing the known ones
+static void TestParseSettings() {
+    HybridEventSettings settings = {};
+    Check(EventTable::ParseSettings("FP_ON,PAN_OFF,HND_OFF,CTRL_ON", settings), "Event table: a list of known settings had an unknown setting in it");
+    Check(settings.firstPerson && settings.ignoreCameraRotation && settings.disablePlayerDrivenLinkHands && !settings.demoEnableCameraInput, "Event table: parsed the settings as {}", EventTable::FormatSettings(settings));
+    Check(!EventTable::ParseSettings("FP_OFF,NOPE", settings) && !settings.firstPerson, "Event table: an unknown setting wasn't reported or stopped the known ones from applying");
+
+    HybridEventSettings formatted = {};
+    EventTable::ParseSettings(EventTable::FormatSettings(SettingsOf(0b1010)), formatted);
+    Check(Equal(formatted, SettingsOf(0b1010)), "Event table: formatting and parsing the settings again gave {}", EventTable::FormatSettings(formatted));
+}
+
+// Overrides are saved and loaded again, including the ones of events that weren't in the graphic pack's table yet
+static void TestOverrides() {
+    const std::filesystem::path filePath = std::filesystem::temp_directory_path() / "bettervr_event_overrides_test.txt";
+    {
+        EventTable table;
+        const EventTable::EventId known = table.Add("Demo001_0", SettingsOf(0));
+        table.Add("Demo002_0", SettingsOf(0));
+        const EventTable::EventId added = table.Add("Demo003_0", SettingsOf(0));
+        table.SetOverride(known, SettingsOf(0b0101));
+        table.SetOverride(added, SettingsOf(0b1111));
+        table.SaveOverrides(filePath);
+    }
+
+    EventTable table;
+    const EventTable::EventId known = table.Add("Demo001_0", SettingsOf(0));
+    const EventTable::EventId other = table.Add("Demo002_0", SettingsOf(0));
+    table.LoadOverrides(filePath, SettingsOf(0b0001));
+    std::filesystem::remove(filePath);
+
+    const EventTable::EventId added = table.Find("Demo003_0");
+    Check(Equal(table.GetOverride(known).value_or(SettingsOf(0)), SettingsOf(0b0101)), "Event table: the override of a known event didn't load");
+    Check(!table.GetOverride(other).has_value(), "Event table: an event without an override got one");
+    Check(added != EventTable::NO_EVENT && Equal(table.GetDefaults(added), SettingsOf(0b0001)) && Equal(table.GetOverride(added).value_or(SettingsOf(0)), SettingsOf(0b1111)),
+        "Event table: an event that wasn't known yet didn't get added with the given defaults and its override");
+}
+
+// Adding more than MAX_EVENTS events leaves the table as it was instead of overwriting anything
+static void TestFull() {
+    auto table = std::make_unique<EventTable>();
+    for (uint32_t i = 0; i < EventTable::MAX_EVENTS; i++) {
+        table->Add(std::format("Event{}", i), SettingsOf(i));
+    }
+    Check(table->Size() == EventTable::MAX_EVENTS, "Event table: only {} of {} events fit into the table", table->Size(), EventTable::MAX_EVENTS);
+    Check(table->Add("OneTooMany", SettingsOf(0)) == EventTable::NO_EVENT && table->Find("OneTooMany") == EventTable::NO_EVENT, "Event table: an event got added to a full table");
+    const EventTable::EventId last = table->Find(std::format("Event{}", EventTable::MAX_EVENTS - 1));
+    Check(last != EventTable::NO_EVENT && Equal(table->GetDefaults(last), SettingsOf(EventTable::MAX_EVENTS - 1)), "Event table: the last event that fit got lost");
+}
+
+// Looks up the active event by the guest's name and checks that it finds the same settings as building a std::string and looking it up in an
+// unordered_map like before, timing both
+static void CompareWithMap(uint32_t iterations) {
+    constexpr uint32_t EVENT_COUNT = 512;
+    auto table = std::make_unique<EventTable>();
+    std::unordered_map<std::string, HybridEventSettings> map;
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < EVENT_COUNT; i++) {
+        names.emplace_back(std::format("Demo{:03}_{}", i, i % 7));
+        table->Add(names.back(), SettingsOf(i));
+        map.emplace(names.back(), SettingsOf(i));
+    }
+
+    uint32_t mismatches = 0;
+    for (const std::string& name : names) {
+        const EventTable::EventId id = table->Find(name);
+        mismatches += id == EventTable::NO_EVENT || table->GetName(id) != name || !Equal(table->GetDefaults(id), map.at(name)) ? 1 : 0;
+    }
+    Check(mismatches == 0, "Event table: {} of {} events had a different name or settings than in the map", mismatches, EVENT_COUNT);
+    Check(table->Find("Demo999_9") == EventTable::NO_EVENT, "Event table: found an event that was never added");
+
+    // guest strings are null-terminated, so both have to find the end of the name first
+    uint32_t tableChecksum = 0;
+    const auto tableStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        const char* guestName = names[(i * 37) % EVENT_COUNT].c_str();
+        const EventTable::EventId id = table->Find(std::string_view(guestName));
+        tableChecksum += id != EventTable::NO_EVENT && table->GetDefaults(id).firstPerson ? 1 : 0;
+    }
+    const auto tableElapsed = std::chrono::steady_clock::now() - tableStart;
+
+    uint32_t mapChecksum = 0;
+    const auto mapStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        const char* guestName = names[(i * 37) % EVENT_COUNT].c_str();
+        const auto it = map.find(std::string(guestName));
+        mapChecksum += it != map.end() && it->second.firstPerson ? 1 : 0;
+    }
+    const auto mapElapsed = std::chrono::steady_clock::now() - mapStart;
+
+    Check(tableChecksum == mapChecksum, "Event table: the lookups found {} first-person events and the map {}", tableChecksum, mapChecksum);
+    Log::print<INFO>("Event table: {:.1f} ns per lookup by name, {:.1f} ns with a std::string and unordered_map", NsPer(tableElapsed, iterations), NsPer(mapElapsed, iterations));
+}
+
+int main() {
+    TestParseSettings();
+    TestOverrides();
+    TestFull();
+    CompareWithMap(1000000);
+    return FinishTests("Event table");
+}
@@ -0,0 +1,69 @@
+#include "test_utils.h"
+#include "hooking/haptic_waveforms.h"
+
+using namespace HapticWaveforms;
+
+// The tables match the shapes they're built from
+static void TestTables() {
+    float worstError = 0.0f;
+    for (uint32_t i = 0; i <= 10000; i++) {
+        const float t = (float)i / 10000.0f;
+        worstError = std::max(worstError, std::abs(Sample(Shape::Sine, t) - (sinf(t * 2.0f * glm::pi<float>()) + 1.0f) * 0.5f));
+        worstError = std::max(worstError, std::abs(Sample(Shape::RisingSquare, t) - t * t));
+        worstError = std::max(worstError, std::abs(Sample(Shape::FallingSquare, t) - (1.0f - t) * (1.0f - t)));
+    }
+    Check(worstError < 0.001f, "Haptic waveforms: the tables are off by up to {} from the shapes they're built from", worstError);
+}
+
+// Held voices keep going until they're released, and the release fades out from wherever the envelope was
+static void TestRelease() {
+    Voice voice;
+    voice.Start({ .envelope = { .attack = 0.1f, .hold = HELD, .release = 0.2f }, .frequency = 1.0f, .amplitude = 1.0f });
+    Check(voice.Length() == HELD && voice.Level(100.0f) == 1.0f, "Haptic waveforms: a held voice ended or faded on its own");
+    voice.Release(0.05f);
+    Check(std::abs(voice.Length() - 0.25f) < 0.0001f, "Haptic waveforms: releasing during the attack gave a length of {}", voice.Length());
+    Check(std::abs(voice.Level(0.05f) - 0.25f) < 0.001f && voice.Level(0.25f) == 0.0f, "Haptic waveforms: the release started at {} and ended at {}", voice.Level(0.05f), voice.Level(0.25f));
+}
+
+// Samples two layered voices per tick from the tables and evaluates the same shapes directly, checking that both agree and timing them
+static void CompareWithDirectShapes(uint32_t ticks) {
+    Preset layered = { .envelope = { .attack = 0.05f, .decay = 0.1f, .sustain = 0.6f, .hold = HELD, .release = 0.2f }, .frequency = 1.0f, .amplitude = 1.0f };
+    layered.oscillators[layered.oscillatorCount++] = { Shape::Sine, 7.0f, 0.5f };
+    layered.oscillators[layered.oscillatorCount++] = { Shape::FallingSquare, 2.0f, 0.3f };
+    std::array<Voice, 2> voices;
+    voices[0].Start(layered);
+    voices[1].Start(FromParameters({ true, 1, RumbleType::OscillationSmooth, 4.0f, false, 1000.0, 0.5f, 0.5f }));
+
+    const float tickSeconds = 1.0f / 90.0f;
+    float tableSum = 0.0f;
+    const auto tableStart = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        for (const Voice& voice : voices) {
+            tableSum += voice.Render((float)tick * tickSeconds).amplitude;
+        }
+    }
+    const auto tableElapsed = std::chrono::steady_clock::now() - tableStart;
+
+    float directSum = 0.0f;
+    const auto directStart = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        const float time = (float)tick * tickSeconds;
+        const float envelope = time < 0.05f ? (time / 0.05f) * (time / 0.05f) : time < 0.15f ? 0.6f + 0.4f * (1.0f - (time - 0.05f) / 0.1f) * (1.0f - (time - 0.05f) / 0.1f) : 0.6f;
+        const float fastPhase = fmodf(time * 7.0f, 1.0f);
+        const float slowPhase = fmodf(time * 2.0f, 1.0f);
+        directSum += envelope * (0.5f + 0.5f * (sinf(fastPhase * 2.0f * glm::pi<float>()) + 1.0f) * 0.5f) * (0.7f + 0.3f * (1.0f - slowPhase) * (1.0f - slowPhase));
+        directSum += 0.5f * (sinf(fmodf(time * 4.0f, 1.0f) * 2.0f * glm::pi<float>()) + 1.0f) * 0.5f;
+    }
+    const auto directElapsed = std::chrono::steady_clock::now() - directStart;
+
+    const float sumError = std::abs(tableSum - directSum) / std::max(directSum, 1.0f);
+    Check(sumError < 0.001f, "Haptic waveforms: the voices add up to {} from the tables and {} from the shapes", tableSum, directSum);
+    Log::print<INFO>("Haptic waveforms: {:.1f} ns per tick of two voices from tables, {:.1f} ns evaluating the shapes directly", NsPer(tableElapsed, ticks), NsPer(directElapsed, ticks));
+}
+
+int main() {
+    TestTables();
+    TestRelease();
+    CompareWithDirectShapes(1000000);
+    return FinishTests("Haptic waveforms");
+}
@@ -0,0 +1,69 @@
+#include "test_utils.h"
+#include "utils/image_table.h"
+
+using TestImageTable = ImageTable<4096>;
+
+// Hammers the table with concurrent inserts, lookups and erases and checks that every thread always sees its own images with the right values,
+// that lookups of another thread's images that are being erased never return a wrong value, and that no tombstones are left once everything is erased.
+static void RunStressTest(uint32_t threadCount, uint32_t iterations) {
+    auto table = std::make_unique<TestImageTable>();
+    std::atomic_uint32_t failures = 0;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([&table, &failures, t, threadCount, iterations]() {
+            constexpr uint32_t IMAGES_PER_THREAD = 32;
+            std::array<VkImage, IMAGES_PER_THREAD> images = {};
+            for (uint32_t i = 0; i < iterations; i++) {
+                uint32_t slot = i % IMAGES_PER_THREAD;
+                if (images[slot] != VK_NULL_HANDLE) {
+                    if (!table->Erase(images[slot]) || table->Find(images[slot]).has_value()) {
+                        failures++;
+                    }
+                }
+
+                // fake handles that are unique across threads and iterations, avoiding the reserved keys
+                images[slot] = (VkImage)(((uint64_t)(t + 1) << 40) | ((uint64_t)i << 4));
+                VkExtent2D extent = { 1280 + t, 720 + (i & 0xFFF) };
+                VkFormat format = (i & 1) ? VK_FORMAT_D32_SFLOAT : VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+                if (!table->Insert(images[slot], extent, format)) {
+                    failures++;
+                    images[slot] = VK_NULL_HANDLE;
+                    continue;
+                }
+
+                auto info = table->Find(images[slot]);
+                if (!info || info->extent.width != extent.width || info->extent.height != extent.height || info->format != format || info->classification != TestImageTable::Classify(format)) {
+                    failures++;
+                }
+
+                // an image of the next thread that might get erased right now, it either isn't found or has exactly the values it was inserted with
+                const uint32_t other = (t + 1) % threadCount;
+                const uint32_t otherIteration = i > IMAGES_PER_THREAD ? i - IMAGES_PER_THREAD + 1 : i;
+                if (auto otherInfo = table->Find((VkImage)(((uint64_t)(other + 1) << 40) | ((uint64_t)otherIteration << 4)))) {
+                    if (otherInfo->extent.width != 1280 + other || otherInfo->extent.height != 720 + (otherIteration & 0xFFF) || otherInfo->format != ((otherIteration & 1) ? VK_FORMAT_D32_SFLOAT : VK_FORMAT_A2B10G10R10_UNORM_PACK32)) {
+                        failures++;
+                    }
+                }
+            }
+
+            for (VkImage image : images) {
+                if (image != VK_NULL_HANDLE && !table->Erase(image)) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Check(table->Size() == 0 && table->TombstoneCount() == 0, "ImageTable stress test left {} images and {} tombstones behind after erasing everything", table->Size(), table->TombstoneCount());
+    Check(failures == 0, "ImageTable stress test failed {} times with {} threads and {} iterations each", failures.load(), threadCount, iterations);
+}
+
+int main() {
+    const uint32_t threadCount = std::max(2u, std::thread::hardware_concurrency());
+    RunStressTest(threadCount, 20000);
+    return FinishTests("ImageTable");
+}
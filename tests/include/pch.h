@@ -0,0 +1,101 @@
+#pragma once
+
+// Stand-in for include/pch.h in the tests, with only the headers that are available on every platform.
+// Logging goes to the console and failed asserts throw instead of showing a message box.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <ranges>
+#include <set>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan_core.h>
+
+#include <openxr/openxr.h>
+
+// glm includes, with the same settings as the layer
+#define GLM_FORCE_XYZW_ONLY
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_access.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/norm.hpp>
+#include <glm/gtx/string_cast.hpp>
+#include <glm/gtx/euler_angles.hpp>
+#undef GLM_ENABLE_EXPERIMENTAL
+
+#include "pch_portable.h"
+
+enum class LogType {
+    // verbose logging types
+    RENDERING,
+    INTEROP,
+    CONTROLS,
+    PPC,
+    XR_DEBUGUTILS,
+
+    // generic types
+    INFO,
+    WARNING,
+    ERROR,
+    VERBOSE
+};
+
+using enum LogType;
+ENABLE_BITMASK_OPERATORS(LogType);
+
+class Log {
+public:
+    template <LogType L>
+    static inline bool consteval isLogTypeEnabled() {
+        return L == ERROR || L == WARNING || L == INFO;
+    }
+
+    template <LogType L>
+    static inline void print(const char* message) {
+        if constexpr (!isLogTypeEnabled<L>()) {
+            return;
+        }
+        static std::mutex logMutex;
+        std::lock_guard<std::mutex> lock(logMutex);
+        (L == ERROR ? std::cerr : std::cout) << message << std::endl;
+    }
+
+    template <LogType L, class... Args>
+    static inline void print(const char* format, Args&&... args) {
+        if constexpr (!isLogTypeEnabled<L>()) {
+            return;
+        }
+        Log::print<L>(std::vformat(format, std::make_format_args(args...)).c_str());
+    }
+};
+
+static void checkAssert(const bool assert, const char* errorMessage) {
+    if (!assert) {
+        Log::print<ERROR>("{}", errorMessage == nullptr ? "Something unexpected happened that prevents further execution!" : errorMessage);
+        throw std::runtime_error(errorMessage == nullptr ? "Unexpected assertion occurred!" : errorMessage);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "pch.h"
+
+// Every test is its own executable that returns how many of its checks failed, so that ctest reports it.
+inline uint32_t s_failedChecks = 0;
+
+template <class... Args>
+inline void Check(bool condition, const char* format, Args&&... args) {
+    if (!condition) {
+        s_failedChecks++;
+        Log::print<ERROR>(format, args...);
+    }
+}
+
+inline int FinishTests(const char* name) {
+    if (s_failedChecks != 0) {
+        Log::print<ERROR>("{}: {} checks failed", name, s_failedChecks);
+        return 1;
+    }
+    Log::print<INFO>("{}: all checks passed", name);
+    return 0;
+}
+
+inline double NsPer(std::chrono::steady_clock::duration elapsed, size_t count) {
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double)count;
+}
+
+// Deterministic xorshift so that every run checks the same inputs
+struct TestRandom {
+    uint32_t state = 0x9E3779B9u;
+
+    uint32_t Next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float Range(float min, float max) {
+        return min + (max - min) * (float)(Next() >> 8) / (float)(1u << 24);
+    }
+};
@@ -0,0 +1,108 @@
+#include "test_utils.h"
+#include "hooking/input_mapping.h"
+
+using namespace InputMapping;
+
+static Clock::time_point At(uint32_t ms) {
+    return Clock::time_point{} + std::chrono::milliseconds(ms);
+}
+
+// Feeds the same sources as the hook, with the presses of the inventory and crouch buttons going through their ButtonState first
+struct ScriptedInput {
+    Mapper mapper;
+    ButtonState inventory = {};
+    ButtonState crouch = {};
+
+    ActionMask Frame(uint32_t ms, bool inventoryDown, bool crouchDown, bool jumpDown, Context context, bool inputDelayed) {
+        inventory.Update(inventoryDown, At(ms));
+        crouch.Update(crouchDown, At(ms));
+        SourceStates sources = {};
+        sources[(size_t)Source::InventoryMap] = Pack(inventoryDown, inventory.lastEvent);
+        sources[(size_t)Source::CrouchScope] = Pack(crouchDown, crouch.lastEvent);
+        sources[(size_t)Source::JumpCancel] = Pack(jumpDown, ButtonState::Event::None);
+        return mapper.Update(sources, context, inputDelayed);
+    }
+};
+
+// A short press opens the inventory on release, a long press opens the map once the threshold is reached and keeps it held until release
+static void TestPresses() {
+    ScriptedInput input;
+    Check(input.Frame(0, true, false, false, Context::InGame, false) == 0, "Input mapping: pressing a button fired something already");
+    Check(input.Frame(100, false, false, false, Context::InGame, false) == Bit(Action::OpenInventory), "Input mapping: releasing early wasn't a short press");
+    Check(input.Frame(111, false, false, false, Context::InGame, false) == 0, "Input mapping: a short press lasted longer than a single frame");
+    Check(input.Frame(200, true, false, false, Context::InGame, false) == 0, "Input mapping: pressing again fired something already");
+    Check(input.Frame(440, true, false, false, Context::InGame, false) == 0, "Input mapping: the long press fired before its threshold");
+    Check(input.Frame(450, true, false, false, Context::InGame, false) == Bit(Action::OpenMap), "Input mapping: the long press didn't fire at its threshold");
+    Check(input.Frame(600, false, false, false, Context::InGame, false) == 0, "Input mapping: releasing a long press was also a short press");
+}
+
+// Held bindings, the input delay and the context
+static void TestHeldAndContext() {
+    ScriptedInput input;
+    Check(input.Frame(700, false, false, true, Context::InGame, true) == 0, "Input mapping: the input delay didn't block jumping");
+    Check(input.Frame(711, false, false, true, Context::InGame, false) == Bit(Action::Jump), "Input mapping: jumping didn't work once the input delay was over");
+    Check(input.Frame(722, false, true, true, Context::InGame, false) == Bit(Action::Jump), "Input mapping: holding crouch fired something already");
+    Check(input.Frame(733, false, false, true, Context::InGame, false) == (Bit(Action::Jump) | Bit(Action::Crouch)), "Input mapping: crouching affected jumping");
+    Check(input.mapper.GetButtons() == (VPAD_BUTTON_X | VPAD_BUTTON_STICK_L), "Input mapping: the buttons {:#x} don't match the active actions", input.mapper.GetButtons());
+    Check(input.Frame(744, false, false, true, Context::InMenu, false) == 0, "Input mapping: in-game bindings fired in a menu");
+}
+
+// The start button needs to be held for a while, and only toggles once per press
+static void TestStartButton() {
+    Mapper mapper;
+    uint32_t toggles = 0;
+    for (uint32_t ms = 0; ms <= 1000; ms += 11) toggles += mapper.UpdateStartButton(true, At(ms)) ? 1 : 0;
+    toggles += mapper.UpdateStartButton(false, At(1011)) ? 1 : 0;
+    toggles += mapper.UpdateStartButton(true, At(1022)) ? 1 : 0;
+    Check(toggles == 1, "Input mapping: holding the start button toggled the mod menu {} times", toggles);
+}
+
+// The stick emulation only lets go once the stick is close to the center, and the trigger and release edges follow the hold
+static void TestStickEmulationAndEdges() {
+    Mapper mapper;
+    Check(mapper.UpdateStickEmulation({ 0.6f, 0.0f }, { 0.0f, -0.6f }) == (VPAD_STICK_L_EMULATION_RIGHT | VPAD_STICK_R_EMULATION_DOWN), "Input mapping: sticks past the threshold weren't held");
+    Check(mapper.UpdateStickEmulation({ 0.2f, 0.0f }, { 0.0f, 0.0f }) == VPAD_STICK_L_EMULATION_RIGHT, "Input mapping: a held stick was released before it got centered");
+    Check(mapper.UpdateStickEmulation({ 0.05f, 0.2f }, { 0.0f, 0.0f }) == VPAD_BUTTON_NONE, "Input mapping: a centered stick wasn't released");
+
+    const Mapper::Edges edges = mapper.UpdateHold(VPAD_BUTTON_A | VPAD_BUTTON_B);
+    const Mapper::Edges nextEdges = mapper.UpdateHold(VPAD_BUTTON_B);
+    Check(edges.trig == (VPAD_BUTTON_A | VPAD_BUTTON_B) && nextEdges.trig == 0 && nextEdges.release == VPAD_BUTTON_A, "Input mapping: the trigger and release edges don't follow the hold");
+}
+
+// The hook runs once per game frame and most of those frames have no changes, so those shouldn't re-evaluate any bindings.
+// Times those frames and frames where every source changed.
+static void TimeFrames(uint32_t iterations) {
+    Mapper mapper;
+    SourceStates idle = {};
+    idle[(size_t)Source::JumpCancel] = Pack(true, ButtonState::Event::None);
+    SourceStates busy = idle;
+    ActionMask sink = 0;
+
+    mapper.Update(idle, Context::InGame, false);
+    const uint64_t reevaluatedBefore = mapper.GetReevaluatedBindings();
+    const auto idleStart = Clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sink ^= mapper.Update(idle, Context::InGame, false);
+    }
+    const auto idleElapsed = Clock::now() - idleStart;
+    const uint64_t idleReevaluated = mapper.GetReevaluatedBindings() - reevaluatedBefore;
+    Check(idleReevaluated == 0, "Input mapping: {} bindings got re-evaluated over {} unchanged frames", idleReevaluated, iterations);
+
+    const auto busyStart = Clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (SourceState& state : busy) state = Pack((i & 1) != 0, (i & 2) != 0 ? ButtonState::Event::ShortPress : ButtonState::Event::LongPress);
+        sink ^= mapper.Update(busy, Context::InGame, false);
+    }
+    const auto busyElapsed = Clock::now() - busyStart;
+
+    Log::print<INFO>("Input mapping: {:.1f} ns per unchanged frame, {:.1f} ns per frame where every source changed (result {})", NsPer(idleElapsed, iterations), NsPer(busyElapsed, iterations), sink);
+}
+
+int main() {
+    TestPresses();
+    TestHeldAndContext();
+    TestStartButton();
+    TestStickEmulationAndEdges();
+    TimeFrames(1000000);
+    return FinishTests("Input mapping");
+}
@@ -0,0 +1,104 @@
+#include "test_utils.h"
+#include "hooking/input_rumbles.h"
+
+using Clock = InputRumbleScheduler::Clock;
+
+static Clock::time_point At(uint32_t ms) {
+    return Clock::time_point{} + std::chrono::milliseconds(ms);
+}
+
+static bool Near(float a, float b) {
+    return std::abs(a - b) < 0.01f;
+}
+
+// Records what would've been sent to the headset
+static std::array<std::optional<HapticWaveforms::Packet>, 2> Update(InputRumbleScheduler& scheduler, uint32_t ms) {
+    std::array<std::optional<HapticWaveforms::Packet>, 2> packets = {};
+    scheduler.Update(At(ms), [&](size_t hand, const HapticWaveforms::Packet& packet) { packets[hand] = packet; });
+    return packets;
+}
+
+static const RumbleParameters OSCILLATING = { true, 0, RumbleType::OscillationSmooth, 2.0f, false, 1.0, 1.0f, 1.0f };
+static const RumbleParameters FIXED = { true, 1, RumbleType::Fixed, 0.0f, false, 0.25, 0.3f, 0.5f };
+static const RumbleParameters RAISING = { true, 0, RumbleType::Raising, 0.0f, false, 0.2, 1.0f, 1.0f };
+static const RumbleParameters HELD = { true, 1, RumbleType::Raising, 0.5f, true, 0.2, 0.25f, 0.25f };
+static const RumbleParameters WEAK = { false, 1, RumbleType::Falling, 0.0f, false, 0.1, 0.1f, 0.2f };
+
+// Rumbles play on their own hand for their duration and follow their envelope, all with a fake clock so that no real time has to pass
+static void TestEnvelopes() {
+    InputRumbleScheduler scheduler;
+    scheduler.Enqueue(FIXED);
+    auto vibrations = Update(scheduler, 0);
+    Check(!vibrations[0] && vibrations[1] && Near(vibrations[1]->amplitude, 0.5f), "Input rumbles: a fixed rumble didn't only play on its own hand at full strength");
+    Check(!Update(scheduler, 300)[1], "Input rumbles: a rumble didn't end after its duration");
+
+    scheduler.Enqueue(RAISING);
+    Update(scheduler, 1000);
+    vibrations = Update(scheduler, 1100);
+    Check(vibrations[0] && Near(vibrations[0]->amplitude, 0.25f), "Input rumbles: a raising rumble wasn't at a quarter of its strength halfway through");
+
+    scheduler.Enqueue(OSCILLATING);
+    Update(scheduler, 4100);
+    vibrations = Update(scheduler, 4225);
+    const bool crest = vibrations[0] && Near(vibrations[0]->amplitude, 1.0f) && Near(vibrations[0]->frequency, 1.0f);
+    vibrations = Update(scheduler, 4475);
+    Check(crest && vibrations[0] && Near(vibrations[0]->amplitude, 0.0f), "Input rumbles: an oscillating rumble didn't follow its wave");
+    Check(Update(scheduler, 4900)[0].has_value() && !Update(scheduler, 5100)[0], "Input rumbles: an oscillating rumble didn't end after its duration");
+}
+
+// Prioritized rumbles can't be replaced, and only one rumble that isn't prioritized waits to be applied at a time
+static void TestPriorities() {
+    InputRumbleScheduler scheduler;
+    scheduler.Enqueue(FIXED);
+    Update(scheduler, 2000);
+    scheduler.Enqueue(WEAK);
+    auto vibrations = Update(scheduler, 2010);
+    Check(vibrations[1] && Near(vibrations[1]->amplitude, 0.5f), "Input rumbles: a prioritized rumble got replaced by one that isn't");
+    scheduler.Enqueue(WEAK);
+    vibrations = Update(scheduler, 2300);
+    Check(vibrations[1] && Near(vibrations[1]->amplitude, 0.2f), "Input rumbles: a rumble that isn't prioritized didn't play once the hand was free");
+
+    RumbleParameters weakLeft = WEAK;
+    weakLeft.hand = 0;
+    scheduler.Enqueue(WEAK);
+    scheduler.Enqueue(weakLeft);
+    vibrations = Update(scheduler, 3000);
+    Check(vibrations[1] && !vibrations[0], "Input rumbles: a second rumble that isn't prioritized got queued behind the first one");
+}
+
+// Held rumbles keep going past their duration until they're stopped
+static void TestHeld() {
+    InputRumbleScheduler scheduler;
+    scheduler.Enqueue(HELD);
+    for (uint32_t ms = 3000; ms <= 4000; ms += 11) {
+        Update(scheduler, ms);
+    }
+    Check(Update(scheduler, 4000)[1].has_value(), "Input rumbles: a held rumble ended after its duration");
+    scheduler.Stop(1, RumbleType::Raising, At(4010));
+    Check(!Update(scheduler, 4020)[1], "Input rumbles: stopping a held rumble didn't end it");
+}
+
+// A few minutes of 90 Hz updates with both hands busy
+static void TimeUpdates() {
+    constexpr uint32_t UPDATE_COUNT = 90 * 300;
+    InputRumbleScheduler scheduler;
+    float checksum = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < UPDATE_COUNT; i++) {
+        if (i % 45 == 0) {
+            scheduler.Enqueue({ true, (int)(i / 45) & 1, (RumbleType)((i / 90) % 6), 4.0f, false, 0.5, 0.5f, 0.5f });
+        }
+        for (const auto& vibration : Update(scheduler, i * 11)) {
+            checksum += vibration ? vibration->amplitude : 0.0f;
+        }
+    }
+    Log::print<INFO>("Input rumbles: {:.0f} ns per update (checksum {:.1f})", NsPer(std::chrono::steady_clock::now() - start, UPDATE_COUNT), checksum);
+}
+
+int main() {
+    TestEnvelopes();
+    TestPriorities();
+    TestHeld();
+    TimeUpdates();
+    return FinishTests("Input rumbles");
+}
@@ -0,0 +1,88 @@
+#include "test_utils.h"
+#include "utils/interop_barriers.h"
+
+using namespace VulkanUtils;
+
+// Everything that touches the images around the interop copy, with the stages and accesses that the Vulkan spec gives each command.
+// The barrier plans are checked against these instead of against masks that are written the same way as in PlanInteropCopyBarriers.
+struct ImageAccess {
+    const char* name;
+    VkPipelineStageFlags2 stages;
+    VkAccessFlags2 access;
+    bool writes;
+};
+
+constexpr ImageAccess COLOR_RENDERING = { "rendering into the color framebuffer", VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, true };
+constexpr ImageAccess DEPTH_RENDERING = { "rendering into the depth framebuffer", VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, true };
+constexpr ImageAccess CEMU_CLEAR = { "Cemu clearing the framebuffer", VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, true };
+constexpr ImageAccess CEMU_TRANSFER = { "Cemu copying, blitting or resolving into the framebuffer", VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT | VK_PIPELINE_STAGE_2_RESOLVE_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, true };
+constexpr ImageAccess COPY_READ = { "the interop copy reading the framebuffer", VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, false };
+constexpr ImageAccess COPY_WRITE = { "the interop copy writing the interop texture", VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, true };
+
+// the stages that a stage mask stands for, with the meta stages replaced by the stages they contain
+static VkPipelineStageFlags2 ExpandStages(VkPipelineStageFlags2 stages) {
+    if (stages & VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT) {
+        return ~VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+    if (stages & VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT) {
+        stages = (stages & ~VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT) | VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT | VK_PIPELINE_STAGE_2_RESOLVE_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    }
+    return stages;
+}
+
+// the accesses that an access mask stands for, MEMORY_READ and MEMORY_WRITE cover every read and write
+static bool CoversAccess(VkAccessFlags2 mask, const ImageAccess& access) {
+    return (mask & access.access) == access.access || (mask & (access.writes ? VK_ACCESS_2_MEMORY_WRITE_BIT : VK_ACCESS_2_MEMORY_READ_BIT)) != 0;
+}
+
+// A barrier between every access before it and every access after it has to include all of their stages, and also has to make the writes before it
+// available and visible to the accesses after it. It shouldn't wait for or flush anything else, and a barrier that only follows reads needs no memory dependency.
+static void CheckBarrier(const char* name, const ImageBarrierMasks& masks, std::initializer_list<ImageAccess> before, std::initializer_list<ImageAccess> after) {
+    const VkPipelineStageFlags2 srcStages = ExpandStages(masks.srcStageMask);
+    const VkPipelineStageFlags2 dstStages = ExpandStages(masks.dstStageMask);
+    VkPipelineStageFlags2 neededSrcStages = 0, neededDstStages = 0;
+    VkAccessFlags2 neededSrcAccess = 0, neededDstAccess = 0;
+    const bool afterWrite = std::ranges::any_of(before, &ImageAccess::writes);
+
+    for (const ImageAccess& access : before) {
+        neededSrcStages |= access.stages;
+        Check((srcStages & access.stages) == access.stages, "{}: doesn't wait for {}", name, access.name);
+        if (access.writes) {
+            neededSrcAccess |= access.access;
+            Check(CoversAccess(masks.srcAccessMask, access), "{}: doesn't make {} available", name, access.name);
+        }
+    }
+    for (const ImageAccess& access : after) {
+        neededDstStages |= access.stages;
+        Check((dstStages & access.stages) == access.stages, "{}: doesn't block {}", name, access.name);
+        if (afterWrite) {
+            neededDstAccess |= access.access;
+            Check(CoversAccess(masks.dstAccessMask, access), "{}: doesn't make the writes visible to {}", name, access.name);
+        }
+    }
+
+    Check((srcStages & ~neededSrcStages) == 0, "{}: also waits for stages {:#x} that don't touch the image", name, srcStages & ~neededSrcStages);
+    Check((dstStages & ~neededDstStages) == 0, "{}: also blocks stages {:#x} that don't touch the image", name, dstStages & ~neededDstStages);
+    Check((masks.srcAccessMask & ~neededSrcAccess) == 0, "{}: also makes accesses {:#x} available", name, masks.srcAccessMask & ~neededSrcAccess);
+    Check((masks.dstAccessMask & ~neededDstAccess) == 0, "{}: also makes accesses {:#x} visible", name, masks.dstAccessMask & ~neededDstAccess);
+}
+
+int main() {
+    const InteropCopyBarrierPlan colorPlan = PlanInteropCopyBarriers(false);
+    CheckBarrier("color framebuffer before the copy", colorPlan.srcBefore, { COLOR_RENDERING, CEMU_CLEAR, CEMU_TRANSFER }, { COPY_READ });
+    CheckBarrier("color interop texture before the copy", colorPlan.dstBefore, { COPY_WRITE }, { COPY_WRITE });
+    CheckBarrier("color framebuffer after the copy", colorPlan.srcAfter, { COPY_READ }, { COLOR_RENDERING, CEMU_CLEAR, CEMU_TRANSFER });
+
+    const InteropCopyBarrierPlan depthPlan = PlanInteropCopyBarriers(true);
+    CheckBarrier("depth framebuffer before the copy", depthPlan.srcBefore, { DEPTH_RENDERING, CEMU_CLEAR, CEMU_TRANSFER }, { COPY_READ });
+    CheckBarrier("depth interop texture before the copy", depthPlan.dstBefore, { COPY_WRITE }, { COPY_WRITE });
+    CheckBarrier("depth framebuffer after the copy", depthPlan.srcAfter, { COPY_READ }, { DEPTH_RENDERING, CEMU_CLEAR, CEMU_TRANSFER });
+
+    // both images stay in the GENERAL layout on the same queue, so the barriers may not transition or transfer anything
+    const VkImageMemoryBarrier2 barrier = MakeImageBarrier(colorPlan.srcBefore, (VkImage)(uintptr_t)0x1000, VK_IMAGE_ASPECT_COLOR_BIT);
+    Check(barrier.oldLayout == VK_IMAGE_LAYOUT_GENERAL && barrier.newLayout == VK_IMAGE_LAYOUT_GENERAL, "Image barriers change the layout");
+    Check(barrier.srcQueueFamilyIndex == VK_QUEUE_FAMILY_IGNORED && barrier.dstQueueFamilyIndex == VK_QUEUE_FAMILY_IGNORED, "Image barriers transfer queue family ownership");
+    Check(barrier.subresourceRange.levelCount == VK_REMAINING_MIP_LEVELS && barrier.subresourceRange.layerCount == VK_REMAINING_ARRAY_LAYERS, "Image barriers don't cover the whole image");
+
+    return FinishTests("Interop barriers");
+}
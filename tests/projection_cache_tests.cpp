@@ -0,0 +1,79 @@
+#include "test_utils.h"
+#include "hooking/projection_cache.h"
+
+// like the layer, every thread that runs the projection hooks gets its own cache
+static thread_local ProjectionCache s_projectionCache;
+
+// Random fields of view, clip distances and depth ranges that repeat often enough to hit the cache and to evict entries
+static void MakeInput(TestRandom& random, XrFovf& fov, BESeadPerspectiveProjection& input) {
+    const float variant = (float)(random.Next() % 6);
+    fov = { -0.9f - variant * 0.01f, 0.8f + variant * 0.01f, 0.85f, -0.9f - variant * 0.02f };
+
+    input = {};
+    input.zNear = 0.1f + (float)(random.Next() % 3) * 0.05f;
+    input.zFar = 1000.0f * (float)(1 + random.Next() % 3);
+    input.deviceZScale = random.Next() % 2 == 0 ? 1.0f : 0.5f;
+    input.deviceZOffset = random.Next() % 2 == 0 ? 0.0f : 0.5f;
+    input.devicePosture = random.Next() % 2;
+    input.fovYRadiansOrAngle = (float)(random.Next() % 100); // overwritten, so it shouldn't matter for the cache
+}
+
+// Checks that cached projections are bit-identical to calculating them every time
+static uint32_t CountMismatches(uint32_t seed, uint32_t iterations) {
+    TestRandom random = { seed };
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        XrFovf fov;
+        BESeadPerspectiveProjection input;
+        MakeInput(random, fov, input);
+
+        BESeadPerspectiveProjection expected = input;
+        applyVRProjection(expected, fov);
+        BESeadPerspectiveProjection cached = input;
+        s_projectionCache.Apply((uint8_t)(random.Next() % 2), cached, fov);
+        mismatches += memcmp(&expected, &cached, sizeof(BESeadPerspectiveProjection)) != 0 ? 1 : 0;
+    }
+    return mismatches;
+}
+
+int main() {
+    constexpr uint32_t ITERATIONS = 100000;
+    const uint32_t mismatches = CountMismatches(0x2545F491u, ITERATIONS);
+    Check(mismatches == 0, "Projection cache: {} of {} projections differed from calculating them directly", mismatches, ITERATIONS);
+
+    // the hooks run on several of Cemu's threads at once
+    constexpr uint32_t THREAD_COUNT = 4;
+    std::array<uint32_t, THREAD_COUNT> threadMismatches = {};
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+        threads.emplace_back([&threadMismatches, i] { threadMismatches[i] = CountMismatches(0x1000u + i, ITERATIONS); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+        Check(threadMismatches[i] == 0, "Projection cache: thread {} got {} of {} projections that differed from calculating them directly", i, threadMismatches[i], ITERATIONS);
+    }
+
+    // time a frame's worth of calls with unchanged inputs against calculating them every time
+    XrFovf fov;
+    BESeadPerspectiveProjection input;
+    TestRandom random;
+    MakeInput(random, fov, input);
+    BESeadPerspectiveProjection output = input;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        output = input;
+        applyVRProjection(output, fov);
+    }
+    const double uncachedNs = NsPer(std::chrono::steady_clock::now() - start, ITERATIONS);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        output = input;
+        s_projectionCache.Apply((uint8_t)(i % 2), output, fov);
+    }
+    const double cachedNs = NsPer(std::chrono::steady_clock::now() - start, ITERATIONS);
+    Log::print<INFO>("Projection cache: {:.1f} ns per projection when cached, {:.1f} ns when calculated ({})", cachedNs, uncachedNs, output.aspect.getLE());
+
+    return FinishTests("Projection cache");
+}
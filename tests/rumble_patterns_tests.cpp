@@ -0,0 +1,121 @@
+#include "test_utils.h"
+#include "hooking/rumble_patterns.h"
+
+static const uint8_t KNOWN_PATTERN[] = { 0b00000011, 0b00001100 };
+
+// The game's patterns are packed into bits as one 60 Hz step per 2 bits
+static std::array<uint8_t, RumblePattern::MAX_STEPS / 4> ToBytes(uint64_t steps, uint8_t stepCount) {
+    std::array<uint8_t, RumblePattern::MAX_STEPS / 4> bytes = {};
+    for (uint32_t step = 0; step < stepCount; step++) {
+        bytes[step / 4] |= (uint8_t)(((steps >> step) & 1) * 3) << ((step % 4) * 2);
+    }
+    return bytes;
+}
+
+// Every 2 bits become one step, rounding up
+static void TestPack() {
+    const RumblePattern packed = RumblePattern::Pack(KNOWN_PATTERN, 16);
+    Check(packed.stepCount == 8 && packed.steps == 0b00100001, "Rumble patterns: packing the known pattern gave {} steps {:#b}", packed.stepCount, packed.steps);
+    Check(RumblePattern::Pack(KNOWN_PATTERN, 3).stepCount == 2, "Rumble patterns: an odd bit count didn't round up to a whole step");
+}
+
+// Steps play in order, a full queue drops new patterns and stopping discards the playing and the queued patterns
+static void TestPlayback() {
+    RumblePatternPlayer player;
+    Check(!player.Tick().has_value(), "Rumble patterns: something played without a pattern");
+    player.Push(KNOWN_PATTERN, 16);
+    std::string steps;
+    while (std::optional<bool> on = player.Tick()) {
+        steps += *on ? '1' : '0';
+    }
+    Check(steps == "10000100", "Rumble patterns: the known pattern played as {}", steps);
+
+    for (size_t i = 0; i < RumblePatternPlayer::QUEUE_CAPACITY; i++) {
+        Check(player.Push(KNOWN_PATTERN, 16), "Rumble patterns: the queue only took {} of {} patterns", i, RumblePatternPlayer::QUEUE_CAPACITY);
+    }
+    Check(!player.Push(KNOWN_PATTERN, 16), "Rumble patterns: a full queue took another pattern");
+    player.Tick();
+    player.Stop();
+    Check(!player.Tick().has_value(), "Rumble patterns: stopping didn't discard the playing and the queued patterns");
+    Check(player.Push(KNOWN_PATTERN, 16) && player.Tick() == true, "Rumble patterns: a pattern pushed after stopping didn't play");
+}
+
+// Pushes patterns from a second thread while this one ticks them, like the game and the rumble thread do. Every pattern encodes a counter
+// so that any lost, reordered or torn pattern shows up.
+static void TestPushFromAnotherThread(uint32_t patternCount) {
+    auto patternSteps = [](uint32_t index) {
+        uint64_t x = 0x9E3779B97F4A7C15ull * (index + 1);
+        x ^= x >> 29;
+        return (x | 1) & ((1ull << RumblePattern::MAX_STEPS) - 1);
+    };
+
+    RumblePatternPlayer player;
+    std::chrono::steady_clock::duration pushTime = {};
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < patternCount; i++) {
+            const auto bytes = ToBytes(patternSteps(i), RumblePattern::MAX_STEPS);
+            const auto start = std::chrono::steady_clock::now();
+            while (!player.Push(bytes.data(), RumblePattern::MAX_STEPS * 2)) {
+                std::this_thread::yield();
+            }
+            pushTime += std::chrono::steady_clock::now() - start;
+        }
+    });
+
+    uint32_t received = 0;
+    uint32_t mismatches = 0;
+    uint64_t steps = 0;
+    uint32_t stepCount = 0;
+    while (received < patternCount) {
+        std::optional<bool> on = player.Tick();
+        if (!on) {
+            std::this_thread::yield();
+            continue;
+        }
+        steps |= (uint64_t)*on << stepCount;
+        if (++stepCount == RumblePattern::MAX_STEPS) {
+            mismatches += steps != patternSteps(received) ? 1 : 0;
+            received++;
+            steps = 0;
+            stepCount = 0;
+        }
+    }
+    producer.join();
+
+    Check(mismatches == 0, "Rumble patterns: {} of {} patterns from another thread arrived changed or out of order", mismatches, patternCount);
+    Log::print<INFO>("Rumble patterns: {:.0f} ns per push from another thread, including waits for a full queue", NsPer(pushTime, patternCount));
+}
+
+// The rumble thread doesn't wake up at all while there's nothing to play, only ticks while a pattern plays and goes back to sleep afterwards.
+// Needs real time to pass since Run sleeps between ticks.
+static void TestIdleWakeups() {
+    RumblePatternPlayer player;
+    std::atomic<bool> shutdown = false;
+    std::atomic<uint32_t> motorChanges = 0;
+    std::thread rumbleThread([&] { player.Run(shutdown, [&](bool) { motorChanges++; }); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const uint64_t idleWakeups = player.GetWakeups();
+    Check(idleWakeups == 0, "Rumble patterns: the rumble thread woke up {} times while it was idle", idleWakeups);
+
+    // the known pattern is 8 steps long, so it's done well before this
+    player.Push(KNOWN_PATTERN, 16);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const uint64_t playingWakeups = player.GetWakeups();
+    Check(motorChanges == 4, "Rumble patterns: the known pattern changed the motor {} times instead of turning it on and off twice", motorChanges.load());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    Check(player.GetWakeups() == playingWakeups, "Rumble patterns: the rumble thread woke up {} times after the pattern was done", player.GetWakeups() - playingWakeups);
+
+    player.Stop();
+    shutdown = true;
+    player.Wake();
+    rumbleThread.join();
+    Log::print<INFO>("Rumble patterns: {} wakeups to play an 8 step pattern", playingWakeups);
+}
+
+int main() {
+    TestPack();
+    TestPlayback();
+    TestPushFromAnotherThread(20000);
+    TestIdleWakeups();
+    return FinishTests("Rumble patterns");
+}
@@ -0,0 +1,116 @@
+#include "test_utils.h"
+#include "utils/settings_store.h"
+
+#include <cstdio>
+
+constexpr uint32_t ITERATIONS = 10000;
+
+// Round-trips every setting through the ini format and times loading against the sscanf chain it replaced
+static void TestSchema() {
+    ModSettings changed = {};
+    changed.cameraMode = CameraMode::THIRD_PERSON;
+    changed.thirdPlayerDistance = 0.875f;
+    changed.cutsceneCameraMode = EventMode::ALWAYS_THIRD_PERSON;
+    changed.uiFollowsGaze = false;
+    changed.buggyAngularVelocity = AngularVelocityFixerMode::FORCED_OFF;
+    changed.performanceOverlayFrequency = 144;
+    const std::string saved = SettingsSchema::Serialize(changed);
+
+    std::vector<std::string> lines;
+    for (size_t start = 0, end; (end = saved.find('\n', start)) != std::string::npos; start = end + 1) {
+        lines.push_back(saved.substr(start, end - start));
+    }
+    Check(lines.size() == SettingsSchema::FIELDS.size(), "Settings: {} settings were saved on {} lines", SettingsSchema::FIELDS.size(), lines.size());
+
+    ModSettings loaded = {};
+    bool parsedAll = true;
+    for (const std::string& line : lines) {
+        parsedAll &= SettingsSchema::ParseLine(loaded, line);
+    }
+    Check(parsedAll && SettingsSchema::Serialize(loaded) == saved, "Settings: the saved settings didn't load back to what was saved");
+    Check(!SettingsSchema::ParseLine(loaded, "Unknown=1") && !SettingsSchema::ParseLine(loaded, "CameraMode=") && loaded.cameraMode == CameraMode::THIRD_PERSON, "Settings: unknown keys or broken values weren't ignored");
+
+    const auto parseStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        for (const std::string& line : lines) {
+            SettingsSchema::ParseLine(loaded, line);
+        }
+    }
+    const auto parseElapsed = std::chrono::steady_clock::now() - parseStart;
+
+    // the old loader tried a sscanf of every key in turn until one matched
+    std::vector<std::string> formats;
+    for (const SettingsSchema::Field& field : SettingsSchema::FIELDS) {
+        formats.push_back(std::string(field.key) + "=%f");
+    }
+    const auto sscanfStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        for (const std::string& line : lines) {
+            float value;
+            for (const std::string& format : formats) {
+                if (sscanf(line.c_str(), format.c_str(), &value) == 1) break;
+            }
+        }
+    }
+    const auto sscanfElapsed = std::chrono::steady_clock::now() - sscanfStart;
+
+    Log::print<INFO>("Settings: {:.0f} ns per loaded line (sscanf chain: {:.0f} ns)", NsPer(parseElapsed, ITERATIONS * lines.size()), NsPer(sscanfElapsed, ITERATIONS * lines.size()));
+}
+
+// Checks that readers never see a half-written snapshot while another thread keeps publishing new ones
+static void TestConcurrentReads() {
+    // the writer keeps both fields equal in every snapshot it publishes
+    SettingsStore store;
+    std::atomic<bool> done = false;
+    std::thread writer([&] {
+        for (uint32_t i = 1; !done.load(std::memory_order_relaxed); i++) {
+            store.Update([&](ModSettings& settings) {
+                settings.performanceOverlayFrequency = i;
+                settings.thirdPlayerDistance = (float)(i % 100000);
+            });
+        }
+    });
+
+    uint32_t tornReads = 0;
+    uint64_t lastVersion = 0;
+    bool versionsIncrease = true;
+    const uint32_t readCount = ITERATIONS * 100;
+    const auto readStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < readCount; i++) {
+        const std::shared_ptr<const ModSettings> settings = store.Get();
+        tornReads += (float)(settings->performanceOverlayFrequency % 100000) != settings->thirdPlayerDistance && settings->version != 0 ? 1 : 0;
+        versionsIncrease &= settings->version >= lastVersion;
+        lastVersion = settings->version;
+    }
+    const auto readElapsed = std::chrono::steady_clock::now() - readStart;
+    done = true;
+    writer.join();
+    Check(tornReads == 0, "Settings: {} reads saw a half-written snapshot", tornReads);
+    Check(versionsIncrease, "Settings: reads saw snapshots out of the order they were published in");
+
+    Log::print<INFO>("Settings: {:.1f} ns per snapshot read while another thread published {} snapshots", NsPer(readElapsed, readCount), lastVersion);
+}
+
+// A snapshot that a reader holds on to has to stay alive and unchanged no matter how many newer ones get published, and has to be freed once it's let go
+static void TestHeldSnapshots() {
+    SettingsStore store;
+    store.Update([](ModSettings& settings) { settings.performanceOverlayFrequency = 72; });
+    std::shared_ptr<const ModSettings> held = store.Get();
+    const std::weak_ptr<const ModSettings> watched = held;
+
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        store.Update([&](ModSettings& settings) { settings.performanceOverlayFrequency = 90 + i; });
+    }
+    Check(held->performanceOverlayFrequency == 72 && held->version == 1, "Settings: a held snapshot changed after newer ones were published");
+    Check(store.Get()->version == ITERATIONS + 1, "Settings: the store is at version {} after {} updates", store.Get()->version, ITERATIONS + 1);
+
+    held.reset();
+    Check(watched.expired(), "Settings: a replaced snapshot wasn't freed once its last reader let go of it");
+}
+
+int main() {
+    TestSchema();
+    TestConcurrentReads();
+    TestHeldSnapshots();
+    return FinishTests("Settings");
+}
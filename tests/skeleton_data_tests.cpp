@@ -0,0 +1,82 @@
+#include "test_utils.h"
+#include "hooking/skeleton_data.h"
+
+#include <sstream>
+
+struct ParsedBone {
+    std::string name;
+    int parentIndex = -1;
+    std::array<float, 3> position = {};
+    std::array<float, 3> rotation = {};
+};
+
+// The stringstream parser that the layer used to run at startup, everything that SkeletonData parses at compile time has to match it
+static std::vector<ParsedBone> ParseAtRuntime(const std::string& data) {
+    std::vector<ParsedBone> bones;
+    std::stringstream ss(data);
+    std::string line;
+    std::vector<std::pair<int, int>> parentStack;
+    parentStack.push_back({ -1, -1 }); // Root parent is -1
+    while (std::getline(ss, line)) {
+        if (line.empty()) continue;
+        int indent = 0;
+        while (indent < (int)line.length() && line[indent] == ' ') indent++;
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos) continue;
+        std::string content = line.substr(start);
+        size_t p1 = content.find('|');
+        if (p1 == std::string::npos) continue;
+        std::string currentName = content.substr(0, p1);
+        size_t lastChar = currentName.find_last_not_of(' ');
+        if (lastChar != std::string::npos) currentName = currentName.substr(0, lastChar + 1);
+        size_t p2 = content.find('|', p1 + 1);
+        if (p2 == std::string::npos) continue;
+
+        ParsedBone bone;
+        bone.name = currentName;
+        std::stringstream ssPos(content.substr(p1 + 1, p2 - p1 - 1));
+        ssPos >> bone.position[0] >> bone.position[1] >> bone.position[2];
+        std::stringstream ssRot(content.substr(p2 + 1));
+        ssRot >> bone.rotation[0] >> bone.rotation[1] >> bone.rotation[2];
+
+        while (parentStack.size() > 1 && parentStack.back().first >= indent) {
+            parentStack.pop_back();
+        }
+        bone.parentIndex = parentStack.back().second;
+        parentStack.push_back({ indent, (int)bones.size() });
+        bones.push_back(bone);
+    }
+    return bones;
+}
+
+// whether bone is the ancestor or the bone itself
+static bool IsInSubtree(const std::vector<ParsedBone>& bones, int ancestor, int bone) {
+    for (int i = bone; i != -1; i = bones[i].parentIndex) {
+        if (i == ancestor) return true;
+    }
+    return false;
+}
+
+int main() {
+    const std::vector<ParsedBone> expected = ParseAtRuntime(std::string(SkeletonData::SOURCE));
+    Check(expected.size() == SkeletonData::BONE_COUNT, "Skeleton data: parsed {} bones at compile time and {} at runtime", SkeletonData::BONE_COUNT, expected.size());
+
+    for (size_t i = 0; i < std::min(expected.size(), SkeletonData::BONE_COUNT); i++) {
+        const SkeletonData::BoneDef& bone = SkeletonData::BONES[i];
+        Check(bone.name == expected[i].name, "Skeleton data: bone {} is called {} instead of {}", i, bone.name, expected[i].name);
+        Check(bone.parentIndex == expected[i].parentIndex, "Skeleton data: {} has parent {} instead of {}", expected[i].name, bone.parentIndex, expected[i].parentIndex);
+        for (int axis = 0; axis < 3; axis++) {
+            Check(bone.position[axis] == expected[i].position[axis], "Skeleton data: {} has position {} of {} instead of {}", expected[i].name, axis, bone.position[axis], expected[i].position[axis]);
+            Check(bone.rotation[axis] == expected[i].rotation[axis], "Skeleton data: {} has rotation {} of {} instead of {}", expected[i].name, axis, bone.rotation[axis], expected[i].rotation[axis]);
+        }
+
+        // the dirty updates rely on every subtree being the contiguous range [bone, subtreeEnd)
+        int subtreeEnd = (int)i + 1;
+        while (subtreeEnd < (int)expected.size() && IsInSubtree(expected, (int)i, subtreeEnd)) subtreeEnd++;
+        Check(bone.subtreeEnd == subtreeEnd, "Skeleton data: the subtree of {} ends at {} instead of {}", expected[i].name, bone.subtreeEnd, subtreeEnd);
+        Check(SkeletonData::FindBone(expected[i].name) == (int)i, "Skeleton data: looking up {} found bone {} instead of {}", expected[i].name, SkeletonData::FindBone(expected[i].name), i);
+    }
+    Check(SkeletonData::FindBone("Leg_1_L") == -1, "Skeleton data: found a bone that's commented out");
+
+    return FinishTests("Skeleton data");
+}
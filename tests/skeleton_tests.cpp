@@ -0,0 +1,241 @@
+#include "test_utils.h"
+#include "hooking/skeleton.h"
+
+#include <map>
+
+// The array-of-structs skeleton with full mat4 world updates and two-bone arm IK that the layer used before, kept as a baseline to compare against.
+// Every frame it moved Skl_Root and then solved each arm, and each of those recomputed the world matrix of every bone.
+class BaselineSkeleton {
+public:
+    struct Bone {
+        std::string name;
+        glm::vec3 localPos;
+        glm::mat4 localMatrix;
+        glm::mat4 worldMatrix;
+        int parentIndex = -1;
+    };
+
+    BaselineSkeleton() {
+        for (size_t i = 0; i < SkeletonData::BONE_COUNT; i++) {
+            const SkeletonData::BoneDef& def = SkeletonData::BONES[i];
+            Bone& bone = m_bones.emplace_back();
+            bone.name = def.name;
+            bone.localPos = glm::vec3(def.position[0], def.position[1], def.position[2]);
+            bone.localMatrix = glm::translate(glm::identity<glm::mat4>(), bone.localPos) * glm::eulerAngleZYX(def.rotation[0], def.rotation[1], def.rotation[2]);
+            bone.parentIndex = def.parentIndex;
+            m_boneNameMap[bone.name] = (int)i;
+        }
+        UpdateWorldMatrices();
+    }
+
+    void UpdateWorldMatrices() {
+        for (auto& bone : m_bones) {
+            bone.worldMatrix = bone.parentIndex == -1 ? bone.localMatrix : m_bones[bone.parentIndex].worldMatrix * bone.localMatrix;
+        }
+    }
+
+    void SolveTwoBoneIK(int rootIdx, int midIdx, int endIdx, const glm::vec3& targetPos, const glm::vec3& poleVector, float boneForwardSign) {
+        Bone& rootBone = m_bones[rootIdx];
+        Bone& midBone = m_bones[midIdx];
+        Bone& endBone = m_bones[endIdx];
+
+        glm::mat4 parentWorld = rootBone.parentIndex != -1 ? m_bones[rootBone.parentIndex].worldMatrix : glm::identity<glm::mat4>();
+        glm::vec3 rootPos = glm::vec3(parentWorld * glm::vec4(rootBone.localPos, 1.0f));
+
+        float l1 = glm::length(midBone.localPos);
+        float l2 = glm::length(endBone.localPos);
+
+        glm::vec3 dir = targetPos - rootPos;
+        float epsilon = 0.001f;
+        float dist = glm::clamp(glm::length(dir), epsilon, l1 + l2 - epsilon);
+
+        float cosAlpha = (l1 * l1 + dist * dist - l2 * l2) / (2 * l1 * dist);
+        float alpha = glm::acos(glm::clamp(cosAlpha, -1.0f, 1.0f));
+
+        glm::vec3 dirNorm = glm::normalize(dir);
+        glm::vec3 planeNormal = glm::normalize(glm::cross(dirNorm, poleVector));
+        glm::vec3 ortho = glm::normalize(glm::cross(planeNormal, dirNorm));
+
+        glm::vec3 arm1Dir = glm::normalize(dirNorm * cosf(alpha) + ortho * sinf(alpha));
+        glm::vec3 elbowPos = rootPos + arm1Dir * l1;
+        glm::vec3 arm2Dir = glm::normalize(targetPos - elbowPos);
+
+        glm::vec3 x1 = arm1Dir * boneForwardSign;
+        glm::vec3 y1 = glm::cross(planeNormal, x1);
+        glm::mat3 rot1World = glm::mat3(x1, -y1, -planeNormal);
+
+        glm::vec3 x2 = arm2Dir * boneForwardSign;
+        glm::vec3 y2 = glm::cross(planeNormal, x2);
+        glm::mat3 rot2World = glm::mat3(x2, -y2, -planeNormal);
+
+        glm::mat4 arm1Local = glm::inverse(parentWorld) * glm::mat4(rot1World);
+        arm1Local[3] = glm::vec4(rootBone.localPos, 1.0f);
+
+        glm::mat4 arm1World = parentWorld * arm1Local;
+        glm::mat4 arm2Local = glm::inverse(arm1World) * glm::mat4(rot2World);
+        arm2Local[3] = glm::vec4(midBone.localPos, 1.0f);
+
+        rootBone.localMatrix = arm1Local;
+        midBone.localMatrix = arm2Local;
+        UpdateWorldMatrices();
+    }
+
+    int GetBoneIndex(const std::string& name) const {
+        auto it = m_boneNameMap.find(name);
+        return it != m_boneNameMap.end() ? it->second : -1;
+    }
+
+    Bone& GetBone(int index) { return m_bones[index]; }
+
+private:
+    std::vector<Bone> m_bones;
+    std::map<std::string, int> m_boneNameMap;
+};
+
+// a body turning in place with both hands circling in front of it, in model space
+static glm::mat4 RootMatrix(uint32_t i) {
+    return glm::translate(glm::identity<glm::mat4>(), glm::vec3(0.0f, 1.0f, 0.0f)) * glm::eulerAngleY((float)i * 0.001f);
+}
+
+// the hands turn with the body so that they always stay within reach
+static glm::vec3 WristTarget(uint32_t i, int side) {
+    const float t = (float)i * 0.01f;
+    return glm::vec3(RootMatrix(i) * glm::vec4(side == 0 ? 0.3f : -0.3f, 0.2f + 0.1f * sinf(t), 0.3f + 0.1f * cosf(t), 1.0f));
+}
+
+static glm::vec3 ElbowPole(int side) {
+    return glm::vec3(side == 0 ? 1.0f : -1.0f, -1.0f, -0.5f);
+}
+
+// Only recomputing the dirty range of bones gives the same world matrices as recomputing all of them
+static void TestDirtyWorldMatrices() {
+    Skeleton skeleton;
+    skeleton.SetLocalMatrix(SkeletonData::SKL_ROOT, glm::mat4x3(RootMatrix(500)));
+    Skeleton::UpperBodyTargets targets;
+    targets.headPosition = glm::vec3(skeleton.GetWorldMatrix(SkeletonData::HEAD)[3]) + glm::vec3(0.0f, 0.05f, 0.05f);
+    for (int side = 0; side < 2; side++) {
+        targets.wristPositions[side] = WristTarget(500, side);
+        targets.elbowPoles[side] = ElbowPole(side);
+    }
+    skeleton.SolveUpperBody(targets);
+    skeleton.UpdateWorldMatrices();
+
+    Skeleton recomputed = skeleton;
+    recomputed.UpdateAllWorldMatrices();
+    uint32_t mismatches = 0;
+    for (int i = 0; i < skeleton.GetBoneCount(); i++) {
+        mismatches += memcmp(&skeleton.GetWorldMatrix(i), &recomputed.GetWorldMatrix(i), sizeof(glm::mat4x3)) != 0 ? 1 : 0;
+    }
+    Check(mismatches == 0, "Skeleton: {} of {} world matrices differ from recomputing every bone", mismatches, skeleton.GetBoneCount());
+}
+
+// Applies the same local matrix changes that a frame of IK makes, the root and then both arms one bone at a time, and reads the wrist after each
+// change like the solvers do. This times just the world matrix updates, all of them on the baseline and only the dirty subtrees on the skeleton.
+static void CompareWorldUpdates(uint32_t iterations) {
+    const std::array<int, 5> bones = { SkeletonData::SKL_ROOT, SkeletonData::ARM_1[0], SkeletonData::ARM_2[0], SkeletonData::ARM_1[1], SkeletonData::ARM_2[1] };
+    auto localMatrix = [](uint32_t i, size_t b, const glm::vec3& position) {
+        return glm::translate(glm::identity<glm::mat4>(), position) * glm::eulerAngleZYX(0.001f * (float)i, 0.1f * (float)b, 0.2f);
+    };
+    auto wrist = [](size_t b) { return b <= 2 ? SkeletonData::WRIST[0] : SkeletonData::WRIST[1]; };
+
+    Skeleton skeleton;
+    float checksum = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (size_t b = 0; b < bones.size(); b++) {
+            skeleton.SetLocalMatrix(bones[b], glm::mat4x3(localMatrix(i, b, skeleton.GetLocalPosition(bones[b]))));
+            checksum += skeleton.GetWorldMatrix(wrist(b))[3].y;
+        }
+    }
+    const double micros = NsPer(std::chrono::steady_clock::now() - start, iterations) / 1000.0;
+
+    BaselineSkeleton baseline;
+    float baselineChecksum = 0.0f;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (size_t b = 0; b < bones.size(); b++) {
+            baseline.GetBone(bones[b]).localMatrix = localMatrix(i, b, baseline.GetBone(bones[b]).localPos);
+            baseline.UpdateWorldMatrices();
+            baselineChecksum += baseline.GetBone(wrist(b)).worldMatrix[3].y;
+        }
+    }
+    const double baselineMicros = NsPer(std::chrono::steady_clock::now() - start, iterations) / 1000.0;
+
+    Check(std::abs(checksum - baselineChecksum) <= 1e-4f * std::abs(baselineChecksum), "Skeleton: the wrists ended up at different heights than on the baseline skeleton ({} and {})", checksum, baselineChecksum);
+    Log::print<INFO>("Skeleton: {:.2f} us per frame of world matrix updates, {:.2f} us on the baseline skeleton", micros, baselineMicros);
+}
+
+// Times the same per-frame work on both skeletons, moving the root and reaching both arms for the same targets, and checks that the wrists get there
+static void CompareWithBaseline(uint32_t iterations) {
+    Skeleton skeleton;
+    float maxError = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        skeleton.SetLocalMatrix(SkeletonData::SKL_ROOT, glm::mat4x3(RootMatrix(i)));
+        Skeleton::UpperBodyTargets targets;
+        for (int side = 0; side < 2; side++) {
+            targets.wristPositions[side] = WristTarget(i, side);
+            targets.elbowPoles[side] = ElbowPole(side);
+        }
+        skeleton.SolveUpperBody(targets);
+        for (int side = 0; side < 2; side++) {
+            maxError = std::max(maxError, glm::distance(glm::vec3(skeleton.GetWorldMatrix(SkeletonData::WRIST[side])[3]), WristTarget(i, side)));
+        }
+    }
+    const double micros = NsPer(std::chrono::steady_clock::now() - start, iterations) / 1000.0;
+
+    // the layer looked the bones up by name every frame, here they're looked up once so that both sides only do the solve
+    BaselineSkeleton baseline;
+    const int rootIndex = baseline.GetBoneIndex("Skl_Root");
+    const std::array<std::array<int, 3>, 2> armIndices = { {
+        { baseline.GetBoneIndex("Arm_1_L"), baseline.GetBoneIndex("Arm_2_L"), baseline.GetBoneIndex("Wrist_L") },
+        { baseline.GetBoneIndex("Arm_1_R"), baseline.GetBoneIndex("Arm_2_R"), baseline.GetBoneIndex("Wrist_R") },
+    } };
+    float baselineMaxError = 0.0f;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        baseline.GetBone(rootIndex).localMatrix = RootMatrix(i);
+        baseline.UpdateWorldMatrices();
+        for (int side = 0; side < 2; side++) {
+            const glm::vec3 poleDir = glm::quat_cast(baseline.GetBone(rootIndex).localMatrix) * ElbowPole(side);
+            baseline.SolveTwoBoneIK(armIndices[side][0], armIndices[side][1], armIndices[side][2], WristTarget(i, side), poleDir, side == 0 ? 1.0f : -1.0f);
+            baselineMaxError = std::max(baselineMaxError, glm::distance(glm::vec3(baseline.GetBone(armIndices[side][2]).worldMatrix[3]), WristTarget(i, side)));
+        }
+    }
+    const double baselineMicros = NsPer(std::chrono::steady_clock::now() - start, iterations) / 1000.0;
+
+    Check(maxError < 0.01f, "Skeleton: the wrists ended up {:.4f} m away from their targets", maxError);
+    Log::print<INFO>("Skeleton: {:.2f} us per root and arm solve ({:.4f} m max wrist error), {:.2f} us for the baseline skeleton ({:.4f} m max wrist error)", micros, maxError, baselineMicros, baselineMaxError);
+}
+
+// Times the whole upper-body solve that the layer does every frame, which also bends the spine towards the head
+static void TimeUpperBody(uint32_t iterations) {
+    constexpr double BUDGET_MICROS = 20.0;
+    Skeleton skeleton;
+    const glm::vec3 restHeadPos = skeleton.GetWorldMatrix(SkeletonData::HEAD)[3];
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        skeleton.SetLocalMatrix(SkeletonData::SKL_ROOT, glm::mat4x3(RootMatrix(i)));
+        Skeleton::UpperBodyTargets targets;
+        targets.headPosition = restHeadPos + glm::vec3(0.0f, 1.0f, 0.05f * sinf((float)i * 0.001f));
+        for (int side = 0; side < 2; side++) {
+            targets.wristPositions[side] = WristTarget(i, side);
+            targets.elbowPoles[side] = ElbowPole(side);
+        }
+        skeleton.SolveUpperBody(targets);
+        skeleton.UpdateWorldMatrices();
+    }
+    const double micros = NsPer(std::chrono::steady_clock::now() - start, iterations) / 1000.0;
+    Log::print<INFO>("Skeleton: {:.2f} us per upper-body solve", micros);
+    if (micros > BUDGET_MICROS) {
+        Log::print<WARNING>("Skeleton: the upper-body solve takes {:.2f} us which is over the budget of {:.0f} us per frame", micros, BUDGET_MICROS);
+    }
+}
+
+int main() {
+    TestDirtyWorldMatrices();
+    CompareWorldUpdates(100000);
+    CompareWithBaseline(100000);
+    TimeUpperBody(100000);
+    return FinishTests("Skeleton");
+}
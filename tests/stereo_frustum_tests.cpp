@@ -0,0 +1,131 @@
+#include "test_utils.h"
+#include "utils/stereo_frustum.h"
+
+// Same plane extraction as Frustum in game_structs.h, which isn't portable, checked against one eye at a time
+struct PerEyeFrustum {
+    glm::vec4 planes[6];
+
+    void update(const glm::mat4& vp) {
+        planes[0] = glm::vec4(vp[0][3] + vp[0][0], vp[1][3] + vp[1][0], vp[2][3] + vp[2][0], vp[3][3] + vp[3][0]);
+        planes[1] = glm::vec4(vp[0][3] - vp[0][0], vp[1][3] - vp[1][0], vp[2][3] - vp[2][0], vp[3][3] - vp[3][0]);
+        planes[2] = glm::vec4(vp[0][3] + vp[0][1], vp[1][3] + vp[1][1], vp[2][3] + vp[2][1], vp[3][3] + vp[3][1]);
+        planes[3] = glm::vec4(vp[0][3] - vp[0][1], vp[1][3] - vp[1][1], vp[2][3] - vp[2][1], vp[3][3] - vp[3][1]);
+        planes[4] = glm::vec4(vp[0][3] + vp[0][2], vp[1][3] + vp[1][2], vp[2][3] + vp[2][2], vp[3][3] + vp[3][2]);
+        planes[5] = glm::vec4(vp[0][3] - vp[0][2], vp[1][3] - vp[1][2], vp[2][3] - vp[2][2], vp[3][3] - vp[3][2]);
+        for (int i = 0; i < 6; ++i) {
+            planes[i] /= glm::length(glm::vec3(planes[i]));
+        }
+    }
+
+    bool checkSphere(const glm::vec3& center, float radius) const {
+        for (int i = 0; i < 6; ++i) {
+            if (glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The plane test also keeps spheres near an edge that are outside of two planes, even when they're further from the frustum than their radius.
+    // Those don't have to be kept by the combined frustum, so only spheres that are outside of at most one plane count as visible here.
+    bool checkSphereAwayFromEdges(const glm::vec3& center, float radius) const {
+        int outsidePlanes = 0;
+        for (int i = 0; i < 6; ++i) {
+            const float dist = glm::dot(glm::vec3(planes[i]), center) + planes[i].w;
+            if (dist < -radius) {
+                return false;
+            }
+            outsidePlanes += dist < 0.0f ? 1 : 0;
+        }
+        return outsidePlanes <= 1;
+    }
+};
+
+// Compares the combined frustum against the two per-eye frusta for random spheres around random headset poses: it may never cull a sphere
+// that either eye can see, and should only keep a few that both per-eye frusta cull. Also times both.
+int main() {
+    constexpr uint32_t SPHERE_COUNT = 1000000;
+    constexpr uint32_t SPHERES_PER_POSE = 1000;
+    constexpr float NEAR_CLIP = 0.1f;
+    constexpr float FAR_CLIP = 200.0f;
+    constexpr float PULL_BACK = 1.0f;
+
+    TestRandom random;
+    uint32_t wronglyCulled = 0;
+    uint32_t visibleAwayFromEdges = 0;
+    uint32_t extraVisible = 0;
+    std::chrono::steady_clock::duration perEyeElapsed = {};
+    std::chrono::steady_clock::duration combinedElapsed = {};
+
+    std::vector<glm::fvec4> spheres(SPHERES_PER_POSE);
+    std::vector<uint8_t> perEyeResults(SPHERES_PER_POSE);
+    std::vector<uint8_t> awayFromEdgesResults(SPHERES_PER_POSE);
+    std::vector<uint8_t> combinedResults(SPHERES_PER_POSE);
+    for (uint32_t pose = 0; pose * SPHERES_PER_POSE < SPHERE_COUNT; pose++) {
+        // a headset somewhere in the world looking in a random direction, with slightly canted and asymmetric eyes every other pose
+        const glm::fvec3 headPos = glm::fvec3(random.Range(-1000.0f, 1000.0f), random.Range(0.0f, 300.0f), random.Range(-1000.0f, 1000.0f));
+        const glm::fquat headRot = glm::angleAxis(random.Range(-3.14f, 3.14f), glm::fvec3(0.0f, 1.0f, 0.0f)) * glm::angleAxis(random.Range(-1.2f, 1.2f), glm::fvec3(1.0f, 0.0f, 0.0f));
+        const float cant = (pose % 2 == 0) ? 0.0f : glm::radians(10.0f);
+        const float ipd = random.Range(0.055f, 0.075f);
+        std::array<StereoFrustum::Eye, 2> eyes = {};
+        for (size_t side = 0; side < 2; side++) {
+            const float sign = side == 0 ? -1.0f : 1.0f;
+            eyes[side].rotation = headRot * glm::angleAxis(-sign * cant, glm::fvec3(0.0f, 1.0f, 0.0f));
+            eyes[side].fov = { side == 0 ? -0.95f : -0.8f, side == 0 ? 0.8f : 0.95f, 0.9f, -0.95f };
+            // pulled back the same way as hook_CheckIfCameraCanSeePos does
+            eyes[side].position = headPos + headRot * glm::fvec3(sign * ipd * 0.5f, 0.0f, 0.0f) + eyes[side].rotation * glm::fvec3(0.0f, 0.0f, PULL_BACK);
+        }
+        for (glm::fvec4& sphere : spheres) {
+            sphere = glm::fvec4(headPos + glm::fvec3(random.Range(-150.0f, 150.0f), random.Range(-150.0f, 150.0f), random.Range(-150.0f, 150.0f)), random.Range(0.05f, 3.0f));
+        }
+
+        // the old way, building both frusta for every check
+        const auto perEyeStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < spheres.size(); i++) {
+            bool visible = false;
+            for (const StereoFrustum::Eye& eye : eyes) {
+                const glm::fmat4 view = glm::inverse(glm::translate(glm::fmat4(1.0f), eye.position) * glm::mat4_cast(eye.rotation));
+                const glm::fmat4 proj = glm::frustumRH_NO(tanf(eye.fov.angleLeft) * NEAR_CLIP, tanf(eye.fov.angleRight) * NEAR_CLIP, tanf(eye.fov.angleDown) * NEAR_CLIP, tanf(eye.fov.angleUp) * NEAR_CLIP, NEAR_CLIP, FAR_CLIP);
+                PerEyeFrustum frustum;
+                frustum.update(proj * view);
+                if (frustum.checkSphere(glm::fvec3(spheres[i]), spheres[i].w)) {
+                    visible = true;
+                    break;
+                }
+            }
+            perEyeResults[i] = visible ? 1 : 0;
+        }
+        perEyeElapsed += std::chrono::steady_clock::now() - perEyeStart;
+
+        for (size_t i = 0; i < spheres.size(); i++) {
+            awayFromEdgesResults[i] = 0;
+            for (const StereoFrustum::Eye& eye : eyes) {
+                const glm::fmat4 view = glm::inverse(glm::translate(glm::fmat4(1.0f), eye.position) * glm::mat4_cast(eye.rotation));
+                const glm::fmat4 proj = glm::frustumRH_NO(tanf(eye.fov.angleLeft) * NEAR_CLIP, tanf(eye.fov.angleRight) * NEAR_CLIP, tanf(eye.fov.angleDown) * NEAR_CLIP, tanf(eye.fov.angleUp) * NEAR_CLIP, NEAR_CLIP, FAR_CLIP);
+                PerEyeFrustum frustum;
+                frustum.update(proj * view);
+                awayFromEdgesResults[i] |= frustum.checkSphereAwayFromEdges(glm::fvec3(spheres[i]), spheres[i].w) ? 1 : 0;
+            }
+        }
+
+        const auto combinedStart = std::chrono::steady_clock::now();
+        StereoFrustum combined;
+        combined.Build(eyes, NEAR_CLIP, FAR_CLIP);
+        for (size_t i = 0; i < spheres.size(); i++) {
+            combinedResults[i] = combined.CheckSphere(glm::fvec3(spheres[i]), spheres[i].w) ? 1 : 0;
+        }
+        combinedElapsed += std::chrono::steady_clock::now() - combinedStart;
+
+        for (size_t i = 0; i < spheres.size(); i++) {
+            visibleAwayFromEdges += awayFromEdgesResults[i];
+            wronglyCulled += (awayFromEdgesResults[i] && !combinedResults[i]) ? 1 : 0;
+            extraVisible += (!perEyeResults[i] && combinedResults[i]) ? 1 : 0;
+        }
+    }
+
+    Log::print<INFO>("Stereo frustum: {:.1f} ns per sphere with a frustum per eye, {:.1f} ns per sphere with the combined frustum, {} of {} visible spheres were wrongly culled and {} that the per-eye frusta cull were kept",
+        NsPer(perEyeElapsed, SPHERE_COUNT), NsPer(combinedElapsed, SPHERE_COUNT), wronglyCulled, visibleAwayFromEdges, extraVisible);
+    Check(visibleAwayFromEdges != 0, "Stereo frustum: none of the random spheres were visible, so nothing was tested");
+    Check(wronglyCulled == 0, "Stereo frustum: the combined frustum culled {} spheres that were visible to an eye", wronglyCulled);
+    return FinishTests("Stereo frustum");
+}
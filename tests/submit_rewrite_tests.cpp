@@ -0,0 +1,269 @@
+#include "test_utils.h"
+#include "utils/submit_rewrite.h"
+
+// Stands in for SharedTexture, every copy waits on and signals its texture's semaphore
+struct FakeTexture {
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    uint64_t counter = 0;
+
+    uint64_t GetVulkanWaitValue() const { return counter; }
+    uint64_t GetVulkanSignalValue() { return ++counter; }
+    const VkSemaphore& GetSemaphoreForWait(uint64_t) const { return semaphore; }
+    const VkSemaphore& GetSemaphoreForSignal(uint64_t) const { return semaphore; }
+};
+
+// Shape of one VkSubmitInfo or VkSubmitInfo2
+struct SubmitShape {
+    uint32_t waitCount;
+    uint32_t signalCount;
+    uint32_t commandBufferCount;
+    uint32_t copyCount; // copies for the command buffers of this submit
+    bool hasTimelineInfo;
+};
+
+// A submission with fake handles, built up front so that only the rewrite gets timed
+struct FakeSubmission {
+    std::vector<SubmitShape> shapes;
+    std::vector<VkSubmitInfo> infos;
+    std::vector<VkTimelineSemaphoreSubmitInfo> timelineInfos;
+    std::vector<VkSemaphore> semaphores;
+    std::vector<uint64_t> values;
+    std::vector<VkPipelineStageFlags> stages;
+    std::vector<VkCommandBuffer> commandBuffers;
+    std::vector<std::pair<VkCommandBuffer, FakeTexture*>> copies;
+
+    // the same submission for vkQueueSubmit2
+    std::vector<VkSubmitInfo2> infos2;
+    std::vector<VkSemaphoreSubmitInfo> semaphoreInfos;
+    std::vector<VkCommandBufferSubmitInfo> commandBufferInfos;
+
+    FakeSubmission(std::vector<SubmitShape> submitShapes, uint32_t laterCopyCount, FakeTexture* texture, uintptr_t& nextHandle) : shapes(std::move(submitShapes)) {
+        uint32_t semaphoreCount = 0, waitCount = 0, commandBufferCount = 0;
+        for (const SubmitShape& shape : shapes) {
+            semaphoreCount += shape.waitCount + shape.signalCount;
+            waitCount += shape.waitCount;
+            commandBufferCount += shape.commandBufferCount;
+        }
+        // sized first so that the pointers into them stay valid
+        infos.resize(shapes.size(), { VK_STRUCTURE_TYPE_SUBMIT_INFO });
+        timelineInfos.resize(shapes.size(), { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO });
+        semaphores.resize(semaphoreCount);
+        values.resize(semaphoreCount);
+        stages.resize(waitCount, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        commandBuffers.resize(commandBufferCount);
+        for (uint32_t i = 0; i < semaphoreCount; i++) {
+            semaphores[i] = (VkSemaphore)nextHandle++;
+            values[i] = i + 1;
+        }
+
+        uint32_t semaphoreIdx = 0, stageIdx = 0, commandBufferIdx = 0;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            const SubmitShape& shape = shapes[i];
+            VkSubmitInfo& info = infos[i];
+            VkTimelineSemaphoreSubmitInfo& timelineInfo = timelineInfos[i];
+            info.waitSemaphoreCount = shape.waitCount;
+            info.pWaitSemaphores = semaphores.data() + semaphoreIdx;
+            info.pWaitDstStageMask = stages.data() + stageIdx;
+            timelineInfo.waitSemaphoreValueCount = shape.waitCount;
+            timelineInfo.pWaitSemaphoreValues = values.data() + semaphoreIdx;
+            semaphoreIdx += shape.waitCount;
+            stageIdx += shape.waitCount;
+            info.signalSemaphoreCount = shape.signalCount;
+            info.pSignalSemaphores = semaphores.data() + semaphoreIdx;
+            timelineInfo.signalSemaphoreValueCount = shape.signalCount;
+            timelineInfo.pSignalSemaphoreValues = values.data() + semaphoreIdx;
+            semaphoreIdx += shape.signalCount;
+            info.commandBufferCount = shape.commandBufferCount;
+            info.pCommandBuffers = commandBuffers.data() + commandBufferIdx;
+            info.pNext = shape.hasTimelineInfo ? &timelineInfo : nullptr;
+            for (uint32_t j = 0; j < shape.commandBufferCount; j++) {
+                commandBuffers[commandBufferIdx + j] = (VkCommandBuffer)nextHandle++;
+            }
+            for (uint32_t j = 0; j < shape.copyCount; j++) {
+                copies.push_back({ commandBuffers[commandBufferIdx + j % shape.commandBufferCount], texture });
+            }
+            commandBufferIdx += shape.commandBufferCount;
+        }
+        // copies for command buffers that get submitted later
+        for (uint32_t i = 0; i < laterCopyCount; i++) {
+            copies.push_back({ (VkCommandBuffer)nextHandle++, texture });
+        }
+
+        infos2.resize(shapes.size(), { VK_STRUCTURE_TYPE_SUBMIT_INFO_2 });
+        semaphoreInfos.reserve(semaphoreCount);
+        commandBufferInfos.reserve(commandBufferCount);
+        for (size_t i = 0; i < shapes.size(); i++) {
+            const VkSubmitInfo& info = infos[i];
+            VkSubmitInfo2& info2 = infos2[i];
+            info2.waitSemaphoreInfoCount = info.waitSemaphoreCount;
+            info2.pWaitSemaphoreInfos = semaphoreInfos.data() + semaphoreInfos.size();
+            for (uint32_t j = 0; j < info.waitSemaphoreCount; j++) {
+                semaphoreInfos.push_back({ VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO, nullptr, info.pWaitSemaphores[j], timelineInfos[i].pWaitSemaphoreValues[j], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 0 });
+            }
+            info2.signalSemaphoreInfoCount = info.signalSemaphoreCount;
+            info2.pSignalSemaphoreInfos = semaphoreInfos.data() + semaphoreInfos.size();
+            for (uint32_t j = 0; j < info.signalSemaphoreCount; j++) {
+                semaphoreInfos.push_back({ VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO, nullptr, info.pSignalSemaphores[j], timelineInfos[i].pSignalSemaphoreValues[j], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 0 });
+            }
+            info2.commandBufferInfoCount = info.commandBufferCount;
+            info2.pCommandBufferInfos = commandBufferInfos.data() + commandBufferInfos.size();
+            for (uint32_t j = 0; j < info.commandBufferCount; j++) {
+                commandBufferInfos.push_back({ VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, nullptr, info.pCommandBuffers[j], 0 });
+            }
+        }
+    }
+
+    PendingCopyListOf<FakeTexture> PendingCopies() const {
+        PendingCopyListOf<FakeTexture> pendingCopies;
+        for (const auto& copy : copies) {
+            pendingCopies.push_back(copy);
+        }
+        return pendingCopies;
+    }
+};
+
+// Checks that every submit kept its own semaphores, timeline values and pNext chain, and got one wait and one signal added per copy
+static void CheckRewrite(const char* name, const FakeSubmission& submission, const VkSubmitInfo* rewritten, const FakeTexture& texture) {
+    for (size_t i = 0; i < submission.shapes.size(); i++) {
+        const SubmitShape& shape = submission.shapes[i];
+        const VkSubmitInfo& original = submission.infos[i];
+        const VkSubmitInfo& info = rewritten[i];
+        const auto* timelineInfo = static_cast<const VkTimelineSemaphoreSubmitInfo*>(info.pNext);
+
+        Check(info.waitSemaphoreCount == shape.waitCount + shape.copyCount && info.signalSemaphoreCount == shape.signalCount + shape.copyCount,
+            "{}: submit {} has {} waits and {} signals instead of {} and {}", name, i, info.waitSemaphoreCount, info.signalSemaphoreCount, shape.waitCount + shape.copyCount, shape.signalCount + shape.copyCount);
+        Check(timelineInfo != nullptr && timelineInfo->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO && timelineInfo->pNext == original.pNext,
+            "{}: submit {} doesn't start its pNext chain with the timeline values followed by the original chain", name, i);
+        if (timelineInfo == nullptr) {
+            continue;
+        }
+        Check(timelineInfo->waitSemaphoreValueCount == info.waitSemaphoreCount && timelineInfo->signalSemaphoreValueCount == info.signalSemaphoreCount,
+            "{}: submit {} has a different number of timeline values than semaphores", name, i);
+        Check(info.commandBufferCount == original.commandBufferCount && info.pCommandBuffers == original.pCommandBuffers, "{}: submit {} changed its command buffers", name, i);
+
+        for (uint32_t j = 0; j < shape.waitCount; j++) {
+            const uint64_t expectedValue = shape.hasTimelineInfo ? submission.timelineInfos[i].pWaitSemaphoreValues[j] : 0;
+            Check(info.pWaitSemaphores[j] == original.pWaitSemaphores[j] && info.pWaitDstStageMask[j] == original.pWaitDstStageMask[j] && timelineInfo->pWaitSemaphoreValues[j] == expectedValue,
+                "{}: submit {} changed its wait semaphore {}", name, i, j);
+        }
+        for (uint32_t j = 0; j < shape.signalCount; j++) {
+            const uint64_t expectedValue = shape.hasTimelineInfo ? submission.timelineInfos[i].pSignalSemaphoreValues[j] : 0;
+            Check(info.pSignalSemaphores[j] == original.pSignalSemaphores[j] && timelineInfo->pSignalSemaphoreValues[j] == expectedValue,
+                "{}: submit {} changed its signal semaphore {}", name, i, j);
+        }
+        for (uint32_t j = 0; j < shape.copyCount; j++) {
+            const uint32_t wait = shape.waitCount + j, signal = shape.signalCount + j;
+            Check(info.pWaitSemaphores[wait] == texture.semaphore && info.pWaitDstStageMask[wait] == VK_PIPELINE_STAGE_ALL_COMMANDS_BIT && info.pSignalSemaphores[signal] == texture.semaphore,
+                "{}: submit {} didn't get the semaphores of copy {}", name, i, j);
+            Check(timelineInfo->pSignalSemaphoreValues[signal] == timelineInfo->pWaitSemaphoreValues[wait] + 1,
+                "{}: submit {} signals copy {} with {} after waiting for {}", name, i, j, timelineInfo->pSignalSemaphoreValues[signal], timelineInfo->pWaitSemaphoreValues[wait]);
+        }
+    }
+}
+
+// Same for vkQueueSubmit2, where the copies only have to block the copy stage and the pNext chain stays untouched
+static void CheckRewrite2(const char* name, const FakeSubmission& submission, const VkSubmitInfo2* rewritten, const FakeTexture& texture) {
+    for (size_t i = 0; i < submission.shapes.size(); i++) {
+        const SubmitShape& shape = submission.shapes[i];
+        const VkSubmitInfo2& original = submission.infos2[i];
+        const VkSubmitInfo2& info = rewritten[i];
+
+        Check(info.waitSemaphoreInfoCount == shape.waitCount + shape.copyCount && info.signalSemaphoreInfoCount == shape.signalCount + shape.copyCount,
+            "{}: submit2 {} has {} waits and {} signals instead of {} and {}", name, i, info.waitSemaphoreInfoCount, info.signalSemaphoreInfoCount, shape.waitCount + shape.copyCount, shape.signalCount + shape.copyCount);
+        Check(info.pNext == original.pNext, "{}: submit2 {} changed its pNext chain", name, i);
+        Check(info.commandBufferInfoCount == original.commandBufferInfoCount && info.pCommandBufferInfos == original.pCommandBufferInfos, "{}: submit2 {} changed its command buffers", name, i);
+
+        for (uint32_t j = 0; j < shape.waitCount; j++) {
+            const VkSemaphoreSubmitInfo& wait = info.pWaitSemaphoreInfos[j];
+            Check(wait.semaphore == original.pWaitSemaphoreInfos[j].semaphore && wait.value == original.pWaitSemaphoreInfos[j].value && wait.stageMask == original.pWaitSemaphoreInfos[j].stageMask,
+                "{}: submit2 {} changed its wait semaphore {}", name, i, j);
+        }
+        for (uint32_t j = 0; j < shape.signalCount; j++) {
+            const VkSemaphoreSubmitInfo& signal = info.pSignalSemaphoreInfos[j];
+            Check(signal.semaphore == original.pSignalSemaphoreInfos[j].semaphore && signal.value == original.pSignalSemaphoreInfos[j].value,
+                "{}: submit2 {} changed its signal semaphore {}", name, i, j);
+        }
+        for (uint32_t j = 0; j < shape.copyCount; j++) {
+            const VkSemaphoreSubmitInfo& wait = info.pWaitSemaphoreInfos[shape.waitCount + j];
+            const VkSemaphoreSubmitInfo& signal = info.pSignalSemaphoreInfos[shape.signalCount + j];
+            Check(wait.semaphore == texture.semaphore && wait.stageMask == VK_PIPELINE_STAGE_2_COPY_BIT && signal.semaphore == texture.semaphore && signal.stageMask == VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                "{}: submit2 {} didn't get the semaphores of copy {}", name, i, j);
+            Check(signal.value == wait.value + 1, "{}: submit2 {} signals copy {} with {} after waiting for {}", name, i, j, signal.value, wait.value);
+        }
+    }
+}
+
+int main() {
+    FakeTexture texture = { (VkSemaphore)(uintptr_t)0xFEED0000 };
+    uintptr_t nextHandle = 1;
+
+    // what Cemu submits, one VkSubmitInfo at a time with a few command buffers and semaphores, and a big batch that has to use the heap
+    struct Case {
+        const char* name;
+        FakeSubmission submission;
+        bool mayUseHeap;
+    };
+    std::vector<Case> cases;
+    cases.push_back({ "single copy", FakeSubmission({ { 0, 0, 1, 1, false } }, 0, &texture, nextHandle), false });
+    cases.push_back({ "timeline semaphores", FakeSubmission({ { 2, 1, 2, 1, true } }, 0, &texture, nextHandle), false });
+    cases.push_back({ "both eyes", FakeSubmission({ { 1, 1, 3, 4, true } }, 2, &texture, nextHandle), false });
+    cases.push_back({ "several submits", FakeSubmission({ { 1, 0, 1, 0, false }, { 0, 1, 2, 2, true }, { 1, 1, 1, 1, true }, { 0, 0, 1, 0, false } }, 1, &texture, nextHandle), false });
+    cases.push_back({ "many semaphores", FakeSubmission({ { 7, 7, 1, 3, true } }, 0, &texture, nextHandle), true });
+    cases.push_back({ "many submits", FakeSubmission(std::vector<SubmitShape>(12, { 1, 1, 1, 1, true }), 3, &texture, nextHandle), true });
+    cases.push_back({ "many pending copies", FakeSubmission({ { 1, 1, 4, 4, true } }, 40, &texture, nextHandle), true });
+
+    for (Case& test : cases) {
+        PendingCopyListOf<FakeTexture> pendingCopies = test.submission.PendingCopies();
+        Check(pendingCopies.size() == test.submission.copies.size(), "{}: the pending copy list kept {} of {} copies", test.name, pendingCopies.size(), test.submission.copies.size());
+
+        bool usedHeap = false;
+        bool submitted = false;
+        RewriteSubmits((uint32_t)test.submission.shapes.size(), test.submission.infos.data(), pendingCopies, usedHeap, [&](const VkSubmitInfo* rewritten) {
+            submitted = true;
+            CheckRewrite(test.name, test.submission, rewritten, texture);
+            return VK_SUCCESS;
+        });
+        Check(submitted, "{}: the rewritten submits were never submitted", test.name);
+        Check(test.mayUseHeap || !usedHeap, "{}: the rewrite allocated for a submission that Cemu makes every frame", test.name);
+
+        // vkQueueSubmit2 goes through the same rewrite and has to consume the same copies
+        PendingCopyListOf<FakeTexture> pendingCopies2 = test.submission.PendingCopies();
+        bool usedHeap2 = false;
+        bool submitted2 = false;
+        RewriteSubmits((uint32_t)test.submission.shapes.size(), test.submission.infos2.data(), pendingCopies2, usedHeap2, [&](const VkSubmitInfo2* rewritten) {
+            submitted2 = true;
+            CheckRewrite2(test.name, test.submission, rewritten, texture);
+            return VK_SUCCESS;
+        });
+        Check(submitted2, "{}: the rewritten submits2 were never submitted", test.name);
+        Check(test.mayUseHeap || !usedHeap2, "{}: the rewrite allocated for a vkQueueSubmit2 submission that Cemu makes every frame", test.name);
+        Check(std::ranges::equal(pendingCopies, pendingCopies2), "{}: vkQueueSubmit and vkQueueSubmit2 consumed different copies", test.name);
+
+        // copies of command buffers that weren't part of the submission stay pending for the next one
+        uint32_t expectedUnconsumed = (uint32_t)test.submission.copies.size();
+        for (const SubmitShape& shape : test.submission.shapes) {
+            expectedUnconsumed -= shape.copyCount;
+        }
+        const auto unconsumed = std::ranges::count_if(pendingCopies, [](const auto& copy) { return copy.first != VK_NULL_HANDLE; });
+        Check(unconsumed == expectedUnconsumed, "{}: {} copies are still pending instead of {}", test.name, unconsumed, expectedUnconsumed);
+    }
+
+    // time the rewrite of the submissions that Cemu makes every frame
+    constexpr uint32_t REPETITIONS = 200000;
+    const auto start = std::chrono::steady_clock::now();
+    uint32_t rewrites = 0;
+    for (uint32_t repetition = 0; repetition < REPETITIONS; repetition++) {
+        for (Case& test : cases) {
+            if (test.mayUseHeap) {
+                continue;
+            }
+            PendingCopyListOf<FakeTexture> pendingCopies = test.submission.PendingCopies();
+            bool usedHeap = false;
+            RewriteSubmits((uint32_t)test.submission.shapes.size(), test.submission.infos.data(), pendingCopies, usedHeap, [](const VkSubmitInfo*) { return VK_SUCCESS; });
+            rewrites++;
+        }
+    }
+    Log::print<INFO>("Submit rewrite: {:.0f} ns per submission", NsPer(std::chrono::steady_clock::now() - start, rewrites));
+
+    return FinishTests("Submit rewrite");
+}
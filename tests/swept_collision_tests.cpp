@@ -0,0 +1,105 @@
+#include "test_utils.h"
+#include "utils/swept_collision.h"
+
+using namespace SweptCollision;
+
+static std::optional<Hit> FindFirstHitOfAll(const SweptCapsule& sweep, const std::vector<AABB>& boxes) {
+    std::optional<Hit> firstHit;
+    for (uint32_t i = 0; i < boxes.size(); i++) {
+        if (std::optional<float> time = SweepAgainstBox(sweep, boxes[i]); time && (!firstHit || *time < firstHit->time)) {
+            firstHit = Hit{ i, *time };
+        }
+    }
+    return firstHit;
+}
+
+// A fast swing that's on either side of a box at the two poses still hits it, and one that swings away from it doesn't
+static void TestTunneling() {
+    const AABB box = { glm::fvec3(0.9f, -0.5f, -0.1f), glm::fvec3(1.1f, 0.5f, 0.1f) };
+    const glm::fvec3 hand = glm::fvec3(0.0f);
+    const SweptCapsule through = { hand, hand + glm::fvec3(1.5f, 0.0f, -1.0f), hand, hand + glm::fvec3(1.5f, 0.0f, 1.0f), 0.02f };
+    Check(!SegmentIntersects(through.baseStart, through.tipStart, box) && !SegmentIntersects(through.baseEnd, through.tipEnd, box), "Swept collision: the tunneling swing already touches the box at one of its poses");
+    const std::optional<float> time = SweepAgainstBox(through, box);
+    Check(time.has_value() && *time > 0.0f && *time < 1.0f, "Swept collision: a swing through the box hit it at {}", time.value_or(-1.0f));
+
+    const SweptCapsule away = { hand, hand + glm::fvec3(1.5f, 0.0f, 0.5f), hand, hand + glm::fvec3(0.0f, 0.0f, 1.5f), 0.02f };
+    Check(!SweepAgainstBox(away, box).has_value(), "Swept collision: a swing away from the box hit it");
+}
+
+// Boxes that cover too many cells still get found, and clearing the hash forgets everything
+static void TestOversizedAndClear() {
+    auto hash = std::make_unique<SpatialHash<8>>();
+    const AABB huge = { glm::fvec3(-50.0f), glm::fvec3(50.0f) };
+    Check(hash->Insert(7, huge), "Swept collision: inserting a huge box failed");
+    const SweptCapsule sweep = { glm::fvec3(10.0f, 0.0f, 10.0f), glm::fvec3(11.0f, 0.0f, 10.0f), glm::fvec3(10.0f, 0.0f, 10.0f), glm::fvec3(10.0f, 0.0f, 11.0f), 0.05f };
+    const std::optional<Hit> hit = hash->FindFirstHit(sweep);
+    Check(hit.has_value() && hit->id == 7, "Swept collision: a sweep inside of a huge box didn't hit it");
+
+    hash->Clear();
+    Check(hash->Size() == 0 && !hash->FindFirstHit(sweep).has_value(), "Swept collision: the hash still has {} boxes after clearing it", hash->Size());
+}
+
+// Scatters boxes the size of enemies and objects around a player and sweeps sword-sized capsules through them, checking that the spatial hash
+// finds the same first hits as testing every box and timing both
+template <size_t MaxEntries>
+static void CompareWithEveryBox(uint32_t boxCount, uint32_t sweepCount) {
+    auto hash = std::make_unique<SpatialHash<MaxEntries>>();
+    std::vector<AABB> boxes;
+    TestRandom random = { 1234 };
+    auto area = [&random]() { return random.Range(-20.0f, 20.0f); };
+    auto size = [&random]() { return random.Range(0.2f, 2.5f); };
+    for (uint32_t i = 0; i < boxCount && i < MaxEntries; i++) {
+        const glm::fvec3 center = glm::fvec3(area(), area() * 0.1f, area());
+        const glm::fvec3 halfExtent = glm::fvec3(size(), size(), size()) * 0.5f;
+        boxes.push_back({ center - halfExtent, center + halfExtent });
+        Check(hash->Insert(i, boxes.back()), "Swept collision: inserting box {} of {} failed", i, boxCount);
+    }
+
+    std::vector<SweptCapsule> sweeps;
+    for (uint32_t i = 0; i < sweepCount; i++) {
+        // a 1m weapon swinging 90 degrees around the hand, about what happens in between two frames at 30 FPS during a fast slash
+        const glm::fvec3 hand = glm::fvec3(area(), area() * 0.1f, area());
+        const float startAngle = random.Range(0.0f, glm::two_pi<float>());
+        const glm::fvec3 startDir = glm::fvec3(cosf(startAngle), 0.0f, sinf(startAngle));
+        const glm::fvec3 endDir = glm::fvec3(cosf(startAngle + glm::half_pi<float>()), 0.0f, sinf(startAngle + glm::half_pi<float>()));
+        sweeps.push_back({ hand, hand + startDir, hand + glm::fvec3(0.0f, 0.05f, 0.0f), hand + endDir, 0.05f });
+    }
+
+    std::vector<std::optional<Hit>> hashHits;
+    hashHits.reserve(sweeps.size());
+    const auto hashStart = std::chrono::steady_clock::now();
+    for (const SweptCapsule& sweep : sweeps) {
+        hashHits.push_back(hash->FindFirstHit(sweep));
+    }
+    const auto hashTime = std::chrono::steady_clock::now() - hashStart;
+
+    std::vector<std::optional<Hit>> bruteHits;
+    bruteHits.reserve(sweeps.size());
+    const auto bruteStart = std::chrono::steady_clock::now();
+    for (const SweptCapsule& sweep : sweeps) {
+        bruteHits.push_back(FindFirstHitOfAll(sweep, boxes));
+    }
+    const auto bruteTime = std::chrono::steady_clock::now() - bruteStart;
+
+    uint32_t mismatches = 0;
+    uint32_t hits = 0;
+    for (size_t i = 0; i < sweeps.size(); i++) {
+        // boxes can touch the capsule at the same time, so only the time has to match
+        if (bruteHits[i].has_value() != hashHits[i].has_value() || (bruteHits[i] && bruteHits[i]->time != hashHits[i]->time)) {
+            mismatches++;
+        }
+        hits += bruteHits[i].has_value() ? 1 : 0;
+    }
+    Check(mismatches == 0, "Swept collision: the spatial hash disagreed with testing every box for {} of {} sweeps through {} boxes", mismatches, sweeps.size(), boxes.size());
+    Check(hits != 0, "Swept collision: none of the {} sweeps through {} boxes hit anything", sweeps.size(), boxes.size());
+    Log::print<INFO>("Swept collision: {} boxes, {}/{} sweeps hit, {:.0f} ns per sweep with the spatial hash and {:.0f} ns when testing every box",
+        boxes.size(), hits, sweeps.size(), NsPer(hashTime, sweeps.size()), NsPer(bruteTime, sweeps.size()));
+}
+
+int main() {
+    TestTunneling();
+    TestOversizedAndClear();
+    CompareWithEveryBox<512>(50, 2000);
+    CompareWithEveryBox<512>(400, 2000);
+    return FinishTests("Swept collision");
+}
@@ -0,0 +1,136 @@
+#include "test_utils.h"
+#include "hooking/weapon.h"
+
+// the tests only use the tuned profiles, apart from the ones that are loaded explicitly
+void WeaponProfiles::Load() {}
+
+struct Motion {
+    const char* name;
+    AttackType expected;
+    std::vector<DebugSample> samples;
+};
+
+// Synthetic idle, stab and slash motions that are closed-form functions of time, so that every rate samples the exact same movement
+static std::array<Motion, 3> SampleMotions(uint32_t rate, float stabScale = 1.0f) {
+    const XrTime interval = 1000000000 / rate;
+    std::array<Motion, 3> motions = { { { "idle", AttackType::None }, { "stab", AttackType::Stab }, { "slash", AttackType::Slash } } };
+    for (uint32_t i = 0; i < rate; i++) {
+        const XrTime time = interval * (i + 1);
+        const float t = (float)i / (float)rate;
+
+        // hand held still with a bit of tracking noise
+        const float noise = 0.01f * sinf(t * 153.0f);
+        motions[0].samples.push_back({ time, glm::fvec3(0.2f, 1.2f, -0.3f), glm::identity<glm::fquat>(), glm::fvec3(noise, 0.0f, -noise), glm::fvec3(0.0f, noise, noise) });
+
+        // pushing forward, accelerating at 30 m/s^2 up to 3 m/s and stopping again after 0.4s
+        const float stabSpeed = t < 0.1f ? 30.0f * t : t < 0.4f ? 3.0f : std::max(0.0f, 3.0f - 30.0f * (t - 0.4f));
+        const float stabDistance = t < 0.1f ? 15.0f * t * t : t < 0.4f ? 0.15f + 3.0f * (t - 0.1f) : t < 0.5f ? 1.05f + 3.0f * (t - 0.4f) - 15.0f * (t - 0.4f) * (t - 0.4f) : 1.2f;
+        motions[1].samples.push_back({ time, glm::fvec3(0.2f, 1.2f, -0.3f - stabDistance * stabScale), glm::identity<glm::fquat>(), glm::fvec3(0.0f, 0.0f, -stabSpeed * stabScale), glm::fvec3(0.0f) });
+
+        // swinging around the controller's x axis, accelerating at 200 rad/s^2 up to 10 rad/s and stopping after 0.4s
+        const float slashSpeed = t < 0.05f ? 200.0f * t : t < 0.4f ? 10.0f : 0.0f;
+        const float slashAngle = t < 0.05f ? 100.0f * t * t : t < 0.4f ? 0.25f + 10.0f * (t - 0.05f) : 3.75f;
+        motions[2].samples.push_back({ time, glm::fvec3(0.2f, 1.2f, -0.3f), glm::angleAxis(slashAngle, glm::fvec3(1, 0, 0)), glm::fvec3(0.0f), glm::fvec3(slashSpeed, 0.0f, 0.0f) });
+    }
+    return motions;
+}
+
+struct MotionResult {
+    uint32_t correctSamples = 0;
+    uint32_t wrongSamples = 0;
+    float activationMs = 0.0f;
+};
+
+static MotionResult Replay(const WeaponProfile& profile, const Motion& motion, XrTime interval) {
+    const glm::fmat4 headsetMtx = glm::translate(glm::identity<glm::fmat4>(), glm::fvec3(0.0f, 1.6f, 0.0f));
+    WeaponMotionAnalyser analyser;
+    analyser.SetProfile(profile);
+
+    MotionResult result;
+    for (const DebugSample& sample : motion.samples) {
+        // the game shows the hit one sample interval after the input got sampled
+        analyser.Update(sample, headsetMtx, sample.time + interval);
+        const AttackType detected = analyser.GetActiveAttackType();
+        if (detected != AttackType::None) {
+            if (result.correctSamples + result.wrongSamples == 0) {
+                result.activationMs = (float)(sample.time - motion.samples.front().time) / 1e6f;
+            }
+            (detected == motion.expected ? result.correctSamples : result.wrongSamples)++;
+        }
+    }
+    return result;
+}
+
+// Every motion is only recognized as the attack it's supposed to be, at every rate and with the profile of every melee weapon type
+static void TestRecognition() {
+    for (WeaponType weaponType : { WeaponType::SmallSword, WeaponType::LargeSword, WeaponType::Spear }) {
+        for (uint32_t rate : { 30u, 60u, 90u, 120u }) {
+            const XrTime interval = 1000000000 / rate;
+            std::array<float, 3> activationMs = {};
+            for (size_t m = 0; const Motion& motion : SampleMotions(rate)) {
+                const MotionResult result = Replay(WeaponProfiles::Get(weaponType), motion, interval);
+                const bool recognized = result.wrongSamples == 0 && (motion.expected == AttackType::None || result.correctSamples > 0);
+                Check(recognized, "Weapon motion: {} motion at {} Hz with weapon type {} was attacking with the right type for {} samples and the wrong type for {} samples", motion.name, rate, (uint32_t)weaponType, result.correctSamples, result.wrongSamples);
+                activationMs[m++] = result.activationMs;
+            }
+            Log::print<INFO>("Weapon motion: weapon type {} at {} Hz activates stabs after {:.0f} ms and slashes after {:.0f} ms", (uint32_t)weaponType, rate, activationMs[1], activationMs[2]);
+        }
+    }
+}
+
+// Spears have their own tuning, a short push that's enough for a sword stab doesn't reach far enough for a spear
+static void TestSpearProfile() {
+    Check(memcmp(&WeaponProfiles::Get(WeaponType::Spear), &WeaponProfiles::SPEAR, sizeof(WeaponProfile)) == 0, "Weapon motion: spears don't use the spear profile");
+    Check(memcmp(&WeaponProfiles::Get(WeaponType::LargeSword), &WeaponProfiles::DEFAULT, sizeof(WeaponProfile)) == 0, "Weapon motion: large swords don't use the default profile");
+    Check(memcmp(&WeaponProfiles::Get((WeaponType)100), &WeaponProfiles::DEFAULT, sizeof(WeaponProfile)) == 0, "Weapon motion: unknown weapon types don't use the default profile");
+
+    constexpr uint32_t RATE = 90;
+    const Motion shortStab = SampleMotions(RATE, 0.2f)[1];
+    const MotionResult sword = Replay(WeaponProfiles::Get(WeaponType::LargeSword), shortStab, 1000000000 / RATE);
+    const MotionResult spear = Replay(WeaponProfiles::Get(WeaponType::Spear), shortStab, 1000000000 / RATE);
+    Check(sword.correctSamples > 0 && sword.wrongSamples == 0, "Weapon motion: a short stab with a sword was stabbing for {} samples and something else for {} samples", sword.correctSamples, sword.wrongSamples);
+    Check(spear.correctSamples == 0 && spear.wrongSamples == 0, "Weapon motion: a short stab with a spear was stabbing for {} samples and something else for {} samples", spear.correctSamples, spear.wrongSamples);
+}
+
+// Overrides in a profiles file only change the fields and weapon types that they name
+static void TestLoadFile() {
+    const std::filesystem::path filePath = std::filesystem::temp_directory_path() / "bettervr_weapon_profiles_test.txt";
+    {
+        std::ofstream file(filePath);
+        file << "# comment\n[Spear]\nstab_travelDistance = 0.5\nunknown_field = 1\n\n[Bow]\nslash_SpeedThreshold = 2\n[SmallSword]\nslash_SpeedThreshold = nope\nslash_AccThreshold=25\n";
+    }
+    WeaponProfiles::LoadFile(filePath);
+    std::filesystem::remove(filePath);
+
+    const WeaponProfile& spear = WeaponProfiles::Get(WeaponType::Spear);
+    Check(spear.stab_travelDistance == 0.5f && spear.stab_SpeedThreshold == WeaponProfiles::SPEAR.stab_SpeedThreshold, "Weapon motion: the spear override gave a stab distance of {} and a stab speed of {}", spear.stab_travelDistance, spear.stab_SpeedThreshold);
+    const WeaponProfile& smallSword = WeaponProfiles::Get(WeaponType::SmallSword);
+    Check(smallSword.slash_AccThreshold == 25.0f && smallSword.slash_SpeedThreshold == WeaponProfiles::DEFAULT.slash_SpeedThreshold, "Weapon motion: the small sword override gave a slash acceleration of {} and a slash speed of {}", smallSword.slash_AccThreshold, smallSword.slash_SpeedThreshold);
+    Check(memcmp(&WeaponProfiles::Get(WeaponType::LargeSword), &WeaponProfiles::DEFAULT, sizeof(WeaponProfile)) == 0, "Weapon motion: the large sword changed without being overridden");
+    Check(memcmp(&WeaponProfiles::Get(WeaponType::Bow), &WeaponProfiles::DEFAULT, sizeof(WeaponProfile)) == 0, "Weapon motion: the bow's [Bow] section was applied even though it's not a melee weapon type");
+}
+
+// Times the updates of every motion at 90 Hz
+static void TimeUpdates() {
+    constexpr uint32_t RATE = 90;
+    constexpr uint32_t REPETITIONS = 1000;
+    const std::array<Motion, 3> motions = SampleMotions(RATE);
+    size_t updates = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t repetition = 0; repetition < REPETITIONS; repetition++) {
+        for (const Motion& motion : motions) {
+            Replay(WeaponProfiles::Get(WeaponType::LargeSword), motion, 1000000000 / RATE);
+            updates += motion.samples.size();
+        }
+    }
+    Log::print<INFO>("Weapon motion: {:.0f} ns per update", NsPer(std::chrono::steady_clock::now() - start, updates));
+}
+
+int main() {
+    TestRecognition();
+    TestSpearProfile();
+    TimeUpdates();
+    // last since it changes the profiles
+    TestLoadFile();
+    return FinishTests("Weapon motion");
+}
@@ -0,0 +1,77 @@
+// Replays weapon motion traces recorded from the Weapon Motion Debugger against the weapon profiles, so that profile changes
+// can be compared on any machine without starting the game:
+//   weapon_trace_replay [--profiles BetterVR_weapon_profiles.txt] [--repetitions 100] <trace.wmt or folder of traces>...
+#include "pch.h"
+#include "hooking/weapon.h"
+
+static std::filesystem::path s_profilesPath;
+
+void WeaponProfiles::Load() {
+    if (!s_profilesPath.empty()) {
+        LoadFile(s_profilesPath);
+    }
+}
+
+static void PrintUsage() {
+    Log::print<ERROR>("Usage: weapon_trace_replay [--profiles <weapon profiles file>] [--repetitions <count>] <trace.wmt or folder>...");
+}
+
+int main(int argc, char** argv) {
+    uint32_t repetitions = 100;
+    std::vector<std::filesystem::path> traces;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if (arg == "--profiles" && i + 1 < argc) {
+            s_profilesPath = argv[++i];
+            if (!std::filesystem::is_regular_file(s_profilesPath)) {
+                Log::print<ERROR>("{} doesn't exist", s_profilesPath.string());
+                return 1;
+            }
+        }
+        else if (arg == "--repetitions" && i + 1 < argc) {
+            const std::string_view value = argv[++i];
+            if (std::from_chars(value.data(), value.data() + value.size(), repetitions).ec != std::errc() || repetitions == 0) {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (arg.starts_with("--")) {
+            PrintUsage();
+            return 1;
+        }
+        else if (std::error_code ec; std::filesystem::is_directory(arg, ec)) {
+            for (const auto& entry : std::filesystem::directory_iterator(arg, ec)) {
+                if (entry.path().extension() == ".wmt") {
+                    traces.push_back(entry.path());
+                }
+            }
+        }
+        else {
+            traces.emplace_back(arg);
+        }
+    }
+    if (traces.empty()) {
+        PrintUsage();
+        return 1;
+    }
+    std::ranges::sort(traces);
+
+    WeaponMotionTrace::ReplayResult total;
+    uint32_t failedTraces = 0;
+    for (const std::filesystem::path& path : traces) {
+        std::optional<WeaponMotionTrace> trace = WeaponMotionTrace::Load(path);
+        if (!trace) {
+            failedTraces++;
+            continue;
+        }
+
+        const WeaponMotionTrace::ReplayResult result = trace->Replay(repetitions);
+        Log::print<INFO>("{}: {} correct and {} wrong attacks out of {} (precision {:.2f}, recall {:.2f}), {:.0f} ns per update",
+            path.filename().string(), result.correctAttacks, result.wrongAttacks, result.expectedAttacks, result.Precision(), result.Recall(), result.NanosPerUpdate());
+        total += result;
+    }
+    if (total.updates != 0) {
+        Log::print<INFO>("All {} traces: precision {:.2f}, recall {:.2f}, {:.0f} ns per update", traces.size() - failedTraces, total.Precision(), total.Recall(), total.NanosPerUpdate());
+    }
+    return failedTraces == 0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+#include "test_utils.h"
+#include "hooking/weapon.h"
+
+#include <sstream>
+
+// the tests only use the tuned profiles
+void WeaponProfiles::Load() {}
+
+// A recorded stab at 90 Hz, pushing forward at up to 3 m/s
+static WeaponMotionTrace MakeStabTrace() {
+    constexpr uint32_t RATE = 90;
+    constexpr XrTime INTERVAL = 1000000000 / RATE;
+    const glm::fmat4 headsetMtx = glm::translate(glm::identity<glm::fmat4>(), glm::fvec3(0.0f, 1.6f, 0.0f));
+    WeaponMotionTrace trace(WeaponType::LargeSword);
+    for (uint32_t i = 0; i < RATE; i++) {
+        const float t = (float)i / (float)RATE;
+        const float speed = t < 0.1f ? 30.0f * t : t < 0.4f ? 3.0f : std::max(0.0f, 3.0f - 30.0f * (t - 0.4f));
+        const float distance = t < 0.1f ? 15.0f * t * t : t < 0.4f ? 0.15f + 3.0f * (t - 0.1f) : t < 0.5f ? 1.05f + 3.0f * (t - 0.4f) - 15.0f * (t - 0.4f) * (t - 0.4f) : 1.2f;
+        const DebugSample sample = { INTERVAL * (i + 1), glm::fvec3(0.2f, 1.2f, -0.3f - distance), glm::identity<glm::fquat>(), glm::fvec3(0.0f, 0.0f, -speed), glm::fvec3(0.0f) };
+        trace.Add(sample, headsetMtx, sample.time + INTERVAL);
+    }
+    return trace;
+}
+
+static std::string Serialize(WeaponMotionTrace trace, AttackType label, uint32_t expectedAttacks) {
+    std::ostringstream stream(std::ios::binary);
+    trace.Save(stream, label, expectedAttacks);
+    return stream.str();
+}
+
+static std::optional<WeaponMotionTrace> Deserialize(const std::string& bytes) {
+    std::istringstream stream(bytes, std::ios::binary);
+    try {
+        return WeaponMotionTrace::Load(stream, "test trace");
+    }
+    catch (const std::exception& e) {
+        Check(false, "Weapon trace: loading threw {}", e.what());
+        return std::nullopt;
+    }
+}
+
+static WeaponMotionTrace::Header ReadHeader(const std::string& bytes) {
+    WeaponMotionTrace::Header header;
+    memcpy(&header, bytes.data(), sizeof(header));
+    return header;
+}
+
+static std::string WithHeader(std::string bytes, const WeaponMotionTrace::Header& header) {
+    memcpy(bytes.data(), &header, sizeof(header));
+    return bytes;
+}
+
+static bool SameReplay(const WeaponMotionTrace& a, const WeaponMotionTrace& b) {
+    const WeaponMotionTrace::ReplayResult resultA = a.Replay(1);
+    const WeaponMotionTrace::ReplayResult resultB = b.Replay(1);
+    return resultA.correctAttacks == resultB.correctAttacks && resultA.wrongAttacks == resultB.wrongAttacks && resultA.expectedAttacks == resultB.expectedAttacks && resultA.updates == resultB.updates;
+}
+
+int main() {
+    const WeaponMotionTrace recorded = MakeStabTrace();
+    const std::string bytes = Serialize(recorded, AttackType::Stab, 1);
+    Check(bytes.size() == sizeof(WeaponMotionTrace::Header) + recorded.GetSampleCount() * sizeof(WeaponMotionTrace::PackedSample), "Weapon trace: saved {} bytes for {} samples", bytes.size(), recorded.GetSampleCount());
+
+    // saving and loading keeps everything that the replay uses
+    std::optional<WeaponMotionTrace> loaded = Deserialize(bytes);
+    Check(loaded.has_value(), "Weapon trace: a saved trace didn't load");
+    if (loaded) {
+        Check(loaded->GetSampleCount() == recorded.GetSampleCount() && loaded->GetLabel() == AttackType::Stab, "Weapon trace: the loaded trace has {} samples labeled {} instead of {} labeled stab", loaded->GetSampleCount(), (uint32_t)loaded->GetLabel(), recorded.GetSampleCount());
+        const WeaponMotionTrace::ReplayResult result = loaded->Replay(1);
+        Check(result.expectedAttacks == 1 && result.correctAttacks == 1 && result.wrongAttacks == 0, "Weapon trace: replaying the stab found {} correct and {} wrong attacks", result.correctAttacks, result.wrongAttacks);
+    }
+
+    const WeaponMotionTrace::Header header = ReadHeader(bytes);
+    auto expectRejected = [](const char* what, const std::string& corrupt) {
+        Check(!Deserialize(corrupt).has_value(), "Weapon trace: a trace with {} was loaded", what);
+    };
+
+    WeaponMotionTrace::Header corrupt = header;
+    corrupt.magic = 0x12345678;
+    expectRejected("the wrong magic", WithHeader(bytes, corrupt));
+
+    corrupt = header;
+    corrupt.version = WeaponMotionTrace::VERSION + 1;
+    expectRejected("a newer version", WithHeader(bytes, corrupt));
+
+    corrupt = header;
+    corrupt.label = 7;
+    expectRejected("an unknown attack label", WithHeader(bytes, corrupt));
+
+    corrupt = header;
+    corrupt.weaponType = 0x100;
+    expectRejected("an unknown weapon type", WithHeader(bytes, corrupt));
+
+    // a sample count that would need gigabytes has to be rejected before allocating them
+    corrupt = header;
+    corrupt.sampleCount = std::numeric_limits<uint32_t>::max();
+    expectRejected("a sample count far beyond the file size", WithHeader(bytes, corrupt));
+
+    corrupt = header;
+    corrupt.sampleCount = header.sampleCount + 1;
+    expectRejected("one sample more than the file has", WithHeader(bytes, corrupt));
+
+    expectRejected("a cut off sample", bytes.substr(0, bytes.size() - 1));
+    expectRejected("a cut off header", bytes.substr(0, sizeof(WeaponMotionTrace::Header) - 1));
+
+    // version 1 stored the samples without their display time, which replays like a version 2 trace without display times
+    WeaponMotionTrace::Header v1Header = header;
+    v1Header.version = 1;
+    std::string v1Bytes(sizeof(v1Header), '\0');
+    memcpy(v1Bytes.data(), &v1Header, sizeof(v1Header));
+    std::string v2WithoutHitTimes = bytes;
+    for (size_t i = 0; i < header.sampleCount; i++) {
+        const size_t offset = sizeof(WeaponMotionTrace::Header) + i * sizeof(WeaponMotionTrace::PackedSample);
+        WeaponMotionTrace::PackedSample sample;
+        memcpy(&sample, bytes.data() + offset, sizeof(sample));
+        v1Bytes.append((const char*)&sample.time, sizeof(sample.time));
+        v1Bytes.append((const char*)sample.values, sizeof(sample.values));
+        sample.hitTime = 0;
+        memcpy(v2WithoutHitTimes.data() + offset, &sample, sizeof(sample));
+    }
+    std::optional<WeaponMotionTrace> v1Trace = Deserialize(v1Bytes);
+    std::optional<WeaponMotionTrace> v2Trace = Deserialize(v2WithoutHitTimes);
+    Check(v1Trace.has_value() && v2Trace.has_value(), "Weapon trace: a version 1 trace didn't load");
+    if (v1Trace && v2Trace) {
+        Check(SameReplay(*v1Trace, *v2Trace), "Weapon trace: a version 1 trace replays differently than the same samples without display times");
+    }
+    expectRejected("a version 1 sample count beyond the file size", v1Bytes.substr(0, v1Bytes.size() - 1));
+
+    return FinishTests("Weapon trace");
+}